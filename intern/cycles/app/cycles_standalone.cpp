@@ -42,6 +42,7 @@ struct Options {
   Session *session;
   Scene *scene;
   string filepath;
+  vector<string> filepaths;
   int width, height;
   SceneParams scene_params;
   SessionParams session_params;
@@ -49,6 +50,8 @@ struct Options {
   bool show_help, interactive, pause;
   string output_filepath;
   string output_pass;
+  bool no_pipeline;
+  int pipeline_memory;
 } options;
 
 static void session_print(const string &str)
@@ -95,52 +98,67 @@ static BufferParams &session_buffer_params()
   return buffer_params;
 }
 
-static void scene_init()
+static void scene_init(Session *session, const string &filepath)
 {
-  options.scene = options.session->scene;
+  Scene *scene = session->scene;
 
   /* Read XML or USD */
 #ifdef WITH_USD
-  if (!string_endswith(string_to_lower(options.filepath), ".xml")) {
-    HD_CYCLES_NS::HdCyclesFileReader::read(options.session, options.filepath.c_str());
+  if (!string_endswith(string_to_lower(filepath), ".xml")) {
+    HD_CYCLES_NS::HdCyclesFileReader::read(session, filepath.c_str());
   }
   else
 #endif
   {
-    xml_read_file(options.scene, options.filepath.c_str());
+    xml_read_file(scene, filepath.c_str());
   }
 
   /* Camera width/height override? */
   if (!(options.width == 0 || options.height == 0)) {
-    options.scene->camera->set_full_width(options.width);
-    options.scene->camera->set_full_height(options.height);
+    scene->camera->set_full_width(options.width);
+    scene->camera->set_full_height(options.height);
   }
   else {
-    options.width = options.scene->camera->get_full_width();
-    options.height = options.scene->camera->get_full_height();
+    options.width = scene->camera->get_full_width();
+    options.height = scene->camera->get_full_height();
   }
 
   /* Calculate Viewplane */
-  options.scene->camera->compute_auto_viewplane();
+  scene->camera->compute_auto_viewplane();
 }
 
-static void session_init()
+static Session *session_create(const string &filepath, const string &output_filepath)
 {
-  options.output_pass = "combined";
-  options.session = new Session(options.session_params, options.scene_params);
+  Session *session = new Session(options.session_params, options.scene_params);
 
 #ifdef WITH_CYCLES_STANDALONE_GUI
   if (!options.session_params.background) {
-    options.session->set_display_driver(make_unique<OpenGLDisplayDriver>(
-        window_opengl_context_enable, window_opengl_context_disable));
+    session->set_display_driver(make_unique<OpenGLDisplayDriver>(window_opengl_context_enable,
+                                                                 window_opengl_context_disable));
   }
 #endif
 
-  if (!options.output_filepath.empty()) {
-    options.session->set_output_driver(make_unique<OIIOOutputDriver>(
-        options.output_filepath, options.output_pass, session_print));
+  if (!output_filepath.empty()) {
+    session->set_output_driver(
+        make_unique<OIIOOutputDriver>(output_filepath, options.output_pass, session_print));
   }
 
+  /* load scene */
+  scene_init(session, filepath);
+
+  /* add pass for output. */
+  Pass *pass = session->scene->create_node<Pass>();
+  pass->set_name(ustring(options.output_pass.c_str()));
+  pass->set_type(PASS_COMBINED);
+
+  return session;
+}
+
+static void session_start(Session *session)
+{
+  options.session = session;
+  options.scene = session->scene;
+
   if (options.session_params.background && !options.quiet)
     options.session->progress.set_update_callback(function_bind(&session_print_status));
 #ifdef WITH_CYCLES_STANDALONE_GUI
@@ -148,18 +166,15 @@ static void session_init()
     options.session->progress.set_update_callback(function_bind(&window_redraw));
 #endif
 
-  /* load scene */
-  scene_init();
-
-  /* add pass for output. */
-  Pass *pass = options.scene->create_node<Pass>();
-  pass->set_name(ustring(options.output_pass.c_str()));
-  pass->set_type(PASS_COMBINED);
-
   options.session->reset(options.session_params, session_buffer_params());
   options.session->start();
 }
 
+static void session_init()
+{
+  session_start(session_create(options.filepath, options.output_filepath));
+}
+
 static void session_exit()
 {
   if (options.session) {
@@ -173,6 +188,80 @@ static void session_exit()
   }
 }
 
+/* Output file path for a frame of a sequence. A run of '#' characters is replaced by the
+ * zero-padded frame number, otherwise the frame number is appended to the file name. */
+static string session_frame_output_filepath(const int frame)
+{
+  const string &filepath = options.output_filepath;
+  if (filepath.empty() || options.filepaths.size() <= 1) {
+    return filepath;
+  }
+
+  const size_t start = filepath.find('#');
+  if (start != string::npos) {
+    size_t end = start;
+    while (end < filepath.size() && filepath[end] == '#') {
+      end++;
+    }
+    return filepath.substr(0, start) + string_printf("%0*d", int(end - start), frame) +
+           filepath.substr(end);
+  }
+
+  const string filename = path_filename(filepath);
+  size_t extension = filename.rfind('.');
+  if (extension == string::npos) {
+    extension = filename.size();
+  }
+  return path_join(path_dirname(filepath),
+                   filename.substr(0, extension) + string_printf("_%04d", frame) +
+                       filename.substr(extension));
+}
+
+/* Load the scene of a frame and upload its device data, including the BVH, so that the session
+ * can start rendering right away once the previous frame is done. */
+static Session *session_prepare(const int frame)
+{
+  Session *session = session_create(options.filepaths[frame],
+                                    session_frame_output_filepath(frame));
+
+  thread_scoped_lock scene_lock(session->scene->mutex);
+  session->scene->update(session->progress);
+
+  return session;
+}
+
+/* Render all scene files in background mode. While a frame renders, the next frame is prepared
+ * on the main thread. The next frame is only prepared ahead when two frames are expected to fit
+ * in the pipeline memory budget, estimated from the peak memory usage of the previous frame. */
+static void session_render_sequence()
+{
+  const int num_frames = options.filepaths.size();
+  const size_t memory_budget = size_t(options.pipeline_memory) * 1024 * 1024;
+  size_t frame_mem_peak = 0;
+
+  Session *next_session = nullptr;
+
+  for (int frame = 0; frame < num_frames; frame++) {
+    Session *session = (next_session) ? next_session : session_prepare(frame);
+    next_session = nullptr;
+
+    session_start(session);
+
+    const bool use_pipeline = !options.no_pipeline && frame + 1 < num_frames &&
+                              (memory_budget == 0 ||
+                               (frame_mem_peak != 0 && frame_mem_peak * 2 <= memory_budget));
+    if (use_pipeline) {
+      VLOG_WORK << "Preparing " << options.filepaths[frame + 1] << " while rendering "
+                << options.filepaths[frame];
+      next_session = session_prepare(frame + 1);
+    }
+
+    session->wait();
+    frame_mem_peak = max(frame_mem_peak, session->stats.mem_peak);
+    session_exit();
+  }
+}
+
 #ifdef WITH_CYCLES_STANDALONE_GUI
 static void display_info(Progress &progress)
 {
@@ -347,6 +436,10 @@ static void keyboard(unsigned char key)
 
 static int files_parse(int argc, const char *argv[])
 {
+  for (int i = 0; i < argc; i++) {
+    options.filepaths.push_back(argv[i]);
+  }
+
   if (argc > 0)
     options.filepath = argv[0];
 
@@ -360,6 +453,9 @@ static void options_parse(int argc, const char **argv)
   options.filepath = "";
   options.session = NULL;
   options.quiet = false;
+  options.output_pass = "combined";
+  options.no_pipeline = false;
+  options.pipeline_memory = 0;
   options.session_params.use_auto_tile = false;
   options.session_params.tile_size = 0;
 
@@ -385,7 +481,7 @@ static void options_parse(int argc, const char **argv)
   bool help = false, profile = false, debug = false, version = false;
   int verbosity = 1;
 
-  ap.options("Usage: cycles [options] file.xml",
+  ap.options("Usage: cycles [options] file.xml [file.xml ...]",
              "%*",
              files_parse,
              "",
@@ -408,7 +504,7 @@ static void options_parse(int argc, const char **argv)
              "Number of samples to render",
              "--output %s",
              &options.output_filepath,
-             "File path to write output image",
+             "File path to write output image, '#' is replaced by the frame number",
              "--threads %d",
              &options.session_params.threads,
              "CPU Rendering Threads",
@@ -421,6 +517,12 @@ static void options_parse(int argc, const char **argv)
              "--tile-size %d",
              &options.session_params.tile_size,
              "Tile size in pixels",
+             "--no-pipeline",
+             &options.no_pipeline,
+             "Don't prepare the next file of a sequence while rendering",
+             "--pipeline-memory %d",
+             &options.pipeline_memory,
+             "Memory budget in MB for preparing the next file while rendering (0 for no limit)",
              "--list-devices",
              &list,
              "List information about all available devices",
@@ -522,6 +624,10 @@ static void options_parse(int argc, const char **argv)
     fprintf(stderr, "Invalid number of samples: %d\n", options.session_params.samples);
     exit(EXIT_FAILURE);
   }
+  else if (options.pipeline_memory < 0) {
+    fprintf(stderr, "Invalid pipeline memory budget: %d\n", options.pipeline_memory);
+    exit(EXIT_FAILURE);
+  }
   else if (options.filepath == "") {
     fprintf(stderr, "No file path specified\n");
     exit(EXIT_FAILURE);
@@ -541,9 +647,7 @@ int main(int argc, const char **argv)
 #ifdef WITH_CYCLES_STANDALONE_GUI
   if (options.session_params.background) {
 #endif
-    session_init();
-    options.session->wait();
-    session_exit();
+    session_render_sequence();
 #ifdef WITH_CYCLES_STANDALONE_GUI
   }
   else {
@@ -807,9 +807,8 @@ class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Pa
 
         if use_cpu(context):
             col.prop(cscene, "debug_use_spatial_splits")
-            if use_embree:
-                col.prop(cscene, "debug_use_compact_bvh")
-            else:
+            col.prop(cscene, "debug_use_compact_bvh")
+            if not use_embree:
                 sub = col.column()
                 sub.active = not cscene.debug_use_spatial_splits
                 sub.prop(cscene, "debug_bvh_time_steps")
@@ -827,8 +826,13 @@ class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Pa
 
             col.prop(cscene, "debug_use_hair_bvh")
 
-            # CPU is used in addition to a GPU
-            if use_multi_device(context) and use_embree:
+            # Only BVH2 and Embree builds are compact, hardware ray tracing uses its own structure.
+            # CPU is used in addition to a GPU when using multiple devices.
+            prefs = context.preferences.addons[__package__].preferences
+            use_hardware_raytracing = (use_optix(context) or
+                                       (use_hip(context) and prefs.use_hiprt) or
+                                       (use_metal(context) and prefs.use_metalrt))
+            if not use_hardware_raytracing or (use_multi_device(context) and use_embree):
                 col.prop(cscene, "debug_use_compact_bvh")
 
 
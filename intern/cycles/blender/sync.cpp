@@ -806,6 +806,7 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene,
 
   params.use_bvh_spatial_split = RNA_boolean_get(&cscene, "debug_use_spatial_splits");
   params.use_bvh_compact_structure = RNA_boolean_get(&cscene, "debug_use_compact_bvh");
+  params.use_bvh2_compact_structure = params.use_bvh_compact_structure;
   params.use_bvh_unaligned_nodes = RNA_boolean_get(&cscene, "debug_use_hair_bvh");
   params.num_bvh_time_steps = RNA_int_get(&cscene, "debug_bvh_time_steps");
 
@@ -17,7 +17,9 @@
 #include "bvh/unaligned.h"
 
 #include "util/foreach.h"
+#include "util/log.h"
 #include "util/progress.h"
+#include "util/string.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -33,6 +35,15 @@ BVH2::BVH2(const BVHParams &params_,
            const vector<Object *> &objects_)
     : BVH(params_, geometry_, objects_)
 {
+  if (params.use_bvh2_compact_structure) {
+    /* Trade render speed for memory: unaligned nodes take almost twice the space of aligned
+     * ones, and larger leaves need fewer nodes. Spatial splits are left to their own option. */
+    params.use_unaligned_nodes = false;
+    params.max_triangle_leaf_size *= 2;
+    params.max_motion_triangle_leaf_size *= 2;
+    params.max_point_leaf_size *= 2;
+    params.max_motion_point_leaf_size *= 2;
+  }
 }
 
 void BVH2::build(Progress &progress, Stats *)
@@ -85,6 +96,18 @@ void BVH2::build(Progress &progress, Stats *)
 
   /* free build nodes */
   root->deleteSubtree();
+
+  const size_t prims_size = pack.prim_type.size() * sizeof(int) +
+                           pack.prim_visibility.size() * sizeof(uint) +
+                           pack.prim_index.size() * sizeof(int) +
+                           pack.prim_object.size() * sizeof(int) +
+                           pack.prim_time.size() * sizeof(float2);
+  VLOG_WORK << "BVH2 memory usage" << (params.use_bvh2_compact_structure ? " (compact)" : "")
+            << ":\n"
+            << "  Nodes: " << string_human_readable_size(pack.nodes.size() * sizeof(int4)) << "\n"
+            << "  Leaf nodes: "
+            << string_human_readable_size(pack.leaf_nodes.size() * sizeof(int4)) << "\n"
+            << "  Primitives: " << string_human_readable_size(prims_size) << "\n";
 }
 
 void BVH2::refit(Progress &progress)
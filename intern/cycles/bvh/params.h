@@ -87,9 +87,14 @@ class BVHParams {
    */
   bool use_unaligned_nodes;
 
-  /* Use compact acceleration structure (Embree)*/
+  /* Use compact acceleration structure, using less memory at the cost of render speed.
+   * Only used for Embree. */
   bool use_compact_structure;
 
+  /* Build shallower BVH2 trees without unaligned nodes, using less memory at the cost of render
+   * speed. Only used for BVH2. */
+  bool use_bvh2_compact_structure;
+
   /* Split time range to this number of steps and create leaf node for each
    * of this time steps.
    *
@@ -133,6 +138,7 @@ class BVHParams {
     top_level = false;
     bvh_layout = BVH_LAYOUT_BVH2;
     use_compact_structure = false;
+    use_bvh2_compact_structure = false;
     use_unaligned_nodes = false;
 
     num_motion_curve_steps = 0;
@@ -22,6 +22,12 @@
 
 CCL_NAMESPACE_BEGIN
 
+/* Size in pixels of the square tiles rendered by a single task. All pixels of a tile are traced
+ * for one sample before moving on to the next sample, so the paths traced one after another by a
+ * thread start from neighboring camera rays. They tend to traverse the same BVH nodes and hit the
+ * same shaders, which are then still in the cache. */
+static constexpr int CPU_RENDER_TILE_SIZE = 8;
+
 /* Create TBB arena for execution of path tracing and rendering tasks. */
 static inline tbb::task_arena local_tbb_arena_create(const Device *device)
 {
@@ -65,7 +71,6 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
 {
   const int64_t image_width = effective_buffer_params_.width;
   const int64_t image_height = effective_buffer_params_.height;
-  const int64_t total_pixels_num = image_width * image_height;
 
   if (device_->profiler.active()) {
     for (CPUKernelThreadGlobals &kernel_globals : kernel_thread_globals_) {
@@ -73,21 +78,26 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
     }
   }
 
+  const int64_t tiles_x = divide_up(image_width, CPU_RENDER_TILE_SIZE);
+  const int64_t tiles_y = divide_up(image_height, CPU_RENDER_TILE_SIZE);
+
   tbb::task_arena local_arena = local_tbb_arena_create(device_);
   local_arena.execute([&]() {
-    parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
+    parallel_for(int64_t(0), tiles_x * tiles_y, [&](int64_t work_index) {
       if (is_cancel_requested()) {
         return;
       }
 
-      const int y = work_index / image_width;
-      const int x = work_index - y * image_width;
+      const int tile_y = work_index / tiles_x;
+      const int tile_x = work_index - tile_y * tiles_x;
+      const int x = tile_x * CPU_RENDER_TILE_SIZE;
+      const int y = tile_y * CPU_RENDER_TILE_SIZE;
 
       KernelWorkTile work_tile;
       work_tile.x = effective_buffer_params_.full_x + x;
       work_tile.y = effective_buffer_params_.full_y + y;
-      work_tile.w = 1;
-      work_tile.h = 1;
+      work_tile.w = min(CPU_RENDER_TILE_SIZE, int(image_width) - x);
+      work_tile.h = min(CPU_RENDER_TILE_SIZE, int(image_height) - y);
       work_tile.start_sample = start_sample;
       work_tile.sample_offset = sample_offset;
       work_tile.num_samples = 1;
@@ -124,41 +134,67 @@ void PathTraceWorkCPU::render_samples_full_pipeline(KernelGlobalsCPU *kernel_glo
     path_state_init_queues(shadow_catcher_state);
   }
 
-  KernelWorkTile sample_work_tile = work_tile;
   float *render_buffer = buffers_->buffer.data();
 
+  /* Pixels which are not sampled anymore, because they converged or the bake has no data. */
+  bool pixel_done[CPU_RENDER_TILE_SIZE * CPU_RENDER_TILE_SIZE] = {false};
+
   for (int sample = 0; sample < samples_num; ++sample) {
     if (is_cancel_requested()) {
       break;
     }
 
-    if (has_bake) {
-      if (!kernels_.integrator_init_from_bake(
-              kernel_globals, state, &sample_work_tile, render_buffer)) {
-        break;
-      }
-    }
-    else {
-      if (!kernels_.integrator_init_from_camera(
-              kernel_globals, state, &sample_work_tile, render_buffer)) {
-        break;
-      }
-    }
+    bool has_active_pixels = false;
 
-    kernels_.integrator_megakernel(kernel_globals, state, render_buffer);
+    for (int y = 0; y < work_tile.h; ++y) {
+      for (int x = 0; x < work_tile.w; ++x) {
+        bool &done = pixel_done[y * CPU_RENDER_TILE_SIZE + x];
+        if (done) {
+          continue;
+        }
+
+        KernelWorkTile sample_work_tile = work_tile;
+        sample_work_tile.x = work_tile.x + x;
+        sample_work_tile.y = work_tile.y + y;
+        sample_work_tile.w = 1;
+        sample_work_tile.h = 1;
+        sample_work_tile.start_sample = work_tile.start_sample + sample;
+
+        if (has_bake) {
+          if (!kernels_.integrator_init_from_bake(
+                  kernel_globals, state, &sample_work_tile, render_buffer)) {
+            done = true;
+            continue;
+          }
+        }
+        else {
+          if (!kernels_.integrator_init_from_camera(
+                  kernel_globals, state, &sample_work_tile, render_buffer)) {
+            done = true;
+            continue;
+          }
+        }
+
+        kernels_.integrator_megakernel(kernel_globals, state, render_buffer);
 
 #ifdef WITH_PATH_GUIDING
-    if (kernel_globals->data.integrator.train_guiding) {
-      /* Push the generated sample data to the global sample data storage. */
-      guiding_push_sample_data_to_global_storage(kernel_globals, state, render_buffer);
-    }
+        if (kernel_globals->data.integrator.train_guiding) {
+          /* Push the generated sample data to the global sample data storage. */
+          guiding_push_sample_data_to_global_storage(kernel_globals, state, render_buffer);
+        }
 #endif
 
-    if (shadow_catcher_state) {
-      kernels_.integrator_megakernel(kernel_globals, shadow_catcher_state, render_buffer);
+        if (shadow_catcher_state) {
+          kernels_.integrator_megakernel(kernel_globals, shadow_catcher_state, render_buffer);
+        }
+
+        has_active_pixels = true;
+      }
     }
 
-    ++sample_work_tile.start_sample;
+    if (!has_active_pixels) {
+      break;
+    }
   }
 }
 
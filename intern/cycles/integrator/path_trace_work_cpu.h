@@ -69,7 +69,8 @@ class PathTraceWorkCPU : public PathTraceWork {
 #endif
 
  protected:
-  /* Core path tracing routine. Renders given work time on the given queue. */
+  /* Core path tracing routine. Renders all samples of the pixels in the given work tile, one
+   * sample at a time for all pixels of the tile. */
   void render_samples_full_pipeline(KernelGlobalsCPU *kernel_globals,
                                     const KernelWorkTile &work_tile,
                                     const int samples_num);
@@ -243,6 +243,7 @@ ImageMetaData::ImageMetaData()
       colorspace(u_colorspace_raw),
       colorspace_file_format(""),
       use_transform_3d(false),
+      mip_level(0),
       compress_as_srgb(false)
 {
 }
@@ -250,7 +251,8 @@ ImageMetaData::ImageMetaData()
 bool ImageMetaData::operator==(const ImageMetaData &other) const
 {
   return channels == other.channels && width == other.width && height == other.height &&
-         depth == other.depth && use_transform_3d == other.use_transform_3d &&
+         depth == other.depth && mip_level == other.mip_level &&
+         use_transform_3d == other.use_transform_3d &&
          (!use_transform_3d || transform_3d == other.transform_3d) && type == other.type &&
          colorspace == other.colorspace && compress_as_srgb == other.compress_as_srgb;
 }
@@ -301,6 +303,11 @@ int ImageLoader::get_tile_number() const
   return 0;
 }
 
+bool ImageLoader::load_mip_level_metadata(const int /*max_size*/, ImageMetaData & /*metadata*/)
+{
+  return false;
+}
+
 bool ImageLoader::equals(const ImageLoader *a, const ImageLoader *b)
 {
   if (a == NULL && b == NULL) {
@@ -535,11 +542,22 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
     return false;
   }
 
-  /* Get metadata. */
-  int width = img->metadata.width;
-  int height = img->metadata.height;
-  int depth = img->metadata.depth;
-  int components = img->metadata.channels;
+  /* Get metadata. When the image has to be scaled down, prefer loading a smaller MIP level
+   * stored in the file, which takes much less time and memory than loading the full resolution. */
+  ImageMetaData metadata = img->metadata;
+  if (texture_limit > 0 &&
+      max(max(metadata.width, metadata.height), metadata.depth) > size_t(texture_limit))
+  {
+    if (img->loader->load_mip_level_metadata(texture_limit, metadata)) {
+      VLOG_WORK << "Loading MIP level " << metadata.mip_level << " of image "
+                << img->loader->name() << ".";
+    }
+  }
+
+  int width = metadata.width;
+  int height = metadata.height;
+  int depth = metadata.depth;
+  int components = metadata.channels;
 
   /* Read pixels. */
   vector<StorageType> pixels_storage;
@@ -566,8 +584,7 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
   }
 
   const size_t num_pixels = ((size_t)width) * height * depth;
-  img->loader->load_pixels(
-      img->metadata, pixels, num_pixels * components, image_associate_alpha(img));
+  img->loader->load_pixels(metadata, pixels, num_pixels * components, image_associate_alpha(img));
 
   /* The kernel can handle 1 and 4 channel images. Anything that is not a single
    * channel image is converted to RGBA format. */
@@ -77,6 +77,10 @@ class ImageMetaData {
   bool use_transform_3d;
   Transform transform_3d;
 
+  /* Optional MIP level stored in the file to load, see ImageLoader.load_mip_level_metadata().
+   * The dimensions above are those of this level. */
+  int mip_level;
+
   /* Automatically set. */
   bool compress_as_srgb;
 
@@ -117,6 +121,10 @@ class ImageLoader {
   /* Optional for tiled textures loaded externally. */
   virtual int get_tile_number() const;
 
+  /* Optional for images storing MIP levels. Select the largest level with no dimension larger
+   * than max_size, and update the metadata for loading it. Returns false if there is none. */
+  virtual bool load_mip_level_metadata(const int max_size, ImageMetaData &metadata);
+
   /* Free any memory used for loading metadata and pixels. */
   virtual void cleanup(){};
 
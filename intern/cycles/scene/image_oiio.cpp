@@ -111,7 +111,7 @@ static void oiio_load_pixels(const ImageMetaData &metadata,
   if (depth <= 1) {
     size_t scanlinesize = width * components * sizeof(StorageType);
     in->read_image(0,
-                   0,
+                   metadata.mip_level,
                    0,
                    components,
                    FileFormat,
@@ -121,7 +121,7 @@ static void oiio_load_pixels(const ImageMetaData &metadata,
                    AutoStride);
   }
   else {
-    in->read_image(0, 0, 0, components, FileFormat, (uchar *)readpixels);
+    in->read_image(0, metadata.mip_level, 0, components, FileFormat, (uchar *)readpixels);
   }
 
   if (components > 4) {
@@ -246,6 +246,38 @@ bool OIIOImageLoader::load_pixels(const ImageMetaData &metadata,
   return true;
 }
 
+bool OIIOImageLoader::load_mip_level_metadata(const int max_size, ImageMetaData &metadata)
+{
+  unique_ptr<ImageInput> in(ImageInput::create(filepath.string()));
+  if (!in) {
+    return false;
+  }
+
+  ImageSpec spec;
+  if (!in->open(filepath.string(), spec)) {
+    return false;
+  }
+
+  /* Levels are ordered from the largest to the smallest, level 0 being the full resolution. */
+  bool found = false;
+  for (int level = 1; in->seek_subimage(0, level); level++) {
+    const ImageSpec &level_spec = in->spec();
+    if (level_spec.width <= max_size && level_spec.height <= max_size &&
+        level_spec.depth <= max_size)
+    {
+      metadata.width = level_spec.width;
+      metadata.height = level_spec.height;
+      metadata.depth = level_spec.depth;
+      metadata.mip_level = level;
+      found = true;
+      break;
+    }
+  }
+
+  in->close();
+  return found;
+}
+
 string OIIOImageLoader::name() const
 {
   return path_filename(filepath.string());
@@ -25,6 +25,8 @@ class OIIOImageLoader : public ImageLoader {
 
   ustring osl_filepath() const override;
 
+  bool load_mip_level_metadata(const int max_size, ImageMetaData &metadata) override;
+
   bool equals(const ImageLoader &other) const override;
 
  protected:
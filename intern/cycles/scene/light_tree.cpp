@@ -7,6 +7,7 @@
 #include "scene/object.h"
 
 #include "util/progress.h"
+#include "util/tbb.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -512,14 +513,69 @@ bool LightTree::should_split(LightTreeEmitter *emitters,
 
   middle = (start + end) / 2;
 
+  /* Large ranges near the root are split into fixed size blocks which are processed in parallel.
+   * The per-block results are combined in order, so the result does not depend on scheduling. */
+  const int num_blocks = divide_up(num_emitters, MIN_EMITTERS_PER_THREAD);
+  auto for_each_block = [&](auto &&fn) {
+    if (num_blocks == 1) {
+      fn(0, start, end);
+      return;
+    }
+    parallel_for(blocked_range<int>(0, num_blocks), [&](const blocked_range<int> &range) {
+      for (int block = range.begin(); block != range.end(); block++) {
+        const int block_start = start + block * MIN_EMITTERS_PER_THREAD;
+        fn(block, block_start, min(block_start + MIN_EMITTERS_PER_THREAD, end));
+      }
+    });
+  };
+
+  /* Results of the first block are accumulated in place, avoiding allocations for small nodes. */
   BoundBox centroid_bbox = BoundBox::empty;
-  for (int i = start; i < end; i++) {
-    centroid_bbox.grow((emitters + i)->centroid);
+  vector<BoundBox> block_centroid_bbox(num_blocks - 1, BoundBox::empty);
+  for_each_block([&](const int block, const int block_start, const int block_end) {
+    BoundBox &bbox = (block == 0) ? centroid_bbox : block_centroid_bbox[block - 1];
+    for (int i = block_start; i < block_end; i++) {
+      bbox.grow((emitters + i)->centroid);
+    }
+  });
+  for (const BoundBox &bbox : block_centroid_bbox) {
+    centroid_bbox.grow(bbox);
   }
 
   const float3 extent = centroid_bbox.size();
   const float max_extent = max4(extent.x, extent.y, extent.z, 0.0f);
 
+  /* Fill in buckets with emitters for all dimensions at once, where the centroid box is split into
+   * equal partitions along each dimension. If the centroid bounding box is 0 along a given
+   * dimension, its buckets are not needed. */
+  using DimensionBuckets = std::array<LightTreeBucket, LightTreeBucket::num_buckets>;
+  std::array<DimensionBuckets, 3> dim_buckets;
+  vector<std::array<DimensionBuckets, 3>> block_dim_buckets(num_blocks - 1);
+  for_each_block([&](const int block, const int block_start, const int block_end) {
+    std::array<DimensionBuckets, 3> &buckets = (block == 0) ? dim_buckets :
+                                                              block_dim_buckets[block - 1];
+    for (int dim = 0; dim < 3; dim++) {
+      if (extent[dim] == 0.0f && dim != 0) {
+        continue;
+      }
+      const float inv_extent = 1 / extent[dim];
+      for (int i = block_start; i < block_end; i++) {
+        const LightTreeEmitter *emitter = emitters + i;
+        int bucket_idx = LightTreeBucket::num_buckets *
+                         (emitter->centroid[dim] - centroid_bbox.min[dim]) * inv_extent;
+        bucket_idx = clamp(bucket_idx, 0, LightTreeBucket::num_buckets - 1);
+        buckets[dim][bucket_idx].add(*emitter);
+      }
+    }
+  });
+  for (const std::array<DimensionBuckets, 3> &buckets : block_dim_buckets) {
+    for (int dim = 0; dim < 3; dim++) {
+      for (int i = 0; i < LightTreeBucket::num_buckets; i++) {
+        dim_buckets[dim][i] = dim_buckets[dim][i] + buckets[dim][i];
+      }
+    }
+  }
+
   /* Check each dimension to find the minimum splitting cost. */
   float total_cost = 0.0f;
   float min_cost = FLT_MAX;
@@ -531,20 +587,7 @@ bool LightTree::should_split(LightTreeEmitter *emitters,
     }
 
     const float inv_extent = 1 / (centroid_bbox.size()[dim]);
-
-    /* Fill in buckets with emitters. */
-    std::array<LightTreeBucket, LightTreeBucket::num_buckets> buckets;
-    for (int i = start; i < end; i++) {
-      const LightTreeEmitter *emitter = emitters + i;
-
-      /* Place emitter into the appropriate bucket, where the centroid box is split into equal
-       * partitions. */
-      int bucket_idx = LightTreeBucket::num_buckets *
-                       (emitter->centroid[dim] - centroid_bbox.min[dim]) * inv_extent;
-      bucket_idx = clamp(bucket_idx, 0, LightTreeBucket::num_buckets - 1);
-
-      buckets[bucket_idx].add(*emitter);
-    }
+    const DimensionBuckets &buckets = dim_buckets[dim];
 
     /* Precompute the left bucket measure cumulatively. */
     std::array<LightTreeBucket, LightTreeBucket::num_buckets - 1> left_buckets;
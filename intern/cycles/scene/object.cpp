@@ -632,6 +632,27 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
   }
 }
 
+void ObjectManager::device_update_object_transform_unchanged(UpdateObjectTransformState *state,
+                                                             const Object *ob)
+{
+  /* The packed data of the object is still valid from the previous update, only gather the
+   * scene-wide flags that device_update_object_transform() would set. */
+  const Geometry *geom = ob->geometry;
+
+  if (geom->get_use_motion_blur() || (state->object_flag[ob->index] & SD_OBJECT_MOTION)) {
+    state->have_motion = true;
+  }
+  if (geom->geometry_type == Geometry::HAIR) {
+    state->have_curves = true;
+  }
+  if (geom->geometry_type == Geometry::POINTCLOUD) {
+    state->have_points = true;
+  }
+  if (geom->geometry_type == Geometry::VOLUME) {
+    state->have_volumes = true;
+  }
+}
+
 void ObjectManager::device_update_prim_offsets(Device *device, DeviceScene *dscene, Scene *scene)
 {
   if (!scene->integrator->get_use_light_tree()) {
@@ -676,6 +697,14 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
   state.scene = scene;
   state.queue_start_object = 0;
 
+  /* As all the arrays are the same size, checking only dscene.objects is sufficient. Other than
+   * per-object changes, any update of the object manager affects all objects. The static BVH
+   * modifies the packed data of the objects when applying their transforms. */
+  bool update_all = dscene->objects.need_realloc() ||
+                    (update_flags & ~(OBJECT_MODIFIED | TRANSFORM_MODIFIED | VISIBILITY_MODIFIED |
+                                      HOLDOUT_MODIFIED | GEOMETRY_MANAGER)) ||
+                    scene->params.bvh_type != BVH_TYPE_DYNAMIC;
+
   state.objects = dscene->objects.alloc(scene->objects.size());
   state.object_flag = dscene->object_flag.alloc(scene->objects.size());
   state.object_volume_step = dscene->object_volume_step.alloc(scene->objects.size());
@@ -683,6 +712,9 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
   state.object_motion_pass = NULL;
 
   if (state.need_motion == Scene::MOTION_PASS) {
+    if (dscene->object_motion_pass.size() != OBJECT_MOTION_PASS_SIZE * scene->objects.size()) {
+      update_all = true;
+    }
     state.object_motion_pass = dscene->object_motion_pass.alloc(OBJECT_MOTION_PASS_SIZE *
                                                                 scene->objects.size());
   }
@@ -695,11 +727,19 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
       *motion_offsets = motion_offset;
       motion_offsets++;
 
+      /* Changing the number of motion steps of one object moves the motion of others. */
+      if (ob->motion_is_modified()) {
+        update_all = true;
+      }
+
       /* Clear motion array if there is no actual motion. */
       ob->update_motion();
       motion_offset += ob->motion.size();
     }
 
+    if (dscene->object_motion.size() != motion_offset) {
+      update_all = true;
+    }
     state.object_motion = dscene->object_motion.alloc(motion_offset);
   }
 
@@ -712,9 +752,6 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
     numparticles += psys->particles.size();
   }
 
-  /* as all the arrays are the same size, checking only dscene.objects is sufficient */
-  const bool update_all = dscene->objects.need_realloc();
-
   /* Parallel object update, with grain size to avoid too much threading overhead
    * for individual objects. */
   static const int OBJECTS_PER_TASK = 32;
@@ -722,7 +759,12 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
                [&](const blocked_range<size_t> &r) {
                  for (size_t i = r.begin(); i != r.end(); i++) {
                    Object *ob = state.scene->objects[i];
-                   device_update_object_transform(&state, ob, update_all, scene);
+                   if (update_all || ob->is_modified() || ob->geometry->is_modified()) {
+                     device_update_object_transform(&state, ob, update_all, scene);
+                   }
+                   else {
+                     device_update_object_transform_unchanged(&state, ob);
+                   }
                  }
                });
 
@@ -877,6 +919,9 @@ void ObjectManager::device_update_flags(
   }
 
   foreach (Object *object, scene->objects) {
+    /* Objects which were not modified keep their flags from the previous update. */
+    object_flag[object->index] &= ~SD_OBJECT_INTERSECTS_VOLUME;
+
     if (object->geometry->has_volume) {
       object_flag[object->index] |= SD_OBJECT_HAS_VOLUME;
       object_flag[object->index] &= ~SD_OBJECT_HAS_VOLUME_ATTRIBUTES;
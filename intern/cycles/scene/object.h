@@ -148,6 +148,7 @@ class ObjectManager {
     HOLDOUT_MODIFIED = (1 << 6),
     TRANSFORM_MODIFIED = (1 << 7),
     VISIBILITY_MODIFIED = (1 << 8),
+    LIGHTGROUP_MODIFIED = (1 << 9),
 
     /* tag everything in the manager for an update */
     UPDATE_ALL = ~0u,
@@ -187,6 +188,8 @@ class ObjectManager {
                                       Object *ob,
                                       bool update_all,
                                       const Scene *scene);
+  void device_update_object_transform_unchanged(UpdateObjectTransformState *state,
+                                                const Object *ob);
   void device_update_object_transform_task(UpdateObjectTransformState *state);
   bool device_update_object_transform_pop_work(UpdateObjectTransformState *state,
                                                int *start_index,
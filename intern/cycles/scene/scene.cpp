@@ -204,7 +204,7 @@ void Scene::device_update(Device *device_, Progress &progress)
 
   if (film->update_lightgroups(this)) {
     light_manager->tag_update(this, ccl::LightManager::LIGHT_MODIFIED);
-    object_manager->tag_update(this, ccl::ObjectManager::OBJECT_MODIFIED);
+    object_manager->tag_update(this, ccl::ObjectManager::LIGHTGROUP_MODIFIED);
   }
   if (film->exposure_is_modified()) {
     integrator->tag_modified();
@@ -258,36 +258,43 @@ template<typename Mesh> class Mikktspace {
 
   void generateInitialVerticesIndexList()
   {
+    /* Count the triangles and tangent spaces of every face first, so that the triangles can be
+     * initialized in parallel afterwards. */
+    std::vector<uint> triOffsets(nrFaces), tSpaceOffsets(nrFaces);
+    runParallel(0u, nrFaces, [&](uint f) {
+      const uint verts = mesh.GetNumVerticesOfFace(f);
+      const bool isValid = (verts == 3 || verts == 4);
+      triOffsets[f] = isValid ? (verts - 2) : 0;
+      tSpaceOffsets[f] = isValid ? verts : 0;
+    });
+
     nrTriangles = 0;
+    nrTSpaces = 0;
     for (uint f = 0; f < nrFaces; f++) {
-      const uint verts = mesh.GetNumVerticesOfFace(f);
-      if (verts == 3) {
-        nrTriangles += 1;
-      }
-      else if (verts == 4) {
-        nrTriangles += 2;
-      }
+      const uint faceTriangles = triOffsets[f], faceTSpaces = tSpaceOffsets[f];
+      triOffsets[f] = nrTriangles;
+      tSpaceOffsets[f] = nrTSpaces;
+      nrTriangles += faceTriangles;
+      nrTSpaces += faceTSpaces;
     }
 
-    triangles.reserve(nrTriangles);
+    triangles.resize(nrTriangles, Triangle(0, 0));
 
-    nrTSpaces = 0;
-    for (uint f = 0; f < nrFaces; f++) {
+    runParallel(0u, nrFaces, [&](uint f) {
       const uint verts = mesh.GetNumVerticesOfFace(f);
       if (verts != 3 && verts != 4)
-        continue;
+        return;
 
-      uint tA = uint(triangles.size());
-      triangles.emplace_back(f, nrTSpaces);
+      const uint tA = triOffsets[f];
       Triangle &triA = triangles[tA];
+      triA = Triangle(f, tSpaceOffsets[f]);
 
       if (verts == 3) {
         triA.setVertices(0, 1, 2);
       }
       else {
-        uint tB = uint(triangles.size());
-        triangles.emplace_back(f, nrTSpaces);
-        Triangle &triB = triangles[tB];
+        Triangle &triB = triangles[tA + 1];
+        triB = Triangle(f, tSpaceOffsets[f]);
 
         // need an order independent way to evaluate
         // tspace on quads. This is done by splitting
@@ -312,9 +319,7 @@ template<typename Mesh> class Mikktspace {
           triB.setVertices(1, 2, 3);
         }
       }
-
-      nrTSpaces += verts;
-    }
+    });
   }
 
   struct VertexHash {
@@ -580,11 +585,6 @@ template<typename Mesh> class Mikktspace {
     };
     std::vector<Entry> entries;
 
-    NeighborShard(size_t capacity)
-    {
-      entries.reserve(capacity);
-    }
-
     void buildNeighbors(Mikktspace<Mesh> *mikk)
     {
       /* Entries are added by iterating over t, so by using a stable sort,
@@ -637,7 +637,6 @@ template<typename Mesh> class Mikktspace {
      * key go into the same shard.
      * This is done by hashing the key to get the shard index of each vertex.
      */
-    // TODO: Two-step filling that first counts and then fills? Could be parallel then.
     uint targetNrShards = isParallel ? uint(4 * nrThreads) : 1;
     uint nrShards = 1, hashShift = 32;
     while (nrShards < targetNrShards) {
@@ -645,12 +644,8 @@ template<typename Mesh> class Mikktspace {
       hashShift -= 1;
     }
 
-    /* Reserve 25% extra to account for variation due to hashing. */
-    size_t reserveSize = size_t(double(3 * nrTriangles) * 1.25 / nrShards);
-    std::vector<NeighborShard> shards(nrShards, {reserveSize});
-
-    for (uint t = 0; t < nrTriangles; t++) {
-      Triangle &triangle = triangles[t];
+    auto forEachEdge = [&](uint t, auto fn) {
+      const Triangle &triangle = triangles[t];
       for (uint i = 0; i < 3; i++) {
         const uint i0 = triangle.vertices[i];
         const uint i1 = triangle.vertices[(i != 2) ? (i + 1) : 0];
@@ -659,10 +654,46 @@ template<typename Mesh> class Mikktspace {
         /* TODO: Reusing the hash here means less hash space inside each shard.
          * Computing a second hash with a different seed it probably not worth it? */
         const uint shard = isParallel ? (hash >> hashShift) : 0;
-        shards[shard].entries.emplace_back(hash, pack_index(t, i));
+        fn(shard, hash, pack_index(t, i));
       }
+    };
+
+    /* The shards are filled in two steps, so that both can run in parallel: first the number of
+     * entries that every chunk of triangles adds to every shard is counted, then every chunk
+     * writes its entries to its own range of each shard. Within a shard, the entries stay
+     * ordered by triangle, just like when they are added serially. */
+    const uint nrChunks = isParallel ? uint(4 * nrThreads) : 1;
+    const uint chunkSize = (nrTriangles + nrChunks - 1) / nrChunks;
+    std::vector<uint> chunkOffsets(size_t(nrChunks) * nrShards, 0);
+    runParallel(0u, nrChunks, [&](uint c) {
+      uint *counts = &chunkOffsets[size_t(c) * nrShards];
+      const uint tEnd = std::min(nrTriangles, (c + 1) * chunkSize);
+      for (uint t = c * chunkSize; t < tEnd; t++) {
+        forEachEdge(t, [&](uint shard, uint /*hash*/, uint /*data*/) { counts[shard]++; });
+      }
+    });
+
+    std::vector<NeighborShard> shards(nrShards);
+    for (uint s = 0; s < nrShards; s++) {
+      uint offset = 0;
+      for (uint c = 0; c < nrChunks; c++) {
+        const uint count = chunkOffsets[size_t(c) * nrShards + s];
+        chunkOffsets[size_t(c) * nrShards + s] = offset;
+        offset += count;
+      }
+      shards[s].entries.resize(offset, {0, 0});
     }
 
+    runParallel(0u, nrChunks, [&](uint c) {
+      uint *offsets = &chunkOffsets[size_t(c) * nrShards];
+      const uint tEnd = std::min(nrTriangles, (c + 1) * chunkSize);
+      for (uint t = c * chunkSize; t < tEnd; t++) {
+        forEachEdge(t, [&](uint shard, uint hash, uint data) {
+          shards[shard].entries[offsets[shard]++] = {hash, data};
+        });
+      }
+    });
+
     runParallel(0u, nrShards, [&](uint s) { shards[s].buildNeighbors(this); });
   }
 
@@ -793,29 +824,36 @@ template<typename Mesh> class Mikktspace {
       }
     }
 
-    /* TODO: Worth parallelizing? Probably not. */
-    for (Group &group : groups) {
-      group.normalizeTSpace();
-    }
+    runParallel(0u, uint(groups.size()), [&](uint g) { groups[g].normalizeTSpace(); });
 
     tSpaces.resize(nrTSpaces);
 
-    for (uint t = 0; t < nrTriangles; t++) {
-      Triangle &triangle = triangles[t];
-      for (uint i = 0; i < 3; i++) {
-        uint groupId = triangle.group[i];
-        if (groupId == UNSET_ENTRY) {
-          continue;
-        }
-        const Group group = groups[groupId];
-        assert(triangle.orientPreserving == group.orientPreserving);
+    /* The two triangles of a quad share tangent spaces, and the result of accumulating groups
+     * depends on their order. So both triangles of a face are handled by the same task, in the
+     * same order as they are stored. */
+    runParallel(0u, nrTriangles, [&](uint t) {
+      if (t > 0 && triangles[t - 1].faceIdx == triangles[t].faceIdx) {
+        return;
+      }
+      for (uint tFace = t; tFace < nrTriangles && triangles[tFace].faceIdx == triangles[t].faceIdx;
+           tFace++)
+      {
+        const Triangle &triangle = triangles[tFace];
+        for (uint i = 0; i < 3; i++) {
+          uint groupId = triangle.group[i];
+          if (groupId == UNSET_ENTRY) {
+            continue;
+          }
+          const Group group = groups[groupId];
+          assert(triangle.orientPreserving == group.orientPreserving);
 
-        // output tspace
-        const uint offset = triangle.tSpaceIdx;
-        const uint faceVertex = triangle.faceVertex[i];
-        tSpaces[offset + faceVertex].accumulateGroup(group);
+          // output tspace
+          const uint offset = triangle.tSpaceIdx;
+          const uint faceVertex = triangle.faceVertex[i];
+          tSpaces[offset + faceVertex].accumulateGroup(group);
+        }
       }
-    }
+    });
   }
 };
 
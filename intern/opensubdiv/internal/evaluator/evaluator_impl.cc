@@ -410,6 +410,26 @@ bool EvalOutputAPI::hasVertexData() const
   return implementation_->hasVertexData();
 }
 
+StencilTableFactory::Options getVertexStencilTableOptions(const bool is_adaptive)
+{
+  StencilTableFactory::Options options;
+  options.generateOffsets = true;
+  options.generateIntermediateLevels = is_adaptive;
+  return options;
+}
+
+PatchTableFactory::Options getLimitPatchTableOptions(const int level,
+                                                     const bool use_inf_sharp_patch,
+                                                     const bool has_face_varying_data)
+{
+  PatchTableFactory::Options options(level);
+  options.SetEndCapType(PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+  options.useInfSharpPatch = use_inf_sharp_patch;
+  options.generateFVarTables = has_face_varying_data;
+  options.generateFVarLegacyLinearPatches = false;
+  return options;
+}
+
 }  // namespace opensubdiv
 }  // namespace blender
 
@@ -462,11 +482,8 @@ OpenSubdiv_EvaluatorImpl *openSubdiv_createEvaluatorInternal(
   // after they have been re-posed (both for vertex & varying interpolation).
   //
   // Vertex stencils.
-  StencilTableFactory::Options vertex_stencil_options;
-  vertex_stencil_options.generateOffsets = stencil_generate_offsets;
-  vertex_stencil_options.generateIntermediateLevels = stencil_generate_intermediate_levels;
-  const StencilTable *vertex_stencils = StencilTableFactory::Create(*refiner,
-                                                                    vertex_stencil_options);
+  const StencilTable *vertex_stencils = StencilTableFactory::Create(
+      *refiner, blender::opensubdiv::getVertexStencilTableOptions(is_adaptive));
   // Varying stencils.
   //
   // TODO(sergey): Seems currently varying stencils are always required in
@@ -494,12 +511,10 @@ OpenSubdiv_EvaluatorImpl *openSubdiv_createEvaluatorInternal(
         StencilTableFactory::Create(*refiner, face_varying_stencil_options));
   }
   // Generate bi-cubic patch table for the limit surface.
-  PatchTableFactory::Options patch_options(level);
-  patch_options.SetEndCapType(PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
-  patch_options.useInfSharpPatch = use_inf_sharp_patch;
-  patch_options.generateFVarTables = has_face_varying_data;
-  patch_options.generateFVarLegacyLinearPatches = false;
-  const PatchTable *patch_table = PatchTableFactory::Create(*refiner, patch_options);
+  const PatchTable *patch_table = PatchTableFactory::Create(
+      *refiner,
+      blender::opensubdiv::getLimitPatchTableOptions(
+          level, use_inf_sharp_patch, has_face_varying_data));
   // Append local points stencils.
   // Point stencils.
   const StencilTable *local_point_stencil_table = patch_table->GetLocalPointStencilTable();
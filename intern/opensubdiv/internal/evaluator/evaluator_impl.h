@@ -13,6 +13,8 @@
 
 #include <opensubdiv/far/patchMap.h>
 #include <opensubdiv/far/patchTable.h>
+#include <opensubdiv/far/patchTableFactory.h>
+#include <opensubdiv/far/stencilTableFactory.h>
 
 #include "internal/base/memory.h"
 
@@ -183,6 +185,16 @@ class EvalOutputAPI {
   EvalOutput *implementation_;
 };
 
+// Options of the stencils which compute the refined and local points from the coarse vertices.
+OpenSubdiv::Far::StencilTableFactory::Options getVertexStencilTableOptions(bool is_adaptive);
+
+// Options of the patch table which is used to evaluate the limit surface. They are shared by the
+// evaluator and the limit stencils, so that both use the same end caps and the same isolation of
+// infinitely sharp features.
+OpenSubdiv::Far::PatchTableFactory::Options getLimitPatchTableOptions(int level,
+                                                                      bool use_inf_sharp_patch,
+                                                                      bool has_face_varying_data);
+
 }  // namespace opensubdiv
 }  // namespace blender
 
@@ -0,0 +1,126 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "opensubdiv_evaluator_capi.h"
+
+#include <algorithm>
+
+#include <opensubdiv/far/patchTable.h>
+#include <opensubdiv/far/patchTableFactory.h>
+#include <opensubdiv/far/stencilTable.h>
+#include <opensubdiv/far/stencilTableFactory.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "internal/base/type.h"
+#include "internal/evaluator/evaluator_impl.h"
+#include "internal/topology/topology_refiner_impl.h"
+#include "opensubdiv_capi_type.h"
+#include "opensubdiv_topology_refiner_capi.h"
+
+using OpenSubdiv::Far::LimitStencilTable;
+using OpenSubdiv::Far::LimitStencilTableFactory;
+using OpenSubdiv::Far::PatchTable;
+using OpenSubdiv::Far::PatchTableFactory;
+using OpenSubdiv::Far::StencilTable;
+using OpenSubdiv::Far::StencilTableFactory;
+using OpenSubdiv::Far::TopologyRefiner;
+
+template<typename T> static T *copy_to_new_array(const blender::opensubdiv::vector<T> &values)
+{
+  T *result = static_cast<T *>(MEM_malloc_arrayN(values.size(), sizeof(T), __func__));
+  std::copy(values.begin(), values.end(), result);
+  return result;
+}
+
+OpenSubdiv_LimitStencils *openSubdiv_createLimitStencils(
+    OpenSubdiv_TopologyRefiner *topology_refiner,
+    const OpenSubdiv_PatchCoord *patch_coords,
+    const int num_patch_coords)
+{
+  using blender::opensubdiv::vector;
+  const TopologyRefiner *refiner = topology_refiner->impl->topology_refiner;
+  if (refiner == nullptr) {
+    // Happens on bad topology.
+    return nullptr;
+  }
+  // Uniform refinement does not evaluate the limit surface.
+  if (!topology_refiner->getIsAdaptive(topology_refiner) || refiner->IsUniform()) {
+    return nullptr;
+  }
+
+  // Group consecutive coordinates on the same ptex face into a single location array, the
+  // stencils are created in the order of the location arrays.
+  vector<float> s(num_patch_coords), t(num_patch_coords);
+  LimitStencilTableFactory::LocationArrayVec locations;
+  for (int i = 0; i < num_patch_coords; i++) {
+    const OpenSubdiv_PatchCoord &patch_coord = patch_coords[i];
+    s[i] = patch_coord.u;
+    t[i] = patch_coord.v;
+    if (locations.empty() || locations.back().ptexIdx != patch_coord.ptex_face) {
+      LimitStencilTableFactory::LocationArray location;
+      location.ptexIdx = patch_coord.ptex_face;
+      location.numLocations = 0;
+      location.s = &s[i];
+      location.t = &t[i];
+      locations.push_back(location);
+    }
+    locations.back().numLocations++;
+  }
+
+  // Create the patch table and the stencils of its control points with the same options as the
+  // evaluator. Otherwise the factory uses its own defaults, which do not necessarily match the end
+  // caps and sharp patches the evaluator uses for the limit surface.
+  const int level = topology_refiner->getSubdivisionLevel(topology_refiner);
+  const PatchTable *patch_table = PatchTableFactory::Create(
+      *refiner,
+      blender::opensubdiv::getLimitPatchTableOptions(
+          level, refiner->GetAdaptiveOptions().useInfSharpPatch, false));
+  // Unlike the evaluator, which stores the coarse vertices separately, the stencils index all
+  // vertices of the refiner, including the coarse ones.
+  StencilTableFactory::Options cv_stencil_options =
+      blender::opensubdiv::getVertexStencilTableOptions(true);
+  cv_stencil_options.generateControlVerts = true;
+  const StencilTable *cv_stencils = StencilTableFactory::Create(*refiner, cv_stencil_options);
+  if (const StencilTable *local_point_stencils = patch_table->GetLocalPointStencilTable()) {
+    const StencilTable *table = StencilTableFactory::AppendLocalPointStencilTable(
+        *refiner, cv_stencils, local_point_stencils);
+    delete cv_stencils;
+    cv_stencils = table;
+  }
+
+  LimitStencilTableFactory::Options options;
+  options.generate1stDerivatives = false;
+  options.generate2ndDerivatives = false;
+  const LimitStencilTable *table = LimitStencilTableFactory::Create(
+      *refiner, locations, cv_stencils, patch_table, options);
+  delete cv_stencils;
+  delete patch_table;
+  if (table == nullptr) {
+    return nullptr;
+  }
+  if (table->GetNumStencils() != num_patch_coords) {
+    delete table;
+    return nullptr;
+  }
+
+  OpenSubdiv_LimitStencils *limit_stencils = MEM_new<OpenSubdiv_LimitStencils>(__func__);
+  limit_stencils->num_stencils = table->GetNumStencils();
+  limit_stencils->num_weights = int(table->GetWeights().size());
+  limit_stencils->sizes = copy_to_new_array(table->GetSizes());
+  limit_stencils->offsets = copy_to_new_array(table->GetOffsets());
+  limit_stencils->indices = copy_to_new_array(table->GetControlIndices());
+  limit_stencils->weights = copy_to_new_array(table->GetWeights());
+  delete table;
+  return limit_stencils;
+}
+
+void openSubdiv_deleteLimitStencils(OpenSubdiv_LimitStencils *limit_stencils)
+{
+  MEM_freeN(limit_stencils->sizes);
+  MEM_freeN(limit_stencils->offsets);
+  MEM_freeN(limit_stencils->indices);
+  MEM_freeN(limit_stencils->weights);
+  MEM_delete(limit_stencils);
+}
@@ -246,6 +246,32 @@ void openSubdiv_deleteEvaluatorCache(OpenSubdiv_EvaluatorCache *evaluator_cache)
 // This function is not thread-safe.
 const char *openSubdiv_getGLSLPatchBasisSource(void);
 
+// Limit stencils of a set of patch coordinates: the limit surface position of every coordinate
+// is a weighted sum of the coarse vertex positions. The stencils are stored in a compressed row
+// layout, the stencil of coordinate `i` uses `sizes[i]` coarse vertices, which are stored in the
+// `indices` and `weights` arrays starting at `offsets[i]`.
+typedef struct OpenSubdiv_LimitStencils {
+  int num_stencils;
+  int num_weights;
+  int *sizes;
+  int *offsets;
+  int *indices;
+  float *weights;
+} OpenSubdiv_LimitStencils;
+
+// Create limit stencils for the given patch coordinates. The topology refiner must already be
+// refined for evaluation, which happens when an evaluator is created from it. The stencils use the
+// same patches as the evaluator, so they give the same limit positions.
+//
+// Returns NULL if the stencils could not be created, for example for bad topology or uniform
+// refinement.
+OpenSubdiv_LimitStencils *openSubdiv_createLimitStencils(
+    struct OpenSubdiv_TopologyRefiner *topology_refiner,
+    const struct OpenSubdiv_PatchCoord *patch_coords,
+    const int num_patch_coords);
+
+void openSubdiv_deleteLimitStencils(OpenSubdiv_LimitStencils *limit_stencils);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,3 +29,13 @@ const char *openSubdiv_getGLSLPatchBasisSource()
 {
   return NULL;
 }
+
+OpenSubdiv_LimitStencils *openSubdiv_createLimitStencils(
+    struct OpenSubdiv_TopologyRefiner * /*topology_refiner*/,
+    const struct OpenSubdiv_PatchCoord * /*patch_coords*/,
+    const int /*num_patch_coords*/)
+{
+  return NULL;
+}
+
+void openSubdiv_deleteLimitStencils(OpenSubdiv_LimitStencils * /*limit_stencils*/) {}
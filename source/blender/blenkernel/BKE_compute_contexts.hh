@@ -8,9 +8,15 @@
  * This file implements some specific compute contexts for concepts in Blender.
  */
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <optional>
 
 #include "BLI_compute_context.hh"
+#include "BLI_generic_pointer.hh"
+#include "BLI_map.hh"
+#include "BLI_vector.hh"
 
 struct bNode;
 
@@ -103,4 +109,130 @@ class RepeatZoneComputeContext : public ComputeContext {
   void print_current_in_line(std::ostream &stream) const override;
 };
 
+/**
+ * Builds a hash of the values that a node group is evaluated with. Together with the hash of the
+ * compute context of the node group, it identifies an evaluation whose outputs can be reused (see
+ * #NodeGroupEvaluationCache).
+ *
+ * Geometries are identified by the addresses of their implicitly shared components. This is only
+ * reliable as long as those components are kept alive, which is why the cache keeps copies of the
+ * inputs that it compares against.
+ */
+class NodeGroupInputsHashBuilder {
+ private:
+  ComputeContextHash hash_;
+  bool is_cacheable_ = true;
+
+ public:
+  /**
+   * \param group_version: Has to change whenever the node group itself changes.
+   */
+  NodeGroupInputsHashBuilder(uint64_t group_version);
+
+  void mix_in(const void *data, int64_t len);
+
+  /**
+   * Mix in a value of a type that is used for geometry nodes sockets. Values that can't be
+   * identified reliably (e.g. geometries that reference object data) make the inputs uncacheable.
+   */
+  void mix_in_value(GPointer value);
+
+  /**
+   * False when the outputs computed from the inputs must not be cached.
+   */
+  bool is_cacheable() const
+  {
+    return is_cacheable_;
+  }
+
+  const ComputeContextHash &hash() const
+  {
+    return hash_;
+  }
+};
+
+/**
+ * Memoizes the outputs of node group evaluations across multiple evaluations of the same node
+ * tree. There is at most one entry per compute context. The memory used by the cache is bounded,
+ * least recently used entries are removed first.
+ */
+class NodeGroupEvaluationCache {
+ public:
+  struct Entry {
+    /** Hash built with #NodeGroupInputsHashBuilder. */
+    ComputeContextHash inputs_hash;
+    /**
+     * Indices of the inputs that the outputs were computed from, in increasing order. The other
+     * inputs were not used by the evaluation, so they don't have to be computed to reuse it.
+     */
+    Vector<int> input_indices;
+    /**
+     * Copies of the inputs that the outputs were computed from, matching #input_indices. They are
+     * compared to new inputs to avoid false positives and keep shared data alive, so that its
+     * address stays unique.
+     */
+    Vector<GMutablePointer> inputs;
+    Vector<GMutablePointer> outputs;
+    /** Approximate number of bytes referenced by the inputs and outputs. */
+    int64_t memory_size = 0;
+    /** Used to find the least recently used entries. */
+    mutable std::atomic<uint64_t> last_use = 0;
+
+    Entry() = default;
+    Entry(const Entry &other) = delete;
+    Entry &operator=(const Entry &other) = delete;
+    ~Entry();
+
+    bool inputs_equal(Span<GPointer> other_inputs) const;
+  };
+
+ private:
+  mutable std::mutex mutex_;
+  Map<ComputeContextHash, std::shared_ptr<const Entry>> entries_;
+  /** Atomic because it is compared to the size of new entries before the mutex is locked. */
+  std::atomic<int64_t> memory_budget_ = int64_t(1024) * 1024 * 1024;
+  int64_t memory_usage_ = 0;
+  mutable std::atomic<uint64_t> use_counter_ = 0;
+  /** Value of #use_counter_ when #remove_unused was called the last time. */
+  uint64_t last_cleanup_use_ = 0;
+
+ public:
+  /**
+   * Find the entry of the given context, regardless of its inputs. Its #Entry::input_indices tell
+   * which inputs have to be available to check whether it can be reused with #lookup.
+   */
+  std::shared_ptr<const Entry> find(const ComputeContextHash &context_hash) const;
+
+  /**
+   * Find the outputs that were computed from the same inputs in the given context before.
+   */
+  std::shared_ptr<const Entry> lookup(const ComputeContextHash &context_hash,
+                                      const ComputeContextHash &inputs_hash,
+                                      Span<GPointer> inputs) const;
+
+  /**
+   * Copy the inputs and outputs into a new entry for the given context, replacing an existing
+   * one. Nothing is cached if the entry alone would exceed the memory budget.
+   */
+  void add(const ComputeContextHash &context_hash,
+           const ComputeContextHash &inputs_hash,
+           Span<int> input_indices,
+           Span<GPointer> inputs,
+           Span<GPointer> outputs);
+
+  /**
+   * Remove all entries that have not been used since the last call. This is called after every
+   * evaluation of the node tree, so that outdated data does not stay in memory.
+   */
+  void remove_unused();
+
+  void clear();
+
+  void set_memory_budget(int64_t bytes);
+  int64_t memory_usage() const;
+
+ private:
+  void remove_least_recently_used_until(int64_t max_memory_usage);
+};
+
 }  // namespace blender::bke
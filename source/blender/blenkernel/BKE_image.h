@@ -45,6 +45,11 @@ void BKE_image_free_buffers(struct Image *image);
  */
 void BKE_image_free_buffers_ex(struct Image *image, bool do_lock);
 void BKE_image_free_gputextures(struct Image *ima);
+/**
+ * Give the image a new #Image_Runtime.update_count. Called whenever the image buffers are freed
+ * or marked as updated, see #BKE_image_partial_update_mark_region.
+ */
+void BKE_image_update_count_bump(struct Image *ima);
 /**
  * Free (or release) any data used by this image (does not free the image itself).
  * \note Call from library.
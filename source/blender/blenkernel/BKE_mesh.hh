@@ -84,6 +84,30 @@ void normals_calc_face_vert(Span<float3> vert_positions,
                             MutableSpan<float3> face_normals,
                             MutableSpan<float3> vert_normals);
 
+/**
+ * Calculate vertex normals from already calculated face normals. Every vertex gathers the
+ * angle-weighted normals of its faces in a fixed order, so unlike #normals_calc_face_vert, the
+ * result does not depend on the number of threads or on scheduling.
+ *
+ * \param vert_to_face_map: Map of the faces used by each vertex, see #Mesh::vert_to_face_map().
+ * \param vert_to_corner_map: Map of the corners used by each vertex, with the same groups as
+ * \a vert_to_face_map, see #Mesh::vert_to_corner_map().
+ */
+void normals_calc_verts(Span<float3> vert_positions,
+                        OffsetIndices<int> faces,
+                        Span<int> corner_verts,
+                        GroupedSpan<int> vert_to_face_map,
+                        GroupedSpan<int> vert_to_corner_map,
+                        Span<float3> face_normals,
+                        MutableSpan<float3> vert_normals);
+
+/**
+ * #Mesh::vert_normals() gathers the normals with #normals_calc_verts for meshes with more faces
+ * than this, building the vertex to face map if necessary. Smaller meshes are processed by a
+ * single task of #normals_calc_face_vert, which is deterministic and doesn't need the map.
+ */
+constexpr int vert_normals_gather_min_faces = 1024;
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
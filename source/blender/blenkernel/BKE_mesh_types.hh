@@ -65,6 +65,17 @@ struct LooseEdgeCache : public LooseGeomCache {
 struct LooseVertCache : public LooseGeomCache {
 };
 
+/**
+ * Cache of the faces and corners that use each vertex, accessed with #Mesh::vert_to_face_map()
+ * and #Mesh::vert_to_corner_map(). Both maps share the same offsets, so the face and the corner
+ * at the same position of a vertex's group belong together.
+ */
+struct VertToFaceMapCache {
+  Array<int> offsets;
+  Array<int> face_indices;
+  Array<int> corner_indices;
+};
+
 struct MeshRuntime {
   /* Evaluated mesh for objects which do not have effective modifiers.
    * This mesh is used as a result of modifier stack evaluation.
@@ -155,6 +166,8 @@ struct MeshRuntime {
   SharedCache<LooseVertCache> loose_verts_cache;
   /** Cache of data about vertices not used by faces. See #Mesh::verts_no_face(). */
   SharedCache<LooseVertCache> verts_no_face_cache;
+  /** Cache of the faces and corners that use each vertex. See #Mesh::vert_to_face_map(). */
+  SharedCache<VertToFaceMapCache> vert_to_face_map_cache;
 
   /**
    * A bit vector the size of the number of vertices, set to true for the center vertices of
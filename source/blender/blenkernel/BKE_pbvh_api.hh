@@ -198,6 +198,21 @@ typedef void (*BKE_pbvh_SearchNearestCallback)(PBVHNode *node, void *data, float
 
 PBVH *BKE_pbvh_new(PBVHType type);
 
+/** Heuristic used to choose where nodes are split when building the tree. */
+enum PBVHSplitMethod {
+  /** Split at the middle of the widest axis of the primitive centroids. */
+  PBVH_SPLIT_MIDPOINT = 0,
+  /**
+   * Choose the split plane that minimizes the surface area heuristic, balancing the extents of
+   * the child nodes as well as their primitive counts. Building is a bit slower, but the nodes
+   * are tighter, which helps ray-casts and brush searches.
+   */
+  PBVH_SPLIT_SAH = 1,
+};
+
+/** Set the split heuristic used by the next #BKE_pbvh_build_mesh or #BKE_pbvh_build_grids. */
+void BKE_pbvh_split_method_set(PBVH *pbvh, PBVHSplitMethod method);
+
 /**
  * Do a full rebuild with on Mesh data structure.
  */
@@ -14,6 +14,7 @@
 
 struct Mesh;
 struct Subdiv;
+struct SubdivMeshCache;
 
 struct SubdivToMeshSettings {
   /**
@@ -33,6 +34,23 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
                          const SubdivToMeshSettings *settings,
                          const Mesh *coarse_mesh);
 
+SubdivMeshCache *BKE_subdiv_mesh_cache_new();
+void BKE_subdiv_mesh_cache_free(SubdivMeshCache *cache);
+
+/**
+ * Same as #BKE_subdiv_to_mesh, but the subdivided mesh and the limit surface stencils of its
+ * vertices are stored in the cache. As long as only the vertex positions of the coarse mesh
+ * change, later calls copy the cached mesh and recompute the positions as a sparse product of the
+ * stencil weights and the coarse positions, skipping topology traversal and patch evaluation.
+ *
+ * Falls back to a regular evaluation for meshes that can't be cached, e.g. with displacement,
+ * loose geometry or attributes that are not implicitly shared between evaluations.
+ */
+Mesh *BKE_subdiv_to_mesh_cached(Subdiv *subdiv,
+                                const SubdivToMeshSettings *settings,
+                                const Mesh *coarse_mesh,
+                                SubdivMeshCache *cache);
+
 /**
  * Interpolate a position along the `coarse_edge` at the relative `u` coordinate.
  * If `is_simple` is false, this will perform a B-Spline interpolation using the edge neighbors,
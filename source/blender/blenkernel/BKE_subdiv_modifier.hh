@@ -24,6 +24,7 @@ struct Mesh;
 struct Object;
 struct Scene;
 struct Subdiv;
+struct SubdivMeshCache;
 struct SubdivSettings;
 struct SubsurfModifierData;
 
@@ -36,6 +37,9 @@ struct SubsurfRuntimeData {
   Subdiv *subdiv_cpu;
   Subdiv *subdiv_gpu;
 
+  /* Cached subdivided mesh and limit stencils, when topology caching is enabled. */
+  SubdivMeshCache *mesh_cache;
+
   /* Recent usage markers for UI diagnostics. To avoid UI flicker due to races
    * between evaluation and UI redraw, they are set to 2 when an evaluator is used,
    * and count down every frame. */
@@ -2,9 +2,16 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "MEM_guardedalloc.h"
+
 #include "DNA_node_types.h"
 
+#include "BKE_anonymous_attribute_id.hh"
 #include "BKE_compute_contexts.hh"
+#include "BKE_geometry_set.hh"
+#include "BKE_instances.hh"
+
+#include "FN_field_cpp_type.hh"
 
 namespace blender::bke {
 
@@ -117,4 +124,321 @@ void RepeatZoneComputeContext::print_current_in_line(std::ostream &stream) const
   stream << "Repeat Zone ID: " << output_node_id_;
 }
 
+NodeGroupInputsHashBuilder::NodeGroupInputsHashBuilder(const uint64_t group_version)
+{
+  hash_.mix_in(&group_version, sizeof(group_version));
+}
+
+void NodeGroupInputsHashBuilder::mix_in(const void *data, const int64_t len)
+{
+  hash_.mix_in(data, len);
+}
+
+/**
+ * Object and collection instances reference data that can change without the geometry changing.
+ */
+static bool geometry_is_identified_by_components(const GeometrySet &geometry)
+{
+  if (!geometry.owns_direct_data()) {
+    return false;
+  }
+  if (const Instances *instances = geometry.get_instances()) {
+    for (const InstanceReference &reference : instances->references()) {
+      switch (reference.type()) {
+        case InstanceReference::Type::None:
+          break;
+        case InstanceReference::Type::Object:
+        case InstanceReference::Type::Collection:
+          return false;
+        case InstanceReference::Type::GeometrySet:
+          if (!geometry_is_identified_by_components(reference.geometry_set())) {
+            return false;
+          }
+          break;
+      }
+    }
+  }
+  return true;
+}
+
+void NodeGroupInputsHashBuilder::mix_in_value(const GPointer value)
+{
+  const CPPType &type = *value.type();
+  if (type.is<GeometrySet>()) {
+    const GeometrySet &geometry = *value.get<GeometrySet>();
+    if (!geometry_is_identified_by_components(geometry)) {
+      is_cacheable_ = false;
+      return;
+    }
+    for (const GeometryComponent *component : geometry.get_components()) {
+      const GeometryComponent::Type component_type = component->type();
+      hash_.mix_in(&component_type, sizeof(component_type));
+      hash_.mix_in(&component, sizeof(component));
+    }
+    return;
+  }
+  if (type.is<AnonymousAttributeSet>()) {
+    const AnonymousAttributeSet &attribute_set = *value.get<AnonymousAttributeSet>();
+    /* The order of names in the set is arbitrary, so combine their hashes in an order independent
+     * way. */
+    uint64_t names_hash = 0;
+    if (attribute_set.names) {
+      for (const std::string &name : *attribute_set.names) {
+        names_hash ^= get_default_hash(name);
+      }
+    }
+    hash_.mix_in(&names_hash, sizeof(names_hash));
+    return;
+  }
+  if (const fn::ValueOrFieldCPPType *value_or_field_type = fn::ValueOrFieldCPPType::get_from_self(
+          type))
+  {
+    if (const fn::GField *field = value_or_field_type->get_field_ptr(value.get())) {
+      const uint64_t field_hash = field->hash();
+      hash_.mix_in(&field_hash, sizeof(field_hash));
+      return;
+    }
+    const CPPType &value_type = value_or_field_type->value;
+    if (!value_type.is_hashable()) {
+      is_cacheable_ = false;
+      return;
+    }
+    const uint64_t value_hash = value_type.hash(value_or_field_type->get_value_ptr(value.get()));
+    hash_.mix_in(&value_hash, sizeof(value_hash));
+    return;
+  }
+  if (!type.is_hashable() || !type.is_equality_comparable()) {
+    is_cacheable_ = false;
+    return;
+  }
+  const uint64_t value_hash = type.hash(value.get());
+  hash_.mix_in(&value_hash, sizeof(value_hash));
+}
+
+static bool cached_values_equal(const GPointer a, const GPointer b)
+{
+  const CPPType &type = *a.type();
+  if (&type != b.type()) {
+    return false;
+  }
+  if (type.is<GeometrySet>()) {
+    const GeometrySet &geometry_a = *a.get<GeometrySet>();
+    const GeometrySet &geometry_b = *b.get<GeometrySet>();
+    for (const int i : IndexRange(GEO_COMPONENT_TYPE_ENUM_SIZE)) {
+      const GeometryComponent::Type component_type = GeometryComponent::Type(i);
+      if (geometry_a.get_component(component_type) != geometry_b.get_component(component_type)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (type.is<AnonymousAttributeSet>()) {
+    const AnonymousAttributeSet &set_a = *a.get<AnonymousAttributeSet>();
+    const AnonymousAttributeSet &set_b = *b.get<AnonymousAttributeSet>();
+    const bool is_empty_a = !set_a.names || set_a.names->is_empty();
+    const bool is_empty_b = !set_b.names || set_b.names->is_empty();
+    if (is_empty_a || is_empty_b) {
+      return is_empty_a == is_empty_b;
+    }
+    return *set_a.names == *set_b.names;
+  }
+  if (const fn::ValueOrFieldCPPType *value_or_field_type = fn::ValueOrFieldCPPType::get_from_self(
+          type))
+  {
+    const fn::GField *field_a = value_or_field_type->get_field_ptr(a.get());
+    const fn::GField *field_b = value_or_field_type->get_field_ptr(b.get());
+    if (field_a || field_b) {
+      return field_a && field_b && *field_a == *field_b;
+    }
+    const CPPType &value_type = value_or_field_type->value;
+    return value_type.is_equal_or_false(value_or_field_type->get_value_ptr(a.get()),
+                                        value_or_field_type->get_value_ptr(b.get()));
+  }
+  return type.is_equal_or_false(a.get(), b.get());
+}
+
+static int64_t estimate_geometry_memory(const GeometrySet &geometry)
+{
+  int64_t size = 0;
+  for (const GeometryComponent *component : geometry.get_components()) {
+    if (const std::optional<AttributeAccessor> attributes = component->attributes()) {
+      attributes->for_all([&](const AttributeIDRef & /*id*/, const AttributeMetaData &meta_data) {
+        const CPPType &type = *custom_data_type_to_cpp_type(meta_data.data_type);
+        size += int64_t(attributes->domain_size(meta_data.domain)) * type.size();
+        return true;
+      });
+    }
+  }
+  if (const Instances *instances = geometry.get_instances()) {
+    for (const InstanceReference &reference : instances->references()) {
+      if (reference.type() == InstanceReference::Type::GeometrySet) {
+        size += estimate_geometry_memory(reference.geometry_set());
+      }
+    }
+  }
+  return size;
+}
+
+static int64_t estimate_value_memory(const GPointer value)
+{
+  const CPPType &type = *value.type();
+  if (type.is<GeometrySet>()) {
+    return type.size() + estimate_geometry_memory(*value.get<GeometrySet>());
+  }
+  return type.size();
+}
+
+static GMutablePointer copy_cached_value(const GPointer value)
+{
+  const CPPType &type = *value.type();
+  void *buffer = MEM_mallocN_aligned(type.size(), type.alignment(), __func__);
+  type.copy_construct(value.get(), buffer);
+  if (type.is<GeometrySet>()) {
+    /* The cached geometry has to stay valid when the data it was created from is freed. */
+    static_cast<GeometrySet *>(buffer)->ensure_owns_direct_data();
+  }
+  return {type, buffer};
+}
+
+NodeGroupEvaluationCache::Entry::~Entry()
+{
+  for (Vector<GMutablePointer> *values : {&inputs, &outputs}) {
+    for (GMutablePointer &value : *values) {
+      value.destruct();
+      MEM_freeN(value.get());
+    }
+  }
+}
+
+bool NodeGroupEvaluationCache::Entry::inputs_equal(const Span<GPointer> other_inputs) const
+{
+  if (inputs.size() != other_inputs.size()) {
+    return false;
+  }
+  for (const int i : inputs.index_range()) {
+    if (!cached_values_equal(inputs[i], other_inputs[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::shared_ptr<const NodeGroupEvaluationCache::Entry> NodeGroupEvaluationCache::find(
+    const ComputeContextHash &context_hash) const
+{
+  std::lock_guard lock{mutex_};
+  return entries_.lookup_default(context_hash, nullptr);
+}
+
+std::shared_ptr<const NodeGroupEvaluationCache::Entry> NodeGroupEvaluationCache::lookup(
+    const ComputeContextHash &context_hash,
+    const ComputeContextHash &inputs_hash,
+    const Span<GPointer> inputs) const
+{
+  const std::shared_ptr<const Entry> entry = this->find(context_hash);
+  if (!entry) {
+    return nullptr;
+  }
+  if (entry->inputs_hash != inputs_hash || !entry->inputs_equal(inputs)) {
+    return nullptr;
+  }
+  entry->last_use = use_counter_.fetch_add(1) + 1;
+  return entry;
+}
+
+void NodeGroupEvaluationCache::add(const ComputeContextHash &context_hash,
+                                   const ComputeContextHash &inputs_hash,
+                                   const Span<int> input_indices,
+                                   const Span<GPointer> inputs,
+                                   const Span<GPointer> outputs)
+{
+  BLI_assert(input_indices.size() == inputs.size());
+  int64_t memory_size = 0;
+  for (const Span<GPointer> values : {inputs, outputs}) {
+    for (const GPointer value : values) {
+      memory_size += estimate_value_memory(value);
+    }
+  }
+  if (memory_size > memory_budget_) {
+    std::lock_guard lock{mutex_};
+    if (const std::optional<std::shared_ptr<const Entry>> old_entry = entries_.pop_try(
+            context_hash))
+    {
+      memory_usage_ -= (*old_entry)->memory_size;
+    }
+    return;
+  }
+
+  auto entry = std::make_shared<Entry>();
+  entry->inputs_hash = inputs_hash;
+  entry->input_indices = input_indices;
+  entry->memory_size = memory_size;
+  for (const GPointer value : inputs) {
+    entry->inputs.append(copy_cached_value(value));
+  }
+  for (const GPointer value : outputs) {
+    entry->outputs.append(copy_cached_value(value));
+  }
+  entry->last_use = use_counter_.fetch_add(1) + 1;
+
+  std::lock_guard lock{mutex_};
+  if (const std::optional<std::shared_ptr<const Entry>> old_entry = entries_.pop_try(context_hash))
+  {
+    memory_usage_ -= (*old_entry)->memory_size;
+  }
+  this->remove_least_recently_used_until(memory_budget_ - memory_size);
+  memory_usage_ += memory_size;
+  entries_.add_new(context_hash, std::move(entry));
+}
+
+void NodeGroupEvaluationCache::remove_least_recently_used_until(const int64_t max_memory_usage)
+{
+  while (memory_usage_ > max_memory_usage && !entries_.is_empty()) {
+    const ComputeContextHash *oldest_key = nullptr;
+    uint64_t oldest_use = UINT64_MAX;
+    for (const auto item : entries_.items()) {
+      const uint64_t last_use = item.value->last_use;
+      if (last_use < oldest_use) {
+        oldest_use = last_use;
+        oldest_key = &item.key;
+      }
+    }
+    const std::shared_ptr<const Entry> entry = entries_.pop(*oldest_key);
+    memory_usage_ -= entry->memory_size;
+  }
+}
+
+void NodeGroupEvaluationCache::remove_unused()
+{
+  std::lock_guard lock{mutex_};
+  entries_.remove_if([&](const auto item) {
+    if (item.value->last_use > last_cleanup_use_) {
+      return false;
+    }
+    memory_usage_ -= item.value->memory_size;
+    return true;
+  });
+  last_cleanup_use_ = use_counter_;
+}
+
+void NodeGroupEvaluationCache::clear()
+{
+  std::lock_guard lock{mutex_};
+  entries_.clear();
+  memory_usage_ = 0;
+}
+
+void NodeGroupEvaluationCache::set_memory_budget(const int64_t bytes)
+{
+  std::lock_guard lock{mutex_};
+  memory_budget_ = bytes;
+  this->remove_least_recently_used_until(memory_budget_);
+}
+
+int64_t NodeGroupEvaluationCache::memory_usage() const
+{
+  std::lock_guard lock{mutex_};
+  return memory_usage_;
+}
+
 }  // namespace blender::bke
@@ -0,0 +1,135 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BKE_compute_contexts.hh"
+
+namespace blender::bke::tests {
+
+static ComputeContextHash context_hash_from_id(const int id)
+{
+  ComputeContextHash hash;
+  hash.mix_in(&id, sizeof(id));
+  return hash;
+}
+
+/** Hash the inputs like the group node does, including their indices. */
+static ComputeContextHash inputs_hash(const Span<int> indices, const Span<GPointer> inputs)
+{
+  NodeGroupInputsHashBuilder builder{1};
+  for (const int i : indices.index_range()) {
+    builder.mix_in(&indices[i], sizeof(int));
+    builder.mix_in_value(inputs[i]);
+  }
+  EXPECT_TRUE(builder.is_cacheable());
+  return builder.hash();
+}
+
+TEST(node_group_evaluation_cache, Hit)
+{
+  NodeGroupEvaluationCache cache;
+  const ComputeContextHash context = context_hash_from_id(0);
+
+  const int input = 5;
+  const float output = 2.5f;
+  const Array<int> indices = {1};
+  const Array<GPointer> inputs = {GPointer(&input)};
+  const ComputeContextHash hash = inputs_hash(indices, inputs);
+  cache.add(context, hash, indices, inputs, {GPointer(&output)});
+
+  /* The indices of the used inputs are known before the inputs are compared. */
+  const std::shared_ptr<const NodeGroupEvaluationCache::Entry> found = cache.find(context);
+  ASSERT_NE(found, nullptr);
+  EXPECT_EQ(found->input_indices.as_span(), indices.as_span());
+
+  /* Equal inputs in separate memory give the cached outputs. */
+  const int same_input = 5;
+  const Array<GPointer> same_inputs = {GPointer(&same_input)};
+  const std::shared_ptr<const NodeGroupEvaluationCache::Entry> entry = cache.lookup(
+      context, inputs_hash(indices, same_inputs), same_inputs);
+  ASSERT_NE(entry, nullptr);
+  ASSERT_EQ(entry->outputs.size(), 1);
+  EXPECT_EQ(*entry->outputs[0].get<float>(), 2.5f);
+  EXPECT_GT(cache.memory_usage(), 0);
+}
+
+TEST(node_group_evaluation_cache, Miss)
+{
+  NodeGroupEvaluationCache cache;
+  const ComputeContextHash context = context_hash_from_id(0);
+
+  const int input = 5;
+  const float output = 2.5f;
+  const Array<int> indices = {0};
+  const Array<GPointer> inputs = {GPointer(&input)};
+  const ComputeContextHash hash = inputs_hash(indices, inputs);
+
+  /* Nothing is cached yet. */
+  EXPECT_EQ(cache.find(context), nullptr);
+  EXPECT_EQ(cache.lookup(context, hash, inputs), nullptr);
+
+  cache.add(context, hash, indices, inputs, {GPointer(&output)});
+
+  /* Different input value. */
+  const int other_input = 6;
+  const Array<GPointer> other_inputs = {GPointer(&other_input)};
+  EXPECT_EQ(cache.lookup(context, inputs_hash(indices, other_inputs), other_inputs), nullptr);
+
+  /* Same input value at another input index. */
+  EXPECT_EQ(cache.lookup(context, inputs_hash({1}, inputs), inputs), nullptr);
+
+  /* Different inputs with the cached hash, as with a hash collision. */
+  EXPECT_EQ(cache.lookup(context, hash, other_inputs), nullptr);
+
+  /* Different compute context. */
+  EXPECT_EQ(cache.lookup(context_hash_from_id(1), hash, inputs), nullptr);
+
+  /* The matching lookup still works after all the misses. */
+  EXPECT_NE(cache.lookup(context, hash, inputs), nullptr);
+}
+
+TEST(node_group_evaluation_cache, RemoveUnused)
+{
+  NodeGroupEvaluationCache cache;
+  const int input = 5;
+  const float output = 2.5f;
+  const Array<int> indices = {0};
+  const Array<GPointer> inputs = {GPointer(&input)};
+  const ComputeContextHash hash = inputs_hash(indices, inputs);
+  cache.add(context_hash_from_id(0), hash, indices, inputs, {GPointer(&output)});
+  cache.add(context_hash_from_id(1), hash, indices, inputs, {GPointer(&output)});
+  cache.remove_unused();
+
+  /* Only the entry that is used between two cleanups is kept. */
+  EXPECT_NE(cache.lookup(context_hash_from_id(0), hash, inputs), nullptr);
+  cache.remove_unused();
+  EXPECT_NE(cache.find(context_hash_from_id(0)), nullptr);
+  EXPECT_EQ(cache.find(context_hash_from_id(1)), nullptr);
+}
+
+TEST(node_group_evaluation_cache, MemoryBudget)
+{
+  NodeGroupEvaluationCache cache;
+  const int input = 5;
+  const float output = 2.5f;
+  const Array<int> indices = {0};
+  const Array<GPointer> inputs = {GPointer(&input)};
+  const ComputeContextHash hash = inputs_hash(indices, inputs);
+
+  /* An entry that does not fit into the budget is not added. */
+  cache.set_memory_budget(1);
+  cache.add(context_hash_from_id(0), hash, indices, inputs, {GPointer(&output)});
+  EXPECT_EQ(cache.find(context_hash_from_id(0)), nullptr);
+  EXPECT_EQ(cache.memory_usage(), 0);
+
+  /* With room for one entry, the least recently used one is removed. */
+  cache.set_memory_budget(sizeof(int) + sizeof(float));
+  cache.add(context_hash_from_id(0), hash, indices, inputs, {GPointer(&output)});
+  cache.add(context_hash_from_id(1), hash, indices, inputs, {GPointer(&output)});
+  EXPECT_EQ(cache.find(context_hash_from_id(0)), nullptr);
+  EXPECT_NE(cache.find(context_hash_from_id(1)), nullptr);
+}
+
+}  // namespace blender::bke::tests
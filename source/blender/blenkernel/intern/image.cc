@@ -28,6 +28,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "IMB_colormanagement.h"
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
@@ -121,6 +123,7 @@ static void image_runtime_reset(Image *image)
   memset(&image->runtime, 0, sizeof(image->runtime));
   image->runtime.cache_mutex = MEM_mallocN(sizeof(ThreadMutex), "image runtime cache_mutex");
   BLI_mutex_init(static_cast<ThreadMutex *>(image->runtime.cache_mutex));
+  BKE_image_update_count_bump(image);
 }
 
 /** Reset runtime image fields when data-block is being copied. */
@@ -131,6 +134,7 @@ static void image_runtime_reset_on_copy(Image *image)
 
   image->runtime.partial_update_register = nullptr;
   image->runtime.partial_update_user = nullptr;
+  BKE_image_update_count_bump(image);
 }
 
 static void image_runtime_free_data(Image *image)
@@ -338,6 +342,7 @@ static void image_blend_write(BlendWriter *writer, ID *id, const void *id_addres
   BLI_listbase_clear(&ima->anims);
   ima->runtime.partial_update_register = nullptr;
   ima->runtime.partial_update_user = nullptr;
+  ima->runtime.update_count = 0;
   for (int i = 0; i < 3; i++) {
     for (int j = 0; j < 2; j++) {
       ima->gputexture[i][j] = nullptr;
@@ -620,12 +625,19 @@ void BKE_image_free_buffers_ex(Image *ima, bool do_lock)
   }
 
   BKE_image_free_gputextures(ima);
+  BKE_image_update_count_bump(ima);
 
   if (do_lock) {
     BLI_mutex_unlock(static_cast<ThreadMutex *>(ima->runtime.cache_mutex));
   }
 }
 
+void BKE_image_update_count_bump(Image *ima)
+{
+  static uint64_t update_count = 0;
+  ima->runtime.update_count = atomic_add_and_fetch_uint64(&update_count, 1);
+}
+
 void BKE_image_free_buffers(Image *ima)
 {
   BKE_image_free_buffers_ex(ima, false);
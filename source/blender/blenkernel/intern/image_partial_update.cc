@@ -581,11 +581,13 @@ void BKE_image_partial_update_mark_region(Image *image,
   PartialUpdateRegisterImpl *partial_updater = unwrap(image_partial_update_register_ensure(image));
   partial_updater->update_resolution(image_tile, image_buffer);
   partial_updater->mark_region(image_tile, updated_region);
+  BKE_image_update_count_bump(image);
 }
 
 void BKE_image_partial_update_mark_full_update(Image *image)
 {
   PartialUpdateRegisterImpl *partial_updater = unwrap(image_partial_update_register_ensure(image));
   partial_updater->mark_full_update();
+  BKE_image_update_count_bump(image);
 }
 }
@@ -6,174 +6,205 @@
  * \ingroup bke
  */
 
+#include <algorithm>
+
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 
-#include "BLI_map.hh"
-#include "BLI_ordered_edge.hh"
+#include "BLI_array.hh"
+#include "BLI_offset_indices.hh"
 #include "BLI_task.hh"
-#include "BLI_threads.h"
-#include "BLI_timeit.hh"
 
 #include "BKE_attribute.hh"
 #include "BKE_customdata.h"
 #include "BKE_mesh.hh"
 
+#include "atomic_ops.h"
+
 namespace blender::bke::calc_edges {
 
 /**
- * Return a hash value that is likely to be different in the low bits from the normal `hash()`
- * function. This is necessary to avoid collisions in #BKE_mesh_calc_edges.
+ * Edges are deduplicated with a counting sort on the lower vertex index of every edge,
+ * followed by a comparison sort within each (usually tiny) group that orders the entries by
+ * their higher vertex index. Compared to hash tables this has a deterministic memory footprint
+ * of a few bytes per corner, and the resulting edge order only depends on the topology.
  */
-static uint64_t edge_hash_2(const OrderedEdge &edge)
+struct EdgeEntry {
+  int v_high;
+  /**
+   * The face corner that uses the edge, or for an existing edge, its negated index minus one.
+   * Existing edges are sorted before corners that use the same edge.
+   */
+  int source;
+};
+
+static bool operator<(const EdgeEntry &a, const EdgeEntry &b)
 {
-  return edge.v_low;
+  return a.v_high < b.v_high || (a.v_high == b.v_high && a.source < b.source);
 }
 
-/* The map first contains an edge pointer and later an index. */
-union OrigEdgeOrIndex {
-  const int2 *original_edge;
-  int index;
-};
-using EdgeMap = Map<OrderedEdge, OrigEdgeOrIndex>;
+static int encode_existing_edge(const int edge_index)
+{
+  return -edge_index - 1;
+}
 
-static void reserve_hash_maps(const Mesh *mesh,
-                              const bool keep_existing_edges,
-                              MutableSpan<EdgeMap> edge_maps)
+static int decode_existing_edge(const int source)
 {
-  const int totedge_guess = std::max(keep_existing_edges ? mesh->totedge : 0, mesh->faces_num * 2);
-  threading::parallel_for_each(
-      edge_maps, [&](EdgeMap &edge_map) { edge_map.reserve(totedge_guess / edge_maps.size()); });
+  return -source - 1;
 }
 
-static void add_existing_edges_to_hash_maps(Mesh *mesh,
-                                            MutableSpan<EdgeMap> edge_maps,
-                                            uint32_t parallel_mask)
+/**
+ * Call the callback for every edge from a face corner to the next corner in the same face,
+ * skipping degenerate edges.
+ */
+template<typename Fn>
+static void foreach_face_edge(const OffsetIndices<int> faces,
+                              const Span<int> corner_verts,
+                              const IndexRange face_range,
+                              const Fn &fn)
 {
-  /* Assume existing edges are valid. */
-  const Span<int2> edges = mesh->edges();
-  threading::parallel_for_each(edge_maps, [&](EdgeMap &edge_map) {
-    const int task_index = &edge_map - edge_maps.data();
-    for (const int2 &edge : edges) {
-      OrderedEdge ordered_edge{edge[0], edge[1]};
-      /* Only add the edge when it belongs into this map. */
-      if (task_index == (parallel_mask & edge_hash_2(ordered_edge))) {
-        edge_map.add_new(ordered_edge, {&edge});
+  for (const int face_index : face_range) {
+    const IndexRange face = faces[face_index];
+    int prev_corner = face.last();
+    for (const int next_corner : face) {
+      const int vert_prev = corner_verts[prev_corner];
+      const int vert = corner_verts[next_corner];
+      /* Can only be the same when the mesh data is invalid. */
+      if (vert_prev != vert) {
+        fn(prev_corner, std::min(vert_prev, vert), std::max(vert_prev, vert));
       }
+      prev_corner = next_corner;
     }
-  });
+  }
 }
 
-static void add_face_edges_to_hash_maps(Mesh *mesh,
-                                        MutableSpan<EdgeMap> edge_maps,
-                                        uint32_t parallel_mask)
+static void count_edges_per_low_vert(const Mesh &mesh,
+                                     const bool keep_existing_edges,
+                                     MutableSpan<int> counts)
 {
-  const OffsetIndices faces = mesh->faces();
-  const Span<int> corner_verts = mesh->corner_verts();
-  threading::parallel_for_each(edge_maps, [&](EdgeMap &edge_map) {
-    const int task_index = &edge_map - edge_maps.data();
-    for (const int i : faces.index_range()) {
-      const Span<int> face_verts = corner_verts.slice(faces[i]);
-      int vert_prev = face_verts.last();
-      for (const int vert : face_verts) {
-        /* Can only be the same when the mesh data is invalid. */
-        if (vert_prev != vert) {
-          OrderedEdge ordered_edge{vert_prev, vert};
-          /* Only add the edge when it belongs into this map. */
-          if (task_index == (parallel_mask & edge_hash_2(ordered_edge))) {
-            edge_map.lookup_or_add(ordered_edge, {nullptr});
-          }
-        }
-        vert_prev = vert;
+  if (keep_existing_edges) {
+    /* Assume existing edges are valid. */
+    const Span<int2> edges = mesh.edges();
+    threading::parallel_for(edges.index_range(), 4096, [&](const IndexRange range) {
+      for (const int2 &edge : edges.slice(range)) {
+        atomic_add_and_fetch_int32(&counts[std::min(edge[0], edge[1])], 1);
       }
-    }
+    });
+  }
+  const OffsetIndices faces = mesh.faces();
+  const Span<int> corner_verts = mesh.corner_verts();
+  threading::parallel_for(faces.index_range(), 1024, [&](const IndexRange range) {
+    foreach_face_edge(faces, corner_verts, range, [&](int /*corner*/, int v_low, int /*v_high*/) {
+      atomic_add_and_fetch_int32(&counts[v_low], 1);
+    });
   });
 }
 
-static void serialize_and_initialize_deduplicated_edges(MutableSpan<EdgeMap> edge_maps,
-                                                        MutableSpan<int2> new_edges)
+static void fill_edge_entries(const Mesh &mesh,
+                              const bool keep_existing_edges,
+                              const OffsetIndices<int> groups,
+                              MutableSpan<int> fill_counts,
+                              MutableSpan<EdgeEntry> entries)
 {
-  /* All edges are distributed in the hash tables now. They have to be serialized into a single
-   * array below. To be able to parallelize this, we have to compute edge index offsets for each
-   * map. */
-  Array<int> edge_index_offsets(edge_maps.size());
-  edge_index_offsets[0] = 0;
-  for (const int i : IndexRange(edge_maps.size() - 1)) {
-    edge_index_offsets[i + 1] = edge_index_offsets[i] + edge_maps[i].size();
+  /* The order within each group depends on scheduling here, it is made deterministic by sorting
+   * the groups afterwards. */
+  if (keep_existing_edges) {
+    const Span<int2> edges = mesh.edges();
+    threading::parallel_for(edges.index_range(), 4096, [&](const IndexRange range) {
+      for (const int edge_index : range) {
+        const int2 edge = edges[edge_index];
+        const int v_low = std::min(edge[0], edge[1]);
+        const int index = groups[v_low].start() +
+                          atomic_fetch_and_add_int32(&fill_counts[v_low], 1);
+        entries[index] = {std::max(edge[0], edge[1]), encode_existing_edge(edge_index)};
+      }
+    });
   }
+  const OffsetIndices faces = mesh.faces();
+  const Span<int> corner_verts = mesh.corner_verts();
+  threading::parallel_for(faces.index_range(), 1024, [&](const IndexRange range) {
+    foreach_face_edge(faces, corner_verts, range, [&](int corner, int v_low, int v_high) {
+      const int index = groups[v_low].start() + atomic_fetch_and_add_int32(&fill_counts[v_low], 1);
+      entries[index] = {v_high, corner};
+    });
+  });
+}
 
-  threading::parallel_for_each(edge_maps, [&](EdgeMap &edge_map) {
-    const int task_index = &edge_map - edge_maps.data();
-
-    int new_edge_index = edge_index_offsets[task_index];
-    for (EdgeMap::MutableItem item : edge_map.items()) {
-      int2 &new_edge = new_edges[new_edge_index];
-      const int2 *orig_edge = item.value.original_edge;
-      if (orig_edge != nullptr) {
-        /* Copy values from original edge. */
-        new_edge = *orig_edge;
-      }
-      else {
-        /* Initialize new edge. */
-        new_edge[0] = item.key.v_low;
-        new_edge[1] = item.key.v_high;
+/**
+ * Sort the entries of every group and count the number of unique edges in each of them.
+ */
+static void sort_groups_and_count_unique_edges(const OffsetIndices<int> groups,
+                                               MutableSpan<EdgeEntry> entries,
+                                               MutableSpan<int> r_unique_counts)
+{
+  threading::parallel_for(groups.index_range(), 2048, [&](const IndexRange range) {
+    for (const int v_low : range) {
+      MutableSpan<EdgeEntry> group = entries.slice(groups[v_low]);
+      std::sort(group.begin(), group.end());
+      int unique_count = 0;
+      for (const int i : group.index_range()) {
+        if (i == 0 || group[i].v_high != group[i - 1].v_high) {
+          unique_count++;
+        }
       }
-      item.value.index = new_edge_index;
-      new_edge_index++;
+      r_unique_counts[v_low] = unique_count;
     }
   });
 }
 
-static void update_edge_indices_in_face_loops(const OffsetIndices<int> faces,
-                                              const Span<int> corner_verts,
-                                              const Span<EdgeMap> edge_maps,
-                                              const uint32_t parallel_mask,
-                                              MutableSpan<int> corner_edges)
+static void initialize_deduplicated_edges(const Span<int2> orig_edges,
+                                          const OffsetIndices<int> groups,
+                                          const Span<EdgeEntry> entries,
+                                          const OffsetIndices<int> edge_offsets,
+                                          MutableSpan<int2> new_edges,
+                                          MutableSpan<int> corner_edges)
 {
-  threading::parallel_for(faces.index_range(), 100, [&](IndexRange range) {
-    for (const int face_index : range) {
-      const IndexRange face = faces[face_index];
-      int prev_corner = face.last();
-      for (const int next_corner : face) {
-        const int vert = corner_verts[next_corner];
-        const int vert_prev = corner_verts[prev_corner];
-
-        int edge_index;
-        if (vert_prev != vert) {
-          OrderedEdge ordered_edge{vert_prev, vert};
-          /* Double lookup: First find the map that contains the edge, then lookup the edge. */
-          const EdgeMap &edge_map = edge_maps[parallel_mask & edge_hash_2(ordered_edge)];
-          edge_index = edge_map.lookup(ordered_edge).index;
+  threading::parallel_for(groups.index_range(), 2048, [&](const IndexRange range) {
+    for (const int v_low : range) {
+      const Span<EdgeEntry> group = entries.slice(groups[v_low]);
+      int edge_index = edge_offsets[v_low].start() - 1;
+      for (const int i : group.index_range()) {
+        const EdgeEntry &entry = group[i];
+        if (i == 0 || entry.v_high != group[i - 1].v_high) {
+          edge_index++;
+          if (entry.source < 0) {
+            /* Copy values from original edge. */
+            new_edges[edge_index] = orig_edges[decode_existing_edge(entry.source)];
+          }
+          else {
+            /* Initialize new edge. */
+            new_edges[edge_index] = int2(v_low, entry.v_high);
+          }
         }
-        else {
-          /* This is an invalid edge; normally this does not happen in Blender,
-           * but it can be part of an imported mesh with invalid geometry. See
-           * #76514. */
-          edge_index = 0;
+        if (entry.source >= 0) {
+          corner_edges[entry.source] = edge_index;
         }
-        corner_edges[prev_corner] = edge_index;
-        prev_corner = next_corner;
       }
     }
   });
 }
 
-static int get_parallel_maps_count(const Mesh *mesh)
-{
-  /* Don't use parallelization when the mesh is small. */
-  if (mesh->faces_num < 1000) {
-    return 1;
-  }
-  /* Use at most 8 separate hash tables. Using more threads has diminishing returns. These threads
-   * can better do something more useful instead. */
-  const int system_thread_count = BLI_system_thread_count();
-  return power_of_2_min_i(std::min(8, system_thread_count));
-}
-
-static void clear_hash_tables(MutableSpan<EdgeMap> edge_maps)
+static void select_new_edges(const OffsetIndices<int> groups,
+                             const Span<EdgeEntry> entries,
+                             const OffsetIndices<int> edge_offsets,
+                             MutableSpan<bool> selection)
 {
-  threading::parallel_for_each(edge_maps, [](EdgeMap &edge_map) { edge_map.clear(); });
+  threading::parallel_for(groups.index_range(), 2048, [&](const IndexRange range) {
+    for (const int v_low : range) {
+      const Span<EdgeEntry> group = entries.slice(groups[v_low]);
+      int edge_index = edge_offsets[v_low].start() - 1;
+      for (const int i : group.index_range()) {
+        if (i == 0 || group[i].v_high != group[i - 1].v_high) {
+          edge_index++;
+          /* Existing edges are sorted first, so this is enough to know if the edge is new. */
+          if (group[i].source >= 0) {
+            selection[edge_index] = true;
+          }
+        }
+      }
+    }
+  });
 }
 
 }  // namespace blender::bke::calc_edges
@@ -184,37 +215,37 @@ void BKE_mesh_calc_edges(Mesh *mesh, bool keep_existing_edges, const bool select
   using namespace blender::bke;
   using namespace blender::bke::calc_edges;
 
-  /* Parallelization is achieved by having multiple hash tables for different subsets of edges.
-   * Each edge is assigned to one of the hash maps based on the lower bits of a hash value. */
-  const int parallel_maps = get_parallel_maps_count(mesh);
-  BLI_assert(is_power_of_2_i(parallel_maps));
-  const uint32_t parallel_mask = uint32_t(parallel_maps) - 1;
-  Array<EdgeMap> edge_maps(parallel_maps);
-  reserve_hash_maps(mesh, keep_existing_edges, edge_maps);
+  /* Group all edges by their lower vertex index. Every face corner adds one entry, and every
+   * existing edge adds one more when they are kept. */
+  Array<int> group_offsets(mesh->totvert + 1, 0);
+  count_edges_per_low_vert(*mesh, keep_existing_edges, group_offsets);
+  const OffsetIndices<int> groups = offset_indices::accumulate_counts_to_offsets(group_offsets);
 
-  /* Add all edges. */
-  if (keep_existing_edges) {
-    calc_edges::add_existing_edges_to_hash_maps(mesh, edge_maps, parallel_mask);
+  Array<EdgeEntry> entries(groups.total_size());
+  {
+    Array<int> fill_counts(mesh->totvert, 0);
+    fill_edge_entries(*mesh, keep_existing_edges, groups, fill_counts, entries);
   }
-  calc_edges::add_face_edges_to_hash_maps(mesh, edge_maps, parallel_mask);
 
   /* Compute total number of edges. */
-  int new_totedge = 0;
-  for (EdgeMap &edge_map : edge_maps) {
-    new_totedge += edge_map.size();
-  }
+  Array<int> edge_offsets_data(mesh->totvert + 1);
+  sort_groups_and_count_unique_edges(groups, entries, edge_offsets_data);
+  const OffsetIndices<int> edge_offsets = offset_indices::accumulate_counts_to_offsets(
+      edge_offsets_data);
+  const int new_totedge = edge_offsets.total_size();
 
   /* Create new edges. */
   MutableAttributeAccessor attributes = mesh->attributes_for_write();
   attributes.add<int>(".corner_edge", ATTR_DOMAIN_CORNER, AttributeInitConstruct());
   MutableSpan<int2> new_edges{
-      static_cast<int2 *>(MEM_calloc_arrayN(new_totedge, sizeof(int2), __func__)), new_totedge};
-  calc_edges::serialize_and_initialize_deduplicated_edges(edge_maps, new_edges);
-  calc_edges::update_edge_indices_in_face_loops(mesh->faces(),
-                                                mesh->corner_verts(),
-                                                edge_maps,
-                                                parallel_mask,
-                                                mesh->corner_edges_for_write());
+      static_cast<int2 *>(MEM_malloc_arrayN(new_totedge, sizeof(int2), __func__)), new_totedge};
+  MutableSpan<int> corner_edges = mesh->corner_edges_for_write();
+  /* This is an invalid edge; normally this does not happen in Blender, but it can be part of an
+   * imported mesh with invalid geometry. See #76514. Degenerate corners are never added to the
+   * groups, so they keep this value. */
+  corner_edges.fill(0);
+  initialize_deduplicated_edges(
+      mesh->edges(), groups, entries, edge_offsets, new_edges, corner_edges);
 
   /* Free old CustomData and assign new one. */
   CustomData_free(&mesh->edge_data, mesh->totedge);
@@ -227,15 +258,7 @@ void BKE_mesh_calc_edges(Mesh *mesh, bool keep_existing_edges, const bool select
     SpanAttributeWriter<bool> select_edge = attributes.lookup_or_add_for_write_span<bool>(
         ".select_edge", ATTR_DOMAIN_EDGE);
     if (select_edge) {
-      int new_edge_index = 0;
-      for (const EdgeMap &edge_map : edge_maps) {
-        for (EdgeMap::Item item : edge_map.items()) {
-          if (item.value.original_edge == nullptr) {
-            select_edge.span[new_edge_index] = true;
-          }
-          new_edge_index++;
-        }
-      }
+      calc_edges::select_new_edges(groups, entries, edge_offsets, select_edge.span);
       select_edge.finish();
     }
   }
@@ -244,7 +267,4 @@ void BKE_mesh_calc_edges(Mesh *mesh, bool keep_existing_edges, const bool select
     /* All edges are rebuilt from the faces, so there are no loose edges. */
     mesh->tag_loose_edges_none();
   }
-
-  /* Explicitly clear edge maps, because that way it can be parallelized. */
-  clear_hash_tables(edge_maps);
 }
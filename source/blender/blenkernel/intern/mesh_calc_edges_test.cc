@@ -0,0 +1,141 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "BKE_attribute.hh"
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.hh"
+
+namespace blender::bke::tests {
+
+/**
+ * Create two quads sharing an edge, with the given existing edges.
+ *
+ * \code{.unparsed}
+ * 3---4---5
+ * |   |   |
+ * 0---1---2
+ * \endcode
+ */
+static Mesh *create_two_quads_mesh(const Span<int2> existing_edges)
+{
+  Mesh *mesh = BKE_mesh_new_nomain(6, existing_edges.size(), 2, 8);
+  mesh->edges_for_write().copy_from(existing_edges);
+  MutableSpan<int> face_offsets = mesh->face_offsets_for_write();
+  face_offsets[0] = 0;
+  face_offsets[1] = 4;
+  face_offsets[2] = 8;
+  mesh->corner_verts_for_write().copy_from({0, 1, 4, 3, 1, 2, 5, 4});
+  return mesh;
+}
+
+/** Every corner uses the edge between its vertex and the vertex of the next corner. */
+static void expect_corner_edges_valid(const Mesh &mesh)
+{
+  const OffsetIndices faces = mesh.faces();
+  const Span<int> corner_verts = mesh.corner_verts();
+  const Span<int> corner_edges = mesh.corner_edges();
+  const Span<int2> edges = mesh.edges();
+  for (const int face : faces.index_range()) {
+    for (const int corner : faces[face]) {
+      const int next_corner = corner == faces[face].last() ? faces[face].first() : corner + 1;
+      const int2 edge = edges[corner_edges[corner]];
+      const int vert = corner_verts[corner];
+      const int next_vert = corner_verts[next_corner];
+      EXPECT_TRUE((edge[0] == vert && edge[1] == next_vert) ||
+                  (edge[0] == next_vert && edge[1] == vert));
+    }
+  }
+}
+
+class MeshCalcEdgesTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+TEST_F(MeshCalcEdgesTest, DeduplicateFaceEdges)
+{
+  Mesh *mesh = create_two_quads_mesh({});
+  BKE_mesh_calc_edges(mesh, false, false);
+
+  /* The shared edge is only added once. Edges are ordered by their lowest vertex, then by their
+   * highest vertex. */
+  const Array<int2> expected = {{0, 1}, {0, 3}, {1, 2}, {1, 4}, {2, 5}, {3, 4}, {4, 5}};
+  EXPECT_EQ(mesh->edges(), expected.as_span());
+  expect_corner_edges_valid(*mesh);
+  EXPECT_EQ(mesh->loose_edges().count, 0);
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshCalcEdgesTest, OrderOnlyDependsOnTopology)
+{
+  Mesh *mesh = create_two_quads_mesh({});
+  BKE_mesh_calc_edges(mesh, false, false);
+  const Array<int2> edges(mesh->edges());
+
+  /* Swapping the faces and starting them at different corners gives the same edges. */
+  mesh->corner_verts_for_write().copy_from({5, 4, 1, 2, 4, 3, 0, 1});
+  BKE_mesh_calc_edges(mesh, false, false);
+  EXPECT_EQ(mesh->edges(), edges.as_span());
+  expect_corner_edges_valid(*mesh);
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshCalcEdgesTest, KeepExistingEdges)
+{
+  /* An existing edge used by the faces in reversed order, and a loose edge. */
+  Mesh *mesh = create_two_quads_mesh({{4, 1}, {0, 5}});
+  BKE_mesh_calc_edges(mesh, true, false);
+
+  /* Existing edges keep their vertex order and are sorted like the new edges. */
+  const Array<int2> expected = {{0, 1}, {0, 3}, {0, 5}, {1, 2}, {4, 1}, {2, 5}, {3, 4}, {4, 5}};
+  EXPECT_EQ(mesh->edges(), expected.as_span());
+  expect_corner_edges_valid(*mesh);
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshCalcEdgesTest, RemoveExistingEdges)
+{
+  Mesh *mesh = create_two_quads_mesh({{4, 1}, {0, 5}});
+  BKE_mesh_calc_edges(mesh, false, false);
+
+  /* The loose edge is removed and the used edge is recreated in sorted vertex order. */
+  const Array<int2> expected = {{0, 1}, {0, 3}, {1, 2}, {1, 4}, {2, 5}, {3, 4}, {4, 5}};
+  EXPECT_EQ(mesh->edges(), expected.as_span());
+  expect_corner_edges_valid(*mesh);
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshCalcEdgesTest, SelectNewEdges)
+{
+  Mesh *mesh = create_two_quads_mesh({{4, 1}, {0, 5}});
+  BKE_mesh_calc_edges(mesh, true, true);
+
+  const VArraySpan<bool> selection = *mesh->attributes().lookup<bool>(".select_edge",
+                                                                      ATTR_DOMAIN_EDGE);
+  const Span<int2> edges = mesh->edges();
+  ASSERT_EQ(selection.size(), edges.size());
+  for (const int edge : edges.index_range()) {
+    const bool is_existing = edges[edge] == int2(4, 1) || edges[edge] == int2(0, 5);
+    EXPECT_EQ(selection[edge], !is_existing);
+  }
+
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::bke::tests
@@ -289,6 +289,52 @@ void normals_calc_face_vert(const Span<float3> positions,
   }
 }
 
+void normals_calc_verts(const Span<float3> positions,
+                        const OffsetIndices<int> faces,
+                        const Span<int> corner_verts,
+                        const GroupedSpan<int> vert_to_face_map,
+                        const GroupedSpan<int> vert_to_corner_map,
+                        const Span<float3> face_normals,
+                        MutableSpan<float3> vert_normals)
+{
+  threading::parallel_for(positions.index_range(), 1024, [&](const IndexRange range) {
+    for (const int vert : range) {
+      const float3 &position = positions[vert];
+      float3 vert_normal(0.0f);
+      const Span<int> vert_faces = vert_to_face_map[vert];
+      const Span<int> vert_corners = vert_to_corner_map[vert];
+      for (const int i : vert_faces.index_range()) {
+        const int face = vert_faces[i];
+        const int corner = vert_corners[i];
+        const int vert_prev = corner_verts[face_corner_prev(faces[face], corner)];
+        const int vert_next = corner_verts[face_corner_next(faces[face], corner)];
+        const float3 dir_prev = math::normalize(positions[vert_prev] - position);
+        const float3 dir_next = math::normalize(positions[vert_next] - position);
+        /* Weight the face normal by the angle between the two face edges used by the vertex. */
+        const float fac = saacos(math::dot(dir_prev, dir_next));
+        vert_normal += face_normals[face] * fac;
+      }
+
+      if (UNLIKELY(normalize_v3(vert_normal) == 0.0f)) {
+        /* Following Mesh convention; we use vertex coordinate itself for normal in this case. */
+        normalize_v3_v3(vert_normal, position);
+      }
+      vert_normals[vert] = vert_normal;
+    }
+  });
+}
+
+/**
+ * Scattering face normals to vertices with atomics avoids building the vertex to face map, but it
+ * contends on shared vertices when many threads are used and the float rounding depends on the
+ * order in which threads add their values. Only the face count is used to choose, so that the
+ * normals of a mesh don't depend on which caches were computed before.
+ */
+static bool use_vert_normals_gather(const Mesh &mesh)
+{
+  return mesh.faces_num > vert_normals_gather_min_faces;
+}
+
 /** \} */
 
 }  // namespace blender::bke::mesh
@@ -318,9 +364,27 @@ blender::Span<blender::float3> Mesh::vert_normals() const
     const Span<int> corner_verts = this->corner_verts();
 
     this->runtime->vert_normals.reinitialize(positions.size());
-    this->runtime->face_normals.reinitialize(faces.size());
-    bke::mesh::normals_calc_face_vert(
-        positions, faces, corner_verts, this->runtime->face_normals, this->runtime->vert_normals);
+    if (bke::mesh::use_vert_normals_gather(*this)) {
+      if (this->runtime->face_normals_dirty) {
+        this->runtime->face_normals.reinitialize(faces.size());
+        bke::mesh::normals_calc_faces(positions, faces, corner_verts, this->runtime->face_normals);
+      }
+      bke::mesh::normals_calc_verts(positions,
+                                    faces,
+                                    corner_verts,
+                                    this->vert_to_face_map(),
+                                    this->vert_to_corner_map(),
+                                    this->runtime->face_normals,
+                                    this->runtime->vert_normals);
+    }
+    else {
+      this->runtime->face_normals.reinitialize(faces.size());
+      bke::mesh::normals_calc_face_vert(positions,
+                                        faces,
+                                        corner_verts,
+                                        this->runtime->face_normals,
+                                        this->runtime->vert_normals);
+    }
 
     this->runtime->vert_normals_dirty = false;
     this->runtime->face_normals_dirty = false;
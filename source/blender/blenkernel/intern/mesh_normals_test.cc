@@ -0,0 +1,196 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cmath>
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.hh"
+#include "BKE_mesh_mapping.hh"
+#include "BKE_mesh_types.hh"
+
+namespace blender::bke::tests {
+
+/**
+ * Create a wavy grid with enough faces to be processed by several tasks. Every other quad is
+ * split into two triangles so vertices are used by faces of different sizes and corner counts.
+ */
+static Mesh *create_wavy_grid_mesh(const int size)
+{
+  const int verts_per_row = size + 1;
+  int faces_num = 0;
+  int corners_num = 0;
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      const bool split = (x + y) % 2 == 1;
+      faces_num += split ? 2 : 1;
+      corners_num += split ? 6 : 4;
+    }
+  }
+
+  Mesh *mesh = BKE_mesh_new_nomain(verts_per_row * verts_per_row, 0, faces_num, corners_num);
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int y : IndexRange(verts_per_row)) {
+    for (const int x : IndexRange(verts_per_row)) {
+      positions[y * verts_per_row + x] = float3(
+          x, y, std::sin(x * 0.3f) * std::cos(y * 0.2f) * 2.0f);
+    }
+  }
+
+  MutableSpan<int> face_offsets = mesh->face_offsets_for_write();
+  MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
+  int face = 0;
+  int corner = 0;
+  auto add_face = [&](const Span<int> verts) {
+    face_offsets[face++] = corner;
+    for (const int vert : verts) {
+      corner_verts[corner++] = vert;
+    }
+  };
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      const int v0 = y * verts_per_row + x;
+      const int v1 = v0 + 1;
+      const int v2 = v1 + verts_per_row;
+      const int v3 = v0 + verts_per_row;
+      if ((x + y) % 2 == 1) {
+        add_face({v0, v1, v2});
+        add_face({v0, v2, v3});
+      }
+      else {
+        add_face({v0, v1, v2, v3});
+      }
+    }
+  }
+  face_offsets.last() = corner;
+  return mesh;
+}
+
+static void expect_normals_near(const Span<float3> a, const Span<float3> b)
+{
+  ASSERT_EQ(a.size(), b.size());
+  for (const int i : a.index_range()) {
+    EXPECT_NEAR(a[i].x, b[i].x, 1e-5f);
+    EXPECT_NEAR(a[i].y, b[i].y, 1e-5f);
+    EXPECT_NEAR(a[i].z, b[i].z, 1e-5f);
+  }
+}
+
+class MeshNormalsTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+TEST_F(MeshNormalsTest, GatherMatchesScatter)
+{
+  Mesh *mesh = create_wavy_grid_mesh(40);
+  const Span<float3> positions = mesh->vert_positions();
+  const OffsetIndices faces = mesh->faces();
+  const Span<int> corner_verts = mesh->corner_verts();
+
+  Array<float3> scatter_face_normals(faces.size());
+  Array<float3> scatter_vert_normals(positions.size());
+  mesh::normals_calc_face_vert(
+      positions, faces, corner_verts, scatter_face_normals, scatter_vert_normals);
+
+  Array<float3> gather_face_normals(faces.size());
+  Array<float3> gather_vert_normals(positions.size());
+  mesh::normals_calc_faces(positions, faces, corner_verts, gather_face_normals);
+  mesh::normals_calc_verts(positions,
+                           faces,
+                           corner_verts,
+                           mesh->vert_to_face_map(),
+                           mesh->vert_to_corner_map(),
+                           gather_face_normals,
+                           gather_vert_normals);
+
+  expect_normals_near(gather_face_normals, scatter_face_normals);
+  expect_normals_near(gather_vert_normals, scatter_vert_normals);
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshNormalsTest, VertToCornerMapMatchesFaces)
+{
+  Mesh *mesh = create_wavy_grid_mesh(4);
+  const OffsetIndices faces = mesh->faces();
+  const Span<int> corner_verts = mesh->corner_verts();
+  const GroupedSpan<int> vert_to_face = mesh->vert_to_face_map();
+  const GroupedSpan<int> vert_to_corner = mesh->vert_to_corner_map();
+
+  for (const int vert : mesh->vert_positions().index_range()) {
+    ASSERT_EQ(vert_to_face[vert].size(), vert_to_corner[vert].size());
+    for (const int i : vert_to_face[vert].index_range()) {
+      const int face = vert_to_face[vert][i];
+      const int corner = vert_to_corner[vert][i];
+      EXPECT_TRUE(faces[face].contains(corner));
+      EXPECT_EQ(corner_verts[corner], vert);
+      if (i > 0) {
+        EXPECT_LT(vert_to_face[vert][i - 1], face);
+      }
+    }
+  }
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(MeshNormalsTest, GatherAboveFaceThreshold)
+{
+  /* Meshes on both sides of the threshold. */
+  Mesh *small_mesh = create_wavy_grid_mesh(26);
+  Mesh *large_mesh = create_wavy_grid_mesh(27);
+  ASSERT_LE(small_mesh->faces_num, mesh::vert_normals_gather_min_faces);
+  ASSERT_GT(large_mesh->faces_num, mesh::vert_normals_gather_min_faces);
+
+  /* The small mesh scatters the normals in a single task, without building the map. */
+  {
+    const Span<float3> positions = small_mesh->vert_positions();
+    Array<float3> face_normals(small_mesh->faces_num);
+    Array<float3> expected(positions.size());
+    mesh::normals_calc_face_vert(
+        positions, small_mesh->faces(), small_mesh->corner_verts(), face_normals, expected);
+    EXPECT_EQ(small_mesh->vert_normals(), expected.as_span());
+    EXPECT_FALSE(small_mesh->runtime->vert_to_face_map_cache.is_cached());
+  }
+
+  /* The large mesh builds the map to gather the normals. */
+  {
+    const Span<float3> normals = large_mesh->vert_normals();
+    EXPECT_TRUE(large_mesh->runtime->vert_to_face_map_cache.is_cached());
+    const Span<float3> positions = large_mesh->vert_positions();
+    Array<float3> face_normals(large_mesh->faces_num);
+    Array<float3> expected(positions.size());
+    mesh::normals_calc_faces(
+        positions, large_mesh->faces(), large_mesh->corner_verts(), face_normals);
+    mesh::normals_calc_verts(positions,
+                             large_mesh->faces(),
+                             large_mesh->corner_verts(),
+                             large_mesh->vert_to_face_map(),
+                             large_mesh->vert_to_corner_map(),
+                             face_normals,
+                             expected);
+    EXPECT_EQ(normals, expected.as_span());
+  }
+
+  /* Caching the map doesn't change the method used for the small mesh. */
+  const Array<float3> small_normals(small_mesh->vert_normals());
+  small_mesh->vert_to_face_map();
+  BKE_mesh_tag_positions_changed(small_mesh);
+  EXPECT_EQ(small_mesh->vert_normals(), small_normals.as_span());
+
+  BKE_id_free(nullptr, small_mesh);
+  BKE_id_free(nullptr, large_mesh);
+}
+
+}  // namespace blender::bke::tests
@@ -18,6 +18,7 @@
 #include "BLI_array.hh"
 #include "BLI_array_utils.hh"
 #include "BLI_index_range.hh"
+#include "BLI_math_base.h"
 #include "BLI_math_vector.h"
 #include "BLI_span.hh"
 #include "BLI_task.hh"
@@ -192,17 +193,26 @@ static openvdb::FloatGrid::Ptr remesh_voxel_level_set_create(const Mesh *mesh,
   std::vector<openvdb::Vec3s> points(mesh->totvert);
   std::vector<openvdb::Vec3I> triangles(looptris.size());
 
-  for (const int i : IndexRange(mesh->totvert)) {
-    const float3 &co = positions[i];
-    points[i] = openvdb::Vec3s(co.x, co.y, co.z);
-  }
-
-  for (const int i : IndexRange(looptris.size())) {
-    const MLoopTri &loop_tri = looptris[i];
-    triangles[i] = openvdb::Vec3I(corner_verts[loop_tri.tri[0]],
-                                  corner_verts[loop_tri.tri[1]],
-                                  corner_verts[loop_tri.tri[2]]);
-  }
+  blender::threading::parallel_invoke(
+      looptris.size() > 1024,
+      [&]() {
+        blender::threading::parallel_for(positions.index_range(), 4096, [&](const IndexRange range) {
+          for (const int i : range) {
+            const float3 &co = positions[i];
+            points[i] = openvdb::Vec3s(co.x, co.y, co.z);
+          }
+        });
+      },
+      [&]() {
+        blender::threading::parallel_for(looptris.index_range(), 4096, [&](const IndexRange range) {
+          for (const int i : range) {
+            const MLoopTri &loop_tri = looptris[i];
+            triangles[i] = openvdb::Vec3I(corner_verts[loop_tri.tri[0]],
+                                          corner_verts[loop_tri.tri[1]],
+                                          corner_verts[loop_tri.tri[2]]);
+          }
+        });
+      });
 
   openvdb::math::Transform::Ptr transform = openvdb::math::Transform::createLinearTransform(
       voxel_size);
@@ -236,24 +246,39 @@ static Mesh *remesh_voxel_volume_to_mesh(const openvdb::FloatGrid::Ptr level_set
         3, triangle_loop_start, face_offsets.drop_front(quads.size()));
   }
 
-  for (const int i : vert_positions.index_range()) {
-    vert_positions[i] = float3(vertices[i].x(), vertices[i].y(), vertices[i].z());
-  }
-
-  for (const int i : IndexRange(quads.size())) {
-    const int loopstart = i * 4;
-    mesh_corner_verts[loopstart] = quads[i][0];
-    mesh_corner_verts[loopstart + 1] = quads[i][3];
-    mesh_corner_verts[loopstart + 2] = quads[i][2];
-    mesh_corner_verts[loopstart + 3] = quads[i][1];
-  }
-
-  for (const int i : IndexRange(tris.size())) {
-    const int loopstart = triangle_loop_start + i * 3;
-    mesh_corner_verts[loopstart] = tris[i][2];
-    mesh_corner_verts[loopstart + 1] = tris[i][1];
-    mesh_corner_verts[loopstart + 2] = tris[i][0];
-  }
+  blender::threading::parallel_invoke(
+      vertices.size() > 1024,
+      [&]() {
+        blender::threading::parallel_for(
+            vert_positions.index_range(), 4096, [&](const IndexRange range) {
+              for (const int i : range) {
+                vert_positions[i] = float3(vertices[i].x(), vertices[i].y(), vertices[i].z());
+              }
+            });
+      },
+      [&]() {
+        blender::threading::parallel_for(
+            IndexRange(quads.size()), 4096, [&](const IndexRange range) {
+              for (const int i : range) {
+                const int loopstart = i * 4;
+                mesh_corner_verts[loopstart] = quads[i][0];
+                mesh_corner_verts[loopstart + 1] = quads[i][3];
+                mesh_corner_verts[loopstart + 2] = quads[i][2];
+                mesh_corner_verts[loopstart + 3] = quads[i][1];
+              }
+            });
+      },
+      [&]() {
+        blender::threading::parallel_for(
+            IndexRange(tris.size()), 4096, [&](const IndexRange range) {
+              for (const int i : range) {
+                const int loopstart = triangle_loop_start + i * 3;
+                mesh_corner_verts[loopstart] = tris[i][2];
+                mesh_corner_verts[loopstart + 1] = tris[i][1];
+                mesh_corner_verts[loopstart + 2] = tris[i][0];
+              }
+            });
+      });
 
   BKE_mesh_calc_edges(mesh, false, false);
 
@@ -277,6 +302,49 @@ Mesh *BKE_mesh_remesh_voxel(const Mesh *mesh,
 #endif
 }
 
+/**
+ * Find the index of the nearest element in the BVH tree for every position, or -1 if there is
+ * none. The vertices of a remeshed result are generated in a spatially coherent order, so in
+ * each batch of queries the previous result gives a tight initial bound for the next query,
+ * which lets the tree traversal skip most nodes.
+ */
+static void find_nearest_batched(const BVHTreeFromMesh &bvhtree,
+                                 const Span<float3> positions,
+                                 MutableSpan<int> r_indices)
+{
+  BVHTreeFromMesh &bvhtree_data = const_cast<BVHTreeFromMesh &>(bvhtree);
+  /* The seed can decide between equally near elements, so the batches are fixed rather than left
+   * to the scheduler to keep the result the same from one run to the next. */
+  constexpr int64_t batch_size = 1024;
+  const int64_t batches_num = divide_ceil_ul(positions.size(), batch_size);
+  blender::threading::parallel_for(IndexRange(batches_num), 1, [&](const IndexRange batches) {
+    for (const int64_t batch : batches) {
+      const IndexRange range = positions.index_range().slice(
+          batch * batch_size, std::min(batch_size, positions.size() - batch * batch_size));
+      int prev_index = -1;
+      for (const int i : range) {
+        BVHTreeNearest nearest;
+        nearest.index = -1;
+        nearest.dist_sq = FLT_MAX;
+        if (prev_index != -1) {
+          if (bvhtree.nearest_callback) {
+            bvhtree.nearest_callback(&bvhtree_data, prev_index, positions[i], &nearest);
+          }
+          else {
+            nearest.index = prev_index;
+            nearest.dist_sq = len_squared_v3v3(positions[i],
+                                               bvhtree.vert_positions[prev_index]);
+          }
+        }
+        BLI_bvhtree_find_nearest(
+            bvhtree.tree, positions[i], &nearest, bvhtree.nearest_callback, &bvhtree_data);
+        r_indices[i] = nearest.index;
+        prev_index = nearest.index;
+      }
+    }
+  });
+}
+
 void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, const Mesh *source)
 {
   BVHTreeFromMesh bvhtree = {nullptr};
@@ -297,15 +365,12 @@ void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, const Mesh *source)
         &target->vert_data, CD_PAINT_MASK, CD_CONSTRUCT, target->totvert);
   }
 
+  Array<int> nearest_src_verts(target->totvert);
+  find_nearest_batched(bvhtree, target_positions, nearest_src_verts);
   blender::threading::parallel_for(IndexRange(target->totvert), 4096, [&](const IndexRange range) {
     for (const int i : range) {
-      BVHTreeNearest nearest;
-      nearest.index = -1;
-      nearest.dist_sq = FLT_MAX;
-      BLI_bvhtree_find_nearest(
-          bvhtree.tree, target_positions[i], &nearest, bvhtree.nearest_callback, &bvhtree);
-      if (nearest.index != -1) {
-        target_mask[i] = source_mask[nearest.index];
+      if (nearest_src_verts[i] != -1) {
+        target_mask[i] = source_mask[nearest_src_verts[i]];
       }
     }
   });
@@ -339,24 +404,22 @@ void BKE_remesh_reproject_sculpt_face_sets(Mesh *target, const Mesh *source)
   BVHTreeFromMesh bvhtree = {nullptr};
   BKE_bvhtree_from_mesh_get(&bvhtree, source, BVHTREE_FROM_LOOPTRI, 2);
 
-  blender::threading::parallel_for(
-      IndexRange(target->faces_num), 2048, [&](const IndexRange range) {
-        for (const int i : range) {
-          BVHTreeNearest nearest;
-          nearest.index = -1;
-          nearest.dist_sq = FLT_MAX;
-          const float3 from_co = mesh::face_center_calc(
-              target_positions, target_corner_verts.slice(target_polys[i]));
-          BLI_bvhtree_find_nearest(
-              bvhtree.tree, from_co, &nearest, bvhtree.nearest_callback, &bvhtree);
-          if (nearest.index != -1) {
-            dst[i] = src[looptri_faces[nearest.index]];
-          }
-          else {
-            dst[i] = 1;
-          }
-        }
-      });
+  Array<float3> face_centers(target->faces_num);
+  threading::parallel_for(target_polys.index_range(), 2048, [&](const IndexRange range) {
+    for (const int i : range) {
+      face_centers[i] = mesh::face_center_calc(target_positions,
+                                               target_corner_verts.slice(target_polys[i]));
+    }
+  });
+  Array<int> nearest_src_tris(target->faces_num);
+  find_nearest_batched(bvhtree, face_centers, nearest_src_tris);
+
+  threading::parallel_for(target_polys.index_range(), 2048, [&](const IndexRange range) {
+    for (const int i : range) {
+      const int src_tri = nearest_src_tris[i];
+      dst[i] = (src_tri == -1) ? 1 : src[looptri_faces[src_tri]];
+    }
+  });
   free_bvhtree_from_mesh(&bvhtree);
   dst_face_sets.finish();
 }
@@ -410,16 +473,7 @@ void BKE_remesh_reproject_vertex_paint(Mesh *target, const Mesh *source)
 
   const Span<float3> target_positions = target->vert_positions();
   Array<int> nearest_src_verts(target_positions.size());
-  threading::parallel_for(target_positions.index_range(), 1024, [&](const IndexRange range) {
-    for (const int i : range) {
-      BVHTreeNearest nearest;
-      nearest.index = -1;
-      nearest.dist_sq = FLT_MAX;
-      BLI_bvhtree_find_nearest(
-          bvhtree.tree, target_positions[i], &nearest, bvhtree.nearest_callback, &bvhtree);
-      nearest_src_verts[i] = nearest.index;
-    }
-  });
+  find_nearest_batched(bvhtree, target_positions, nearest_src_verts);
 
   for (const AttributeIDRef &id : point_ids) {
     const GVArraySpan src = *src_attributes.lookup(id, ATTR_DOMAIN_POINT);
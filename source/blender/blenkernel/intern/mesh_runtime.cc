@@ -14,6 +14,7 @@
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 
+#include "BLI_array_utils.hh"
 #include "BLI_math_geom.h"
 #include "BLI_task.hh"
 #include "BLI_timeit.hh"
@@ -22,6 +23,7 @@
 #include "BKE_editmesh_cache.hh"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.hh"
+#include "BKE_mesh_mapping.hh"
 #include "BKE_mesh_runtime.hh"
 #include "BKE_shrinkwrap.h"
 #include "BKE_subdiv_ccg.hh"
@@ -183,6 +185,34 @@ void Mesh::tag_loose_edges_none() const
   try_tag_verts_no_face_none(*this);
 }
 
+static const blender::bke::VertToFaceMapCache &ensure_vert_to_face_map(const Mesh &mesh)
+{
+  using namespace blender;
+  mesh.runtime->vert_to_face_map_cache.ensure([&](bke::VertToFaceMapCache &r_data) {
+    const GroupedSpan<int> vert_to_corner = bke::mesh::build_vert_to_loop_map(
+        mesh.corner_verts(), mesh.totvert, r_data.offsets, r_data.corner_indices);
+    /* Corners are visited in increasing order, so the faces are sorted too. */
+    const Array<int> corner_to_face = bke::mesh::build_loop_to_face_map(mesh.faces());
+    r_data.face_indices.reinitialize(vert_to_corner.data.size());
+    array_utils::gather(corner_to_face.as_span(),
+                        r_data.corner_indices.as_span(),
+                        r_data.face_indices.as_mutable_span());
+  });
+  return mesh.runtime->vert_to_face_map_cache.data();
+}
+
+blender::GroupedSpan<int> Mesh::vert_to_face_map() const
+{
+  const blender::bke::VertToFaceMapCache &cache = ensure_vert_to_face_map(*this);
+  return {blender::OffsetIndices<int>(cache.offsets), cache.face_indices};
+}
+
+blender::GroupedSpan<int> Mesh::vert_to_corner_map() const
+{
+  const blender::bke::VertToFaceMapCache &cache = ensure_vert_to_face_map(*this);
+  return {blender::OffsetIndices<int>(cache.offsets), cache.corner_indices};
+}
+
 blender::Span<MLoopTri> Mesh::looptris() const
 {
   this->runtime->looptris_cache.ensure([&](blender::Array<MLoopTri> &r_data) {
@@ -267,6 +297,7 @@ void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
   mesh->runtime->loose_edges_cache.tag_dirty();
   mesh->runtime->loose_verts_cache.tag_dirty();
   mesh->runtime->verts_no_face_cache.tag_dirty();
+  mesh->runtime->vert_to_face_map_cache.tag_dirty();
   mesh->runtime->looptris_cache.tag_dirty();
   mesh->runtime->looptri_faces_cache.tag_dirty();
   mesh->runtime->subsurf_face_dot_tags.clear_and_shrink();
@@ -319,7 +350,11 @@ void BKE_mesh_tag_positions_changed(Mesh *mesh)
   mesh->runtime->vert_normals_dirty = true;
   mesh->runtime->face_normals_dirty = true;
   free_bvh_cache(*mesh->runtime);
-  mesh->runtime->looptris_cache.tag_dirty();
+  /* When all faces are triangles the triangulation doesn't depend on positions. Every face has at
+   * least three corners, so that is the case exactly when there are three corners per face. */
+  if (mesh->totloop != mesh->faces_num * 3) {
+    mesh->runtime->looptris_cache.tag_dirty();
+  }
   mesh->runtime->bounds_cache.tag_dirty();
 }
 
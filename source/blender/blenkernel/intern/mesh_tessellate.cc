@@ -11,11 +11,9 @@
  * \see `bmesh_mesh_tessellate.cc` for the #BMesh equivalent of this file.
  */
 
-#include "BLI_enumerable_thread_specific.hh"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
 #include "BLI_polyfill_2d.h"
-#include "BLI_task.h"
 #include "BLI_task.hh"
 
 #include "BKE_mesh.hh"
@@ -24,9 +22,6 @@
 
 namespace blender::bke::mesh {
 
-/** Compared against total loops. */
-#define MESH_FACE_TESSELLATE_THREADED_LIMIT 4096
-
 /* -------------------------------------------------------------------- */
 /** \name Loop Tessellation
  *
@@ -133,121 +128,98 @@ BLI_INLINE void mesh_calc_tessellation_for_face_impl(const Span<int> corner_vert
 #undef ML_TO_MLT
 }
 
-static void mesh_calc_tessellation_for_face(const Span<int> corner_verts,
-                                            const blender::OffsetIndices<int> faces,
-                                            const Span<float3> positions,
-                                            uint face_index,
-                                            MLoopTri *mlt,
-                                            MemArena **pf_arena_p)
+/**
+ * Triangulate a range of faces made only of triangles, their corners map directly to triangles.
+ */
+static void looptris_calc_range_tris(const IndexRange corners, MutableSpan<MLoopTri> looptris)
 {
-  mesh_calc_tessellation_for_face_impl(
-      corner_verts, faces, positions, face_index, mlt, pf_arena_p, false, nullptr);
+  BLI_assert(looptris.size() * 3 == corners.size());
+  for (const int64_t i : looptris.index_range()) {
+    const uint start = uint(corners.start() + i * 3);
+    looptris[i].tri[0] = start;
+    looptris[i].tri[1] = start + 1;
+    looptris[i].tri[2] = start + 2;
+  }
 }
 
-static void mesh_calc_tessellation_for_face_with_normal(const Span<int> corner_verts,
-                                                        const blender::OffsetIndices<int> faces,
-                                                        const Span<float3> positions,
-                                                        uint face_index,
-                                                        MLoopTri *mlt,
-                                                        MemArena **pf_arena_p,
-                                                        const float normal_precalc[3])
+/**
+ * Triangulate a range of faces made only of quads, avoiding per face size checks.
+ */
+static void looptris_calc_range_quads(const Span<float3> positions,
+                                      const Span<int> corner_verts,
+                                      const IndexRange corners,
+                                      MutableSpan<MLoopTri> looptris)
 {
-  mesh_calc_tessellation_for_face_impl(
-      corner_verts, faces, positions, face_index, mlt, pf_arena_p, true, normal_precalc);
+  BLI_assert(looptris.size() * 2 == corners.size());
+  for (const int64_t i : IndexRange(corners.size() / 4)) {
+    const uint start = uint(corners.start() + i * 4);
+    const bool flip = is_quad_flip_v3_first_third_fast(positions[corner_verts[start]],
+                                                       positions[corner_verts[start + 1]],
+                                                       positions[corner_verts[start + 2]],
+                                                       positions[corner_verts[start + 3]]);
+    /* When flipped, split along 1-3 to get out of the degenerate 0-2 state. */
+    MLoopTri &mlt_a = looptris[i * 2];
+    MLoopTri &mlt_b = looptris[i * 2 + 1];
+    mlt_a.tri[0] = start;
+    mlt_a.tri[1] = start + 1;
+    mlt_a.tri[2] = start + (flip ? 3 : 2);
+    mlt_b.tri[0] = start + (flip ? 1 : 0);
+    mlt_b.tri[1] = start + 2;
+    mlt_b.tri[2] = start + 3;
+  }
 }
 
-static void mesh_recalc_looptri__single_threaded(const Span<int> corner_verts,
-                                                 const blender::OffsetIndices<int> faces,
-                                                 const Span<float3> positions,
-                                                 MLoopTri *mlooptri,
-                                                 const float (*face_normals)[3])
+static bool faces_are_all_quads(const OffsetIndices<int> faces, const IndexRange range)
 {
-  MemArena *pf_arena = nullptr;
-  uint looptri_i = 0;
-
-  if (face_normals != nullptr) {
-    for (const int64_t i : faces.index_range()) {
-      mesh_calc_tessellation_for_face_with_normal(corner_verts,
-                                                  faces,
-                                                  positions,
-                                                  uint(i),
-                                                  &mlooptri[looptri_i],
-                                                  &pf_arena,
-                                                  face_normals[i]);
-      looptri_i += uint(faces[i].size() - 2);
-    }
-  }
-  else {
-    for (const int64_t i : faces.index_range()) {
-      mesh_calc_tessellation_for_face(
-          corner_verts, faces, positions, uint(i), &mlooptri[looptri_i], &pf_arena);
-      looptri_i += uint(faces[i].size() - 2);
+  for (const int64_t i : range) {
+    if (faces[i].size() != 4) {
+      return false;
     }
   }
-
-  if (pf_arena) {
-    BLI_memarena_free(pf_arena);
-    pf_arena = nullptr;
-  }
-  BLI_assert(looptri_i == uint(poly_to_tri_count(int(faces.size()), int(corner_verts.size()))));
-}
-
-struct TessellationUserData {
-  Span<int> corner_verts;
-  blender::OffsetIndices<int> faces;
-  Span<float3> positions;
-
-  /** Output array. */
-  MutableSpan<MLoopTri> mlooptri;
-
-  /** Optional pre-calculated face normals array. */
-  const float (*face_normals)[3];
-};
-
-struct TessellationUserTLS {
-  MemArena *pf_arena;
-};
-
-static void mesh_calc_tessellation_for_face_fn(void *__restrict userdata,
-                                               const int index,
-                                               const TaskParallelTLS *__restrict tls)
-{
-  const TessellationUserData *data = static_cast<const TessellationUserData *>(userdata);
-  TessellationUserTLS *tls_data = static_cast<TessellationUserTLS *>(tls->userdata_chunk);
-  const int looptri_i = poly_to_tri_count(index, int(data->faces[index].start()));
-  mesh_calc_tessellation_for_face_impl(data->corner_verts,
-                                       data->faces,
-                                       data->positions,
-                                       uint(index),
-                                       &data->mlooptri[looptri_i],
-                                       &tls_data->pf_arena,
-                                       false,
-                                       nullptr);
+  return true;
 }
 
-static void mesh_calc_tessellation_for_face_with_normal_fn(void *__restrict userdata,
-                                                           const int index,
-                                                           const TaskParallelTLS *__restrict tls)
+/**
+ * Triangulate a range of faces, \a face_normals may be empty.
+ * Ranges made only of triangles or quads use simpler code paths,
+ * the polygon fill arena is only allocated if the range contains n-gons.
+ */
+static void looptris_calc_range(const Span<float3> positions,
+                                const OffsetIndices<int> faces,
+                                const Span<int> corner_verts,
+                                const Span<float3> face_normals,
+                                const IndexRange range,
+                                MutableSpan<MLoopTri> looptris)
 {
-  const TessellationUserData *data = static_cast<const TessellationUserData *>(userdata);
-  TessellationUserTLS *tls_data = static_cast<TessellationUserTLS *>(tls->userdata_chunk);
-  const int looptri_i = poly_to_tri_count(index, int(data->faces[index].start()));
-  mesh_calc_tessellation_for_face_impl(data->corner_verts,
-                                       data->faces,
-                                       data->positions,
-                                       uint(index),
-                                       &data->mlooptri[looptri_i],
-                                       &tls_data->pf_arena,
-                                       true,
-                                       data->face_normals[index]);
-}
+  const IndexRange corners = faces[range];
+  const int looptri_start = poly_to_tri_count(int(range.start()), int(corners.start()));
+  const int looptri_num = poly_to_tri_count(int(range.size()), int(corners.size()));
+  MutableSpan<MLoopTri> range_looptris = looptris.slice(looptri_start, looptri_num);
+
+  /* Every face has at least three corners, so this is only true when all faces are triangles. */
+  if (corners.size() == range.size() * 3) {
+    looptris_calc_range_tris(corners, range_looptris);
+    return;
+  }
+  if (corners.size() == range.size() * 4 && faces_are_all_quads(faces, range)) {
+    looptris_calc_range_quads(positions, corner_verts, corners, range_looptris);
+    return;
+  }
 
-static void mesh_calc_tessellation_for_face_free_fn(const void *__restrict /*userdata*/,
-                                                    void *__restrict tls_v)
-{
-  TessellationUserTLS *tls_data = static_cast<TessellationUserTLS *>(tls_v);
-  if (tls_data->pf_arena) {
-    BLI_memarena_free(tls_data->pf_arena);
+  MemArena *pf_arena = nullptr;
+  for (const int64_t i : range) {
+    const int looptri_i = poly_to_tri_count(int(i), int(faces[i].start()));
+    mesh_calc_tessellation_for_face_impl(corner_verts,
+                                         faces,
+                                         positions,
+                                         uint(i),
+                                         &looptris[looptri_i],
+                                         &pf_arena,
+                                         !face_normals.is_empty(),
+                                         face_normals.is_empty() ? nullptr : &face_normals[i].x);
+  }
+  if (pf_arena) {
+    BLI_memarena_free(pf_arena);
   }
 }
 
@@ -257,37 +229,9 @@ static void looptris_calc_all(const Span<float3> positions,
                               const Span<float3> face_normals,
                               MutableSpan<MLoopTri> looptris)
 {
-  if (corner_verts.size() < MESH_FACE_TESSELLATE_THREADED_LIMIT) {
-    mesh_recalc_looptri__single_threaded(corner_verts,
-                                         faces,
-                                         positions,
-                                         looptris.data(),
-                                         reinterpret_cast<const float(*)[3]>(face_normals.data()));
-    return;
-  }
-  TessellationUserTLS tls_data_dummy = {nullptr};
-
-  TessellationUserData data{};
-  data.corner_verts = corner_verts;
-  data.faces = faces;
-  data.positions = positions;
-  data.mlooptri = looptris;
-  data.face_normals = reinterpret_cast<const float(*)[3]>(face_normals.data());
-
-  TaskParallelSettings settings;
-  BLI_parallel_range_settings_defaults(&settings);
-
-  settings.userdata_chunk = &tls_data_dummy;
-  settings.userdata_chunk_size = sizeof(tls_data_dummy);
-
-  settings.func_free = mesh_calc_tessellation_for_face_free_fn;
-
-  BLI_task_parallel_range(0,
-                          int(faces.size()),
-                          &data,
-                          data.face_normals ? mesh_calc_tessellation_for_face_with_normal_fn :
-                                              mesh_calc_tessellation_for_face_fn,
-                          &settings);
+  threading::parallel_for(faces.index_range(), 1024, [&](const IndexRange range) {
+    looptris_calc_range(positions, faces, corner_verts, face_normals, range, looptris);
+  });
 }
 
 void looptris_calc(const Span<float3> vert_positions,
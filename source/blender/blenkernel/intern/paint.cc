@@ -2232,6 +2232,9 @@ static PBVH *build_pbvh_from_regular_mesh(Object *ob, Mesh *me_eval_deform)
 {
   Mesh *me = BKE_object_get_original_mesh(ob);
   PBVH *pbvh = BKE_pbvh_new(PBVH_FACES);
+  if (U.experimental.use_sculpt_pbvh_sah) {
+    BKE_pbvh_split_method_set(pbvh, PBVH_SPLIT_SAH);
+  }
 
   BKE_pbvh_build_mesh(pbvh, me);
 
@@ -2251,6 +2254,9 @@ static PBVH *build_pbvh_from_ccg(Object *ob, SubdivCCG *subdiv_ccg)
   CCGKey key;
   BKE_subdiv_ccg_key_top_level(&key, subdiv_ccg);
   PBVH *pbvh = BKE_pbvh_new(PBVH_GRIDS);
+  if (U.experimental.use_sculpt_pbvh_sah) {
+    BKE_pbvh_split_method_set(pbvh, PBVH_SPLIT_SAH);
+  }
 
   Mesh *base_mesh = BKE_mesh_from_object(ob);
   BKE_sculpt_sync_face_visibility_to_grids(base_mesh, subdiv_ccg);
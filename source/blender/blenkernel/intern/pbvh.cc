@@ -43,6 +43,7 @@
 #include "pbvh_intern.hh"
 
 using blender::float3;
+using blender::IndexRange;
 using blender::MutableSpan;
 using blender::Span;
 using blender::Vector;
@@ -295,13 +296,16 @@ void pbvh_grow_nodes(PBVH *pbvh, int totnode)
 
 /* Add a vertex to the map, with a positive value for unique vertices and
  * a negative value for additional vertices */
-static int map_insert_vert(
-    PBVH *pbvh, blender::Map<int, int> &map, int *face_verts, int *uniq_verts, int vertex)
+static int map_insert_vert(blender::Map<int, int> &map,
+                           const Span<int> vert_owners,
+                           const int leaf_index,
+                           int *face_verts,
+                           int *uniq_verts,
+                           int vertex)
 {
   return map.lookup_or_add_cb(vertex, [&]() {
     int value;
-    if (!pbvh->vert_bitmap[vertex]) {
-      pbvh->vert_bitmap[vertex] = true;
+    if (vert_owners[vertex] == leaf_index) {
       value = *uniq_verts;
       (*uniq_verts)++;
     }
@@ -313,8 +317,46 @@ static int map_insert_vert(
   });
 }
 
+/* Lower the stored value to the given value if it is smaller, safe to call from multiple threads.
+ */
+static void atomic_min_int32(int *value, const int new_value)
+{
+  int old_value = *value;
+  while (new_value < old_value) {
+    const int prev_value = atomic_cas_int32(value, old_value, new_value);
+    if (prev_value == old_value) {
+      break;
+    }
+    old_value = prev_value;
+  }
+}
+
+/**
+ * A vertex is "unique" in the first leaf (in build order) that uses it. Finding the owners of all
+ * vertices up front allows building the leaves in parallel with the same result as building them
+ * one after another.
+ */
+static blender::Array<int> calc_vert_owners(const PBVH &pbvh, const Span<int> leaf_nodes)
+{
+  blender::Array<int> vert_owners(pbvh.totvert, INT_MAX);
+  blender::threading::parallel_for(leaf_nodes.index_range(), 1, [&](const IndexRange range) {
+    for (const int leaf_index : range) {
+      const PBVHNode &node = pbvh.nodes[leaf_nodes[leaf_index]];
+      for (const int looptri : node.prim_indices) {
+        for (const int corner : pbvh.looptri[looptri].tri) {
+          atomic_min_int32(&vert_owners[pbvh.corner_verts[corner]], leaf_index);
+        }
+      }
+    }
+  });
+  return vert_owners;
+}
+
 /* Find vertices used by the faces in this node and update the draw buffers */
-static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
+static void build_mesh_leaf_node(PBVH *pbvh,
+                                 PBVHNode *node,
+                                 const Span<int> vert_owners,
+                                 const int leaf_index)
 {
   bool has_visible = false;
 
@@ -330,8 +372,12 @@ static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
   for (int i = 0; i < totface; i++) {
     const MLoopTri *lt = &pbvh->looptri[node->prim_indices[i]];
     for (int j = 0; j < 3; j++) {
-      node->face_vert_indices[i][j] = map_insert_vert(
-          pbvh, map, &node->face_verts, &node->uniq_verts, pbvh->corner_verts[lt->tri[j]]);
+      node->face_vert_indices[i][j] = map_insert_vert(map,
+                                                      vert_owners,
+                                                      leaf_index,
+                                                      &node->face_verts,
+                                                      &node->uniq_verts,
+                                                      pbvh->corner_verts[lt->tri[j]]);
     }
 
     if (has_visible == false) {
@@ -369,15 +415,6 @@ static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
   BKE_pbvh_node_fully_hidden_set(node, !has_visible);
 }
 
-static void update_vb(PBVH *pbvh, PBVHNode *node, const Span<BBC> prim_bbc, int offset, int count)
-{
-  BB_reset(&node->vb);
-  for (int i = offset + count - 1; i >= offset; i--) {
-    BB_expand_with_bb(&node->vb, (BB *)(&prim_bbc[pbvh->prim_indices[i]]));
-  }
-  node->orig_vb = node->vb;
-}
-
 int BKE_pbvh_count_grid_quads(BLI_bitmap **grid_hidden,
                               const int *grid_indices,
                               int totgrid,
@@ -427,23 +464,6 @@ static void build_grid_leaf_node(PBVH *pbvh, PBVHNode *node)
   BKE_pbvh_node_mark_rebuild_draw(node);
 }
 
-static void build_leaf(PBVH *pbvh, int node_index, const Span<BBC> prim_bbc, int offset, int count)
-{
-  pbvh->nodes[node_index].flag |= PBVH_Leaf;
-
-  pbvh->nodes[node_index].prim_indices = pbvh->prim_indices.as_span().slice(offset, count);
-
-  /* Still need vb for searches */
-  update_vb(pbvh, &pbvh->nodes[node_index], prim_bbc, offset, count);
-
-  if (!pbvh->looptri.is_empty()) {
-    build_mesh_leaf_node(pbvh, &pbvh->nodes[node_index]);
-  }
-  else {
-    build_grid_leaf_node(pbvh, &pbvh->nodes[node_index]);
-  }
-}
-
 /* Return zero if all primitives in the node can be drawn with the
  * same material (including flat/smooth shading), non-zero otherwise */
 static bool leaf_needs_material_split(
@@ -524,21 +544,113 @@ static void test_face_boundaries(PBVH *pbvh)
 }
 #endif
 
+/**
+ * Node of the tree created while partitioning the primitives. The partitioning is done in
+ * parallel, so the nodes are only added to #PBVH::nodes afterwards, in a deterministic order.
+ */
+struct BuildNode {
+  int offset;
+  int count;
+  /** Bounds of all primitives in the node. */
+  BB vb;
+  /** Both children are null for leaf nodes. */
+  std::unique_ptr<BuildNode> children[2];
+};
+
+/** Nodes with fewer primitives are partitioned on the current thread. */
+#define BUILD_THREADING_LIMIT 8192
+
+/** Number of bins used to evaluate candidate split planes with the surface area heuristic. */
+#define SAH_BINS_NUM 16
+
+static float BB_surface_area(const BB *bb)
+{
+  const float3 size = float3(bb->bmax) - float3(bb->bmin);
+  return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+/**
+ * Find the split position along the axis that minimizes the surface area heuristic, by sorting
+ * the primitive centroids into bins and evaluating the planes between those bins. Returns the
+ * middle of the centroid bounds when no plane separates the primitives.
+ */
+static float sah_split_position(const PBVH *pbvh,
+                                const BB *cb,
+                                const int axis,
+                                const Span<BBC> prim_bbc,
+                                const int offset,
+                                const int count)
+{
+  const float mid = (cb->bmax[axis] + cb->bmin[axis]) * 0.5f;
+  const float extent = cb->bmax[axis] - cb->bmin[axis];
+  if (extent <= 0.0f) {
+    return mid;
+  }
+  const float scale = SAH_BINS_NUM / extent;
+
+  BB bin_bounds[SAH_BINS_NUM];
+  int bin_counts[SAH_BINS_NUM] = {0};
+  for (BB &bb : bin_bounds) {
+    BB_reset(&bb);
+  }
+  for (int i = offset; i < offset + count; i++) {
+    const BBC &bbc = prim_bbc[pbvh->prim_indices[i]];
+    const int bin = std::clamp(
+        int((bbc.bcentroid[axis] - cb->bmin[axis]) * scale), 0, SAH_BINS_NUM - 1);
+    bin_counts[bin]++;
+    BB_expand_with_bb(&bin_bounds[bin], (const BB *)&bbc);
+  }
+
+  /* Accumulate the cost of the right side of every plane, then sweep from the left. */
+  float right_costs[SAH_BINS_NUM];
+  BB right_bb;
+  BB_reset(&right_bb);
+  int right_count = 0;
+  for (int bin = SAH_BINS_NUM - 1; bin > 0; bin--) {
+    BB_expand_with_bb(&right_bb, &bin_bounds[bin]);
+    right_count += bin_counts[bin];
+    right_costs[bin] = right_count == 0 ? 0.0f : BB_surface_area(&right_bb) * right_count;
+  }
+
+  float best_cost = FLT_MAX;
+  int best_plane = -1;
+  BB left_bb;
+  BB_reset(&left_bb);
+  int left_count = 0;
+  for (int plane = 1; plane < SAH_BINS_NUM; plane++) {
+    BB_expand_with_bb(&left_bb, &bin_bounds[plane - 1]);
+    left_count += bin_counts[plane - 1];
+    if (left_count == 0 || left_count == count) {
+      continue;
+    }
+    const float cost = BB_surface_area(&left_bb) * left_count + right_costs[plane];
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_plane = plane;
+    }
+  }
+
+  if (best_plane == -1) {
+    return mid;
+  }
+  return cb->bmin[axis] + best_plane / scale;
+}
+
 /* Recursively build a node in the tree
- *
- * vb is the voxel box around all of the primitives contained in
- * this node.
  *
  * cb is the bounding box around all the centroids of the primitives
  * contained in this node
  *
- * offset and start indicate a range in the array of primitive indices
+ * offset and count indicate a range in the array of primitive indices
+ *
+ * prim_scratch is a buffer with the same size as the primitive indices, every node only uses the
+ * part corresponding to its own range, so that sub-trees can be built in parallel.
  */
 
 static void build_sub(PBVH *pbvh,
                       const int *material_indices,
                       const bool *sharp_faces,
-                      int node_index,
+                      BuildNode &node,
                       BB *cb,
                       const Span<BBC> prim_bbc,
                       int offset,
@@ -549,31 +661,22 @@ static void build_sub(PBVH *pbvh,
   int end;
   BB cb_backing;
 
-  if (!prim_scratch) {
-    prim_scratch = static_cast<int *>(MEM_malloc_arrayN(pbvh->totprim, sizeof(int), __func__));
-  }
+  node.offset = offset;
+  node.count = count;
 
   /* Decide whether this is a leaf or not */
   const bool below_leaf_limit = count <= pbvh->leaf_limit || depth >= STACK_FIXED_DEPTH - 1;
   if (below_leaf_limit) {
     if (!leaf_needs_material_split(pbvh, material_indices, sharp_faces, offset, count)) {
-      build_leaf(pbvh, node_index, prim_bbc, offset, count);
-
-      if (node_index == 0) {
-        MEM_SAFE_FREE(prim_scratch);
+      /* Still need vb for searches */
+      BB_reset(&node.vb);
+      for (int i = offset + count - 1; i >= offset; i--) {
+        BB_expand_with_bb(&node.vb, (BB *)(&prim_bbc[pbvh->prim_indices[i]]));
       }
-
       return;
     }
   }
 
-  /* Add two child nodes */
-  pbvh->nodes[node_index].children_offset = pbvh->nodes.size();
-  pbvh_grow_nodes(pbvh, pbvh->nodes.size() + 2);
-
-  /* Update parent node bounding box */
-  update_vb(pbvh, &pbvh->nodes[node_index], prim_bbc, offset, count);
-
   if (!below_leaf_limit) {
     /* Find axis with widest range of primitive centroids */
     if (!cb) {
@@ -584,25 +687,28 @@ static void build_sub(PBVH *pbvh,
       }
     }
     const int axis = BB_widest_axis(cb);
+    const float split_position = pbvh->split_method == PBVH_SPLIT_SAH ?
+                                     sah_split_position(pbvh, cb, axis, prim_bbc, offset, count) :
+                                     (cb->bmax[axis] + cb->bmin[axis]) * 0.5f;
 
     /* Partition primitives along that axis */
     if (pbvh->header.type == PBVH_FACES) {
       end = partition_indices_faces(pbvh->prim_indices,
-                                    prim_scratch,
+                                    prim_scratch + offset,
                                     offset,
                                     offset + count,
                                     axis,
-                                    (cb->bmax[axis] + cb->bmin[axis]) * 0.5f,
+                                    split_position,
                                     prim_bbc,
                                     pbvh->looptri_faces);
     }
     else {
       end = partition_indices_grids(pbvh->prim_indices,
-                                    prim_scratch,
+                                    prim_scratch + offset,
                                     offset,
                                     offset + count,
                                     axis,
-                                    (cb->bmax[axis] + cb->bmin[axis]) * 0.5f,
+                                    split_position,
                                     prim_bbc,
                                     pbvh->subdiv_ccg);
     }
@@ -614,30 +720,74 @@ static void build_sub(PBVH *pbvh,
   }
 
   /* Build children */
-  build_sub(pbvh,
-            material_indices,
-            sharp_faces,
-            pbvh->nodes[node_index].children_offset,
-            nullptr,
-            prim_bbc,
-            offset,
-            end - offset,
-            prim_scratch,
-            depth + 1);
-  build_sub(pbvh,
-            material_indices,
-            sharp_faces,
-            pbvh->nodes[node_index].children_offset + 1,
-            nullptr,
-            prim_bbc,
-            end,
-            offset + count - end,
-            prim_scratch,
-            depth + 1);
-
-  if (node_index == 0) {
-    MEM_SAFE_FREE(prim_scratch);
+  node.children[0] = std::make_unique<BuildNode>();
+  node.children[1] = std::make_unique<BuildNode>();
+  blender::threading::parallel_invoke(
+      count > BUILD_THREADING_LIMIT,
+      [&]() {
+        build_sub(pbvh,
+                  material_indices,
+                  sharp_faces,
+                  *node.children[0],
+                  nullptr,
+                  prim_bbc,
+                  offset,
+                  end - offset,
+                  prim_scratch,
+                  depth + 1);
+      },
+      [&]() {
+        build_sub(pbvh,
+                  material_indices,
+                  sharp_faces,
+                  *node.children[1],
+                  nullptr,
+                  prim_bbc,
+                  end,
+                  offset + count - end,
+                  prim_scratch,
+                  depth + 1);
+      });
+
+  /* Update parent node bounding box */
+  node.vb = node.children[0]->vb;
+  BB_expand_with_bb(&node.vb, &node.children[1]->vb);
+}
+
+/**
+ * Add the built nodes to #PBVH::nodes, depth first with the children of every node stored next
+ * to each other. The indices of leaf nodes are added to \a r_leaf_nodes in the same order.
+ */
+static void add_build_nodes(PBVH *pbvh,
+                            const BuildNode &build_node,
+                            const int node_index,
+                            Vector<int> &r_leaf_nodes)
+{
+  PBVHNode &node = pbvh->nodes[node_index];
+  node.vb = build_node.vb;
+  node.orig_vb = build_node.vb;
+
+  if (!build_node.children[0]) {
+    node.flag |= PBVH_Leaf;
+    node.prim_indices = pbvh->prim_indices.as_span().slice(build_node.offset, build_node.count);
+    r_leaf_nodes.append(node_index);
+    return;
   }
+
+  const int children_offset = pbvh->nodes.size();
+  node.children_offset = children_offset;
+  pbvh_grow_nodes(pbvh, children_offset + 2);
+
+  add_build_nodes(pbvh, *build_node.children[0], children_offset, r_leaf_nodes);
+  add_build_nodes(pbvh, *build_node.children[1], children_offset + 1, r_leaf_nodes);
+}
+
+static int count_build_nodes(const BuildNode &node)
+{
+  if (!node.children[0]) {
+    return 1;
+  }
+  return 1 + count_build_nodes(*node.children[0]) + count_build_nodes(*node.children[1]);
 }
 
 static void pbvh_build(PBVH *pbvh,
@@ -655,9 +805,41 @@ static void pbvh_build(PBVH *pbvh,
     std::iota(pbvh->prim_indices.begin(), pbvh->prim_indices.end(), 0);
   }
 
+  BuildNode root;
+  {
+    blender::Array<int> prim_scratch(totprim);
+    build_sub(pbvh,
+              material_indices,
+              sharp_faces,
+              root,
+              cb,
+              prim_bbc,
+              0,
+              totprim,
+              prim_scratch.data(),
+              0);
+  }
+
+  pbvh->nodes.reserve(count_build_nodes(root));
   pbvh->nodes.resize(1);
+  Vector<int> leaf_nodes;
+  add_build_nodes(pbvh, root, 0, leaf_nodes);
 
-  build_sub(pbvh, material_indices, sharp_faces, 0, cb, prim_bbc, 0, totprim, nullptr, 0);
+  if (!pbvh->looptri.is_empty()) {
+    const blender::Array<int> vert_owners = calc_vert_owners(*pbvh, leaf_nodes);
+    blender::threading::parallel_for(leaf_nodes.index_range(), 1, [&](const IndexRange range) {
+      for (const int leaf_index : range) {
+        build_mesh_leaf_node(pbvh, &pbvh->nodes[leaf_nodes[leaf_index]], vert_owners, leaf_index);
+      }
+    });
+  }
+  else {
+    blender::threading::parallel_for(leaf_nodes.index_range(), 8, [&](const IndexRange range) {
+      for (const int leaf_index : range) {
+        build_grid_leaf_node(pbvh, &pbvh->nodes[leaf_nodes[leaf_index]]);
+      }
+    });
+  }
 }
 
 static void pbvh_draw_args_init(PBVH *pbvh, PBVH_GPU_Args *args, PBVHNode *node)
@@ -1013,6 +1195,11 @@ void BKE_pbvh_build_grids(PBVH *pbvh,
 #endif
 }
 
+void BKE_pbvh_split_method_set(PBVH *pbvh, const PBVHSplitMethod method)
+{
+  pbvh->split_method = method;
+}
+
 PBVH *BKE_pbvh_new(PBVHType type)
 {
   PBVH *pbvh = MEM_new<PBVH>(__func__);
@@ -147,6 +147,7 @@ struct PBVH {
   int leaf_limit;
   int pixel_leaf_limit;
   int depth_limit;
+  PBVHSplitMethod split_method = PBVH_SPLIT_MIDPOINT;
 
   /* Mesh data */
   Mesh *mesh;
@@ -0,0 +1,150 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cmath>
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.hh"
+#include "BKE_pbvh_api.hh"
+
+#include "pbvh_intern.hh"
+
+namespace blender::bke::tests {
+
+/**
+ * Create a grid of quads that is denser on one side, so that the split heuristics have to deal
+ * with primitives of different sizes.
+ */
+static Mesh *create_uneven_grid_mesh(const int size)
+{
+  const int verts_per_row = size + 1;
+  Mesh *mesh = BKE_mesh_new_nomain(verts_per_row * verts_per_row, 0, size * size, size * size * 4);
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int y : IndexRange(verts_per_row)) {
+    for (const int x : IndexRange(verts_per_row)) {
+      const float u = float(x) / size;
+      positions[y * verts_per_row + x] = float3(u * u, float(y) / size, std::sin(u * 6.0f));
+    }
+  }
+
+  MutableSpan<int> face_offsets = mesh->face_offsets_for_write();
+  MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      const int face = y * size + x;
+      const int v0 = y * verts_per_row + x;
+      face_offsets[face] = face * 4;
+      corner_verts[face * 4 + 0] = v0;
+      corner_verts[face * 4 + 1] = v0 + 1;
+      corner_verts[face * 4 + 2] = v0 + 1 + verts_per_row;
+      corner_verts[face * 4 + 3] = v0 + verts_per_row;
+    }
+  }
+  face_offsets.last() = size * size * 4;
+  return mesh;
+}
+
+static bool bb_contains(const BB &outer, const BB &inner)
+{
+  for (const int axis : IndexRange(3)) {
+    if (inner.bmin[axis] < outer.bmin[axis] || inner.bmax[axis] > outer.bmax[axis]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool bb_contains_point(const BB &bb, const float3 &point)
+{
+  for (const int axis : IndexRange(3)) {
+    if (point[axis] < bb.bmin[axis] || point[axis] > bb.bmax[axis]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Check that the leaves partition the triangles and the vertices, and that the bounds of every
+ * node contain its primitives and its children.
+ */
+static void expect_valid_partition(const PBVH &pbvh)
+{
+  Array<int> prim_leaf_count(pbvh.looptri.size(), 0);
+  Array<int> vert_owner_count(pbvh.totvert, 0);
+  int leaves_num = 0;
+
+  for (const PBVHNode &node : pbvh.nodes) {
+    if (!(node.flag & PBVH_Leaf)) {
+      EXPECT_TRUE(bb_contains(node.vb, pbvh.nodes[node.children_offset].vb));
+      EXPECT_TRUE(bb_contains(node.vb, pbvh.nodes[node.children_offset + 1].vb));
+      continue;
+    }
+    leaves_num++;
+    EXPECT_FALSE(node.prim_indices.is_empty());
+    EXPECT_LE(node.prim_indices.size(), pbvh.leaf_limit);
+    for (const int prim : node.prim_indices) {
+      prim_leaf_count[prim]++;
+      for (const int corner : pbvh.looptri[prim].tri) {
+        const int vert = pbvh.corner_verts[corner];
+        EXPECT_TRUE(bb_contains_point(node.vb, pbvh.vert_positions[vert]));
+      }
+    }
+    for (const int vert : node.vert_indices.as_span().take_front(node.uniq_verts)) {
+      vert_owner_count[vert]++;
+    }
+  }
+
+  EXPECT_GT(leaves_num, 1);
+  for (const int count : prim_leaf_count) {
+    EXPECT_EQ(count, 1);
+  }
+  for (const int count : vert_owner_count) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
+class PBVHBuildTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+TEST_F(PBVHBuildTest, MidpointPartition)
+{
+  Mesh *mesh = create_uneven_grid_mesh(150);
+  PBVH *pbvh = BKE_pbvh_new(PBVH_FACES);
+  BKE_pbvh_build_mesh(pbvh, mesh);
+
+  expect_valid_partition(*pbvh);
+
+  BKE_pbvh_free(pbvh);
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(PBVHBuildTest, SAHPartition)
+{
+  Mesh *mesh = create_uneven_grid_mesh(150);
+  PBVH *pbvh = BKE_pbvh_new(PBVH_FACES);
+  BKE_pbvh_split_method_set(pbvh, PBVH_SPLIT_SAH);
+  BKE_pbvh_build_mesh(pbvh, mesh);
+
+  EXPECT_EQ(pbvh->split_method, PBVH_SPLIT_SAH);
+  expect_valid_partition(*pbvh);
+
+  BKE_pbvh_free(pbvh);
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::bke::tests
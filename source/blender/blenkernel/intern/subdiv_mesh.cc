@@ -16,12 +16,15 @@
 
 #include "BLI_array.hh"
 #include "BLI_bitmap.h"
+#include "BLI_implicit_sharing.hh"
 #include "BLI_math_vector.h"
 #include "BLI_math_vector_types.hh"
 #include "BLI_task.hh"
+#include "BLI_vector.hh"
 
 #include "BKE_customdata.h"
 #include "BKE_key.h"
+#include "BKE_lib_id.h"
 #include "BKE_mesh.hh"
 #include "BKE_mesh_mapping.hh"
 #include "BKE_subdiv.hh"
@@ -31,6 +34,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "opensubdiv_evaluator_capi.h"
+
 using blender::float2;
 using blender::float3;
 using blender::IndexRange;
@@ -78,6 +83,11 @@ struct SubdivMeshContext {
    * to avoid race conditions when setting bits. */
   blender::Array<bool> subdiv_display_edges;
 
+  /* Patch coordinates of all subdivided vertices, only written when they are used to create
+   * limit stencils. */
+  blender::Array<OpenSubdiv_PatchCoord> *vert_patch_coords_result;
+  blender::MutableSpan<OpenSubdiv_PatchCoord> vert_patch_coords;
+
   /* Lazily initialize a map from vertices to connected edges. */
   std::mutex vert_to_edge_map_mutex;
   blender::Array<int> vert_to_edge_offsets;
@@ -536,6 +546,10 @@ static bool subdiv_mesh_topology_info(const SubdivForeachContext *foreach_contex
   if (subdiv_context->settings->use_optimal_display) {
     subdiv_context->subdiv_display_edges = blender::Array<bool>(num_edges, false);
   }
+  if (subdiv_context->vert_patch_coords_result != nullptr) {
+    subdiv_context->vert_patch_coords_result->reinitialize(num_vertices);
+    subdiv_context->vert_patch_coords = *subdiv_context->vert_patch_coords_result;
+  }
   return true;
 }
 
@@ -576,6 +590,17 @@ static void subdiv_vertex_data_interpolate(const SubdivMeshContext *ctx,
   }
 }
 
+static void subdiv_vertex_patch_coord_store(const SubdivMeshContext *ctx,
+                                            const int ptex_face_index,
+                                            const float u,
+                                            const float v,
+                                            const int subdiv_vertex_index)
+{
+  if (!ctx->vert_patch_coords.is_empty()) {
+    ctx->vert_patch_coords[subdiv_vertex_index] = {ptex_face_index, u, v};
+  }
+}
+
 static void evaluate_vertex_and_apply_displacement_copy(const SubdivMeshContext *ctx,
                                                         const int ptex_face_index,
                                                         const float u,
@@ -595,6 +620,7 @@ static void evaluate_vertex_and_apply_displacement_copy(const SubdivMeshContext
   /* Copy custom data and evaluate position. */
   subdiv_vertex_data_copy(ctx, coarse_vertex_index, subdiv_vertex_index);
   BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_position);
+  subdiv_vertex_patch_coord_store(ctx, ptex_face_index, u, v, subdiv_vertex_index);
   /* Apply displacement. */
   subdiv_position += D;
   /* Evaluate undeformed texture coordinate. */
@@ -623,6 +649,7 @@ static void evaluate_vertex_and_apply_displacement_interpolate(
   /* Interpolate custom data and evaluate position. */
   subdiv_vertex_data_interpolate(ctx, subdiv_vertex_index, vertex_interpolation, u, v);
   BKE_subdiv_eval_limit_point(ctx->subdiv, ptex_face_index, u, v, subdiv_position);
+  subdiv_vertex_patch_coord_store(ctx, ptex_face_index, u, v, subdiv_vertex_index);
   /* Apply displacement. */
   add_v3_v3(subdiv_position, D);
   /* Evaluate undeformed texture coordinate. */
@@ -780,6 +807,7 @@ static void subdiv_mesh_vertex_inner(const SubdivForeachContext *foreach_context
   subdiv_mesh_ensure_vertex_interpolation(ctx, tls, coarse_face_index, coarse_corner);
   subdiv_vertex_data_interpolate(ctx, subdiv_vertex_index, &tls->vertex_interpolation, u, v);
   BKE_subdiv_eval_final_point(subdiv, ptex_face_index, u, v, subdiv_position);
+  subdiv_vertex_patch_coord_store(ctx, ptex_face_index, u, v, subdiv_vertex_index);
   subdiv_mesh_tag_center_vertex(coarse_face, subdiv_vertex_index, u, v, subdiv_mesh);
   subdiv_vertex_orco_evaluate(ctx, ptex_face_index, u, v, subdiv_vertex_index);
 }
@@ -1151,9 +1179,10 @@ static void setup_foreach_callbacks(const SubdivMeshContext *subdiv_context,
 /** \name Public entry point
  * \{ */
 
-Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
-                         const SubdivToMeshSettings *settings,
-                         const Mesh *coarse_mesh)
+static Mesh *subdiv_to_mesh(Subdiv *subdiv,
+                            const SubdivToMeshSettings *settings,
+                            const Mesh *coarse_mesh,
+                            blender::Array<OpenSubdiv_PatchCoord> *r_vert_patch_coords)
 {
   using namespace blender;
   BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH);
@@ -1184,6 +1213,7 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
 
   subdiv_context.subdiv = subdiv;
   subdiv_context.have_displacement = (subdiv->displacement_evaluator != nullptr);
+  subdiv_context.vert_patch_coords_result = r_vert_patch_coords;
   /* Multi-threaded traversal/evaluation. */
   BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH_GEOMETRY);
   SubdivForeachContext foreach_context;
@@ -1235,3 +1265,205 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
 }
 
 /** \} */
+
+Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
+                         const SubdivToMeshSettings *settings,
+                         const Mesh *coarse_mesh)
+{
+  return subdiv_to_mesh(subdiv, settings, coarse_mesh, nullptr);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Stencil cache
+ * \{ */
+
+struct SubdivMeshCache {
+  /* Descriptor and settings the cached data was created with. They are only compared, never
+   * accessed through the cache. */
+  const Subdiv *subdiv = nullptr;
+  const OpenSubdiv_TopologyRefiner *topology_refiner = nullptr;
+  SubdivSettings subdiv_settings = {};
+  SubdivToMeshSettings settings = {};
+
+  /* Sharing info of all coarse mesh arrays except the positions. Each of them has a user owned by
+   * the cache, which keeps the data alive. So if the same sharing info is found on the coarse mesh
+   * again, the data is unchanged. */
+  blender::Vector<const blender::ImplicitSharingInfo *> coarse_sharing_infos;
+
+  /* Subdivided mesh, copied and given new positions when the cache is used. */
+  Mesh *mesh = nullptr;
+  OpenSubdiv_LimitStencils *stencils = nullptr;
+
+  void clear()
+  {
+    for (const blender::ImplicitSharingInfo *sharing_info : coarse_sharing_infos) {
+      sharing_info->remove_user_and_delete_if_last();
+    }
+    coarse_sharing_infos.clear();
+    if (mesh != nullptr) {
+      BKE_id_free(nullptr, mesh);
+      mesh = nullptr;
+    }
+    if (stencils != nullptr) {
+      openSubdiv_deleteLimitStencils(stencils);
+      stencils = nullptr;
+    }
+    subdiv = nullptr;
+    topology_refiner = nullptr;
+  }
+
+  ~SubdivMeshCache()
+  {
+    this->clear();
+  }
+};
+
+SubdivMeshCache *BKE_subdiv_mesh_cache_new()
+{
+  return MEM_new<SubdivMeshCache>(__func__);
+}
+
+void BKE_subdiv_mesh_cache_free(SubdivMeshCache *cache)
+{
+  MEM_delete(cache);
+}
+
+/**
+ * Gather the sharing info of all arrays of the coarse mesh that are used for the subdivided mesh,
+ * except for the positions. Returns false if any of them isn't shared, in which case it is not
+ * possible to detect that the data changed.
+ */
+static bool coarse_mesh_sharing_infos_get(
+    const Mesh &coarse_mesh, blender::Vector<const blender::ImplicitSharingInfo *> &r_infos)
+{
+  if (coarse_mesh.faces_num > 0) {
+    if (coarse_mesh.runtime->face_offsets_sharing_info == nullptr) {
+      return false;
+    }
+    r_infos.append(coarse_mesh.runtime->face_offsets_sharing_info);
+  }
+  for (const CustomData *data : {&coarse_mesh.vert_data,
+                                 &coarse_mesh.edge_data,
+                                 &coarse_mesh.face_data,
+                                 &coarse_mesh.loop_data})
+  {
+    for (const CustomDataLayer &layer : Span(data->layers, data->totlayer)) {
+      if (data == &coarse_mesh.vert_data && STREQ(layer.name, "position")) {
+        continue;
+      }
+      if (layer.sharing_info == nullptr) {
+        return false;
+      }
+      r_infos.append(layer.sharing_info);
+    }
+  }
+  return true;
+}
+
+static bool subdiv_mesh_cache_supported(const Subdiv *subdiv, const Mesh *coarse_mesh)
+{
+  /* Displacement is not a linear combination of the coarse positions. */
+  if (subdiv->displacement_evaluator != nullptr) {
+    return false;
+  }
+  /* Limit stencils require adaptive refinement of the topology. */
+  if (!subdiv->settings.is_adaptive) {
+    return false;
+  }
+  /* Positions of loose geometry are not evaluated from the limit surface. */
+  if (coarse_mesh->faces_num == 0 || coarse_mesh->verts_no_face().count > 0 ||
+      coarse_mesh->loose_edges().count > 0)
+  {
+    return false;
+  }
+  return true;
+}
+
+static bool subdiv_mesh_cache_is_valid(const SubdivMeshCache &cache,
+                                       const Subdiv *subdiv,
+                                       const SubdivToMeshSettings *settings,
+                                       const Span<const blender::ImplicitSharingInfo *> infos)
+{
+  if (cache.mesh == nullptr || cache.stencils == nullptr) {
+    return false;
+  }
+  if (cache.subdiv != subdiv || cache.topology_refiner != subdiv->topology_refiner) {
+    return false;
+  }
+  if (!BKE_subdiv_settings_equal(&cache.subdiv_settings, &subdiv->settings)) {
+    return false;
+  }
+  if (cache.settings.resolution != settings->resolution ||
+      cache.settings.use_optimal_display != settings->use_optimal_display)
+  {
+    return false;
+  }
+  return cache.coarse_sharing_infos.as_span() == infos;
+}
+
+static void subdiv_mesh_cache_evaluate_positions(const OpenSubdiv_LimitStencils &stencils,
+                                                 const Span<float3> coarse_positions,
+                                                 MutableSpan<float3> positions)
+{
+  BLI_assert(stencils.num_stencils == positions.size());
+  blender::threading::parallel_for(positions.index_range(), 2048, [&](const IndexRange range) {
+    for (const int vert : range) {
+      float3 position(0.0f);
+      for (const int i : IndexRange(stencils.offsets[vert], stencils.sizes[vert])) {
+        position += coarse_positions[stencils.indices[i]] * stencils.weights[i];
+      }
+      positions[vert] = position;
+    }
+  });
+}
+
+Mesh *BKE_subdiv_to_mesh_cached(Subdiv *subdiv,
+                                const SubdivToMeshSettings *settings,
+                                const Mesh *coarse_mesh,
+                                SubdivMeshCache *cache)
+{
+  using namespace blender;
+  Vector<const ImplicitSharingInfo *> sharing_infos;
+  if (!subdiv_mesh_cache_supported(subdiv, coarse_mesh) ||
+      !coarse_mesh_sharing_infos_get(*coarse_mesh, sharing_infos))
+  {
+    cache->clear();
+    return BKE_subdiv_to_mesh(subdiv, settings, coarse_mesh);
+  }
+
+  if (subdiv_mesh_cache_is_valid(*cache, subdiv, settings, sharing_infos)) {
+    BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH);
+    Mesh *result = BKE_mesh_copy_for_eval(cache->mesh);
+    subdiv_mesh_cache_evaluate_positions(
+        *cache->stencils, coarse_mesh->vert_positions(), result->vert_positions_for_write());
+    BKE_mesh_tag_positions_changed(result);
+    BKE_subdiv_stats_end(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH);
+    return result;
+  }
+
+  cache->clear();
+  Array<OpenSubdiv_PatchCoord> vert_patch_coords;
+  Mesh *result = subdiv_to_mesh(subdiv, settings, coarse_mesh, &vert_patch_coords);
+  if (result == nullptr) {
+    return nullptr;
+  }
+  cache->stencils = openSubdiv_createLimitStencils(
+      subdiv->topology_refiner, vert_patch_coords.data(), vert_patch_coords.size());
+  if (cache->stencils == nullptr) {
+    return result;
+  }
+  cache->subdiv = subdiv;
+  cache->topology_refiner = subdiv->topology_refiner;
+  cache->subdiv_settings = subdiv->settings;
+  cache->settings = *settings;
+  for (const ImplicitSharingInfo *sharing_info : sharing_infos) {
+    sharing_info->add_user();
+  }
+  cache->coarse_sharing_infos = std::move(sharing_infos);
+  cache->mesh = BKE_mesh_copy_for_eval(result);
+  return result;
+}
+
+/** \} */
@@ -0,0 +1,225 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cmath>
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_vector.hh"
+
+#include "DNA_mesh_types.h"
+
+#include "BKE_attribute.hh"
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.hh"
+#include "BKE_subdiv.hh"
+#include "BKE_subdiv_eval.hh"
+#include "BKE_subdiv_mesh.hh"
+
+#include "opensubdiv_capi_type.h"
+#include "opensubdiv_evaluator_capi.h"
+
+namespace blender::bke::tests {
+
+#ifdef WITH_OPENSUBDIV
+
+/**
+ * Create an open grid with creased edges and a creased vertex. Some quads are split into
+ * triangles, so that there are extraordinary vertices which are evaluated with end caps.
+ */
+static Mesh *create_creased_grid_mesh(const int size)
+{
+  const int verts_per_row = size + 1;
+  int faces_num = 0;
+  int corners_num = 0;
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      const bool split = (x + y) % 3 == 0;
+      faces_num += split ? 2 : 1;
+      corners_num += split ? 6 : 4;
+    }
+  }
+
+  Mesh *mesh = BKE_mesh_new_nomain(verts_per_row * verts_per_row, 0, faces_num, corners_num);
+  MutableSpan<float3> positions = mesh->vert_positions_for_write();
+  for (const int y : IndexRange(verts_per_row)) {
+    for (const int x : IndexRange(verts_per_row)) {
+      positions[y * verts_per_row + x] = float3(x, y, std::sin(x * 0.7f) * std::cos(y * 0.4f));
+    }
+  }
+
+  MutableSpan<int> face_offsets = mesh->face_offsets_for_write();
+  MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
+  int face = 0;
+  int corner = 0;
+  auto add_face = [&](const Span<int> verts) {
+    face_offsets[face++] = corner;
+    for (const int vert : verts) {
+      corner_verts[corner++] = vert;
+    }
+  };
+  for (const int y : IndexRange(size)) {
+    for (const int x : IndexRange(size)) {
+      const int v0 = y * verts_per_row + x;
+      const int v1 = v0 + 1;
+      const int v2 = v1 + verts_per_row;
+      const int v3 = v0 + verts_per_row;
+      if ((x + y) % 3 == 0) {
+        add_face({v0, v1, v2});
+        add_face({v0, v2, v3});
+      }
+      else {
+        add_face({v0, v1, v2, v3});
+      }
+    }
+  }
+  face_offsets.last() = corner;
+  BKE_mesh_calc_edges(mesh, false, false);
+
+  /* A fully sharp column of edges, which uses infinitely sharp patches, and a semi-sharp row. */
+  MutableAttributeAccessor attributes = mesh->attributes_for_write();
+  SpanAttributeWriter<float> edge_creases = attributes.lookup_or_add_for_write_span<float>(
+      "crease_edge", ATTR_DOMAIN_EDGE);
+  for (const int edge : edge_creases.span.index_range()) {
+    const int2 verts = mesh->edges()[edge];
+    if (verts[0] % verts_per_row == size / 2 && verts[1] % verts_per_row == size / 2) {
+      edge_creases.span[edge] = 1.0f;
+    }
+    else if (verts[0] / verts_per_row == 1 && verts[1] / verts_per_row == 1) {
+      edge_creases.span[edge] = 0.5f;
+    }
+  }
+  edge_creases.finish();
+  SpanAttributeWriter<float> vert_creases = attributes.lookup_or_add_for_write_span<float>(
+      "crease_vert", ATTR_DOMAIN_POINT);
+  vert_creases.span[verts_per_row * (size - 1) + 1] = 0.8f;
+  vert_creases.finish();
+
+  return mesh;
+}
+
+static SubdivSettings limit_subdiv_settings(const int level,
+                                            const eSubdivVtxBoundaryInterpolation boundary)
+{
+  SubdivSettings settings{};
+  settings.is_simple = false;
+  settings.is_adaptive = true;
+  settings.level = level;
+  settings.use_creases = true;
+  settings.vtx_boundary_interpolation = boundary;
+  settings.fvar_linear_interpolation = SUBDIV_FVAR_LINEAR_INTERPOLATION_BOUNDARIES;
+  return settings;
+}
+
+class SubdivMeshTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+/**
+ * The stencils have to give the same limit positions as the evaluator, which requires the same
+ * end caps and the same adaptive isolation of creases and extraordinary vertices.
+ */
+TEST_F(SubdivMeshTest, LimitStencilsMatchEvaluator)
+{
+  Mesh *mesh = create_creased_grid_mesh(6);
+  const Span<float3> coarse_positions = mesh->vert_positions();
+
+  for (const int level : {1, 3}) {
+    for (const eSubdivVtxBoundaryInterpolation boundary :
+         {SUBDIV_VTX_BOUNDARY_EDGE_ONLY, SUBDIV_VTX_BOUNDARY_EDGE_AND_CORNER})
+    {
+      const SubdivSettings settings = limit_subdiv_settings(level, boundary);
+      Subdiv *subdiv = BKE_subdiv_new_from_mesh(&settings, mesh);
+      ASSERT_NE(subdiv, nullptr);
+      ASSERT_TRUE(BKE_subdiv_eval_begin_from_mesh(
+          subdiv, mesh, nullptr, SUBDIV_EVALUATOR_TYPE_CPU, nullptr));
+
+      const int ptex_faces_num = BKE_subdiv_face_ptex_offset_get(subdiv)[mesh->faces_num];
+      const float coords[] = {0.0f, 0.3f, 0.5f, 0.85f, 1.0f};
+      Vector<OpenSubdiv_PatchCoord> patch_coords;
+      for (const int ptex_face : IndexRange(ptex_faces_num)) {
+        for (const float u : coords) {
+          for (const float v : coords) {
+            patch_coords.append({ptex_face, u, v});
+          }
+        }
+      }
+
+      OpenSubdiv_LimitStencils *stencils = openSubdiv_createLimitStencils(
+          subdiv->topology_refiner, patch_coords.data(), patch_coords.size());
+      ASSERT_NE(stencils, nullptr);
+      ASSERT_EQ(stencils->num_stencils, patch_coords.size());
+
+      for (const int i : patch_coords.index_range()) {
+        const OpenSubdiv_PatchCoord &coord = patch_coords[i];
+        float3 expected;
+        BKE_subdiv_eval_limit_point(subdiv, coord.ptex_face, coord.u, coord.v, expected);
+        float3 position(0.0f);
+        for (const int j : IndexRange(stencils->offsets[i], stencils->sizes[i])) {
+          position += coarse_positions[stencils->indices[j]] * stencils->weights[j];
+        }
+        EXPECT_NEAR(position.x, expected.x, 1e-4f);
+        EXPECT_NEAR(position.y, expected.y, 1e-4f);
+        EXPECT_NEAR(position.z, expected.z, 1e-4f);
+      }
+
+      openSubdiv_deleteLimitStencils(stencils);
+      BKE_subdiv_free(subdiv);
+    }
+  }
+
+  BKE_id_free(nullptr, mesh);
+}
+
+TEST_F(SubdivMeshTest, CachedMatchesEvaluated)
+{
+  Mesh *mesh = create_creased_grid_mesh(6);
+  const SubdivSettings settings = limit_subdiv_settings(2, SUBDIV_VTX_BOUNDARY_EDGE_AND_CORNER);
+  Subdiv *subdiv = BKE_subdiv_new_from_mesh(&settings, mesh);
+  ASSERT_NE(subdiv, nullptr);
+  SubdivToMeshSettings mesh_settings{};
+  mesh_settings.resolution = (1 << settings.level) + 1;
+  mesh_settings.use_optimal_display = false;
+
+  SubdivMeshCache *cache = BKE_subdiv_mesh_cache_new();
+  Mesh *first = BKE_subdiv_to_mesh_cached(subdiv, &mesh_settings, mesh, cache);
+  ASSERT_NE(first, nullptr);
+  BKE_id_free(nullptr, first);
+
+  /* Only the positions change, so the second evaluation uses the stencils. */
+  for (float3 &position : mesh->vert_positions_for_write()) {
+    position.z += std::cos(position.x * 0.5f) * 0.3f;
+  }
+  BKE_mesh_tag_positions_changed(mesh);
+
+  Mesh *cached = BKE_subdiv_to_mesh_cached(subdiv, &mesh_settings, mesh, cache);
+  Mesh *evaluated = BKE_subdiv_to_mesh(subdiv, &mesh_settings, mesh);
+  ASSERT_NE(cached, nullptr);
+  ASSERT_NE(evaluated, nullptr);
+  const Span<float3> cached_positions = cached->vert_positions();
+  const Span<float3> evaluated_positions = evaluated->vert_positions();
+  ASSERT_EQ(cached_positions.size(), evaluated_positions.size());
+  for (const int i : cached_positions.index_range()) {
+    EXPECT_NEAR(cached_positions[i].x, evaluated_positions[i].x, 1e-4f);
+    EXPECT_NEAR(cached_positions[i].y, evaluated_positions[i].y, 1e-4f);
+    EXPECT_NEAR(cached_positions[i].z, evaluated_positions[i].z, 1e-4f);
+  }
+
+  BKE_id_free(nullptr, cached);
+  BKE_id_free(nullptr, evaluated);
+  BKE_subdiv_mesh_cache_free(cache);
+  BKE_subdiv_free(subdiv);
+  BKE_id_free(nullptr, mesh);
+}
+
+#endif
+
+}  // namespace blender::bke::tests
@@ -51,6 +51,11 @@ void BLI_mempool_clear(BLI_mempool *pool) ATTR_NONNULL(1);
  */
 void BLI_mempool_destroy(BLI_mempool *pool) ATTR_NONNULL(1);
 int BLI_mempool_len(const BLI_mempool *pool) ATTR_NONNULL(1);
+/**
+ * The number of elements that fit into the chunks allocated by the pool,
+ * used or not. Together with #BLI_mempool_len this tells how sparsely the chunks are used.
+ */
+int BLI_mempool_capacity(const BLI_mempool *pool) ATTR_NONNULL(1);
 void *BLI_mempool_findelem(BLI_mempool *pool, unsigned int index) ATTR_WARN_UNUSED_RESULT
     ATTR_NONNULL(1);
 
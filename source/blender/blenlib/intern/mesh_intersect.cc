@@ -1155,7 +1155,7 @@ static inline mpq3 tti_interp(
 /**
  * Return +1, 0, -1 as a + ad is above, on, or below the oriented plane containing a, b, c in CCW
  * order. This is the same as -oriented(a, b, c, a + ad), but uses fewer arithmetic operations.
- * TODO: change arguments to `const Vert *` and use floating filters.
+ * See #filter_tti_above for a faster inexact version.
  * The ba, ca, n, and dotbuf arguments are used as temporaries; declaring them
  * in the caller can avoid many allocations and frees of mpq3 and mpq_class structures.
  */
@@ -1180,6 +1180,40 @@ static inline int tti_above(const mpq3 &a,
   return sgn(math::dot_with_buffer(ad, n, dotbuf));
 }
 
+/**
+ * The index of the #tti_above expression when all input coordinates have index 1:
+ * the cross product coordinates have index 6 and `ad` has index 2, so each product in the dot
+ * product has index 9, and summing the three products adds 2.
+ */
+constexpr int index_tti_above = 11;
+
+/**
+ * Floating-point filter for #tti_above, using the error bounds described above
+ * #supremum_dot_cross. Return +1 or -1 if the sign is certain to be the same as the sign of the
+ * exact calculation, or 0 if the exact calculation is needed.
+ * \param sup_ad: The supremum of each coordinate of `ad`.
+ */
+static inline int filter_tti_above(const double3 &a,
+                                   const double3 &b,
+                                   const double3 &c,
+                                   const double3 &ad,
+                                   const double3 &sup_ad)
+{
+  const double3 n = math::cross(b - a, c - a);
+  const double d = math::dot(ad, n);
+  const double3 abs_a = math::abs(a);
+  const double3 sup_ba = math::abs(b) + abs_a;
+  const double3 sup_ca = math::abs(c) + abs_a;
+  const double3 sup_n(sup_ba.y * sup_ca.z + sup_ba.z * sup_ca.y,
+                      sup_ba.z * sup_ca.x + sup_ba.x * sup_ca.z,
+                      sup_ba.x * sup_ca.y + sup_ba.y * sup_ca.x);
+  const double err_bound = math::dot(sup_ad, sup_n) * index_tti_above * DBL_EPSILON;
+  if (fabs(d) > err_bound) {
+    return d > 0 ? 1 : -1;
+  }
+  return 0;
+}
+
 /**
  * Given that triangles (p1, q1, r1) and (p2, q2, r2) are in canonical order,
  * use the classification chart in the Guigue and Devillers paper to find out
@@ -1193,16 +1227,22 @@ static inline int tti_above(const mpq3 &a,
  *   of the plane and at least one of q1 and r1 are off the plane.
  * Similarly for p2, q2, r2 with respect to the first triangle's plane.
  */
-static ITT_value itt_canon2(const mpq3 &p1,
-                            const mpq3 &q1,
-                            const mpq3 &r1,
-                            const mpq3 &p2,
-                            const mpq3 &q2,
-                            const mpq3 &r2,
+static ITT_value itt_canon2(const Vert *vp1,
+                            const Vert *vq1,
+                            const Vert *vr1,
+                            const Vert *vp2,
+                            const Vert *vq2,
+                            const Vert *vr2,
                             const mpq3 &n1,
                             const mpq3 &n2)
 {
   constexpr int dbg_level = 0;
+  const mpq3 &p1 = vp1->co_exact;
+  const mpq3 &q1 = vq1->co_exact;
+  const mpq3 &r1 = vr1->co_exact;
+  const mpq3 &p2 = vp2->co_exact;
+  const mpq3 &q2 = vq2->co_exact;
+  const mpq3 &r2 = vr2->co_exact;
   if (dbg_level > 0) {
     std::cout << "\ntri_tri_intersect_canon:\n";
     std::cout << "p1=" << p1 << " q1=" << q1 << " r1=" << r1 << "\n";
@@ -1218,17 +1258,34 @@ static ITT_value itt_canon2(const mpq3 &p1,
     std::cout << "n1=(" << n1[0].get_d() << "," << n1[1].get_d() << "," << n1[2].get_d() << ")\n";
     std::cout << "n2=(" << n2[0].get_d() << "," << n2[1].get_d() << "," << n2[2].get_d() << ")\n";
   }
-  mpq3 p1p2 = p2 - p1;
+  /* The classification tests are decided with the floating-point filter when possible,
+   * the exact difference vector is only computed when some test needs it. */
+  const double3 d_p1p2 = vp2->co - vp1->co;
+  const double3 sup_p1p2 = math::abs(vp2->co) + math::abs(vp1->co);
+  mpq3 p1p2;
+  bool p1p2_exact_computed = false;
   mpq3 intersect_1;
   mpq3 intersect_2;
   mpq3 buf[4];
+  auto above = [&](const Vert *a, const Vert *b, const Vert *c) {
+    const int side = filter_tti_above(a->co, b->co, c->co, d_p1p2, sup_p1p2);
+    if (side != 0) {
+      return side;
+    }
+    if (!p1p2_exact_computed) {
+      p1p2 = p2 - p1;
+      p1p2_exact_computed = true;
+    }
+    return tti_above(
+        a->co_exact, b->co_exact, c->co_exact, p1p2, buf[0], buf[1], buf[2], buf[3]);
+  };
   bool no_overlap = false;
   /* Top test in classification tree. */
-  if (tti_above(p1, q1, r2, p1p2, buf[0], buf[1], buf[2], buf[3]) > 0) {
+  if (above(vp1, vq1, vr2) > 0) {
     /* Middle right test in classification tree. */
-    if (tti_above(p1, r1, r2, p1p2, buf[0], buf[1], buf[2], buf[3]) <= 0) {
+    if (above(vp1, vr1, vr2) <= 0) {
       /* Bottom right test in classification tree. */
-      if (tti_above(p1, r1, q2, p1p2, buf[0], buf[1], buf[2], buf[3]) > 0) {
+      if (above(vp1, vr1, vq2) > 0) {
         /* Overlap is [k [i l] j]. */
         if (dbg_level > 0) {
           std::cout << "overlap [k [i l] j]\n";
@@ -1257,7 +1314,7 @@ static ITT_value itt_canon2(const mpq3 &p1,
   }
   else {
     /* Middle left test in classification tree. */
-    if (tti_above(p1, q1, q2, p1p2, buf[0], buf[1], buf[2], buf[3]) < 0) {
+    if (above(vp1, vq1, vq2) < 0) {
       /* No overlap: [i j] [k l]. */
       if (dbg_level > 0) {
         std::cout << "no overlap: [i j] [k l]\n";
@@ -1266,7 +1323,7 @@ static ITT_value itt_canon2(const mpq3 &p1,
     }
     else {
       /* Bottom left test in classification tree. */
-      if (tti_above(p1, r1, q2, p1p2, buf[0], buf[1], buf[2], buf[3]) >= 0) {
+      if (above(vp1, vr1, vq2) >= 0) {
         /* Overlap is [k [i j] l]. */
         if (dbg_level > 0) {
           std::cout << "overlap [k [i j] l]\n";
@@ -1303,12 +1360,12 @@ static ITT_value itt_canon2(const mpq3 &p1,
 
 /* Helper function for intersect_tri_tri. Arguments have been canonicalized for triangle 1. */
 
-static ITT_value itt_canon1(const mpq3 &p1,
-                            const mpq3 &q1,
-                            const mpq3 &r1,
-                            const mpq3 &p2,
-                            const mpq3 &q2,
-                            const mpq3 &r2,
+static ITT_value itt_canon1(const Vert *vp1,
+                            const Vert *vq1,
+                            const Vert *vr1,
+                            const Vert *vp2,
+                            const Vert *vq2,
+                            const Vert *vr2,
                             const mpq3 &n1,
                             const mpq3 &n2,
                             int sp2,
@@ -1318,39 +1375,39 @@ static ITT_value itt_canon1(const mpq3 &p1,
   constexpr int dbg_level = 0;
   if (sp2 > 0) {
     if (sq2 > 0) {
-      return itt_canon2(p1, r1, q1, r2, p2, q2, n1, n2);
+      return itt_canon2(vp1, vr1, vq1, vr2, vp2, vq2, n1, n2);
     }
     if (sr2 > 0) {
-      return itt_canon2(p1, r1, q1, q2, r2, p2, n1, n2);
+      return itt_canon2(vp1, vr1, vq1, vq2, vr2, vp2, n1, n2);
     }
-    return itt_canon2(p1, q1, r1, p2, q2, r2, n1, n2);
+    return itt_canon2(vp1, vq1, vr1, vp2, vq2, vr2, n1, n2);
   }
   if (sp2 < 0) {
     if (sq2 < 0) {
-      return itt_canon2(p1, q1, r1, r2, p2, q2, n1, n2);
+      return itt_canon2(vp1, vq1, vr1, vr2, vp2, vq2, n1, n2);
     }
     if (sr2 < 0) {
-      return itt_canon2(p1, q1, r1, q2, r2, p2, n1, n2);
+      return itt_canon2(vp1, vq1, vr1, vq2, vr2, vp2, n1, n2);
     }
-    return itt_canon2(p1, r1, q1, p2, q2, r2, n1, n2);
+    return itt_canon2(vp1, vr1, vq1, vp2, vq2, vr2, n1, n2);
   }
   if (sq2 < 0) {
     if (sr2 >= 0) {
-      return itt_canon2(p1, r1, q1, q2, r2, p2, n1, n2);
+      return itt_canon2(vp1, vr1, vq1, vq2, vr2, vp2, n1, n2);
     }
-    return itt_canon2(p1, q1, r1, p2, q2, r2, n1, n2);
+    return itt_canon2(vp1, vq1, vr1, vp2, vq2, vr2, n1, n2);
   }
   if (sq2 > 0) {
     if (sr2 > 0) {
-      return itt_canon2(p1, r1, q1, p2, q2, r2, n1, n2);
+      return itt_canon2(vp1, vr1, vq1, vp2, vq2, vr2, n1, n2);
     }
-    return itt_canon2(p1, q1, r1, q2, r2, p2, n1, n2);
+    return itt_canon2(vp1, vq1, vr1, vq2, vr2, vp2, n1, n2);
   }
   if (sr2 > 0) {
-    return itt_canon2(p1, q1, r1, r2, p2, q2, n1, n2);
+    return itt_canon2(vp1, vq1, vr1, vr2, vp2, vq2, n1, n2);
   }
   if (sr2 < 0) {
-    return itt_canon2(p1, r1, q1, r2, p2, q2, n1, n2);
+    return itt_canon2(vp1, vr1, vq1, vr2, vp2, vq2, n1, n2);
   }
   if (dbg_level > 0) {
     std::cout << "triangles are co-planar\n";
@@ -1510,49 +1567,49 @@ static ITT_value intersect_tri_tri(const IMesh &tm, int t1, int t2)
   ITT_value ans;
   if (sp1 > 0) {
     if (sq1 > 0) {
-      ans = itt_canon1(r1, p1, q1, p2, r2, q2, n1, n2, sp2, sr2, sq2);
+      ans = itt_canon1(vr1, vp1, vq1, vp2, vr2, vq2, n1, n2, sp2, sr2, sq2);
     }
     else if (sr1 > 0) {
-      ans = itt_canon1(q1, r1, p1, p2, r2, q2, n1, n2, sp2, sr2, sq2);
+      ans = itt_canon1(vq1, vr1, vp1, vp2, vr2, vq2, n1, n2, sp2, sr2, sq2);
     }
     else {
-      ans = itt_canon1(p1, q1, r1, p2, q2, r2, n1, n2, sp2, sq2, sr2);
+      ans = itt_canon1(vp1, vq1, vr1, vp2, vq2, vr2, n1, n2, sp2, sq2, sr2);
     }
   }
   else if (sp1 < 0) {
     if (sq1 < 0) {
-      ans = itt_canon1(r1, p1, q1, p2, q2, r2, n1, n2, sp2, sq2, sr2);
+      ans = itt_canon1(vr1, vp1, vq1, vp2, vq2, vr2, n1, n2, sp2, sq2, sr2);
     }
     else if (sr1 < 0) {
-      ans = itt_canon1(q1, r1, p1, p2, q2, r2, n1, n2, sp2, sq2, sr2);
+      ans = itt_canon1(vq1, vr1, vp1, vp2, vq2, vr2, n1, n2, sp2, sq2, sr2);
     }
     else {
-      ans = itt_canon1(p1, q1, r1, p2, r2, q2, n1, n2, sp2, sr2, sq2);
+      ans = itt_canon1(vp1, vq1, vr1, vp2, vr2, vq2, n1, n2, sp2, sr2, sq2);
     }
   }
   else {
     if (sq1 < 0) {
       if (sr1 >= 0) {
-        ans = itt_canon1(q1, r1, p1, p2, r2, q2, n1, n2, sp2, sr2, sq2);
+        ans = itt_canon1(vq1, vr1, vp1, vp2, vr2, vq2, n1, n2, sp2, sr2, sq2);
       }
       else {
-        ans = itt_canon1(p1, q1, r1, p2, q2, r2, n1, n2, sp2, sq2, sr2);
+        ans = itt_canon1(vp1, vq1, vr1, vp2, vq2, vr2, n1, n2, sp2, sq2, sr2);
       }
     }
     else if (sq1 > 0) {
       if (sr1 > 0) {
-        ans = itt_canon1(p1, q1, r1, p2, r2, q2, n1, n2, sp2, sr2, sq2);
+        ans = itt_canon1(vp1, vq1, vr1, vp2, vr2, vq2, n1, n2, sp2, sr2, sq2);
       }
       else {
-        ans = itt_canon1(q1, r1, p1, p2, q2, r2, n1, n2, sp2, sq2, sr2);
+        ans = itt_canon1(vq1, vr1, vp1, vp2, vq2, vr2, n1, n2, sp2, sq2, sr2);
       }
     }
     else {
       if (sr1 > 0) {
-        ans = itt_canon1(r1, p1, q1, p2, q2, r2, n1, n2, sp2, sq2, sr2);
+        ans = itt_canon1(vr1, vp1, vq1, vp2, vq2, vr2, n1, n2, sp2, sq2, sr2);
       }
       else if (sr1 < 0) {
-        ans = itt_canon1(r1, p1, q1, p2, r2, q2, n1, n2, sp2, sr2, sq2);
+        ans = itt_canon1(vr1, vp1, vq1, vp2, vr2, vq2, n1, n2, sp2, sr2, sq2);
       }
       else {
         if (dbg_level > 0) {
@@ -3022,10 +3079,16 @@ IMesh trimesh_nary_intersect(const IMesh &tm_in,
   std::cout << "subdivided non-cluster tris found, time = " << subdivided_tris_time - itt_time
             << "\n";
 #  endif
+  /* Clusters are independent, and their sizes vary a lot, so subdivide each one in a separate
+   * task. The output triangles are still extracted serially by #calc_cluster_tris, so that
+   * Boolean is repeatable regardless of parallelism. */
   Array<CDT_data> cluster_subdivided(clinfo.tot_cluster());
-  for (int c : clinfo.index_range()) {
-    cluster_subdivided[c] = calc_cluster_subdivided(clinfo, c, *tm_clean, tri_ov, itt_map, arena);
-  }
+  threading::parallel_for(clinfo.index_range(), 1, [&](IndexRange range) {
+    for (int c : range) {
+      cluster_subdivided[c] = calc_cluster_subdivided(
+          clinfo, c, *tm_clean, tri_ov, itt_map, arena);
+    }
+  });
 #  ifdef PERFDEBUG
   double cluster_subdivide_time = PIL_check_seconds_timer();
   std::cout << "subdivided clusters found, time = "
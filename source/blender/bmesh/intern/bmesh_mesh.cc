@@ -1290,6 +1290,86 @@ void BM_mesh_rebuild(BMesh *bm,
   }
 }
 
+/**
+ * Move the custom-data blocks of one domain into a new pool, allocating them in iteration order.
+ * The pool is sized for all elements up-front so its free list hands out blocks sequentially.
+ *
+ * Pools where at least half of the allocated blocks are in use are left as they are, the gaps
+ * left by deleted elements cost less than copying every block.
+ */
+template<typename ForeachHeaderFn>
+static void bm_mesh_customdata_compact_domain(CustomData *data,
+                                              const int totelem,
+                                              const char htype,
+                                              const ForeachHeaderFn &foreach_header)
+{
+  BLI_mempool *pool_src = data->pool;
+  if (pool_src == nullptr) {
+    return;
+  }
+  if (BLI_mempool_len(pool_src) * 2 >= BLI_mempool_capacity(pool_src)) {
+    return;
+  }
+  data->pool = nullptr;
+  CustomData_bmesh_init_pool(data, totelem, htype);
+
+  /* The blocks are moved, ownership of any data they reference is transferred with them. */
+  foreach_header([&](BMHeader *head) {
+    if (head->data == nullptr) {
+      return;
+    }
+    void *block = BLI_mempool_alloc(data->pool);
+    memcpy(block, head->data, size_t(data->totsize));
+    head->data = block;
+  });
+
+  BLI_mempool_destroy(pool_src);
+}
+
+void BM_mesh_customdata_compact(BMesh *bm, const char htype)
+{
+  if (htype & BM_VERT) {
+    bm_mesh_customdata_compact_domain(&bm->vdata, bm->totvert, BM_VERT, [&](auto fn) {
+      BMIter iter;
+      BMVert *v;
+      BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+        fn(&v->head);
+      }
+    });
+  }
+  if (htype & BM_EDGE) {
+    bm_mesh_customdata_compact_domain(&bm->edata, bm->totedge, BM_EDGE, [&](auto fn) {
+      BMIter iter;
+      BMEdge *e;
+      BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+        fn(&e->head);
+      }
+    });
+  }
+  if (htype & BM_LOOP) {
+    bm_mesh_customdata_compact_domain(&bm->ldata, bm->totloop, BM_LOOP, [&](auto fn) {
+      BMIter iter;
+      BMFace *f;
+      BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
+        BMLoop *l_iter, *l_first;
+        l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+        do {
+          fn(&l_iter->head);
+        } while ((l_iter = l_iter->next) != l_first);
+      }
+    });
+  }
+  if (htype & BM_FACE) {
+    bm_mesh_customdata_compact_domain(&bm->pdata, bm->totface, BM_FACE, [&](auto fn) {
+      BMIter iter;
+      BMFace *f;
+      BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
+        fn(&f->head);
+      }
+    });
+  }
+}
+
 void BM_mesh_toolflags_set(BMesh *bm, bool use_toolflags)
 {
   if (bm->use_toolflags == use_toolflags) {
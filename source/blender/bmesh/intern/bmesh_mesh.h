@@ -172,6 +172,18 @@ void BM_mesh_rebuild(BMesh *bm,
                      struct BLI_mempool *lpool,
                      struct BLI_mempool *fpool);
 
+/**
+ * Re-allocate the custom-data blocks of the \a htype domains in element order,
+ * so layer-wide loops over the mesh read their data sequentially.
+ *
+ * \note Useful after deleting or re-ordering many elements, which leaves the blocks
+ * scattered over partially used pool chunks. The element pools themselves are not changed.
+ * Domains whose pools are at least half used are skipped, see #BLI_mempool_capacity.
+ *
+ * \warning Pointers into custom-data blocks are invalidated.
+ */
+void BM_mesh_customdata_compact(BMesh *bm, char htype);
+
 typedef struct BMAllocTemplate {
   int totvert, totedge, totloop, totface;
 } BMAllocTemplate;
@@ -93,6 +93,7 @@
 #include "BKE_attribute.hh"
 #include "BKE_customdata.h"
 #include "BKE_mesh.hh"
+#include "BKE_mesh_mapping.hh"
 #include "BKE_mesh_runtime.hh"
 #include "BKE_multires.hh"
 
@@ -210,6 +211,359 @@ static void mesh_attributes_copy_to_bmesh_block(CustomData &data,
   }
 }
 
+/**
+ * Copy attribute values for many elements at once. The custom data blocks must already be
+ * allocated. Every layer is copied separately so that the reads from the mesh are sequential.
+ */
+template<typename T>
+static void mesh_attributes_copy_to_bmesh_blocks(const Span<MeshToBMeshLayerInfo> copy_info,
+                                                 const Span<T *> elems)
+{
+  if (copy_info.is_empty()) {
+    return;
+  }
+  blender::threading::parallel_for(elems.index_range(), 2048, [&](const IndexRange range) {
+    for (const MeshToBMeshLayerInfo &info : copy_info) {
+      if (info.mesh_data) {
+        for (const int i : range) {
+          CustomData_data_copy_value(info.type,
+                                     POINTER_OFFSET(info.mesh_data, info.elem_size * i),
+                                     POINTER_OFFSET(elems[i]->head.data, info.bmesh_offset));
+        }
+      }
+      else {
+        for (const int i : range) {
+          CustomData_data_set_default_value(
+              info.type, POINTER_OFFSET(elems[i]->head.data, info.bmesh_offset));
+        }
+      }
+    }
+  });
+}
+
+/* The tool flags follow the element in each of the `*_OFlag` structs, at a different offset
+ * for every element type. */
+static BMFlagLayer *&bm_elem_oflags(BMVert *v)
+{
+  return reinterpret_cast<BMVert_OFlag *>(v)->oflags;
+}
+static BMFlagLayer *&bm_elem_oflags(BMEdge *e)
+{
+  return reinterpret_cast<BMEdge_OFlag *>(e)->oflags;
+}
+static BMFlagLayer *&bm_elem_oflags(BMFace *f)
+{
+  return reinterpret_cast<BMFace_OFlag *>(f)->oflags;
+}
+
+/**
+ * Allocate elements and their custom data blocks from the #BMesh memory pools. The pools are
+ * not thread-safe, so this is the only part of the bulk conversion that isn't parallelized.
+ * Initializing the allocated memory is left to the caller.
+ */
+template<typename T>
+static void bm_elems_alloc(BLI_mempool *pool,
+                           BLI_mempool *toolflag_pool,
+                           const bool use_toolflags,
+                           CustomData &data,
+                           MutableSpan<T *> r_elems)
+{
+  for (T *&elem : r_elems) {
+    elem = static_cast<T *>(BLI_mempool_alloc(pool));
+    elem->head.data = nullptr;
+    CustomData_bmesh_alloc_block(&data, &elem->head.data);
+  }
+  if constexpr (!std::is_same_v<T, BMLoop>) {
+    if (use_toolflags) {
+      for (T *elem : r_elems) {
+        bm_elem_oflags(elem) = static_cast<BMFlagLayer *>(
+            toolflag_pool ? BLI_mempool_calloc(toolflag_pool) : nullptr);
+      }
+    }
+  }
+}
+
+/** Attributes that are stored as #BMesh element flags or members instead of custom data. */
+struct MeshToBMeshBuiltinAttributes {
+  const bool *select_vert;
+  const bool *select_edge;
+  const bool *select_poly;
+  const bool *hide_vert;
+  const bool *hide_edge;
+  const bool *hide_poly;
+  const int *material_indices;
+  const bool *sharp_faces;
+  const bool *sharp_edges;
+  const bool *uv_seams;
+};
+
+static bool mesh_has_empty_faces(const Mesh &mesh)
+{
+  const blender::OffsetIndices faces = mesh.faces();
+  return std::any_of(faces.index_range().begin(), faces.index_range().end(), [&](const int i) {
+    return faces[i].is_empty();
+  });
+}
+
+/**
+ * A faster alternative to creating the elements one by one with #BM_vert_create,
+ * #BM_edge_create and #BM_face_create, used when the #BMesh is empty. After allocating all
+ * elements, their members, the disk and radial cycles and the custom data are initialized in
+ * parallel, using the mesh topology maps to know the final order of each cycle in advance.
+ * The result is the same as with the element-wise creation functions.
+ */
+static void bm_mesh_elems_create_from_me_bulk(BMesh &bm,
+                                              const Mesh &mesh,
+                                              const BMeshFromMeshParams &params,
+                                              const MeshToBMeshBuiltinAttributes &attrs,
+                                              const float (*keyco)[3],
+                                              const Span<float3> vert_normals,
+                                              const Span<const float(*)[3]> shape_key_table,
+                                              const int cd_shape_key_offset,
+                                              const int cd_shape_keyindex_offset,
+                                              const Span<MeshToBMeshLayerInfo> vert_info,
+                                              const Span<MeshToBMeshLayerInfo> edge_info,
+                                              const Span<MeshToBMeshLayerInfo> poly_info,
+                                              const Span<MeshToBMeshLayerInfo> loop_info,
+                                              MutableSpan<BMVert *> vtable,
+                                              MutableSpan<BMEdge *> etable,
+                                              MutableSpan<BMFace *> ftable)
+{
+  using namespace blender;
+  const Span<float3> positions = mesh.vert_positions();
+  const Span<int2> edges = mesh.edges();
+  const OffsetIndices faces = mesh.faces();
+  const Span<int> corner_verts = mesh.corner_verts();
+  const Span<int> corner_edges = mesh.corner_edges();
+
+  Array<BMLoop *> ltable(mesh.totloop);
+  bm_elems_alloc(bm.vpool, bm.vtoolflagpool, bm.use_toolflags, bm.vdata, vtable);
+  bm_elems_alloc(bm.epool, bm.etoolflagpool, bm.use_toolflags, bm.edata, etable);
+  bm_elems_alloc(bm.fpool, bm.ftoolflagpool, bm.use_toolflags, bm.pdata, ftable);
+  bm_elems_alloc<BMLoop>(bm.lpool, nullptr, false, bm.ldata, ltable);
+
+  Array<int> vert_to_edge_offsets;
+  Array<int> vert_to_edge_indices;
+  Array<int> edge_to_loop_offsets;
+  Array<int> edge_to_loop_indices;
+  GroupedSpan<int> vert_to_edge_map;
+  GroupedSpan<int> edge_to_loop_map;
+  threading::parallel_invoke(
+      mesh.totvert + mesh.totloop > 1024,
+      [&]() {
+        vert_to_edge_map = bke::mesh::build_vert_to_edge_map(
+            edges, mesh.totvert, vert_to_edge_offsets, vert_to_edge_indices);
+      },
+      [&]() {
+        edge_to_loop_map = bke::mesh::build_edge_to_loop_map(
+            corner_edges, mesh.totedge, edge_to_loop_offsets, edge_to_loop_indices);
+      });
+
+  threading::parallel_for(vtable.index_range(), 2048, [&](const IndexRange range) {
+    for (const int i : range) {
+      BMVert *v = vtable[i];
+      v->head.htype = BM_VERT;
+      v->head.hflag = 0;
+      v->head.api_flag = 0;
+      BM_elem_index_set(v, i); /* set_ok */
+      if (attrs.hide_vert && attrs.hide_vert[i]) {
+        BM_elem_flag_enable(v, BM_ELEM_HIDDEN);
+      }
+      copy_v3_v3(v->co, keyco ? keyco[i] : positions[i]);
+      if (vert_normals.is_empty()) {
+        zero_v3(v->no);
+      }
+      else {
+        copy_v3_v3(v->no, vert_normals[i]);
+      }
+
+      /* Link the disk cycle in the same order as #bmesh_disk_edge_append would. */
+      const Span<int> vert_edges = vert_to_edge_map[i];
+      v->e = vert_edges.is_empty() ? nullptr : etable[vert_edges.first()];
+      for (const int j : vert_edges.index_range()) {
+        BMDiskLink *disk_link = bmesh_disk_edge_link_from_vert(etable[vert_edges[j]], v);
+        disk_link->prev = etable[vert_edges[(j == 0) ? vert_edges.size() - 1 : j - 1]];
+        disk_link->next = etable[vert_edges[(j + 1 == vert_edges.size()) ? 0 : j + 1]];
+      }
+    }
+  });
+
+  threading::parallel_for(etable.index_range(), 2048, [&](const IndexRange range) {
+    for (const int i : range) {
+      BMEdge *e = etable[i];
+      e->head.htype = BM_EDGE;
+      e->head.hflag = 0;
+      e->head.api_flag = 0;
+      BM_elem_index_set(e, i); /* set_ok */
+      if (attrs.uv_seams && attrs.uv_seams[i]) {
+        BM_elem_flag_enable(e, BM_ELEM_SEAM);
+      }
+      if (attrs.hide_edge && attrs.hide_edge[i]) {
+        BM_elem_flag_enable(e, BM_ELEM_HIDDEN);
+      }
+      if (!(attrs.sharp_edges && attrs.sharp_edges[i])) {
+        BM_elem_flag_enable(e, BM_ELEM_SMOOTH);
+      }
+      e->v1 = vtable[edges[i][0]];
+      e->v2 = vtable[edges[i][1]];
+
+      /* Link the radial cycle in the same order as #bmesh_radial_loop_append would. */
+      const Span<int> edge_loops = edge_to_loop_map[i];
+      e->l = edge_loops.is_empty() ? nullptr : ltable[edge_loops.last()];
+      for (const int j : edge_loops.index_range()) {
+        BMLoop *l = ltable[edge_loops[j]];
+        l->radial_prev = ltable[edge_loops[(j == 0) ? edge_loops.size() - 1 : j - 1]];
+        l->radial_next = ltable[edge_loops[(j + 1 == edge_loops.size()) ? 0 : j + 1]];
+      }
+    }
+  });
+
+  threading::parallel_for(ftable.index_range(), 1024, [&](const IndexRange range) {
+    for (const int i : range) {
+      BMFace *f = ftable[i];
+      const IndexRange face = faces[i];
+      f->head.htype = BM_FACE;
+      f->head.hflag = 0;
+      f->head.api_flag = 0;
+      BM_elem_index_set(f, i); /* set_ok */
+      if (!(attrs.sharp_faces && attrs.sharp_faces[i])) {
+        BM_elem_flag_enable(f, BM_ELEM_SMOOTH);
+      }
+      if (attrs.hide_poly && attrs.hide_poly[i]) {
+        BM_elem_flag_enable(f, BM_ELEM_HIDDEN);
+      }
+      f->l_first = ltable[face.start()];
+      f->len = int(face.size());
+      f->mat_nr = attrs.material_indices == nullptr ? 0 : attrs.material_indices[i];
+      zero_v3(f->no);
+
+      for (const int corner : face) {
+        BMLoop *l = ltable[corner];
+        l->head.htype = BM_LOOP;
+        l->head.hflag = 0;
+        l->head.api_flag = 0;
+        BM_elem_index_set(l, corner); /* set_ok */
+        l->v = vtable[corner_verts[corner]];
+        l->e = etable[corner_edges[corner]];
+        l->f = f;
+        l->prev = ltable[(corner == face.first()) ? face.last() : corner - 1];
+        l->next = ltable[(corner == face.last()) ? face.first() : corner + 1];
+      }
+    }
+  });
+
+  threading::parallel_invoke(
+      mesh.totvert + mesh.totloop > 1024,
+      [&]() {
+        mesh_attributes_copy_to_bmesh_blocks<BMVert>(vert_info, vtable);
+        if (cd_shape_keyindex_offset == -1 && shape_key_table.is_empty()) {
+          return;
+        }
+        threading::parallel_for(vtable.index_range(), 4096, [&](const IndexRange range) {
+          for (const int i : range) {
+            BMVert *v = vtable[i];
+            /* Set shape key original index. */
+            if (cd_shape_keyindex_offset != -1) {
+              BM_ELEM_CD_SET_INT(v, cd_shape_keyindex_offset, i);
+            }
+            /* Set shape-key data. */
+            if (!shape_key_table.is_empty()) {
+              float(*co_dst)[3] = (float(*)[3])BM_ELEM_CD_GET_VOID_P(v, cd_shape_key_offset);
+              for (const int j : shape_key_table.index_range()) {
+                copy_v3_v3(co_dst[j], shape_key_table[j][i]);
+              }
+            }
+          }
+        });
+      },
+      [&]() { mesh_attributes_copy_to_bmesh_blocks<BMEdge>(edge_info, etable); },
+      [&]() { mesh_attributes_copy_to_bmesh_blocks<BMFace>(poly_info, ftable); },
+      [&]() { mesh_attributes_copy_to_bmesh_blocks<BMLoop>(loop_info, ltable); });
+
+  if (params.calc_face_normal) {
+    threading::parallel_for(ftable.index_range(), 1024, [&](const IndexRange range) {
+      for (BMFace *f : ftable.slice(range)) {
+        BM_face_normal_update(f);
+      }
+    });
+  }
+
+  bm.totvert += mesh.totvert;
+  bm.totedge += mesh.totedge;
+  bm.totface += mesh.faces_num;
+  bm.totloop += mesh.totloop;
+  bm.elem_table_dirty |= BM_ALL_NOLOOP;
+  bm.spacearr_dirty |= BM_SPACEARR_DIRTY_ALL;
+
+  /* Selecting elements also selects their connected elements and changes the selection counts
+   * of the #BMesh, so it is done afterwards. */
+  if (attrs.select_vert) {
+    for (const int i : vtable.index_range()) {
+      if (attrs.select_vert[i]) {
+        BM_vert_select_set(&bm, vtable[i], true);
+      }
+    }
+  }
+  if (attrs.select_edge) {
+    for (const int i : etable.index_range()) {
+      if (attrs.select_edge[i]) {
+        BM_edge_select_set(&bm, etable[i], true);
+      }
+    }
+  }
+  if (attrs.select_poly) {
+    for (const int i : ftable.index_range()) {
+      if (attrs.select_poly[i]) {
+        BM_face_select_set(&bm, ftable[i], true);
+      }
+    }
+  }
+  if (mesh.act_face >= 0 && mesh.act_face < mesh.faces_num) {
+    bm.act_face = ftable[mesh.act_face];
+  }
+}
+
+/**
+ * MSelect clears the array elements (to avoid adding multiple times).
+ *
+ * Take care to call this last and not use the element tables after this.
+ */
+static void bm_select_history_from_me(BMesh &bm,
+                                      const Mesh &mesh,
+                                      MutableSpan<BMVert *> vtable,
+                                      MutableSpan<BMEdge *> etable,
+                                      MutableSpan<BMFace *> ftable)
+{
+  if (mesh.mselect && mesh.totselect != 0) {
+    for (const int i : IndexRange(mesh.totselect)) {
+      const MSelect &msel = mesh.mselect[i];
+
+      BMElem **ele_p;
+      switch (msel.type) {
+        case ME_VSEL:
+          ele_p = (BMElem **)&vtable[msel.index];
+          break;
+        case ME_ESEL:
+          ele_p = (BMElem **)&etable[msel.index];
+          break;
+        case ME_FSEL:
+          ele_p = (BMElem **)&ftable[msel.index];
+          break;
+        default:
+          continue;
+      }
+
+      if (*ele_p != nullptr) {
+        BM_select_history_store_notest(&bm, *ele_p);
+        *ele_p = nullptr;
+      }
+    }
+  }
+  else {
+    BM_select_history_clear(&bm);
+  }
+}
+
 void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const BMeshFromMeshParams *params)
 {
   if (!me) {
@@ -431,6 +785,42 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const BMeshFromMeshParams *pa
   const bool *uv_seams = (const bool *)CustomData_get_layer_named(
       &me->edge_data, CD_PROP_BOOL, ".uv_seam");
 
+  if (is_new && !mesh_has_empty_faces(*me)) {
+    const MeshToBMeshBuiltinAttributes attrs{select_vert,
+                                             select_edge,
+                                             select_poly,
+                                             hide_vert,
+                                             hide_edge,
+                                             hide_poly,
+                                             material_indices,
+                                             sharp_faces,
+                                             sharp_edges,
+                                             uv_seams};
+    Array<BMVert *> vtable(me->totvert);
+    Array<BMEdge *> etable(me->totedge);
+    Array<BMFace *> ftable(me->faces_num);
+    bm_mesh_elems_create_from_me_bulk(*bm,
+                                      *me,
+                                      *params,
+                                      attrs,
+                                      keyco,
+                                      vert_normals,
+                                      Span(shape_key_table, tot_shape_keys),
+                                      cd_shape_key_offset,
+                                      cd_shape_keyindex_offset,
+                                      vert_info,
+                                      edge_info,
+                                      poly_info,
+                                      loop_info,
+                                      vtable,
+                                      etable,
+                                      ftable);
+    /* Added in order, clear dirty flag. */
+    bm->elem_index_dirty &= ~(BM_VERT | BM_EDGE | BM_FACE | BM_LOOP);
+    bm_select_history_from_me(*bm, *me, vtable, etable, ftable);
+    return;
+  }
+
   const Span<float3> positions = me->vert_positions();
   Array<BMVert *> vtable(me->totvert);
   for (const int i : positions.index_range()) {
@@ -565,40 +955,7 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const BMeshFromMeshParams *pa
     bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP); /* Added in order, clear dirty flag. */
   }
 
-  /* -------------------------------------------------------------------- */
-  /* MSelect clears the array elements (to avoid adding multiple times).
-   *
-   * Take care to keep this last and not use (v/e/ftable) after this.
-   */
-
-  if (me->mselect && me->totselect != 0) {
-    for (const int i : IndexRange(me->totselect)) {
-      const MSelect &msel = me->mselect[i];
-
-      BMElem **ele_p;
-      switch (msel.type) {
-        case ME_VSEL:
-          ele_p = (BMElem **)&vtable[msel.index];
-          break;
-        case ME_ESEL:
-          ele_p = (BMElem **)&etable[msel.index];
-          break;
-        case ME_FSEL:
-          ele_p = (BMElem **)&ftable[msel.index];
-          break;
-        default:
-          continue;
-      }
-
-      if (*ele_p != nullptr) {
-        BM_select_history_store_notest(bm, *ele_p);
-        *ele_p = nullptr;
-      }
-    }
-  }
-  else {
-    BM_select_history_clear(bm);
-  }
+  bm_select_history_from_me(*bm, *me, vtable, etable, ftable);
 }
 
 /**
@@ -1243,14 +1600,21 @@ static void bm_face_loop_table_build(BMesh &bm,
   }
 }
 
-static void bmesh_block_copy_to_mesh_attributes(const Span<BMeshToMeshLayerInfo> copy_info,
-                                                const int mesh_index,
-                                                const void *block)
+/**
+ * Copy the attribute values of a range of elements. Every layer is copied separately so that the
+ * writes to the mesh are sequential.
+ */
+template<typename T>
+static void bmesh_blocks_copy_to_mesh_attributes(const Span<BMeshToMeshLayerInfo> copy_info,
+                                                 const Span<const T *> elems,
+                                                 const IndexRange range)
 {
   for (const BMeshToMeshLayerInfo &info : copy_info) {
-    CustomData_data_copy_value(info.type,
-                               POINTER_OFFSET(block, info.bmesh_offset),
-                               POINTER_OFFSET(info.mesh_data, info.elem_size * mesh_index));
+    for (const int i : range) {
+      CustomData_data_copy_value(info.type,
+                                 POINTER_OFFSET(elems[i]->head.data, info.bmesh_offset),
+                                 POINTER_OFFSET(info.mesh_data, info.elem_size * i));
+    }
   }
 }
 
@@ -1271,9 +1635,9 @@ static void bm_to_mesh_verts(const BMesh &bm,
     for (const int vert_i : range) {
       const BMVert &src_vert = *bm_verts[vert_i];
       copy_v3_v3(dst_vert_positions[vert_i], src_vert.co);
-      bmesh_block_copy_to_mesh_attributes(info, vert_i, src_vert.head.data);
       any_loose_vert_local = any_loose_vert_local || src_vert.e == nullptr;
     }
+    bmesh_blocks_copy_to_mesh_attributes(info.as_span(), bm_verts, range);
     if (any_loose_vert_local) {
       any_loose_vert.store(true, std::memory_order_relaxed);
     }
@@ -1313,9 +1677,9 @@ static void bm_to_mesh_edges(const BMesh &bm,
     for (const int edge_i : range) {
       const BMEdge &src_edge = *bm_edges[edge_i];
       dst_edges[edge_i] = int2(BM_elem_index_get(src_edge.v1), BM_elem_index_get(src_edge.v2));
-      bmesh_block_copy_to_mesh_attributes(info, edge_i, src_edge.head.data);
       any_loose_edge_local |= BM_edge_is_wire(&src_edge);
     }
+    bmesh_blocks_copy_to_mesh_attributes(info.as_span(), bm_edges, range);
     if (any_loose_edge_local) {
       any_loose_edge.store(true, std::memory_order_relaxed);
     }
@@ -1361,8 +1725,8 @@ static void bm_to_mesh_faces(const BMesh &bm,
     for (const int face_i : range) {
       const BMFace &src_face = *bm_faces[face_i];
       dst_face_offsets[face_i] = BM_elem_index_get(BM_FACE_FIRST_LOOP(&src_face));
-      bmesh_block_copy_to_mesh_attributes(info, face_i, src_face.head.data);
     }
+    bmesh_blocks_copy_to_mesh_attributes(info.as_span(), bm_faces, range);
     if (!select_poly.is_empty()) {
       for (const int face_i : range) {
         select_poly[face_i] = BM_elem_flag_test(bm_faces[face_i], BM_ELEM_SELECT);
@@ -1400,8 +1764,8 @@ static void bm_to_mesh_loops(const BMesh &bm, const Span<const BMLoop *> bm_loop
       const BMLoop &src_loop = *bm_loops[loop_i];
       dst_corner_verts[loop_i] = BM_elem_index_get(src_loop.v);
       dst_corner_edges[loop_i] = BM_elem_index_get(src_loop.e);
-      bmesh_block_copy_to_mesh_attributes(info, loop_i, src_loop.head.data);
     }
+    bmesh_blocks_copy_to_mesh_attributes(info.as_span(), bm_loops, range);
   });
 }
 
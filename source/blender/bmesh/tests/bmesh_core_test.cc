@@ -4,8 +4,21 @@
 
 #include "testing/testing.h"
 
+#include "MEM_guardedalloc.h"
+
+#include "BLI_array.hh"
 #include "BLI_math.h"
+#include "BLI_math_vector_types.hh"
+#include "BLI_mempool.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
+
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.hh"
+
+#include "DNA_mesh_types.h"
+
 #include "bmesh.h"
 
 TEST(bmesh_core, BMVertCreate)
@@ -42,3 +55,311 @@ TEST(bmesh_core, BMVertCreate)
   EXPECT_EQ(BM_mesh_elem_count(bm, BM_VERT), 3);
   BM_mesh_free(bm);
 }
+
+TEST(bmesh_core, CustomDataCompact)
+{
+  BMeshCreateParams bmesh_create_params{};
+  BMesh *bm = BM_mesh_create(&bm_mesh_allocsize_default, &bmesh_create_params);
+  BM_data_layer_add(bm, &bm->vdata, CD_PROP_FLOAT);
+
+  /* Few enough elements for the compacted blocks to fit into a single pool chunk. */
+  const int verts_num = 600;
+  BMVert **verts = static_cast<BMVert **>(MEM_mallocN(sizeof(BMVert *) * verts_num, __func__));
+  for (int i = 0; i < verts_num; i++) {
+    verts[i] = BM_vert_create(bm, nullptr, nullptr, BM_CREATE_NOP);
+    BM_elem_float_data_set(&bm->vdata, verts[i], CD_PROP_FLOAT, float(i));
+  }
+  for (int i = 0; i < verts_num; i += 2) {
+    BM_vert_kill(bm, verts[i]);
+  }
+  EXPECT_EQ(BLI_mempool_len(bm->vdata.pool), verts_num / 2);
+
+  BM_mesh_customdata_compact(bm, BM_VERT);
+  EXPECT_EQ(BLI_mempool_len(bm->vdata.pool), verts_num / 2);
+
+  /* The blocks follow each other in element order and still hold the data of their element. */
+  BMIter iter;
+  BMVert *v;
+  int i;
+  const char *first_block = static_cast<const char *>(BM_vert_at_index_find(bm, 0)->head.data);
+  const int64_t stride = static_cast<const char *>(BM_vert_at_index_find(bm, 1)->head.data) -
+                         first_block;
+  EXPECT_GE(stride, bm->vdata.totsize);
+  BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+    EXPECT_EQ(v, verts[i * 2 + 1]);
+    EXPECT_EQ(v->head.data, first_block + i * stride);
+    EXPECT_EQ(BM_elem_float_data_get(&bm->vdata, v, CD_PROP_FLOAT), float(i * 2 + 1));
+  }
+  EXPECT_EQ(i, verts_num / 2);
+
+  MEM_freeN(verts);
+  BM_mesh_free(bm);
+}
+
+TEST(bmesh_core, CustomDataCompactDenselyUsed)
+{
+  BMeshCreateParams bmesh_create_params{};
+  BMesh *bm = BM_mesh_create(&bm_mesh_allocsize_default, &bmesh_create_params);
+  BM_data_layer_add(bm, &bm->vdata, CD_PROP_FLOAT);
+
+  const int verts_num = 1000;
+  BMVert **verts = static_cast<BMVert **>(MEM_mallocN(sizeof(BMVert *) * verts_num, __func__));
+  for (int i = 0; i < verts_num; i++) {
+    verts[i] = BM_vert_create(bm, nullptr, nullptr, BM_CREATE_NOP);
+    BM_elem_float_data_set(&bm->vdata, verts[i], CD_PROP_FLOAT, float(i));
+  }
+  for (int i = 0; i < verts_num; i += 10) {
+    BM_vert_kill(bm, verts[i]);
+  }
+
+  /* Most blocks are still used, so they are left where they are. */
+  const BLI_mempool *pool = bm->vdata.pool;
+  void *block = verts[1]->head.data;
+  BM_mesh_customdata_compact(bm, BM_VERT);
+  EXPECT_EQ(bm->vdata.pool, pool);
+  EXPECT_EQ(verts[1]->head.data, block);
+  for (int i = 0; i < verts_num; i++) {
+    if (i % 10 != 0) {
+      EXPECT_EQ(BM_elem_float_data_get(&bm->vdata, verts[i], CD_PROP_FLOAT), float(i));
+    }
+  }
+
+  MEM_freeN(verts);
+  BM_mesh_free(bm);
+}
+
+TEST(bmesh_core, CustomDataCompactLoops)
+{
+  BMeshCreateParams bmesh_create_params{};
+  BMesh *bm = BM_mesh_create(&bm_mesh_allocsize_default, &bmesh_create_params);
+  BM_data_layer_add(bm, &bm->ldata, CD_PROP_FLOAT);
+  BM_data_layer_add(bm, &bm->pdata, CD_PROP_INT32);
+
+  /* A strip of quads, every loop stores the index of its face and its corner. */
+  const int faces_num = 100;
+  blender::Vector<BMVert *> verts;
+  for (int i = 0; i <= faces_num; i++) {
+    verts.append(BM_vert_create(bm, blender::float3(i, 0, 0), nullptr, BM_CREATE_NOP));
+    verts.append(BM_vert_create(bm, blender::float3(i, 1, 0), nullptr, BM_CREATE_NOP));
+  }
+  blender::Vector<BMFace *> faces;
+  for (int i = 0; i < faces_num; i++) {
+    BMVert *quad[4] = {verts[i * 2], verts[i * 2 + 2], verts[i * 2 + 3], verts[i * 2 + 1]};
+    BMFace *f = BM_face_create_verts(bm, quad, 4, nullptr, BM_CREATE_NOP, true);
+    *static_cast<int *>(CustomData_bmesh_get(&bm->pdata, f->head.data, CD_PROP_INT32)) = i;
+    BMLoop *l_iter = BM_FACE_FIRST_LOOP(f);
+    for (int corner = 0; corner < 4; corner++, l_iter = l_iter->next) {
+      BM_elem_float_data_set(&bm->ldata, l_iter, CD_PROP_FLOAT, float(i * 4 + corner));
+    }
+    faces.append(f);
+  }
+  for (int i = 0; i < faces_num; i++) {
+    if (i % 4 != 0) {
+      BM_face_kill(bm, faces[i]);
+    }
+  }
+
+  BM_mesh_customdata_compact(bm, BM_LOOP | BM_FACE);
+
+  BMIter iter;
+  BMFace *f;
+  int i;
+  BMFace *f_first = BM_face_at_index_find(bm, 0);
+  BMFace *f_second = BM_face_at_index_find(bm, 1);
+  const char *first_face_block = static_cast<const char *>(f_first->head.data);
+  const char *first_loop_block = static_cast<const char *>(BM_FACE_FIRST_LOOP(f_first)->head.data);
+  const int64_t face_stride = static_cast<const char *>(f_second->head.data) - first_face_block;
+  const int64_t loop_stride =
+      static_cast<const char *>(BM_FACE_FIRST_LOOP(f_first)->next->head.data) - first_loop_block;
+  EXPECT_GE(face_stride, bm->pdata.totsize);
+  EXPECT_GE(loop_stride, bm->ldata.totsize);
+  BM_ITER_MESH_INDEX (f, &iter, bm, BM_FACES_OF_MESH, i) {
+    const int face_orig = i * 4;
+    EXPECT_EQ(f, faces[face_orig]);
+    EXPECT_EQ(f->head.data, first_face_block + i * face_stride);
+    EXPECT_EQ(*static_cast<int *>(CustomData_bmesh_get(&bm->pdata, f->head.data, CD_PROP_INT32)),
+              face_orig);
+    BMLoop *l_iter = BM_FACE_FIRST_LOOP(f);
+    for (int corner = 0; corner < 4; corner++, l_iter = l_iter->next) {
+      EXPECT_EQ(l_iter->head.data, first_loop_block + (i * 4 + corner) * loop_stride);
+      EXPECT_EQ(BM_elem_float_data_get(&bm->ldata, l_iter, CD_PROP_FLOAT),
+                float(face_orig * 4 + corner));
+    }
+  }
+  EXPECT_EQ(i, faces_num / 4);
+
+  BM_mesh_free(bm);
+}
+
+/**
+ * A 2x2 grid of quads with an extra triangle on the middle edge between the first two quads,
+ * to have boundaries, interior vertices and a non-manifold edge.
+ */
+static Mesh *create_test_mesh()
+{
+  using namespace blender;
+  const Array<float3> positions = {{0, 0, 0},
+                                   {1, 0, 0},
+                                   {2, 0, 0},
+                                   {0, 1, 0},
+                                   {1, 1, 0},
+                                   {2, 1, 0},
+                                   {0, 2, 0},
+                                   {1, 2, 0},
+                                   {2, 2, 0},
+                                   {1, 0.5f, 1}};
+  const Array<int2> edges = {{0, 1},
+                             {1, 2},
+                             {3, 4},
+                             {4, 5},
+                             {6, 7},
+                             {7, 8},
+                             {0, 3},
+                             {3, 6},
+                             {1, 4},
+                             {4, 7},
+                             {2, 5},
+                             {5, 8},
+                             {1, 9},
+                             {4, 9}};
+  const Array<Array<int>> faces = {
+      {0, 1, 4, 3}, {1, 2, 5, 4}, {3, 4, 7, 6}, {4, 5, 8, 7}, {1, 9, 4}};
+
+  int corners_num = 0;
+  for (const Span<int> face : faces) {
+    corners_num += face.size();
+  }
+  Mesh *mesh = BKE_mesh_new_nomain(positions.size(), edges.size(), faces.size(), corners_num);
+  mesh->vert_positions_for_write().copy_from(positions);
+  mesh->edges_for_write().copy_from(edges);
+  MutableSpan<int> face_offsets = mesh->face_offsets_for_write();
+  MutableSpan<int> corner_verts = mesh->corner_verts_for_write();
+  MutableSpan<int> corner_edges = mesh->corner_edges_for_write();
+  int corner = 0;
+  for (const int face : faces.index_range()) {
+    face_offsets[face] = corner;
+    for (const int i : faces[face].index_range()) {
+      const int vert = faces[face][i];
+      const int vert_next = faces[face][(i + 1) % faces[face].size()];
+      corner_verts[corner] = vert;
+      const Span<int2> edges_span = edges;
+      const int edge = edges_span.first_index_try(int2(vert, vert_next));
+      corner_edges[corner] = edge != -1 ? edge : edges_span.first_index(int2(vert_next, vert));
+      corner++;
+    }
+  }
+  face_offsets.last() = corner;
+  return mesh;
+}
+
+/** Create the elements of the mesh one by one, as the conversion into a non-empty BMesh does. */
+static BMesh *create_bmesh_elementwise(const Mesh &mesh)
+{
+  using namespace blender;
+  BMeshCreateParams bmesh_create_params{};
+  bmesh_create_params.use_toolflags = true;
+  BMesh *bm = BM_mesh_create(&bm_mesh_allocsize_default, &bmesh_create_params);
+
+  Array<BMVert *> verts(mesh.totvert);
+  for (const int i : mesh.vert_positions().index_range()) {
+    verts[i] = BM_vert_create(bm, mesh.vert_positions()[i], nullptr, BM_CREATE_NOP);
+  }
+  Array<BMEdge *> edges(mesh.totedge);
+  for (const int i : mesh.edges().index_range()) {
+    const int2 edge = mesh.edges()[i];
+    edges[i] = BM_edge_create(bm, verts[edge[0]], verts[edge[1]], nullptr, BM_CREATE_NOP);
+  }
+  for (const int i : mesh.faces().index_range()) {
+    const IndexRange face = mesh.faces()[i];
+    Vector<BMVert *> face_verts;
+    Vector<BMEdge *> face_edges;
+    for (const int corner : face) {
+      face_verts.append(verts[mesh.corner_verts()[corner]]);
+      face_edges.append(edges[mesh.corner_edges()[corner]]);
+    }
+    BM_face_create(
+        bm, face_verts.data(), face_edges.data(), face.size(), nullptr, BM_CREATE_NOP);
+  }
+  return bm;
+}
+
+TEST(bmesh_core, BMeshFromMeshBulk)
+{
+  BKE_idtype_init();
+  Mesh *mesh = create_test_mesh();
+
+  BMeshCreateParams bmesh_create_params{};
+  bmesh_create_params.use_toolflags = true;
+  BMesh *bm = BM_mesh_create(&bm_mesh_allocsize_default, &bmesh_create_params);
+  BMeshFromMeshParams from_mesh_params{};
+  BM_mesh_bm_from_me(bm, mesh, &from_mesh_params);
+  BMesh *bm_reference = create_bmesh_elementwise(*mesh);
+
+  BM_mesh_elem_table_ensure(bm, BM_ALL_NOLOOP);
+  BM_mesh_elem_index_ensure(bm, BM_ALL);
+  BM_mesh_elem_table_ensure(bm_reference, BM_ALL_NOLOOP);
+  BM_mesh_elem_index_ensure(bm_reference, BM_ALL);
+  ASSERT_EQ(bm->totvert, bm_reference->totvert);
+  ASSERT_EQ(bm->totedge, bm_reference->totedge);
+  ASSERT_EQ(bm->totface, bm_reference->totface);
+  ASSERT_EQ(bm->totloop, bm_reference->totloop);
+
+  /* Tool flags of every element type are allocated and independent. */
+  const short oflag = 1 << 0;
+  for (int i = 0; i < bm->totedge; i++) {
+    BMEdge *e = BM_edge_at_index(bm, i);
+    EXPECT_FALSE(BMO_edge_flag_test(bm, e, oflag));
+    BMO_edge_flag_enable(bm, e, oflag);
+    EXPECT_TRUE(BMO_edge_flag_test(bm, e, oflag));
+  }
+  for (int i = 0; i < bm->totface; i++) {
+    BMFace *f = BM_face_at_index(bm, i);
+    EXPECT_FALSE(BMO_face_flag_test(bm, f, oflag));
+    BMO_face_flag_enable(bm, f, oflag);
+    EXPECT_TRUE(BMO_face_flag_test(bm, f, oflag));
+  }
+  for (int i = 0; i < bm->totvert; i++) {
+    EXPECT_FALSE(BMO_vert_flag_test(bm, BM_vert_at_index(bm, i), oflag));
+  }
+
+  /* Disk and radial cycles are in the same order as when creating elements one by one. */
+  for (int i = 0; i < bm->totvert; i++) {
+    BMVert *v = BM_vert_at_index(bm, i);
+    BMVert *v_reference = BM_vert_at_index(bm_reference, i);
+    ASSERT_EQ(BM_vert_edge_count(v), BM_vert_edge_count(v_reference));
+    if (v->e == nullptr) {
+      EXPECT_EQ(v_reference->e, nullptr);
+      continue;
+    }
+    BMEdge *e = v->e;
+    BMEdge *e_reference = v_reference->e;
+    do {
+      EXPECT_EQ(BM_elem_index_get(e), BM_elem_index_get(e_reference));
+      e = BM_DISK_EDGE_NEXT(e, v);
+      e_reference = BM_DISK_EDGE_NEXT(e_reference, v_reference);
+    } while (e != v->e);
+  }
+  for (int i = 0; i < bm->totedge; i++) {
+    BMEdge *e = BM_edge_at_index(bm, i);
+    BMEdge *e_reference = BM_edge_at_index(bm_reference, i);
+    EXPECT_EQ(BM_elem_index_get(e->v1), BM_elem_index_get(e_reference->v1));
+    EXPECT_EQ(BM_elem_index_get(e->v2), BM_elem_index_get(e_reference->v2));
+    ASSERT_EQ(BM_edge_face_count(e), BM_edge_face_count(e_reference));
+    if (e->l == nullptr) {
+      continue;
+    }
+    BMLoop *l = e->l;
+    BMLoop *l_reference = e_reference->l;
+    do {
+      EXPECT_EQ(BM_elem_index_get(l), BM_elem_index_get(l_reference));
+      EXPECT_EQ(BM_elem_index_get(l->f), BM_elem_index_get(l_reference->f));
+      EXPECT_EQ(BM_elem_index_get(l->next), BM_elem_index_get(l_reference->next));
+      l = l->radial_next;
+      l_reference = l_reference->radial_next;
+    } while (l != e->l);
+  }
+
+  BM_mesh_free(bm);
+  BM_mesh_free(bm_reference);
+  BKE_id_free(nullptr, mesh);
+}
@@ -347,8 +347,9 @@ void COM_deinitialize(void);
 /**
  * \brief Clear all compositor caches. (Compositor system will still remain available).
  * To deinitialize the compositor use the COM_deinitialize method.
+ * Waits for any running compositor execution to finish.
  */
-// void COM_clear_caches(void); // NOT YET WRITTEN
+void COM_clear_caches(void);
 
 #ifdef __cplusplus
 }
@@ -110,6 +110,9 @@ constexpr float COM_PREVIEW_SIZE = 140.f;
 constexpr float COM_RULE_OF_THIRDS_DIVIDER = 100.0f;
 constexpr float COM_BLUR_BOKEH_PIXELS = 512;
 
+/** Memory budget of operation results kept across executions of the full frame compositor. */
+constexpr int64_t COM_RESULTS_CACHE_MEMORY_BUDGET = int64_t(1024) * 1024 * 1024;
+
 constexpr rcti COM_AREA_NONE = {0, 0, 0, 0};
 constexpr rcti COM_CONSTANT_INPUT_AREA_OF_INTEREST = COM_AREA_NONE;
 
@@ -24,7 +24,8 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
                                  bNodeTree *editingtree,
                                  bool rendering,
                                  bool fastcalculation,
-                                 const char *view_name)
+                                 const char *view_name,
+                                 OperationResultsCache *results_cache)
 {
   num_work_threads_ = WorkScheduler::get_num_cpu_threads();
   context_.set_view_name(view_name);
@@ -58,6 +59,7 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
       execution_model_ = new TiledExecutionModel(context_, operations_, groups_);
       break;
     case eExecutionModel::FullFrame:
+      active_buffers_.set_results_cache(results_cache);
       execution_model_ = new FullFrameExecutionModel(context_, active_buffers_, operations_);
       break;
     default:
@@ -108,6 +108,7 @@ namespace blender::compositor {
 class ExecutionGroup;
 class ExecutionModel;
 class NodeOperation;
+class OperationResultsCache;
 
 /**
  * \brief the ExecutionSystem contains the whole compositor tree.
@@ -155,13 +156,16 @@ class ExecutionSystem {
    *
    * \param editingtree: [bNodeTree *]
    * \param rendering: [true false]
+   * \param results_cache: Cache of operation results kept across executions, only used by the
+   * full frame execution model. May be null.
    */
   ExecutionSystem(RenderData *rd,
                   Scene *scene,
                   bNodeTree *editingtree,
                   bool rendering,
                   bool fastcalculation,
-                  const char *view_name);
+                  const char *view_name,
+                  OperationResultsCache *results_cache = nullptr);
 
   /**
    * Destructor
@@ -4,9 +4,13 @@
 
 #include "COM_FullFrameExecutionModel.h"
 
+#include "BLI_map.hh"
+#include "BLI_set.hh"
+
 #include "BLT_translation.h"
 
 #include "COM_Debug.h"
+#include "COM_SharedOperationBuffers.h"
 #include "COM_ViewerOperation.h"
 #include "COM_WorkScheduler.h"
 
@@ -38,10 +42,52 @@ void FullFrameExecutionModel::execute(ExecutionSystem &exec_system)
 
   DebugInfo::graphviz(&exec_system, "compositor_prior_rendering");
 
+  determine_result_hashes();
   determine_areas_to_render_and_reads();
   render_operations();
 }
 
+static void generate_result_hash_recursive(NodeOperation *op,
+                                           Set<NodeOperation *> &visited,
+                                           Map<NodeOperation *, NodeOperationHash> &r_hashes)
+{
+  if (!visited.add(op)) {
+    return;
+  }
+  for (int i = 0; i < op->get_number_of_input_sockets(); i++) {
+    NodeOperation *input_op = op->get_input_operation(i);
+    if (input_op) {
+      generate_result_hash_recursive(input_op, visited, r_hashes);
+    }
+  }
+  std::optional<NodeOperationHash> hash = op->generate_result_hash(r_hashes);
+  if (hash) {
+    r_hashes.add_new(op, *hash);
+  }
+}
+
+void FullFrameExecutionModel::determine_result_hashes()
+{
+  Set<NodeOperation *> visited;
+  Map<NodeOperation *, NodeOperationHash> result_hashes;
+  for (NodeOperation *op : operations_) {
+    generate_result_hash_recursive(op, visited, result_hashes);
+  }
+
+  /* Constant operations are cheap to render and outputs may have side effects, don't cache
+   * them. */
+  const bool is_rendering = context_.is_rendering();
+  for (const auto item : result_hashes.items()) {
+    NodeOperation *op = item.key;
+    if (op->get_flags().is_constant_operation || op->is_output_operation(is_rendering) ||
+        op->get_number_of_output_sockets() == 0)
+    {
+      continue;
+    }
+    active_buffers_.set_result_hash(op, item.value);
+  }
+}
+
 void FullFrameExecutionModel::determine_areas_to_render_and_reads()
 {
   const bool is_rendering = context_.is_rendering();
@@ -146,7 +192,8 @@ void FullFrameExecutionModel::render_operations()
  * Returns all dependencies from inputs to outputs. A dependency may be repeated when
  * several operations depend on it.
  */
-static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operation)
+static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operation,
+                                                          SharedOperationBuffers &buffers)
 {
   /* Get dependencies from outputs to inputs. */
   Vector<NodeOperation *> dependencies;
@@ -156,6 +203,10 @@ static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operati
     Vector<NodeOperation *> outputs(next_outputs);
     next_outputs.clear();
     for (NodeOperation *output : outputs) {
+      /* Inputs of already rendered operations, such as cached ones, aren't needed. */
+      if (buffers.is_operation_rendered(output)) {
+        continue;
+      }
       for (int i = 0; i < output->get_number_of_input_sockets(); i++) {
         next_outputs.append(output->get_input_operation(i));
       }
@@ -172,7 +223,7 @@ static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operati
 void FullFrameExecutionModel::render_output_dependencies(NodeOperation *output_op)
 {
   BLI_assert(output_op->is_output_operation(context_.is_rendering()));
-  Vector<NodeOperation *> dependencies = get_operation_dependencies(output_op);
+  Vector<NodeOperation *> dependencies = get_operation_dependencies(output_op, active_buffers_);
   for (NodeOperation *op : dependencies) {
     if (!active_buffers_.is_operation_rendered(op)) {
       render_operation(op);
@@ -196,6 +247,10 @@ void FullFrameExecutionModel::determine_areas_to_render(NodeOperation *output_op
       continue;
     }
 
+    if (active_buffers_.use_cached_result(operation)) {
+      continue;
+    }
+
     active_buffers_.register_area(operation, render_area);
 
     const int num_inputs = operation->get_number_of_input_sockets();
@@ -223,7 +278,10 @@ void FullFrameExecutionModel::determine_reads(NodeOperation *output_op)
     const int num_inputs = operation->get_number_of_input_sockets();
     for (int i = 0; i < num_inputs; i++) {
       NodeOperation *input_op = operation->get_input_operation(i);
-      if (!active_buffers_.has_registered_reads(input_op)) {
+      /* Inputs of cached operations are not read. */
+      if (!active_buffers_.has_registered_reads(input_op) &&
+          !active_buffers_.is_operation_rendered(input_op))
+      {
         stack.append(input_op);
       }
       active_buffers_.register_read(input_op);
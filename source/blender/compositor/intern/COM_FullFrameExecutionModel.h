@@ -51,6 +51,11 @@ class FullFrameExecutionModel : public ExecutionModel {
   void execute(ExecutionSystem &exec_system) override;
 
  private:
+  /**
+   * Sets the hashes identifying operations results across executions, so that their rendered
+   * buffers can be cached and reused when their parameters and upstream operations don't change.
+   */
+  void determine_result_hashes();
   void determine_areas_to_render_and_reads();
   /**
    * Render output operations in order of priority.
@@ -73,7 +78,8 @@ class FullFrameExecutionModel : public ExecutionModel {
    */
   void get_output_render_area(NodeOperation *output_op, rcti &r_area);
   /**
-   * Determines all operations areas needed to render given output area.
+   * Determines all operations areas needed to render given output area. Operations with a cached
+   * result are set as rendered and their inputs are skipped.
    */
   void determine_areas_to_render(NodeOperation *output_op, const rcti &output_area);
   /**
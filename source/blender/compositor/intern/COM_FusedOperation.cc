@@ -0,0 +1,146 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include <algorithm>
+#include <memory>
+
+#include "BLI_array.hh"
+#include "BLI_rect.h"
+
+#include "COM_FusedOperation.h"
+
+namespace blender::compositor {
+
+/**
+ * Number of pixels processed by each fused operation at once. Small enough for the intermediate
+ * results of a few operations to fit in the CPU cache.
+ */
+constexpr int FUSED_STRIP_PIXELS = 8192;
+
+FusedOperation::FusedOperation(DataType output_type)
+{
+  this->add_output_socket(output_type);
+}
+
+FusedOperation::~FusedOperation()
+{
+  for (MultiThreadedOperation *operation : operations_) {
+    delete operation;
+  }
+}
+
+void FusedOperation::add_fused_operation(MultiThreadedOperation *operation)
+{
+  BLI_assert(operation->get_flags().can_be_fused);
+
+  Vector<InputSource> input_sources;
+  for (int i = 0; i < operation->get_number_of_input_sockets(); i++) {
+    NodeOperationInput *input = operation->get_input_socket(i);
+    const NodeOperation *linked_operation = &input->get_link()->get_operation();
+
+    int operation_index = -1;
+    for (const int j : operations_.index_range()) {
+      if (operations_[j] == linked_operation) {
+        operation_index = j;
+        break;
+      }
+    }
+    if (operation_index != -1) {
+      input_sources.append({operation_index, -1});
+      continue;
+    }
+
+    add_input_socket(input->get_data_type(), input->get_resize_mode());
+    fused_inputs_.append(input);
+    input_sources.append({-1, int(fused_inputs_.size()) - 1});
+  }
+
+  operations_.append(operation);
+  input_sources_.append(std::move(input_sources));
+  flags_.can_be_constant = false;
+}
+
+void FusedOperation::hash_output_params()
+{
+  for (const int i : operations_.index_range()) {
+    const std::optional<size_t> operation_hash = operations_[i]->generate_params_hash();
+    if (!operation_hash) {
+      NodeOperation::hash_output_params();
+      return;
+    }
+    hash_param(*operation_hash);
+    for (const InputSource &source : input_sources_[i]) {
+      hash_params(source.operation_index, source.input_index);
+    }
+  }
+}
+
+void FusedOperation::init_data()
+{
+  for (MultiThreadedOperation *operation : operations_) {
+    operation->init_data();
+  }
+}
+
+void FusedOperation::init_execution()
+{
+  for (MultiThreadedOperation *operation : operations_) {
+    operation->init_execution();
+  }
+}
+
+void FusedOperation::deinit_execution()
+{
+  for (MultiThreadedOperation *operation : operations_) {
+    operation->deinit_execution();
+  }
+}
+
+void FusedOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                  const rcti &area,
+                                                  Span<MemoryBuffer *> inputs)
+{
+  const int width = BLI_rcti_size_x(&area);
+  if (width <= 0) {
+    return;
+  }
+  const int strip_height = std::max(1, FUSED_STRIP_PIXELS / width);
+
+  /* Intermediate results of all operations but the last one, which writes the output. */
+  const int intermediates_num = operations_.size() - 1;
+  Array<Array<float>> intermediate_data(intermediates_num);
+  Array<int> intermediate_channels(intermediates_num);
+  for (const int i : IndexRange(intermediates_num)) {
+    const DataType data_type = operations_[i]->get_output_socket()->get_data_type();
+    intermediate_channels[i] = COM_data_type_num_channels(data_type);
+    intermediate_data[i].reinitialize(width * strip_height * intermediate_channels[i]);
+  }
+
+  Array<std::unique_ptr<MemoryBuffer>> intermediates(intermediates_num);
+  Vector<MemoryBuffer *> operation_inputs;
+  for (int y = area.ymin; y < area.ymax; y += strip_height) {
+    rcti strip;
+    BLI_rcti_init(&strip, area.xmin, area.xmax, y, std::min(y + strip_height, area.ymax));
+
+    for (const int i : operations_.index_range()) {
+      operation_inputs.clear();
+      for (const InputSource &source : input_sources_[i]) {
+        operation_inputs.append(source.operation_index == -1 ?
+                                    inputs[source.input_index] :
+                                    intermediates[source.operation_index].get());
+      }
+
+      MemoryBuffer *operation_output = output;
+      if (i < intermediates_num) {
+        intermediates[i] = std::make_unique<MemoryBuffer>(
+            intermediate_data[i].data(), intermediate_channels[i], strip);
+        operation_output = intermediates[i].get();
+      }
+
+      operations_[i]->update_memory_buffer_partial(operation_output, strip, operation_inputs);
+    }
+  }
+}
+
+}  // namespace blender::compositor
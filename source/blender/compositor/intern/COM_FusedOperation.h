@@ -0,0 +1,71 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include "BLI_vector.hh"
+
+#include "COM_MultiThreadedOperation.h"
+
+namespace blender::compositor {
+
+/**
+ * Executes a tree of operations that only read their inputs at the pixel they write (see
+ * #NodeOperationFlags.can_be_fused) in a single pass. The image is processed in strips of rows
+ * small enough for the intermediate results of all fused operations to stay in the CPU cache,
+ * instead of allocating a full frame buffer for every intermediate result.
+ *
+ * Created by #NodeOperationBuilder for the full frame execution model, it owns the fused
+ * operations. Its inputs are the inputs of the fused operations that aren't computed by other
+ * fused operations, its output is the output of the last fused operation.
+ */
+class FusedOperation : public MultiThreadedOperation {
+ private:
+  struct InputSource {
+    /** Index of the fused operation computing the input, or -1 for inputs of this operation. */
+    int operation_index;
+    /** Index of the input of this operation if the input isn't computed by a fused operation. */
+    int input_index;
+  };
+
+  /** Fused operations in execution order, the last one computes the output. */
+  Vector<MultiThreadedOperation *> operations_;
+  /** Sources of the inputs of each fused operation. */
+  Vector<Vector<InputSource>> input_sources_;
+  /** Inputs of fused operations that are inputs of this operation, by input index. */
+  Vector<NodeOperationInput *> fused_inputs_;
+
+ public:
+  FusedOperation(DataType output_type);
+  ~FusedOperation();
+
+  /**
+   * Add an operation to be executed after the already added ones, taking ownership of it. Inputs
+   * of the operation that aren't linked to an added operation become inputs of this operation.
+   */
+  void add_fused_operation(MultiThreadedOperation *operation);
+
+  Span<MultiThreadedOperation *> get_fused_operations() const
+  {
+    return operations_;
+  }
+
+  /** Input of a fused operation that corresponds to the given input of this operation. */
+  NodeOperationInput *get_fused_input(const int index) const
+  {
+    return fused_inputs_[index];
+  }
+
+  void init_data() override;
+  void init_execution() override;
+  void deinit_execution() override;
+
+ protected:
+  void hash_output_params() override;
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
+};
+
+}  // namespace blender::compositor
@@ -9,6 +9,9 @@
 namespace blender::compositor {
 
 class MultiThreadedOperation : public NodeOperation {
+  /* Executes the update of fused operations directly, see #FusedOperation. */
+  friend class FusedOperation;
+
  protected:
   /**
    * Number of execution passes.
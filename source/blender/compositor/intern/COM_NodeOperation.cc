@@ -40,6 +40,41 @@ const float *NodeOperation::get_constant_elem_default(const float *default_elem)
 }
 
 std::optional<NodeOperationHash> NodeOperation::generate_hash()
+{
+  return generate_hash([](NodeOperation &input) -> std::optional<size_t> {
+    return get_default_hash(input.get_id());
+  });
+}
+
+std::optional<NodeOperationHash> NodeOperation::generate_result_hash(
+    const Map<NodeOperation *, NodeOperationHash> &input_hashes)
+{
+  return generate_hash([&](NodeOperation &input) -> std::optional<size_t> {
+    const NodeOperationHash *input_hash = input_hashes.lookup_ptr(&input);
+    if (input_hash == nullptr) {
+      return std::nullopt;
+    }
+    return input_hash->hash();
+  });
+}
+
+std::optional<size_t> NodeOperation::generate_params_hash()
+{
+  params_hash_ = get_default_hash_2(canvas_.xmin, canvas_.xmax);
+
+  is_hash_output_params_implemented_ = true;
+  hash_output_params();
+  if (!is_hash_output_params_implemented_) {
+    return std::nullopt;
+  }
+
+  hash_params(canvas_.ymin, canvas_.ymax);
+  combine_hashes(params_hash_, typeid(*this).hash_code());
+  return params_hash_;
+}
+
+std::optional<NodeOperationHash> NodeOperation::generate_hash(
+    FunctionRef<std::optional<size_t>(NodeOperation &input)> get_input_hash)
 {
   params_hash_ = get_default_hash_2(canvas_.xmin, canvas_.xmax);
 
@@ -75,7 +110,11 @@ std::optional<NodeOperationHash> NodeOperation::generate_hash()
       }
     }
     else {
-      combine_hashes(hash.parents_hash_, get_default_hash(input.get_id()));
+      const std::optional<size_t> input_hash = get_input_hash(input);
+      if (!input_hash) {
+        return std::nullopt;
+      }
+      combine_hashes(hash.parents_hash_, *input_hash);
     }
   }
 
@@ -492,6 +531,9 @@ std::ostream &operator<<(std::ostream &os, const NodeOperationFlags &node_operat
   if (node_operation_flags.can_be_constant) {
     os << "can_be_constant,";
   }
+  if (node_operation_flags.can_be_fused) {
+    os << "can_be_fused,";
+  }
 
   return os;
 }
@@ -7,8 +7,10 @@
 #include <functional>
 #include <list>
 
+#include "BLI_function_ref.hh"
 #include "BLI_ghash.h"
 #include "BLI_hash.hh"
+#include "BLI_map.hh"
 #include "BLI_rect.h"
 #include "BLI_span.hh"
 #include "BLI_threads.h"
@@ -242,6 +244,13 @@ struct NodeOperationFlags {
    */
   bool can_be_constant : 1;
 
+  /**
+   * Whether operation is a single pass #MultiThreadedOperation that only reads its inputs at the
+   * pixel it writes. Such operations can be executed together without intermediate buffers, see
+   * #FusedOperation.
+   */
+  bool can_be_fused : 1;
+
   NodeOperationFlags()
   {
     complex = false;
@@ -260,6 +269,7 @@ struct NodeOperationFlags {
     is_fullframe_operation = false;
     is_constant_operation = false;
     can_be_constant = false;
+    can_be_fused = false;
   }
 };
 
@@ -297,6 +307,11 @@ struct NodeOperationHash {
            (type_hash_ == other.type_hash_ && parents_hash_ == other.parents_hash_ &&
             params_hash_ < other.params_hash_);
   }
+
+  uint64_t hash() const
+  {
+    return get_default_hash_3(type_hash_, parents_hash_, params_hash_);
+  }
 };
 
 /**
@@ -393,6 +408,22 @@ class NodeOperation {
    */
   std::optional<NodeOperationHash> generate_hash();
 
+  /**
+   * Generate a hash that identifies the operation result across executions. Inputs are
+   * identified by the hashes of their results in \a input_hashes instead of their ids, so the
+   * hash only changes when the operation parameters or any upstream operation change.
+   * Returns `std::nullopt` when the operation or any non constant input has no result hash.
+   */
+  std::optional<NodeOperationHash> generate_result_hash(
+      const Map<NodeOperation *, NodeOperationHash> &input_hashes);
+
+  /**
+   * Generate a hash of the operation type and parameters only, ignoring its inputs. Used by
+   * operations executing other operations to hash them.
+   * Requires `hash_output_params` to be implemented, otherwise `std::nullopt` is returned.
+   */
+  std::optional<size_t> generate_params_hash();
+
   unsigned int get_number_of_input_sockets() const
   {
     return inputs_.size();
@@ -785,6 +816,9 @@ class NodeOperation {
 
   /** \} */
 
+  std::optional<NodeOperationHash> generate_hash(
+      FunctionRef<std::optional<size_t>(NodeOperation &input)> get_input_hash);
+
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
 
@@ -5,6 +5,7 @@
 #include <set>
 
 #include "BLI_multi_value_map.hh"
+#include "BLI_set.hh"
 
 #include "BKE_node_runtime.hh"
 
@@ -12,6 +13,7 @@
 #include "COM_Debug.h"
 
 #include "COM_ExecutionGroup.h"
+#include "COM_FusedOperation.h"
 #include "COM_PreviewOperation.h"
 #include "COM_ReadBufferOperation.h"
 #include "COM_SetColorOperation.h"
@@ -95,6 +97,11 @@ void NodeOperationBuilder::convert_to_operations(ExecutionSystem *system)
   save_graphviz("compositor_prior_merging");
   merge_equal_operations();
 
+  if (context_->get_execution_model() == eExecutionModel::FullFrame) {
+    save_graphviz("compositor_prior_fusion");
+    fuse_operations();
+  }
+
   if (context_->get_execution_model() == eExecutionModel::Tiled) {
     /* surround complex ops with read/write buffer */
     add_complex_operation_buffers();
@@ -503,6 +510,93 @@ void NodeOperationBuilder::merge_equal_operations(NodeOperation *from, NodeOpera
   delete from;
 }
 
+/**
+ * Collect the given operation and the operations fused into it, with inputs before the
+ * operations reading them.
+ */
+static void collect_fused_operations_recursive(
+    NodeOperation *op,
+    const Map<NodeOperation *, NodeOperation *> &fused_into,
+    Vector<NodeOperation *> &r_operations)
+{
+  for (int i = 0; i < op->get_number_of_input_sockets(); i++) {
+    NodeOperation *input_op = &op->get_input_socket(i)->get_link()->get_operation();
+    if (fused_into.lookup_default(input_op, nullptr) == op) {
+      collect_fused_operations_recursive(input_op, fused_into, r_operations);
+    }
+  }
+  r_operations.append(op);
+}
+
+void NodeOperationBuilder::fuse_operations()
+{
+  Map<NodeOperationOutput *, int> output_links_num;
+  for (const Link &link : links_) {
+    output_links_num.add_or_modify(
+        link.from(), [](int *value) { *value = 1; }, [](int *value) { (*value)++; });
+  }
+
+  /* An operation is fused into the operation reading it when both can be fused, it is the only
+   * reader of its output and both operate on the same canvas, so that pixels match. */
+  Map<NodeOperation *, NodeOperation *> fused_into;
+  for (const Link &link : links_) {
+    NodeOperation *op = &link.from()->get_operation();
+    NodeOperation *reader_op = &link.to()->get_operation();
+    if (op->get_flags().can_be_fused && reader_op->get_flags().can_be_fused &&
+        output_links_num.lookup(link.from()) == 1 &&
+        BLI_rcti_compare(&op->get_canvas(), &reader_op->get_canvas()))
+    {
+      fused_into.add(op, reader_op);
+    }
+  }
+
+  /* Fuse every tree of operations into its last operation. */
+  Set<NodeOperation *> roots;
+  for (NodeOperation *reader_op : fused_into.values()) {
+    if (!fused_into.contains(reader_op)) {
+      roots.add(reader_op);
+    }
+  }
+  for (NodeOperation *root : roots) {
+    Vector<NodeOperation *> operations;
+    collect_fused_operations_recursive(root, fused_into, operations);
+    fuse_operations(operations);
+  }
+}
+
+void NodeOperationBuilder::fuse_operations(Span<NodeOperation *> operations)
+{
+  NodeOperation *last_op = operations.last();
+
+  FusedOperation *fused_op = new FusedOperation(last_op->get_output_socket()->get_data_type());
+  for (NodeOperation *op : operations) {
+    fused_op->add_fused_operation(static_cast<MultiThreadedOperation *>(op));
+  }
+  fused_op->set_canvas(last_op->get_canvas());
+  add_operation(fused_op);
+  fused_op->set_name(last_op->get_name());
+
+  /* Links to fused operations are replaced by links to the fused operation inputs, while keeping
+   * the fused operation sockets linked as their readers may be needed on initialization. */
+  links_.remove_if([&](const Link &link) {
+    return operations.contains(&link.to()->get_operation());
+  });
+  for (int i = 0; i < fused_op->get_number_of_input_sockets(); i++) {
+    add_link(fused_op->get_fused_input(i)->get_link(), fused_op->get_input_socket(i));
+  }
+
+  for (Link &link : links_) {
+    if (link.from() == last_op->get_output_socket()) {
+      link.to()->set_link(fused_op->get_output_socket());
+      link = Link(fused_op->get_output_socket(), link.to());
+    }
+  }
+
+  for (NodeOperation *op : operations) {
+    operations_.remove_first_occurrence_and_reorder(op);
+  }
+}
+
 Vector<NodeOperationInput *> NodeOperationBuilder::cache_output_links(
     NodeOperationOutput *output) const
 {
@@ -156,6 +156,12 @@ class NodeOperationBuilder {
   /** Merge operations with same type, inputs and parameters that produce the same result. */
   void merge_equal_operations();
   void merge_equal_operations(NodeOperation *from, NodeOperation *into);
+  /**
+   * Replace trees of operations that only read their inputs at the pixel they write with a
+   * #FusedOperation executing them in a single pass without intermediate buffers.
+   */
+  void fuse_operations();
+  void fuse_operations(Span<NodeOperation *> operations);
   void save_graphviz(StringRefNull name = "");
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("COM:NodeCompilerImpl")
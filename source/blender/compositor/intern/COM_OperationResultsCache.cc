@@ -0,0 +1,75 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "COM_OperationResultsCache.h"
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor {
+
+static int64_t get_buffer_size_in_bytes(const MemoryBuffer &buffer)
+{
+  return int64_t(buffer.get_memory_width()) * buffer.get_memory_height() *
+         buffer.get_num_channels() * sizeof(float);
+}
+
+OperationResultsCache::OperationResultsCache(const int64_t memory_budget)
+    : memory_budget_(memory_budget), memory_used_(0), last_use_(0)
+{
+}
+
+std::unique_ptr<MemoryBuffer> OperationResultsCache::take_result(const NodeOperationHash &hash)
+{
+  std::optional<CachedResult> result = results_.pop_try(hash);
+  if (!result) {
+    return nullptr;
+  }
+  memory_used_ -= result->size_in_bytes;
+  return std::move(result->buffer);
+}
+
+void OperationResultsCache::add_result(const NodeOperationHash &hash,
+                                       std::unique_ptr<MemoryBuffer> buffer)
+{
+  BLI_assert(buffer != nullptr);
+  const int64_t size_in_bytes = get_buffer_size_in_bytes(*buffer);
+  if (size_in_bytes > memory_budget_) {
+    return;
+  }
+
+  /* Replace any result with the same hash, keeping the most recent one. */
+  std::optional<CachedResult> previous_result = results_.pop_try(hash);
+  if (previous_result) {
+    memory_used_ -= previous_result->size_in_bytes;
+  }
+
+  while (memory_used_ + size_in_bytes > memory_budget_) {
+    free_least_recently_used();
+  }
+
+  results_.add_new(hash, {std::move(buffer), size_in_bytes, ++last_use_});
+  memory_used_ += size_in_bytes;
+}
+
+void OperationResultsCache::clear()
+{
+  results_.clear();
+  memory_used_ = 0;
+}
+
+void OperationResultsCache::free_least_recently_used()
+{
+  BLI_assert(!results_.is_empty());
+  const NodeOperationHash *lru_hash = nullptr;
+  int64_t lru_use = INT64_MAX;
+  for (const auto item : results_.items()) {
+    if (item.value.last_use < lru_use) {
+      lru_hash = &item.key;
+      lru_use = item.value.last_use;
+    }
+  }
+  const NodeOperationHash hash = *lru_hash;
+  memory_used_ -= results_.pop(hash).size_in_bytes;
+}
+
+}  // namespace blender::compositor
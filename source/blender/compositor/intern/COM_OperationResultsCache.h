@@ -0,0 +1,71 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <memory>
+
+#include "BLI_map.hh"
+
+#include "COM_NodeOperation.h"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+namespace blender::compositor {
+
+class MemoryBuffer;
+
+/**
+ * Keeps rendered operation buffers across compositor executions, identified by the operation
+ * result hash (see #NodeOperation::generate_result_hash). When the node tree is re-executed
+ * after a change, operations whose parameters and upstream operations didn't change reuse their
+ * previous result instead of being rendered again.
+ *
+ * Buffers are moved out of the cache while in use by an execution and given back once disposed.
+ * When the memory budget is exceeded the least recently used buffers are freed.
+ */
+class OperationResultsCache {
+ private:
+  struct CachedResult {
+    std::unique_ptr<MemoryBuffer> buffer;
+    int64_t size_in_bytes;
+    /** Value of #last_use_ when the result was last added. */
+    int64_t last_use;
+  };
+
+  Map<NodeOperationHash, CachedResult> results_;
+  int64_t memory_budget_;
+  int64_t memory_used_;
+  int64_t last_use_;
+
+ public:
+  OperationResultsCache(int64_t memory_budget);
+
+  /**
+   * Remove the result with the given hash from the cache, if any, and return it.
+   */
+  std::unique_ptr<MemoryBuffer> take_result(const NodeOperationHash &hash);
+
+  /**
+   * Add a rendered result to the cache, freeing least recently used results to keep within the
+   * memory budget. Results larger than the budget are freed.
+   */
+  void add_result(const NodeOperationHash &hash, std::unique_ptr<MemoryBuffer> buffer);
+
+  /**
+   * Free all cached results.
+   */
+  void clear();
+
+ private:
+  void free_least_recently_used();
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:OperationResultsCache")
+#endif
+};
+
+}  // namespace blender::compositor
@@ -4,6 +4,7 @@
 
 #include "COM_SharedOperationBuffers.h"
 #include "COM_NodeOperation.h"
+#include "COM_OperationResultsCache.h"
 
 namespace blender::compositor {
 
@@ -17,6 +18,48 @@ SharedOperationBuffers::BufferData &SharedOperationBuffers::get_buffer_data(Node
   return buffers_.lookup_or_add_cb(op, []() { return BufferData(); });
 }
 
+void SharedOperationBuffers::set_result_hash(NodeOperation *op,
+                                             const NodeOperationHash &result_hash)
+{
+  get_buffer_data(op).result_hash = result_hash;
+}
+
+bool SharedOperationBuffers::use_cached_result(NodeOperation *op)
+{
+  BufferData &buf_data = get_buffer_data(op);
+  if (buf_data.is_rendered) {
+    return true;
+  }
+  if (results_cache_ == nullptr || !buf_data.result_hash) {
+    return false;
+  }
+
+  std::unique_ptr<MemoryBuffer> buffer = results_cache_->take_result(*buf_data.result_hash);
+  if (buffer == nullptr) {
+    return false;
+  }
+  /* Cached buffers have the full operation result, no other area needs to be rendered. */
+  buf_data.render_areas.append(op->get_canvas());
+  set_rendered_buffer(op, std::move(buffer));
+  return true;
+}
+
+bool SharedOperationBuffers::is_buffer_cacheable(NodeOperation *op, const BufferData &buf_data)
+{
+  if (results_cache_ == nullptr || !buf_data.result_hash || buf_data.buffer == nullptr ||
+      buf_data.buffer->is_a_single_elem())
+  {
+    return false;
+  }
+
+  for (const rcti &area : buf_data.render_areas) {
+    if (BLI_rcti_inside_rcti(&area, &op->get_canvas())) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool SharedOperationBuffers::is_area_registered(NodeOperation *op, const rcti &area_to_render)
 {
   /* TODO: Possibly refactor to "request_area". Current implementation is incomplete:
@@ -86,7 +129,10 @@ void SharedOperationBuffers::read_finished(NodeOperation *read_op)
   buf_data.received_reads++;
   BLI_assert(buf_data.received_reads > 0 && buf_data.received_reads <= buf_data.registered_reads);
   if (buf_data.received_reads == buf_data.registered_reads) {
-    /* Dispose buffer. */
+    /* Dispose buffer, keeping it for following executions when possible. */
+    if (is_buffer_cacheable(read_op, buf_data)) {
+      results_cache_->add_result(*buf_data.result_hash, std::move(buf_data.buffer));
+    }
     buf_data.buffer = nullptr;
   }
 }
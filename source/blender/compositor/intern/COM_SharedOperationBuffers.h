@@ -4,9 +4,13 @@
 
 #pragma once
 
+#include <optional>
+
 #include "BLI_map.hh"
 #include "BLI_vector.hh"
 
+#include "COM_NodeOperation.h"
+
 #include "DNA_vec_types.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
@@ -16,11 +20,12 @@
 namespace blender::compositor {
 
 class MemoryBuffer;
-class NodeOperation;
+class OperationResultsCache;
 
 /**
  * Stores and shares operations rendered buffers including render data. Buffers are
- * disposed once all dependent operations have finished reading them.
+ * disposed once all dependent operations have finished reading them, or given to the results
+ * cache when set so that following executions may reuse them.
  */
 class SharedOperationBuffers {
  private:
@@ -32,10 +37,33 @@ class SharedOperationBuffers {
     int registered_reads;
     int received_reads;
     bool is_rendered;
+    /** Hash identifying the operation result in the results cache, if it can be cached. */
+    std::optional<NodeOperationHash> result_hash;
   } BufferData;
   blender::Map<NodeOperation *, BufferData> buffers_;
+  OperationResultsCache *results_cache_ = nullptr;
 
  public:
+  /**
+   * Set the cache rendered buffers are given to once disposed and taken from by
+   * #use_cached_result.
+   */
+  void set_results_cache(OperationResultsCache *results_cache)
+  {
+    results_cache_ = results_cache;
+  }
+
+  /**
+   * Set the hash identifying given operation result across executions, enabling caching it.
+   */
+  void set_result_hash(NodeOperation *op, const NodeOperationHash &result_hash);
+  /**
+   * Set given operation rendered buffer from the results cache if it has a result with the
+   * operation result hash, registering its whole canvas as rendered. Returns whether the
+   * operation is rendered.
+   */
+  bool use_cached_result(NodeOperation *op);
+
   /**
    * Whether given operation area to render is already registered.
    */
@@ -80,6 +108,11 @@ class SharedOperationBuffers {
 
  private:
   BufferData &get_buffer_data(NodeOperation *op);
+  /**
+   * Whether the given operation buffer can be given to the results cache when disposed, only
+   * buffers with the full operation result are cached.
+   */
+  bool is_buffer_cacheable(NodeOperation *op, const BufferData &buf_data);
 
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("COM:SharedOperationBuffers")
@@ -11,6 +11,7 @@
 #include "BKE_scene.h"
 
 #include "COM_ExecutionSystem.h"
+#include "COM_OperationResultsCache.h"
 #include "COM_WorkScheduler.h"
 #include "COM_compositor.h"
 
@@ -19,6 +20,8 @@
 static struct {
   bool is_initialized = false;
   ThreadMutex mutex;
+  /** Operation results kept across executions while editing, see #OperationResultsCache. */
+  blender::compositor::OperationResultsCache *results_cache = nullptr;
 } g_compositor;
 
 /* Make sure node tree has previews.
@@ -61,6 +64,8 @@ void COM_execute(Render *render,
    * initializations can be done lazily. */
   if (!g_compositor.is_initialized) {
     BLI_mutex_init(&g_compositor.mutex);
+    g_compositor.results_cache = new blender::compositor::OperationResultsCache(
+        blender::compositor::COM_RESULTS_CACHE_MEMORY_BUDGET);
     g_compositor.is_initialized = true;
   }
 
@@ -90,11 +95,20 @@ void COM_execute(Render *render,
     blender::compositor::WorkScheduler::initialize(use_opencl,
                                                    BKE_render_num_threads(render_data));
 
+    /* Only cache results while editing, where the same tree is executed again after changes.
+     * Final renders free the results kept while editing, they need the memory more. */
+    blender::compositor::OperationResultsCache *results_cache = rendering ?
+                                                                    nullptr :
+                                                                    g_compositor.results_cache;
+    if (rendering) {
+      g_compositor.results_cache->clear();
+    }
+
     /* Execute. */
     const bool twopass = (node_tree->flag & NTREE_TWO_PASS) && !rendering;
     if (twopass) {
       blender::compositor::ExecutionSystem fast_pass(
-          render_data, scene, node_tree, rendering, true, view_name);
+          render_data, scene, node_tree, rendering, true, view_name, results_cache);
       fast_pass.execute();
 
       if (node_tree->runtime->test_break(node_tree->runtime->tbh)) {
@@ -104,7 +118,7 @@ void COM_execute(Render *render,
     }
 
     blender::compositor::ExecutionSystem system(
-        render_data, scene, node_tree, rendering, false, view_name);
+        render_data, scene, node_tree, rendering, false, view_name, results_cache);
     system.execute();
   }
 
@@ -116,8 +130,19 @@ void COM_deinitialize()
   if (g_compositor.is_initialized) {
     BLI_mutex_lock(&g_compositor.mutex);
     blender::compositor::WorkScheduler::deinitialize();
+    delete g_compositor.results_cache;
+    g_compositor.results_cache = nullptr;
     g_compositor.is_initialized = false;
     BLI_mutex_unlock(&g_compositor.mutex);
     BLI_mutex_end(&g_compositor.mutex);
   }
 }
+
+void COM_clear_caches()
+{
+  if (g_compositor.is_initialized) {
+    BLI_mutex_lock(&g_compositor.mutex);
+    g_compositor.results_cache->clear();
+    BLI_mutex_unlock(&g_compositor.mutex);
+  }
+}
@@ -142,6 +142,12 @@ void BokehBlurOperation::deinit_execution()
   input_bounding_box_reader_ = nullptr;
 }
 
+void BokehBlurOperation::hash_output_params()
+{
+  hash_params(size_, sizeavailable_, extend_bounds_);
+  hash_param(get_quality());
+}
+
 bool BokehBlurOperation::determine_depending_area_of_interest(rcti *input,
                                                               ReadBufferOperation *read_operation,
                                                               rcti *output)
@@ -72,6 +72,9 @@ class BokehBlurOperation : public MultiThreadedOperation, public QualityStepHelp
   void update_memory_buffer_partial(MemoryBuffer *output,
                                     const rcti &area,
                                     Span<MemoryBuffer *> inputs) override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
@@ -11,6 +11,14 @@ BokehImageOperation::BokehImageOperation()
   this->add_output_socket(DataType::Color);
   delete_data_ = false;
 }
+BokehImageOperation::~BokehImageOperation()
+{
+  /* Not deleted when de-initializing the execution, which doesn't happen when the result is
+   * taken from the results cache. */
+  if (delete_data_) {
+    delete data_;
+  }
+}
 void BokehImageOperation::init_execution()
 {
   center_[0] = get_width() / 2;
@@ -123,14 +131,10 @@ void BokehImageOperation::update_memory_buffer_partial(MemoryBuffer *output,
   }
 }
 
-void BokehImageOperation::deinit_execution()
+void BokehImageOperation::hash_output_params()
 {
-  if (delete_data_) {
-    if (data_) {
-      delete data_;
-      data_ = nullptr;
-    }
-  }
+  hash_params(data_->angle, data_->flaps, data_->rounding);
+  hash_params(data_->catadioptric, data_->lensshift);
 }
 
 void BokehImageOperation::determine_canvas(const rcti &preferred_area, rcti &r_area)
@@ -94,6 +94,7 @@ class BokehImageOperation : public MultiThreadedOperation {
 
  public:
   BokehImageOperation();
+  ~BokehImageOperation();
 
   /**
    * \brief The inner loop of this operation.
@@ -105,11 +106,6 @@ class BokehImageOperation : public MultiThreadedOperation {
    */
   void init_execution() override;
 
-  /**
-   * \brief De-initialize the execution
-   */
-  void deinit_execution() override;
-
   /**
    * \brief determine the resolution of this operation. currently fixed at [COM_BLUR_BOKEH_PIXELS,
    * COM_BLUR_BOKEH_PIXELS] \param resolution: \param preferred_resolution:
@@ -140,6 +136,9 @@ class BokehImageOperation : public MultiThreadedOperation {
   void update_memory_buffer_partial(MemoryBuffer *output,
                                     const rcti &area,
                                     Span<MemoryBuffer *> inputs) override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
@@ -59,6 +59,17 @@ void ConvertDepthToRadiusOperation::init_execution()
   }
 }
 
+void ConvertDepthToRadiusOperation::hash_output_params()
+{
+  hash_params(f_stop_, max_radius_, determine_focal_distance());
+  if (camera_object_ && camera_object_->type == OB_CAMERA) {
+    const Camera *camera = (const Camera *)camera_object_->data;
+    hash_params(
+        camera->lens,
+        BKE_camera_sensor_size(camera->sensor_fit, camera->sensor_x, camera->sensor_y));
+  }
+}
+
 void ConvertDepthToRadiusOperation::execute_pixel_sampled(float output[4],
                                                           float x,
                                                           float y,
@@ -2,7 +2,8 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
-#include <climits>
+#include "BLI_array.hh"
+#include "BLI_task.hh"
 
 #include "COM_FastGaussianBlurOperation.h"
 
@@ -86,65 +87,38 @@ void *FastGaussianBlurOperation::initialize_tile_data(rcti *rect)
     MemoryBuffer *copy = new MemoryBuffer(*new_buf);
     update_size();
 
-    int c;
     sx_ = data_.sizex * size_ / 2.0f;
     sy_ = data_.sizey * size_ / 2.0f;
 
-    if ((sx_ == sy_) && (sx_ > 0.0f)) {
-      for (c = 0; c < COM_DATA_TYPE_COLOR_CHANNELS; c++) {
-        IIR_gauss(copy, sx_, c, 3);
-      }
-    }
-    else {
-      if (sx_ > 0.0f) {
-        for (c = 0; c < COM_DATA_TYPE_COLOR_CHANNELS; c++) {
-          IIR_gauss(copy, sx_, c, 1);
-        }
-      }
-      if (sy_ > 0.0f) {
-        for (c = 0; c < COM_DATA_TYPE_COLOR_CHANNELS; c++) {
-          IIR_gauss(copy, sy_, c, 2);
-        }
-      }
-    }
+    IIR_gauss(copy, sx_, sy_, COM_DATA_TYPE_COLOR_CHANNELS);
     iirgaus_ = copy;
   }
   unlock_mutex();
   return iirgaus_;
 }
 
-void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src, float sigma, uint chan, uint xy)
+/**
+ * Number of lines filtered together by #FastGaussianBlurOperation::IIR_gauss. Their channels are
+ * interleaved so that the recursive filter, sequential along a line, is vectorized across lines.
+ */
+constexpr int IIR_GAUSS_BLOCK_LINES = 8;
+constexpr int IIR_GAUSS_MAX_LANES = IIR_GAUSS_BLOCK_LINES * COM_DATA_TYPE_COLOR_CHANNELS;
+
+namespace {
+struct IIRGaussCoefficients {
+  /** Recursive filter coefficients. */
+  double cf[4];
+  /** Triggs/Sdika border correction matrix. */
+  double tsM[9];
+};
+}  // namespace
+
+static IIRGaussCoefficients compute_iir_gauss_coefficients(const float sigma)
 {
-  BLI_assert(!src->is_a_single_elem());
-  double q, q2, sc, cf[4], tsM[9], tsu[3], tsv[3];
-  double *X, *Y, *W;
-  const uint src_width = src->get_width();
-  const uint src_height = src->get_height();
-  uint x, y, src_dim_max;
-  uint i;
-  float *buffer = src->get_buffer();
-  const uint8_t num_channels = src->get_num_channels();
-
-  /* <0.5 not valid, though can have a possibly useful sort of sharpening effect. */
-  if (sigma < 0.5f) {
-    return;
-  }
-
-  if ((xy < 1) || (xy > 3)) {
-    xy = 3;
-  }
-
-  /* XXX The YVV macro defined below explicitly expects sources of at least 3x3 pixels,
-   *     so just skipping blur along faulty direction if src's def is below that limit! */
-  if (src_width < 3) {
-    xy &= ~1;
-  }
-  if (src_height < 3) {
-    xy &= ~2;
-  }
-  if (xy < 1) {
-    return;
-  }
+  IIRGaussCoefficients coefficients;
+  double *cf = coefficients.cf;
+  double *tsM = coefficients.tsM;
+  double q, q2, sc;
 
   /* See "Recursive Gabor Filtering" by Young/VanVliet
    * all factors here in double-precision.
@@ -185,75 +159,154 @@ void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src, float sigma, uint c
                  cf[3] * cf[3] * cf[3] - cf[3] * cf[2] + cf[3]);
   tsM[8] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
 
-#define YVV(L) \
-  { \
-    W[0] = cf[0] * X[0] + cf[1] * X[0] + cf[2] * X[0] + cf[3] * X[0]; \
-    W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * X[0] + cf[3] * X[0]; \
-    W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * X[0]; \
-    for (i = 3; i < L; i++) { \
-      W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3]; \
-    } \
-    tsu[0] = W[L - 1] - X[L - 1]; \
-    tsu[1] = W[L - 2] - X[L - 1]; \
-    tsu[2] = W[L - 3] - X[L - 1]; \
-    tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + X[L - 1]; \
-    tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + X[L - 1]; \
-    tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + X[L - 1]; \
-    Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2]; \
-    Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1]; \
-    Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0]; \
-    /* `i != UINT_MAX` is really `i >= 0`, but necessary for `uint` wrapping. */ \
-    for (i = L - 4; i != UINT_MAX; i--) { \
-      Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3]; \
-    } \
-  } \
-  (void)0
-
-  /* Intermediate buffers. */
-  src_dim_max = MAX2(src_width, src_height);
-  X = (double *)MEM_callocN(src_dim_max * sizeof(double), "IIR_gauss X buf");
-  Y = (double *)MEM_callocN(src_dim_max * sizeof(double), "IIR_gauss Y buf");
-  W = (double *)MEM_callocN(src_dim_max * sizeof(double), "IIR_gauss W buf");
-  if (xy & 1) { /* H. */
-    int offset;
-    for (y = 0; y < src_height; y++) {
-      const int yx = y * src_width;
-      offset = yx * num_channels + chan;
-      for (x = 0; x < src_width; x++) {
-        X[x] = buffer[offset];
-        offset += num_channels;
-      }
-      YVV(src_width);
-      offset = yx * num_channels + chan;
-      for (x = 0; x < src_width; x++) {
-        buffer[offset] = Y[x];
-        offset += num_channels;
-      }
+  return coefficients;
+}
+
+/**
+ * Filter in place \a lanes lines of \a length elements interleaved in \a lines, element `i` of
+ * lane `l` being `lines[i * lanes + l]`. The lines are filtered forward then backward, every
+ * step of the recursion processing all lanes at once.
+ */
+static void iir_gauss_lines(double *lines,
+                            const int length,
+                            const int lanes,
+                            const IIRGaussCoefficients &coefficients)
+{
+  BLI_assert(length >= 3 && lanes <= IIR_GAUSS_MAX_LANES);
+  const double *cf = coefficients.cf;
+  const double *tsM = coefficients.tsM;
+
+  double first[IIR_GAUSS_MAX_LANES];
+  double last[IIR_GAUSS_MAX_LANES];
+  for (const int l : IndexRange(lanes)) {
+    first[l] = lines[l];
+    last[l] = lines[(length - 1) * lanes + l];
+  }
+
+  /* Forward pass, the line is extended with its first element. */
+  double *w0 = lines;
+  double *w1 = w0 + lanes;
+  double *w2 = w1 + lanes;
+  for (const int l : IndexRange(lanes)) {
+    w0[l] = (cf[0] + cf[1] + cf[2] + cf[3]) * first[l];
+    w1[l] = cf[0] * w1[l] + cf[1] * w0[l] + (cf[2] + cf[3]) * first[l];
+    w2[l] = cf[0] * w2[l] + cf[1] * w1[l] + cf[2] * w0[l] + cf[3] * first[l];
+  }
+  for (int i = 3; i < length; i++) {
+    double *w = lines + i * lanes;
+    for (const int l : IndexRange(lanes)) {
+      w[l] = cf[0] * w[l] + cf[1] * w[l - lanes] + cf[2] * w[l - 2 * lanes] +
+             cf[3] * w[l - 3 * lanes];
     }
   }
-  if (xy & 2) { /* V. */
-    int offset;
-    const int add = src_width * num_channels;
-
-    for (x = 0; x < src_width; x++) {
-      offset = x * num_channels + chan;
-      for (y = 0; y < src_height; y++) {
-        X[y] = buffer[offset];
-        offset += add;
+
+  /* Backward pass with Triggs/Sdika border corrections, the line is extended with its last
+   * element. */
+  double *y0 = lines + (length - 1) * lanes;
+  double *y1 = y0 - lanes;
+  double *y2 = y1 - lanes;
+  for (const int l : IndexRange(lanes)) {
+    const double tsu0 = y0[l] - last[l];
+    const double tsu1 = y1[l] - last[l];
+    const double tsu2 = y2[l] - last[l];
+    const double tsv0 = tsM[0] * tsu0 + tsM[1] * tsu1 + tsM[2] * tsu2 + last[l];
+    const double tsv1 = tsM[3] * tsu0 + tsM[4] * tsu1 + tsM[5] * tsu2 + last[l];
+    const double tsv2 = tsM[6] * tsu0 + tsM[7] * tsu1 + tsM[8] * tsu2 + last[l];
+    y0[l] = cf[0] * y0[l] + cf[1] * tsv0 + cf[2] * tsv1 + cf[3] * tsv2;
+    y1[l] = cf[0] * y1[l] + cf[1] * y0[l] + cf[2] * tsv0 + cf[3] * tsv1;
+    y2[l] = cf[0] * y2[l] + cf[1] * y1[l] + cf[2] * y0[l] + cf[3] * tsv0;
+  }
+  for (int i = length - 4; i >= 0; i--) {
+    double *y = lines + i * lanes;
+    for (const int l : IndexRange(lanes)) {
+      y[l] = cf[0] * y[l] + cf[1] * y[l + lanes] + cf[2] * y[l + 2 * lanes] +
+             cf[3] * y[l + 3 * lanes];
+    }
+  }
+}
+
+/**
+ * Filter the first \a num_channels channels of \a lines_num lines of \a length elements,
+ * line `i` starting at `buffer + i * line_stride` with elements `elem_stride` floats apart.
+ * Blocks of lines are copied to interleaved double precision lanes, which transposes rows when
+ * filtering horizontally, and filtered in parallel.
+ */
+static void iir_gauss_buffer_lines(float *buffer,
+                                   const int lines_num,
+                                   const int64_t line_stride,
+                                   const int length,
+                                   const int64_t elem_stride,
+                                   const int num_channels,
+                                   const IIRGaussCoefficients &coefficients)
+{
+  threading::parallel_for(IndexRange(lines_num), IIR_GAUSS_BLOCK_LINES, [&](IndexRange range) {
+    Array<double> lines(int64_t(length) * IIR_GAUSS_BLOCK_LINES * num_channels);
+    for (int block_start = range.first(); block_start < range.one_after_last();
+         block_start += IIR_GAUSS_BLOCK_LINES)
+    {
+      const int block_lines = min_ii(IIR_GAUSS_BLOCK_LINES, range.one_after_last() - block_start);
+      const int lanes = block_lines * num_channels;
+      float *block = buffer + block_start * line_stride;
+
+      for (const int i : IndexRange(length)) {
+        double *elem_lanes = &lines[int64_t(i) * lanes];
+        for (const int line : IndexRange(block_lines)) {
+          const float *elem = block + line * line_stride + i * elem_stride;
+          for (const int c : IndexRange(num_channels)) {
+            elem_lanes[line * num_channels + c] = elem[c];
+          }
+        }
       }
-      YVV(src_height);
-      offset = x * num_channels + chan;
-      for (y = 0; y < src_height; y++) {
-        buffer[offset] = Y[y];
-        offset += add;
+
+      iir_gauss_lines(lines.data(), length, lanes, coefficients);
+
+      for (const int i : IndexRange(length)) {
+        const double *elem_lanes = &lines[int64_t(i) * lanes];
+        for (const int line : IndexRange(block_lines)) {
+          float *elem = block + line * line_stride + i * elem_stride;
+          for (const int c : IndexRange(num_channels)) {
+            elem[c] = float(elem_lanes[line * num_channels + c]);
+          }
+        }
       }
     }
-  }
+  });
+}
+
+void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src,
+                                          const float sigma_x,
+                                          const float sigma_y,
+                                          const int num_channels)
+{
+  BLI_assert(!src->is_a_single_elem());
+  BLI_assert(num_channels <= min_ii(src->get_num_channels(), COM_DATA_TYPE_COLOR_CHANNELS));
+  const int width = src->get_width();
+  const int height = src->get_height();
+  float *buffer = src->get_buffer();
 
-  MEM_freeN(X);
-  MEM_freeN(W);
-  MEM_freeN(Y);
-#undef YVV
+  /* Sigma <0.5 not valid, though can have a possibly useful sort of sharpening effect.
+   * The border corrections expect lines of at least 3 pixels, skip blurring along shorter
+   * lines. */
+  if (sigma_x >= 0.5f && width >= 3) {
+    /* Rows, lines of consecutive pixels. */
+    iir_gauss_buffer_lines(buffer,
+                           height,
+                           src->row_stride,
+                           width,
+                           src->elem_stride,
+                           num_channels,
+                           compute_iir_gauss_coefficients(sigma_x));
+  }
+  if (sigma_y >= 0.5f && height >= 3) {
+    /* Columns, each block of lines being consecutive pixels of the same rows. */
+    iir_gauss_buffer_lines(buffer,
+                           width,
+                           src->elem_stride,
+                           height,
+                           src->row_stride,
+                           num_channels,
+                           compute_iir_gauss_coefficients(sigma_y));
+  }
 }
 
 void FastGaussianBlurOperation::get_area_of_interest(const int input_idx,
@@ -274,8 +327,7 @@ void FastGaussianBlurOperation::update_memory_buffer_started(MemoryBuffer *outpu
                                                              const rcti &area,
                                                              Span<MemoryBuffer *> inputs)
 {
-  /* TODO(manzanilla): Add a render test and make #IIR_gauss multi-threaded with support for
-   * an output buffer. */
+  /* TODO(manzanilla): Add a render test and make #IIR_gauss support an output buffer. */
   const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
   MemoryBuffer *image = nullptr;
   const bool is_full_output = BLI_rcti_compare(&output->get_rect(), &area);
@@ -287,23 +339,7 @@ void FastGaussianBlurOperation::update_memory_buffer_started(MemoryBuffer *outpu
   }
   image->copy_from(input, area);
 
-  if ((sx_ == sy_) && (sx_ > 0.0f)) {
-    for (const int c : IndexRange(COM_DATA_TYPE_COLOR_CHANNELS)) {
-      IIR_gauss(image, sx_, c, 3);
-    }
-  }
-  else {
-    if (sx_ > 0.0f) {
-      for (const int c : IndexRange(COM_DATA_TYPE_COLOR_CHANNELS)) {
-        IIR_gauss(image, sx_, c, 1);
-      }
-    }
-    if (sy_ > 0.0f) {
-      for (const int c : IndexRange(COM_DATA_TYPE_COLOR_CHANNELS)) {
-        IIR_gauss(image, sy_, c, 2);
-      }
-    }
-  }
+  IIR_gauss(image, sx_, sy_, COM_DATA_TYPE_COLOR_CHANNELS);
 
   if (!is_full_output) {
     output->copy_from(image, area);
@@ -360,13 +396,18 @@ void FastGaussianBlurValueOperation::deinit_execution()
   deinit_mutex();
 }
 
+void FastGaussianBlurValueOperation::hash_output_params()
+{
+  hash_params(sigma_, overlay_);
+}
+
 void *FastGaussianBlurValueOperation::initialize_tile_data(rcti *rect)
 {
   lock_mutex();
   if (!iirgaus_) {
     MemoryBuffer *new_buf = (MemoryBuffer *)inputprogram_->initialize_tile_data(rect);
     MemoryBuffer *copy = new MemoryBuffer(*new_buf);
-    FastGaussianBlurOperation::IIR_gauss(copy, sigma_, 0, 3);
+    FastGaussianBlurOperation::IIR_gauss(copy, sigma_, sigma_, COM_DATA_TYPE_VALUE_CHANNELS);
 
     if (overlay_ == FAST_GAUSS_OVERLAY_MIN) {
       float *src = new_buf->get_buffer();
@@ -411,7 +452,7 @@ void FastGaussianBlurValueOperation::update_memory_buffer_started(MemoryBuffer *
   if (iirgaus_ == nullptr) {
     const MemoryBuffer *image = inputs[0];
     MemoryBuffer *gauss = new MemoryBuffer(*image);
-    FastGaussianBlurOperation::IIR_gauss(gauss, sigma_, 0, 3);
+    FastGaussianBlurOperation::IIR_gauss(gauss, sigma_, sigma_, COM_DATA_TYPE_VALUE_CHANNELS);
     iirgaus_ = gauss;
   }
 }
@@ -22,7 +22,12 @@ class FastGaussianBlurOperation : public BlurBaseOperation {
                                             rcti *output) override;
   void execute_pixel(float output[4], int x, int y, void *data) override;
 
-  static void IIR_gauss(MemoryBuffer *src, float sigma, unsigned int channel, unsigned int xy);
+  /**
+   * Blur in place the first \a num_channels channels of \a src with a recursive gaussian filter,
+   * constant time per pixel regardless of the sigma. Sigmas under 0.5 skip blurring along their
+   * axis.
+   */
+  static void IIR_gauss(MemoryBuffer *src, float sigma_x, float sigma_y, int num_channels);
   void *initialize_tile_data(rcti *rect) override;
   void init_data() override;
   void deinit_execution() override;
@@ -88,6 +93,9 @@ class FastGaussianBlurValueOperation : public MultiThreadedOperation {
   void update_memory_buffer_partial(MemoryBuffer *output,
                                     const rcti &area,
                                     Span<MemoryBuffer *> inputs) override;
+
+ protected:
+  void hash_output_params() override;
 };
 
 }  // namespace blender::compositor
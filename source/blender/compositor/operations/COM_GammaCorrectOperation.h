@@ -36,6 +36,9 @@ class GammaCorrectOperation : public MultiThreadedOperation {
   void update_memory_buffer_partial(MemoryBuffer *output,
                                     const rcti &area,
                                     Span<MemoryBuffer *> inputs) override;
+
+ protected:
+  void hash_output_params() override {}
 };
 
 class GammaUncorrectOperation : public MultiThreadedOperation {
@@ -66,6 +69,9 @@ class GammaUncorrectOperation : public MultiThreadedOperation {
   void update_memory_buffer_partial(MemoryBuffer *output,
                                     const rcti &area,
                                     Span<MemoryBuffer *> inputs) override;
+
+ protected:
+  void hash_output_params() override {}
 };
 
 }  // namespace blender::compositor
@@ -35,6 +35,9 @@ class GammaOperation : public MultiThreadedRowOperation {
   void deinit_execution() override;
 
   void update_memory_buffer_row(PixelCursor &p) override;
+
+ protected:
+  void hash_output_params() override {}
 };
 
 }  // namespace blender::compositor
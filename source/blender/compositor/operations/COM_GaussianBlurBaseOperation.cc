@@ -2,6 +2,8 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "BLI_array.hh"
+
 #include "COM_GaussianBlurBaseOperation.h"
 
 namespace blender::compositor {
@@ -82,6 +84,11 @@ void GaussianBlurBaseOperation::update_memory_buffer_partial(MemoryBuffer *outpu
                                                              Span<MemoryBuffer *> inputs)
 {
   MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
+  if (data_.filtertype == R_FILTER_BOX) {
+    update_memory_buffer_partial_box(output, area, input);
+    return;
+  }
+
   const rcti &input_rect = input->get_rect();
   BuffersIterator<float> it = output->iterate_with({input}, area);
 
@@ -137,4 +144,91 @@ void GaussianBlurBaseOperation::update_memory_buffer_partial(MemoryBuffer *outpu
   }
 }
 
+void GaussianBlurBaseOperation::update_memory_buffer_partial_box(MemoryBuffer *output,
+                                                                 const rcti &area,
+                                                                 const MemoryBuffer *input)
+{
+  /* Pixels with a non zero weight in the filter table, the box filter excludes the last table
+   * entry when the radius isn't an integer. */
+  int radius = 0;
+  while (radius < filtersize_ && gausstab_[filtersize_ + radius + 1] > 0.0f) {
+    radius++;
+  }
+
+  /* The average of a constant is the constant. */
+  if (input->is_a_single_elem()) {
+    output->fill(area, input->get_elem(area.xmin, area.ymin));
+    return;
+  }
+
+  const rcti &input_rect = input->get_rect();
+  const int num_channels = output->get_num_channels();
+
+  switch (dimension_) {
+    case eDimension::X: {
+      /* Slide a window along each row, adding entering pixels and removing leaving ones. */
+      Array<double, 4> sum(num_channels);
+      for (const int y : IndexRange(area.ymin, BLI_rcti_size_y(&area))) {
+        sum.fill(0.0);
+        int window_start = max_ii(area.xmin - radius, input_rect.xmin);
+        int window_end = window_start;
+        for (const int x : IndexRange(area.xmin, BLI_rcti_size_x(&area))) {
+          const int x_end = min_ii(x + radius + 1, input_rect.xmax);
+          for (; window_end < x_end; window_end++) {
+            const float *in = input->get_elem(window_end, y);
+            for (const int c : IndexRange(num_channels)) {
+              sum[c] += in[c];
+            }
+          }
+          const int x_start = max_ii(x - radius, input_rect.xmin);
+          for (; window_start < x_start; window_start++) {
+            const float *in = input->get_elem(window_start, y);
+            for (const int c : IndexRange(num_channels)) {
+              sum[c] -= in[c];
+            }
+          }
+
+          const double weight = 1.0 / (window_end - window_start);
+          float *out = output->get_elem(x, y);
+          for (const int c : IndexRange(num_channels)) {
+            out[c] = float(sum[c] * weight);
+          }
+        }
+      }
+      break;
+    }
+    case eDimension::Y: {
+      /* Slide a window of rows down the area, all the columns of a row being added or removed
+       * at once so that the inner loops are contiguous in memory and vectorized. */
+      const int row_length = BLI_rcti_size_x(&area) * num_channels;
+      Array<double> sum(row_length, 0.0);
+      int window_start = max_ii(area.ymin - radius, input_rect.ymin);
+      int window_end = window_start;
+      for (const int y : IndexRange(area.ymin, BLI_rcti_size_y(&area))) {
+        const int y_end = min_ii(y + radius + 1, input_rect.ymax);
+        for (; window_end < y_end; window_end++) {
+          const float *in = input->get_elem(area.xmin, window_end);
+          for (const int i : IndexRange(row_length)) {
+            sum[i] += in[i];
+          }
+        }
+        const int y_start = max_ii(y - radius, input_rect.ymin);
+        for (; window_start < y_start; window_start++) {
+          const float *in = input->get_elem(area.xmin, window_start);
+          for (const int i : IndexRange(row_length)) {
+            sum[i] -= in[i];
+          }
+        }
+
+        const double weight = 1.0 / (window_end - window_start);
+        float *out = output->get_elem(area.xmin, y);
+        for (const int i : IndexRange(row_length)) {
+          out[i] = float(sum[i] * weight);
+        }
+      }
+      break;
+    }
+  }
+}
+
 }  // namespace blender::compositor
@@ -29,6 +29,15 @@ class GaussianBlurBaseOperation : public BlurBaseOperation {
   virtual void update_memory_buffer_partial(MemoryBuffer *output,
                                             const rcti &area,
                                             Span<MemoryBuffer *> inputs) override;
+
+ private:
+  /**
+   * Box filter implementation using running sums, constant time per pixel regardless of the
+   * radius. Gives the same result as weighting with the box filter table.
+   */
+  void update_memory_buffer_partial_box(MemoryBuffer *output,
+                                        const rcti &area,
+                                        const MemoryBuffer *input);
 };
 
 }  // namespace blender::compositor
@@ -35,15 +35,14 @@ void GlareGhostOperation::generate_glare(float *data,
 
   bool breaked = false;
 
-  FastGaussianBlurOperation::IIR_gauss(&tbuf1, s1, 0, 3);
-  if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(&tbuf1, s1, 1, 3);
-  }
+  /* Only the color channels are used. Each axis is blurred separately to check for a break
+   * between the passes. */
+  FastGaussianBlurOperation::IIR_gauss(&tbuf1, s1, 0.0f, 3);
   if (is_braked()) {
     breaked = true;
   }
   if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(&tbuf1, s1, 2, 3);
+    FastGaussianBlurOperation::IIR_gauss(&tbuf1, 0.0f, s1, 3);
   }
 
   MemoryBuffer tbuf2(tbuf1);
@@ -52,19 +51,13 @@ void GlareGhostOperation::generate_glare(float *data,
     breaked = true;
   }
   if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(&tbuf2, s2, 0, 3);
-  }
-  if (is_braked()) {
-    breaked = true;
-  }
-  if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(&tbuf2, s2, 1, 3);
+    FastGaussianBlurOperation::IIR_gauss(&tbuf2, s2, 0.0f, 3);
   }
   if (is_braked()) {
     breaked = true;
   }
   if (!breaked) {
-    FastGaussianBlurOperation::IIR_gauss(&tbuf2, s2, 2, 3);
+    FastGaussianBlurOperation::IIR_gauss(&tbuf2, 0.0f, s2, 3);
   }
 
   ofs = (settings->iter & 1) ? 0.5f : 0.0f;
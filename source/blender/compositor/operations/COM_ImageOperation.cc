@@ -78,6 +78,25 @@ void BaseImageOperation::deinit_execution()
   BKE_image_release_ibuf(image_, buffer_, nullptr);
 }
 
+void BaseImageOperation::hash_output_params()
+{
+  if (image_ == nullptr) {
+    return;
+  }
+  /* Render results and viewer images are written to without being tagged as updated, their
+   * content can't be identified. */
+  if (ELEM(image_->type, IMA_TYPE_R_RESULT, IMA_TYPE_COMPOSITE)) {
+    NodeOperation::hash_output_params();
+    return;
+  }
+
+  hash_params(image_->id.session_uuid, image_->runtime.update_count, framenumber_);
+  hash_params(image_user_->framenr, image_user_->layer, image_user_->pass);
+  hash_params(image_user_->tile,
+              image_user_->view,
+              BKE_scene_multiview_view_id_get(rd_, view_name_));
+}
+
 void BaseImageOperation::determine_canvas(const rcti & /*preferred_area*/, rcti &r_area)
 {
   ImBuf *stackbuf = get_im_buf();
@@ -50,6 +50,11 @@ void MathBaseOperation::determine_canvas(const rcti &preferred_area, rcti &r_are
   NodeOperation::determine_canvas(preferred_area, r_area);
 }
 
+void MathBaseOperation::hash_output_params()
+{
+  hash_param(use_clamp_);
+}
+
 void MathBaseOperation::clamp_if_needed(float *color)
 {
   if (use_clamp_) {
@@ -20,6 +20,7 @@ MixBaseOperation::MixBaseOperation()
   this->set_use_value_alpha_multiply(false);
   this->set_use_clamp(false);
   flags_.can_be_constant = true;
+  flags_.can_be_fused = true;
 }
 
 void MixBaseOperation::init_execution()
@@ -76,6 +77,11 @@ void MixBaseOperation::determine_canvas(const rcti &preferred_area, rcti &r_area
   NodeOperation::determine_canvas(preferred_area, r_area);
 }
 
+void MixBaseOperation::hash_output_params()
+{
+  hash_params(value_alpha_multiply_, use_clamp_);
+}
+
 void MixBaseOperation::deinit_execution()
 {
   input_value_operation_ = nullptr;
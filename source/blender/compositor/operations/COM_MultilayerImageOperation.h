@@ -17,6 +17,7 @@ class MultilayerBaseOperation : public BaseImageOperation {
   RenderLayer *render_layer_;
   RenderPass *render_pass_;
   ImBuf *get_im_buf() override;
+  void hash_output_params() override;
 
  public:
   /**
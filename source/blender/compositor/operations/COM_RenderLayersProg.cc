@@ -51,6 +51,25 @@ void RenderLayersProg::init_execution()
   }
 }
 
+void RenderLayersProg::hash_output_params()
+{
+  /* Identify the render result content by its update count, so that results computed from it
+   * aren't reused after rendering again. */
+  uint64_t update_count = 0;
+  Scene *scene = this->get_scene();
+  Render *re = (scene) ? RE_GetSceneRender(scene) : nullptr;
+  if (re) {
+    RenderResult *rr = RE_AcquireResultRead(re);
+    if (rr) {
+      update_count = rr->update_count;
+    }
+    RE_ReleaseResult(re);
+  }
+
+  hash_params(scene ? scene->id.session_uuid : 0, update_count, scene ? scene->r.cfra : 0);
+  hash_params(layer_id_, pass_name_, view_name_ ? StringRef(view_name_) : StringRef());
+}
+
 void RenderLayersProg::do_interpolation(float output[4], float x, float y, PixelSampler sampler)
 {
   uint offset;
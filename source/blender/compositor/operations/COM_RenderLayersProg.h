@@ -61,6 +61,8 @@ class RenderLayersProg : public MultiThreadedOperation {
    */
   void determine_canvas(const rcti &preferred_area, rcti &r_area) override;
 
+  void hash_output_params() override;
+
   /**
    * retrieve the reference to the float buffer of the renderer.
    */
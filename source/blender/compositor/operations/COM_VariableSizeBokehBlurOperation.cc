@@ -217,6 +217,12 @@ void VariableSizeBokehBlurOperation::deinit_execution()
 #endif
 }
 
+void VariableSizeBokehBlurOperation::hash_output_params()
+{
+  hash_params(max_blur_, threshold_, do_size_scale_);
+  hash_param(get_quality());
+}
+
 bool VariableSizeBokehBlurOperation::determine_depending_area_of_interest(
     rcti *input, ReadBufferOperation *read_operation, rcti *output)
 {
@@ -17,6 +17,8 @@
 #include "COM_static_shader_manager.hh"
 #include "COM_texture_pool.hh"
 
+struct ImBuf;
+
 namespace blender::realtime_compositor {
 
 /* ------------------------------------------------------------------------------------------------
@@ -79,12 +81,29 @@ class Context {
    * called by viewer output nodes to get their target texture. */
   virtual GPUTexture *get_viewer_output_texture() = 0;
 
+  /* Get the host-side RGBA buffer where the result of the compositor should be written when it
+   * evaluates on the CPU, see use_gpu. The buffer has the render size. This should be called by
+   * the composite output node. The default implementation returns nullptr, in which case, the
+   * output is discarded. */
+  virtual float *get_output_buffer();
+
+  /* Same as get_output_buffer but for the result of the compositor viewer. */
+  virtual float *get_viewer_output_buffer();
+
   /* Get the texture where the given render pass is stored. This should be called by the Render
    * Layer node to populate its outputs. */
   virtual GPUTexture *get_input_texture(const Scene *scene,
                                         int view_layer,
                                         const char *pass_name) = 0;
 
+  /* Same as get_input_texture but gets the image buffer where the given render pass is stored,
+   * which is used when the compositor evaluates on the CPU, see use_gpu. The image buffer should
+   * stay valid until the evaluation is done. The default implementation returns nullptr, in which
+   * case, the pass is considered not available. */
+  virtual const ImBuf *get_input_image_buffer(const Scene *scene,
+                                              int view_layer,
+                                              const char *pass_name);
+
   /* Get the name of the view currently being rendered. */
   virtual StringRef get_view_name() = 0;
 
@@ -113,6 +132,10 @@ class Context {
   /* Get the current time in seconds of the active scene. */
   float get_time() const;
 
+  /* Returns true if the compositor evaluates on the GPU, see TexturePool::use_gpu for more
+   * information. */
+  bool use_gpu() const;
+
   /* Get a reference to the texture pool of this context. */
   TexturePool &texture_pool();
 
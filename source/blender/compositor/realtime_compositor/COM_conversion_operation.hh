@@ -25,7 +25,8 @@ class ConversionOperation : public SimpleOperation {
   using SimpleOperation::SimpleOperation;
 
   /* If the input result is a single value, execute_single is called. Otherwise, the shader
-   * provided by get_conversion_shader is dispatched. */
+   * provided by get_conversion_shader is dispatched, or convert_pixel is invoked for every pixel
+   * if the compositor evaluates on the CPU. */
   void execute() override;
 
   /* Determine if a conversion operation is needed for the input with the given result and
@@ -42,6 +43,10 @@ class ConversionOperation : public SimpleOperation {
   /* Get the shader the will be used for conversion. */
   virtual GPUShader *get_conversion_shader() const = 0;
 
+  /* Convert a pixel loaded from the input using Result::load_pixel to a pixel that can be stored
+   * in the output using Result::store_pixel. Used when the compositor evaluates on the CPU. */
+  virtual float4 convert_pixel(const float4 &input) const = 0;
+
   /** \} */
 
 };  // namespace blender::realtime_compositorclassConversionOperation:publicSimpleOperation
@@ -60,6 +65,8 @@ class ConvertFloatToVectorOperation : public ConversionOperation {
   void execute_single(const Result &input, Result &output) override;
 
   GPUShader *get_conversion_shader() const override;
+
+  float4 convert_pixel(const float4 &input) const override;
 };
 
 /** \} */
@@ -78,6 +85,8 @@ class ConvertFloatToColorOperation : public ConversionOperation {
   void execute_single(const Result &input, Result &output) override;
 
   GPUShader *get_conversion_shader() const override;
+
+  float4 convert_pixel(const float4 &input) const override;
 };
 
 /** \} */
@@ -96,6 +105,8 @@ class ConvertColorToFloatOperation : public ConversionOperation {
   void execute_single(const Result &input, Result &output) override;
 
   GPUShader *get_conversion_shader() const override;
+
+  float4 convert_pixel(const float4 &input) const override;
 };
 
 /** \} */
@@ -114,6 +125,8 @@ class ConvertColorToVectorOperation : public ConversionOperation {
   void execute_single(const Result &input, Result &output) override;
 
   GPUShader *get_conversion_shader() const override;
+
+  float4 convert_pixel(const float4 &input) const override;
 };
 
 /** \} */
@@ -135,6 +148,8 @@ class ConvertVectorToFloatOperation : public ConversionOperation {
   void execute_single(const Result &input, Result &output) override;
 
   GPUShader *get_conversion_shader() const override;
+
+  float4 convert_pixel(const float4 &input) const override;
 };
 
 /** \} */
@@ -153,6 +168,8 @@ class ConvertVectorToColorOperation : public ConversionOperation {
   void execute_single(const Result &input, Result &output) override;
 
   GPUShader *get_conversion_shader() const override;
+
+  float4 convert_pixel(const float4 &input) const override;
 };
 
 /** \} */
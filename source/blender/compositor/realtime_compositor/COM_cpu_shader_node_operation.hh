@@ -0,0 +1,47 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+#include <memory>
+
+#include "NOD_derived_node_tree.hh"
+
+#include "COM_context.hh"
+#include "COM_node_operation.hh"
+#include "COM_shader_node.hh"
+
+namespace blender::realtime_compositor {
+
+using namespace nodes::derived_node_tree_types;
+
+/* ------------------------------------------------------------------------------------------------
+ * CPU Shader Node Operation
+ *
+ * A node operation that evaluates a single shader node when the compositor evaluates on the CPU,
+ * see Context::use_gpu. Shader nodes are compiled into Shader Operations on the GPU, but on the
+ * CPU, each shader node is evaluated on its own by invoking the ShaderNode::compute_pixel method
+ * of its shader node for every pixel of the operation domain. The domain is computed from the
+ * inputs of the node in the same way the domain of a shader node is computed on the GPU. If all
+ * inputs are single values, the outputs are single values as well. */
+class CPUShaderNodeOperation : public NodeOperation {
+ private:
+  /* The shader node whose compute_pixel method is used to compute the outputs. */
+  std::unique_ptr<ShaderNode> shader_node_;
+
+ public:
+  CPUShaderNodeOperation(Context &context, DNode node);
+
+  void execute() override;
+
+ private:
+  /* Returns true if all inputs of the operation are single values. */
+  bool is_single_value_operation();
+
+  /* Compute the outputs for the single value inputs by invoking compute_pixel once and setting the
+   * single values of the outputs to the computed values. */
+  void execute_single_value();
+};
+
+}  // namespace blender::realtime_compositor
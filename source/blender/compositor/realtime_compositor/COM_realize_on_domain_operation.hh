@@ -46,6 +46,10 @@ class RealizeOnDomainOperation : public SimpleOperation {
  private:
   /* Get the realization shader of the appropriate type. */
   GPUShader *get_realization_shader();
+
+  /* Realize the input on the CPU by sampling it at the given inverse transformation of the domain
+   * coordinates, identical to what the realization shader does. */
+  void execute_cpu(const float3x3 &inverse_transformation);
 };
 
 }  // namespace blender::realtime_compositor
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "BLI_math_matrix_types.hh"
+#include "BLI_math_vector.h"
 #include "BLI_math_vector_types.hh"
 
 #include "GPU_shader.h"
@@ -78,6 +79,11 @@ class Result {
   /* The texture pool used to allocate the texture of the result, this should be initialized during
    * construction. */
   TexturePool *texture_pool_ = nullptr;
+  /* A host-side buffer storing the result data if the texture pool of the result doesn't use the
+   * GPU, see TexturePool::use_gpu. Pixels are stored row by row with a single channel for float
+   * results and four channels for vector and color results. Single value results are stored in a
+   * buffer of a single pixel, mirroring the 1x1 texture used on the GPU. */
+  float *cpu_data_ = nullptr;
   /* The number of operations that currently needs this result. At the time when the result is
    * computed, this member will have a value that matches initial_reference_count_. Once each
    * operation that needs the result no longer needs it, the release method is called and the
@@ -273,6 +279,26 @@ class Result {
   /* Returns the allocated GPU texture of the result. */
   GPUTexture *texture() const;
 
+  /* Returns true if the result is stored in host memory as opposed to a GPU texture, see
+   * TexturePool::use_gpu for more information. */
+  bool is_cpu() const;
+
+  /* Returns the allocated host-side buffer of the result, see cpu_data_ for more information. */
+  float *cpu_data() const;
+
+  /* Returns the number of channels of the pixels of the result, which is 1 for float results and 4
+   * for vector and color results. */
+  int64_t channels_count() const;
+
+  /* Load the pixel at the given texel from the host-side buffer of the result. Float results
+   * return their value in the first component with the rest set to zero. Single value results
+   * return their value regardless of the texel. */
+  float4 load_pixel(const int2 &texel) const;
+
+  /* Store the given pixel at the given texel in the host-side buffer of the result. Only the first
+   * component is stored for float results. */
+  void store_pixel(const int2 &texel, const float4 &pixel);
+
   /* Returns the reference count of the result. If this result have a master result, then the
    * reference count of the master result is returned instead. */
   int reference_count() const;
@@ -283,6 +309,45 @@ class Result {
  private:
   /* Returns the appropriate texture format based on the result's type and precision. */
   eGPUTextureFormat get_texture_format() const;
+
+  /* Allocate the host-side buffer of the result to store an image of the given size. */
+  void allocate_cpu_data(const int2 &size);
+
+  /* Returns the index of the first channel of the pixel at the given texel in the host-side
+   * buffer of the result. */
+  int64_t get_pixel_index(const int2 &texel) const;
 };
 
+inline int64_t Result::channels_count() const
+{
+  return type_ == ResultType::Float ? 1 : 4;
+}
+
+inline int64_t Result::get_pixel_index(const int2 &texel) const
+{
+  if (is_single_value_) {
+    return 0;
+  }
+  return (int64_t(texel.y) * domain_.size.x + texel.x) * channels_count();
+}
+
+inline float4 Result::load_pixel(const int2 &texel) const
+{
+  const float *pixel = cpu_data_ + get_pixel_index(texel);
+  if (type_ == ResultType::Float) {
+    return float4(pixel[0], 0.0f, 0.0f, 0.0f);
+  }
+  return float4(pixel);
+}
+
+inline void Result::store_pixel(const int2 &texel, const float4 &pixel)
+{
+  float *destination = cpu_data_ + get_pixel_index(texel);
+  if (type_ == ResultType::Float) {
+    destination[0] = pixel.x;
+    return;
+  }
+  copy_v4_v4(destination, pixel);
+}
+
 }  // namespace blender::realtime_compositor
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_string_ref.hh"
 #include "BLI_vector.hh"
 
@@ -52,6 +54,13 @@ class ShaderNode {
    * appropriate resources. */
   virtual void compile(GPUMaterial *material) = 0;
 
+  /* Compute the values of the outputs of the node for a single pixel given the values of its
+   * inputs, both ordered like the sockets of the node, with float values stored in the first
+   * component. This is used instead of compile when the compositor evaluates on the CPU, see
+   * CPUShaderNodeOperation, and should be implemented by nodes supported on the CPU, see
+   * is_node_supported_on_cpu. */
+  virtual void compute_pixel(Span<float4> inputs, MutableSpan<float4> outputs) const;
+
   /* Returns a contiguous array containing the GPU node stacks of each input. */
   GPUNodeStack *get_inputs_array();
 
@@ -68,6 +68,11 @@ class TexturePool {
    * called after the compositor is done evaluating. */
   void reset();
 
+  /* Returns true if results should be stored in GPU textures acquired from this pool, which is the
+   * default. Pools used to evaluate the compositor without a GPU context should return false, in
+   * which case, results are stored in host memory and operations execute on the CPU instead. */
+  virtual bool use_gpu() const;
+
  private:
   /* Returns a newly allocated texture with the given specification. This method should be
    * implemented by the caller of the compositor evaluator. See the class description for more
@@ -14,6 +14,8 @@
 #include "COM_input_descriptor.hh"
 #include "COM_result.hh"
 
+struct ImBuf;
+
 namespace blender::realtime_compositor {
 
 using namespace nodes::derived_node_tree_types;
@@ -55,6 +57,13 @@ bool is_shader_node(DNode node);
  */
 bool is_node_supported(DNode node);
 
+/**
+ * Returns true if the given node can be evaluated when the compositor evaluates on the CPU, see
+ * Context::use_gpu. Most node operations and shader nodes are only implemented on the GPU, and
+ * some nodes are only supported on the CPU with some of their settings.
+ */
+bool is_node_supported_on_cpu(DNode node);
+
 /** Get the input descriptor of the given input socket. */
 InputDescriptor input_descriptor_from_input_socket(const bNodeSocket *socket);
 
@@ -70,6 +79,34 @@ void compute_dispatch_threads_at_least(GPUShader *shader,
                                        int2 threads_range,
                                        int2 local_size = int2(16));
 
+/**
+ * Invoke the given function for every texel in a 2D space of the given range in parallel. This is
+ * the CPU counterpart of compute_dispatch_threads_at_least. The space is split into square tiles
+ * of the given size, each of which is processed by a single thread.
+ */
+void parallel_for(const int2 range, FunctionRef<void(int2)> function, const int tile_size = 64);
+
+/**
+ * Load the pixel at the given texel from the float buffer of the given image buffer, clamping the
+ * texel to the bounds of the image. Channels missing from the buffer are set to zero, except alpha
+ * which is set to one, like when loading from a texture with as many channels. This is the CPU
+ * counterpart of loading from the GPU textures of images and render passes.
+ */
+float4 load_image_buffer_pixel(const ImBuf &image_buffer, int2 texel);
+
+/**
+ * Write the given image result into the given host-side RGBA output buffer of the render size,
+ * offset by the lower bound of the compositing region. If ignore_alpha is true, the written
+ * alpha is one, otherwise, if use_alpha_input is true, the alpha is taken from the given alpha
+ * result. This is the CPU counterpart of the output writing shaders used by the output nodes.
+ */
+void write_output_to_buffer(Context &context,
+                            const Result &image,
+                            const Result &alpha,
+                            bool ignore_alpha,
+                            bool use_alpha_input,
+                            float *output_buffer);
+
 /* Returns true if a node preview needs to be computed for the give node. */
 bool is_node_preview_needed(const DNode &node);
 
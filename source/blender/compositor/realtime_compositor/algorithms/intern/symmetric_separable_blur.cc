@@ -5,6 +5,7 @@
 #include "BLI_math_base.hh"
 #include "BLI_math_vector.hh"
 #include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 
 #include "GPU_shader.h"
 #include "GPU_texture.h"
@@ -118,6 +119,107 @@ static void vertical_pass(Context &context,
   weights.unbind_as_texture();
 }
 
+/* CPU counterpart of gamma_correct_blur_input in the blur shader library. */
+static float4 gamma_correct_blur_input(float4 color)
+{
+  const float alpha = color.w > 0.0f ? color.w : 1.0f;
+  const float3 straight = color.xyz() / alpha;
+  const float3 corrected = math::max(straight, float3(0.0f)) * straight;
+  return float4(corrected * alpha, color.w);
+}
+
+/* CPU counterpart of gamma_uncorrect_blur_output in the blur shader library. */
+static float4 gamma_uncorrect_blur_output(float4 color)
+{
+  const float alpha = color.w > 0.0f ? color.w : 1.0f;
+  const float3 straight = color.xyz() / alpha;
+  const float3 uncorrected = math::sqrt(math::max(straight, float3(0.0f)));
+  return float4(uncorrected * alpha, color.w);
+}
+
+/* Blur the input horizontally on the CPU and write the result transposed to the output, which is
+ * expected to be already allocated. This does exactly what the blur shader does, see the
+ * horizontal_pass function for more information on the transposition. */
+static void blur_pass_cpu(const Result &input,
+                          Result &output,
+                          Span<float> weights,
+                          bool extend_bounds,
+                          bool gamma_correct_input,
+                          bool gamma_uncorrect_output)
+{
+  const int2 input_size = input.domain().size;
+  const int blur_size = weights.size() - 1;
+
+  const auto load_input = [&](int2 texel) {
+    float4 color;
+    if (extend_bounds) {
+      /* The input is treated as padded by a blur size amount of transparent pixels. */
+      texel.x -= blur_size;
+      if (texel.x < 0 || texel.x >= input_size.x || texel.y < 0 || texel.y >= input_size.y) {
+        color = float4(0.0f);
+      }
+      else {
+        color = input.load_pixel(texel);
+      }
+    }
+    else {
+      color = input.load_pixel(math::clamp(texel, int2(0), input_size - 1));
+    }
+
+    return gamma_correct_input ? gamma_correct_blur_input(color) : color;
+  };
+
+  const int2 output_size = output.domain().size;
+  parallel_for(int2(output_size.y, output_size.x), [&](const int2 texel) {
+    float4 accumulated_color = load_input(texel) * weights[0];
+    for (const int i : weights.index_range().drop_front(1)) {
+      accumulated_color += load_input(texel + int2(i, 0)) * weights[i];
+      accumulated_color += load_input(texel + int2(-i, 0)) * weights[i];
+    }
+
+    if (gamma_uncorrect_output) {
+      accumulated_color = gamma_uncorrect_blur_output(accumulated_color);
+    }
+
+    output.store_pixel(int2(texel.y, texel.x), accumulated_color);
+  });
+}
+
+static void symmetric_separable_blur_cpu(Context &context,
+                                         Result &input,
+                                         Result &output,
+                                         float2 radius,
+                                         int filter_type,
+                                         bool extend_bounds,
+                                         bool gamma_correct)
+{
+  Domain domain = input.domain();
+  if (extend_bounds) {
+    /* Add a radius amount of pixels in both sides of the image, hence the multiply by 2. */
+    domain.size += int2(math::ceil(radius)) * 2;
+  }
+
+  /* The horizontal pass has the extended width but the original height, transposed. */
+  Result horizontal_pass_result = Result::Temporary(input.type(), context.texture_pool());
+  horizontal_pass_result.allocate_texture(Domain(int2(input.domain().size.y, domain.size.x)));
+  blur_pass_cpu(input,
+                horizontal_pass_result,
+                SymmetricSeparableBlurWeights::compute_weights(filter_type, radius.x),
+                extend_bounds,
+                gamma_correct,
+                false);
+
+  output.allocate_texture(domain);
+  blur_pass_cpu(horizontal_pass_result,
+                output,
+                SymmetricSeparableBlurWeights::compute_weights(filter_type, radius.y),
+                extend_bounds,
+                false,
+                gamma_correct);
+
+  horizontal_pass_result.release();
+}
+
 void symmetric_separable_blur(Context &context,
                               Result &input,
                               Result &output,
@@ -126,6 +228,12 @@ void symmetric_separable_blur(Context &context,
                               bool extend_bounds,
                               bool gamma_correct)
 {
+  if (!context.use_gpu()) {
+    symmetric_separable_blur_cpu(
+        context, input, output, radius, filter_type, extend_bounds, gamma_correct);
+    return;
+  }
+
   Result horizontal_pass_result = horizontal_pass(
       context, input, radius.x, filter_type, extend_bounds, gamma_correct);
 
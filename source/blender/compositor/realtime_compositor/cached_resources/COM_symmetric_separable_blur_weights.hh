@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <memory>
 
+#include "BLI_array.hh"
 #include "BLI_map.hh"
 #include "BLI_math_vector_types.hh"
 
@@ -57,6 +58,11 @@ class SymmetricSeparableBlurWeights : public CachedResource {
   void bind_as_texture(GPUShader *shader, const char *texture_name) const;
 
   void unbind_as_texture() const;
+
+  /* Compute the normalized weights of the positive half of the filter of the given type and
+   * radius, starting with the center weight. This is used directly when the compositor evaluates
+   * on the CPU, where no texture is needed. */
+  static Array<float> compute_weights(int type, float radius);
 };
 
 /** \} */
@@ -44,6 +44,13 @@ bool operator==(const SymmetricSeparableBlurWeightsKey &a,
  */
 
 SymmetricSeparableBlurWeights::SymmetricSeparableBlurWeights(int type, float radius)
+{
+  const Array<float> weights = compute_weights(type, radius);
+  texture_ = GPU_texture_create_1d(
+      "Weights", weights.size(), 1, GPU_R16F, GPU_TEXTURE_USAGE_GENERAL, weights.data());
+}
+
+Array<float> SymmetricSeparableBlurWeights::compute_weights(int type, float radius)
 {
   /* The size of filter is double the radius plus 1, but since the filter is symmetric, we only
    * compute half of it and no doubling happens. We add 1 to make sure the filter size is always
@@ -73,8 +80,7 @@ SymmetricSeparableBlurWeights::SymmetricSeparableBlurWeights(int type, float rad
     weights[i] /= sum;
   }
 
-  texture_ = GPU_texture_create_1d(
-      "Weights", size, 1, GPU_R16F, GPU_TEXTURE_USAGE_GENERAL, weights.data());
+  return weights;
 }
 
 SymmetricSeparableBlurWeights::~SymmetricSeparableBlurWeights()
@@ -39,6 +39,28 @@ float Context::get_time() const
   return frame_number / frame_rate;
 }
 
+const ImBuf *Context::get_input_image_buffer(const Scene * /*scene*/,
+                                             int /*view_layer*/,
+                                             const char * /*pass_name*/)
+{
+  return nullptr;
+}
+
+float *Context::get_output_buffer()
+{
+  return nullptr;
+}
+
+float *Context::get_viewer_output_buffer()
+{
+  return nullptr;
+}
+
+bool Context::use_gpu() const
+{
+  return texture_pool_.use_gpu();
+}
+
 TexturePool &Context::texture_pool()
 {
   return texture_pool_;
@@ -31,6 +31,13 @@ void ConversionOperation::execute()
 
   result.allocate_texture(input.domain());
 
+  if (!context().use_gpu()) {
+    parallel_for(input.domain().size, [&](const int2 texel) {
+      result.store_pixel(texel, convert_pixel(input.load_pixel(texel)));
+    });
+    return;
+  }
+
   GPUShader *shader = get_conversion_shader();
   GPU_shader_bind(shader);
 
@@ -106,6 +113,11 @@ GPUShader *ConvertFloatToVectorOperation::get_conversion_shader() const
   return shader_manager().get("compositor_convert_float_to_vector");
 }
 
+float4 ConvertFloatToVectorOperation::convert_pixel(const float4 &input) const
+{
+  return float4(float3(input.x), 0.0f);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -133,6 +145,11 @@ GPUShader *ConvertFloatToColorOperation::get_conversion_shader() const
   return shader_manager().get("compositor_convert_float_to_color");
 }
 
+float4 ConvertFloatToColorOperation::convert_pixel(const float4 &input) const
+{
+  return float4(float3(input.x), 1.0f);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -159,6 +176,11 @@ GPUShader *ConvertColorToFloatOperation::get_conversion_shader() const
   return shader_manager().get("compositor_convert_color_to_float");
 }
 
+float4 ConvertColorToFloatOperation::convert_pixel(const float4 &input) const
+{
+  return float4((input.x + input.y + input.z) / 3.0f, 0.0f, 0.0f, 0.0f);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -185,6 +207,11 @@ GPUShader *ConvertColorToVectorOperation::get_conversion_shader() const
   return shader_manager().get("compositor_convert_color_to_vector");
 }
 
+float4 ConvertColorToVectorOperation::convert_pixel(const float4 &input) const
+{
+  return float4(float3(input), 0.0f);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -211,6 +238,11 @@ GPUShader *ConvertVectorToFloatOperation::get_conversion_shader() const
   return shader_manager().get("compositor_convert_vector_to_float");
 }
 
+float4 ConvertVectorToFloatOperation::convert_pixel(const float4 &input) const
+{
+  return float4((input.x + input.y + input.z) / 3.0f, 0.0f, 0.0f, 0.0f);
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -236,6 +268,11 @@ GPUShader *ConvertVectorToColorOperation::get_conversion_shader() const
   return shader_manager().get("compositor_convert_vector_to_color");
 }
 
+float4 ConvertVectorToColorOperation::convert_pixel(const float4 &input) const
+{
+  return float4(float3(input), 1.0f);
+}
+
 /** \} */
 
 }  // namespace blender::realtime_compositor
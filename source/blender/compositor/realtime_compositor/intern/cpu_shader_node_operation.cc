@@ -0,0 +1,122 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "BLI_array.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_vector.hh"
+
+#include "DNA_node_types.h"
+
+#include "NOD_derived_node_tree.hh"
+
+#include "BKE_node_runtime.hh"
+
+#include "COM_context.hh"
+#include "COM_cpu_shader_node_operation.hh"
+#include "COM_domain.hh"
+#include "COM_node_operation.hh"
+#include "COM_result.hh"
+#include "COM_shader_node.hh"
+#include "COM_utilities.hh"
+
+namespace blender::realtime_compositor {
+
+using namespace nodes::derived_node_tree_types;
+
+CPUShaderNodeOperation::CPUShaderNodeOperation(Context &context, DNode node)
+    : NodeOperation(context, node),
+      shader_node_(node->typeinfo->get_compositor_shader_node(node))
+{
+}
+
+void CPUShaderNodeOperation::execute()
+{
+  if (is_single_value_operation()) {
+    execute_single_value();
+    return;
+  }
+
+  const Domain domain = compute_domain();
+
+  Vector<const Result *> inputs;
+  for (const bNodeSocket *input : node()->input_sockets()) {
+    inputs.append(&get_input(input->identifier));
+  }
+
+  /* Outputs that are not needed are stored as null pointers, their computed values are ignored. */
+  Vector<Result *> outputs;
+  for (const bNodeSocket *output : node()->output_sockets()) {
+    Result &result = get_result(output->identifier);
+    if (result.should_compute()) {
+      result.allocate_texture(domain);
+      outputs.append(&result);
+    }
+    else {
+      outputs.append(nullptr);
+    }
+  }
+
+  parallel_for(domain.size, [&](const int2 texel) {
+    Array<float4, 8> input_pixels(inputs.size());
+    for (const int i : inputs.index_range()) {
+      input_pixels[i] = inputs[i]->load_pixel(texel);
+    }
+
+    Array<float4, 4> output_pixels(outputs.size(), float4(0.0f));
+    shader_node_->compute_pixel(input_pixels, output_pixels);
+
+    for (const int i : outputs.index_range()) {
+      if (outputs[i]) {
+        outputs[i]->store_pixel(texel, output_pixels[i]);
+      }
+    }
+  });
+}
+
+bool CPUShaderNodeOperation::is_single_value_operation()
+{
+  for (const bNodeSocket *input : node()->input_sockets()) {
+    if (!get_input(input->identifier).is_single_value()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void CPUShaderNodeOperation::execute_single_value()
+{
+  const Span<const bNodeSocket *> input_sockets = node()->input_sockets();
+  const Span<const bNodeSocket *> output_sockets = node()->output_sockets();
+
+  Array<float4, 8> inputs(input_sockets.size());
+  for (const int i : input_sockets.index_range()) {
+    inputs[i] = get_input(input_sockets[i]->identifier).load_pixel(int2(0));
+  }
+
+  Array<float4, 4> outputs(output_sockets.size(), float4(0.0f));
+  shader_node_->compute_pixel(inputs, outputs);
+
+  for (const int i : output_sockets.index_range()) {
+    Result &result = get_result(output_sockets[i]->identifier);
+    if (!result.should_compute()) {
+      continue;
+    }
+
+    result.allocate_single_value();
+    switch (result.type()) {
+      case ResultType::Float:
+        result.set_float_value(outputs[i].x);
+        break;
+      case ResultType::Vector:
+        result.set_vector_value(outputs[i]);
+        break;
+      case ResultType::Color:
+        result.set_color_value(outputs[i]);
+        break;
+    }
+  }
+}
+
+}  // namespace blender::realtime_compositor
@@ -10,6 +10,7 @@
 
 #include "COM_compile_state.hh"
 #include "COM_context.hh"
+#include "COM_cpu_shader_node_operation.hh"
 #include "COM_evaluator.hh"
 #include "COM_input_single_value_operation.hh"
 #include "COM_node_operation.hh"
@@ -74,6 +75,16 @@ void Evaluator::compile_and_evaluate()
 
   const Schedule schedule = compute_schedule(context_, *derived_node_tree_);
 
+  /* Not all nodes are implemented on the CPU, so don't evaluate node trees with other nodes. */
+  if (!context_.use_gpu()) {
+    for (const DNode &node : schedule) {
+      if (!is_node_supported_on_cpu(node)) {
+        context_.set_info_message("Compositor node tree has nodes not supported on the CPU!");
+        return;
+      }
+    }
+  }
+
   CompileState compile_state(schedule);
 
   for (const DNode &node : schedule) {
@@ -81,7 +92,8 @@ void Evaluator::compile_and_evaluate()
       compile_and_evaluate_shader_compile_unit(compile_state);
     }
 
-    if (is_shader_node(node)) {
+    /* Shader nodes are evaluated one node at a time on the CPU, see CPUShaderNodeOperation. */
+    if (is_shader_node(node) && context_.use_gpu()) {
       compile_state.add_node_to_shader_compile_unit(node);
     }
     else {
@@ -92,7 +104,9 @@ void Evaluator::compile_and_evaluate()
 
 void Evaluator::compile_and_evaluate_node(DNode node, CompileState &compile_state)
 {
-  NodeOperation *operation = node->typeinfo->get_compositor_operation(context_, node);
+  NodeOperation *operation = is_shader_node(node) ?
+                                 new CPUShaderNodeOperation(context_, node) :
+                                 node->typeinfo->get_compositor_operation(context_, node);
 
   compile_state.map_node_to_node_operation(node, operation);
 
@@ -2,7 +2,11 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include "BLI_math_base.h"
+#include "BLI_math_base.hh"
+#include "BLI_math_interp.h"
 #include "BLI_math_matrix.hh"
+#include "BLI_math_vector.hh"
 #include "BLI_utildefines.h"
 
 #include "GPU_shader.h"
@@ -35,9 +39,6 @@ void RealizeOnDomainOperation::execute()
 
   result.allocate_texture(domain_);
 
-  GPUShader *shader = get_realization_shader();
-  GPU_shader_bind(shader);
-
   /* Transform the input space into the domain space. */
   const float3x3 local_transformation = math::invert(domain_.transformation) *
                                         input.domain().transformation;
@@ -50,6 +51,14 @@ void RealizeOnDomainOperation::execute()
    * input image itself and thus expect the inverse. */
   const float3x3 inverse_transformation = math::invert(transformation);
 
+  if (!context().use_gpu()) {
+    execute_cpu(inverse_transformation);
+    return;
+  }
+
+  GPUShader *shader = get_realization_shader();
+  GPU_shader_bind(shader);
+
   GPU_shader_uniform_mat3_as_mat4(shader, "inverse_transformation", inverse_transformation.ptr());
 
   /* The texture sampler should use bilinear interpolation for both the bilinear and bicubic
@@ -81,6 +90,80 @@ void RealizeOnDomainOperation::execute()
   GPU_shader_unbind();
 }
 
+/* Wrap the given coordinate into the [0, size) range. */
+static float wrap_coordinate(const float coordinate, const int size)
+{
+  return coordinate - math::floor(coordinate / size) * size;
+}
+
+void RealizeOnDomainOperation::execute_cpu(const float3x3 &inverse_transformation)
+{
+  const Result &input = get_input();
+  Result &result = get_result();
+
+  const int2 input_size = input.domain().size;
+  const int channels_count = input.channels_count();
+  const RealizationOptions &realization_options = input.domain().realization_options;
+
+  /* See the realization shader for more information about the offset. */
+  const float2 offset = math::floor(float2(domain_.size - input_size) / 2.0f);
+
+  parallel_for(domain_.size, [&](const int2 texel) {
+    /* Transform the center of the domain pixel into the space of the input, where the centers of
+     * pixels are at integer coordinates as expected by the interpolation functions. */
+    const float2 coordinates = (inverse_transformation * float3(float2(texel) + 0.5f, 1.0f)).xy();
+    float2 input_coordinates = coordinates - offset - 0.5f;
+
+    if (realization_options.repeat_x) {
+      input_coordinates.x = wrap_coordinate(input_coordinates.x, input_size.x);
+    }
+    if (realization_options.repeat_y) {
+      input_coordinates.y = wrap_coordinate(input_coordinates.y, input_size.y);
+    }
+
+    float4 pixel = float4(0.0f);
+    switch (realization_options.interpolation) {
+      case Interpolation::Nearest: {
+        int2 input_texel = int2(math::floor(coordinates - offset));
+        if (realization_options.repeat_x) {
+          input_texel.x = mod_i(input_texel.x, input_size.x);
+        }
+        if (realization_options.repeat_y) {
+          input_texel.y = mod_i(input_texel.y, input_size.y);
+        }
+        if (input_texel.x >= 0 && input_texel.y >= 0 && input_texel.x < input_size.x &&
+            input_texel.y < input_size.y)
+        {
+          pixel = input.load_pixel(input_texel);
+        }
+        break;
+      }
+      case Interpolation::Bilinear:
+        BLI_bilinear_interpolation_wrap_fl(input.cpu_data(),
+                                           pixel,
+                                           input_size.x,
+                                           input_size.y,
+                                           channels_count,
+                                           input_coordinates.x,
+                                           input_coordinates.y,
+                                           realization_options.repeat_x,
+                                           realization_options.repeat_y);
+        break;
+      case Interpolation::Bicubic:
+        BLI_bicubic_interpolation_fl(input.cpu_data(),
+                                     pixel,
+                                     input_size.x,
+                                     input_size.y,
+                                     channels_count,
+                                     input_coordinates.x,
+                                     input_coordinates.y);
+        break;
+    }
+
+    result.store_pixel(texel, pixel);
+  });
+}
+
 GPUShader *RealizeOnDomainOperation::get_realization_shader()
 {
   if (get_input().get_realization_options().interpolation == Interpolation::Bicubic) {
@@ -2,6 +2,10 @@
  *
  * SPDX-License-Identifier: GPL-2.0-or-later */
 
+#include <cstring>
+
+#include "BLI_math_vector_types.hh"
+
 #include "GPU_state.h"
 #include "GPU_texture.h"
 
@@ -25,11 +29,21 @@ ReduceToSingleValueOperation::ReduceToSingleValueOperation(Context &context, Res
 
 void ReduceToSingleValueOperation::execute()
 {
-  /* Make sure any prior writes to the texture are reflected before downloading it. */
-  GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
-
   const Result &input = get_input();
-  float *pixel = static_cast<float *>(GPU_texture_read(input.texture(), GPU_DATA_FLOAT, 0));
+
+  float4 pixel = float4(0.0f);
+  if (context().use_gpu()) {
+    /* Make sure any prior writes to the texture are reflected before downloading it. */
+    GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
+
+    float *texture_pixel = static_cast<float *>(
+        GPU_texture_read(input.texture(), GPU_DATA_FLOAT, 0));
+    std::memcpy(pixel, texture_pixel, sizeof(float) * input.channels_count());
+    MEM_freeN(texture_pixel);
+  }
+  else {
+    pixel = input.load_pixel(int2(0));
+  }
 
   Result &result = get_result();
   result.allocate_single_value();
@@ -41,11 +55,9 @@ void ReduceToSingleValueOperation::execute()
       result.set_vector_value(pixel);
       break;
     case ResultType::Float:
-      result.set_float_value(*pixel);
+      result.set_float_value(pixel.x);
       break;
   }
-
-  MEM_freeN(pixel);
 }
 
 SimpleOperation *ReduceToSingleValueOperation::construct_if_needed(Context &context,
@@ -6,6 +6,8 @@
 #include "BLI_math_matrix_types.hh"
 #include "BLI_math_vector_types.hh"
 
+#include "MEM_guardedalloc.h"
+
 #include "GPU_shader.h"
 #include "GPU_state.h"
 #include "GPU_texture.h"
@@ -67,7 +69,12 @@ void Result::allocate_texture(Domain domain)
   }
 
   is_single_value_ = false;
-  texture_ = texture_pool_->acquire(domain.size, get_texture_format());
+  if (is_cpu()) {
+    allocate_cpu_data(domain.size);
+  }
+  else {
+    texture_ = texture_pool_->acquire(domain.size, get_texture_format());
+  }
   domain_ = domain;
 }
 
@@ -76,10 +83,22 @@ void Result::allocate_single_value()
   is_single_value_ = true;
   /* Single values are stored in 1x1 textures as well as the single value members. */
   const int2 texture_size{1, 1};
-  texture_ = texture_pool_->acquire(texture_size, get_texture_format());
+  if (is_cpu()) {
+    allocate_cpu_data(texture_size);
+  }
+  else {
+    texture_ = texture_pool_->acquire(texture_size, get_texture_format());
+  }
   domain_ = Domain::identity();
 }
 
+void Result::allocate_cpu_data(const int2 &size)
+{
+  const size_t pixels_count = size_t(size.x) * size_t(size.y);
+  cpu_data_ = static_cast<float *>(
+      MEM_malloc_arrayN(pixels_count * channels_count(), sizeof(float), __func__));
+}
+
 void Result::allocate_invalid()
 {
   allocate_single_value();
@@ -149,6 +168,7 @@ void Result::steal_data(Result &source)
 
   is_single_value_ = source.is_single_value_;
   texture_ = source.texture_;
+  cpu_data_ = source.cpu_data_;
   texture_pool_ = source.texture_pool_;
   domain_ = source.domain_;
 
@@ -165,6 +185,7 @@ void Result::steal_data(Result &source)
   }
 
   source.texture_ = nullptr;
+  source.cpu_data_ = nullptr;
   source.texture_pool_ = nullptr;
 }
 
@@ -220,18 +241,30 @@ float4 Result::get_color_value_default(const float4 &default_value) const
 void Result::set_float_value(float value)
 {
   float_value_ = value;
+  if (is_cpu()) {
+    cpu_data_[0] = value;
+    return;
+  }
   GPU_texture_update(texture_, GPU_DATA_FLOAT, &float_value_);
 }
 
 void Result::set_vector_value(const float4 &value)
 {
   vector_value_ = value;
+  if (is_cpu()) {
+    store_pixel(int2(0), value);
+    return;
+  }
   GPU_texture_update(texture_, GPU_DATA_FLOAT, vector_value_);
 }
 
 void Result::set_color_value(const float4 &value)
 {
   color_value_ = value;
+  if (is_cpu()) {
+    store_pixel(int2(0), value);
+    return;
+  }
   GPU_texture_update(texture_, GPU_DATA_FLOAT, color_value_);
 }
 
@@ -266,11 +299,17 @@ void Result::release()
   }
 
   /* Decrement the reference count, and if it reaches zero, release the texture back into the
-   * texture pool. */
+   * texture pool or free the host-side buffer. */
   reference_count_--;
   if (reference_count_ == 0) {
-    texture_pool_->release(texture_);
-    texture_ = nullptr;
+    if (cpu_data_) {
+      MEM_freeN(cpu_data_);
+      cpu_data_ = nullptr;
+    }
+    else {
+      texture_pool_->release(texture_);
+      texture_ = nullptr;
+    }
   }
 }
 
@@ -296,7 +335,7 @@ bool Result::is_single_value() const
 
 bool Result::is_allocated() const
 {
-  return texture_ != nullptr;
+  return texture_ != nullptr || cpu_data_ != nullptr;
 }
 
 GPUTexture *Result::texture() const
@@ -304,6 +343,16 @@ GPUTexture *Result::texture() const
   return texture_;
 }
 
+bool Result::is_cpu() const
+{
+  return !texture_pool_->use_gpu();
+}
+
+float *Result::cpu_data() const
+{
+  return cpu_data_;
+}
+
 int Result::reference_count() const
 {
   /* If there is a master result, return its reference count instead. */
@@ -4,6 +4,8 @@
 
 #include "BLI_assert.h"
 #include "BLI_math_vector.h"
+#include "BLI_math_vector_types.hh"
+#include "BLI_span.hh"
 #include "BLI_string_ref.hh"
 
 #include "DNA_node_types.h"
@@ -25,6 +27,13 @@ ShaderNode::ShaderNode(DNode node) : node_(node)
   populate_outputs();
 }
 
+void ShaderNode::compute_pixel(Span<float4> /*inputs*/, MutableSpan<float4> outputs) const
+{
+  /* Nodes that are not supported on the CPU are rejected before evaluation. */
+  BLI_assert_unreachable();
+  outputs.fill(float4(0.0f));
+}
+
 GPUNodeStack *ShaderNode::get_inputs_array()
 {
   return inputs_.data();
@@ -67,6 +67,11 @@ void TexturePool::reset()
   textures_.clear();
 }
 
+bool TexturePool::use_gpu() const
+{
+  return true;
+}
+
 /** \} */
 
 }  // namespace blender::realtime_compositor
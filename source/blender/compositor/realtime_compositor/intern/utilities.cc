@@ -11,10 +11,14 @@
 #include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
+#include "MEM_guardedalloc.h"
+
 #include "IMB_colormanagement.h"
 #include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
 
 #include "DNA_node_types.h"
+#include "DNA_scene_types.h"
 
 #include "NOD_derived_node_tree.hh"
 #include "NOD_node_declaration.hh"
@@ -111,6 +115,53 @@ bool is_node_supported(DNode node)
   return node->typeinfo->get_compositor_operation || node->typeinfo->get_compositor_shader_node;
 }
 
+/* Only the separable blur is implemented on the CPU. Variable size blur, which is only used when
+ * the size input is linked, and non separable bokeh filters are not supported. */
+static bool is_blur_node_supported_on_cpu(DNode node)
+{
+  const NodeBlurData &data = *static_cast<const NodeBlurData *>(node->storage);
+  if (data.filtertype == R_FILTER_FAST_GAUSS) {
+    return true;
+  }
+
+  if ((node->custom1 & CMP_NODEFLAG_BLUR_VARIABLE_SIZE) &&
+      get_output_linked_to_input(node.input_by_identifier("Size")))
+  {
+    return false;
+  }
+
+  return !data.bokeh || ELEM(data.filtertype, R_FILTER_BOX, R_FILTER_GAUSS);
+}
+
+bool is_node_supported_on_cpu(DNode node)
+{
+  switch (node->type) {
+    /* Input and output nodes. */
+    case CMP_NODE_IMAGE:
+    case CMP_NODE_R_LAYERS:
+    case CMP_NODE_VALUE:
+    case CMP_NODE_RGB:
+    case CMP_NODE_COMPOSITE:
+    case CMP_NODE_VIEWER:
+    /* Nodes that only transform domains or select inputs. */
+    case CMP_NODE_SWITCH:
+    case CMP_NODE_TRANSFORM:
+    case CMP_NODE_TRANSLATE:
+    case CMP_NODE_ROTATE:
+    /* Shader nodes, evaluated using CPUShaderNodeOperation. */
+    case CMP_NODE_MIX_RGB:
+    case CMP_NODE_BRIGHTCONTRAST:
+    case CMP_NODE_GAMMA:
+    case CMP_NODE_EXPOSURE:
+    case CMP_NODE_INVERT:
+      return true;
+    /* Filter nodes. */
+    case CMP_NODE_BLUR:
+      return is_blur_node_supported_on_cpu(node);
+  }
+  return false;
+}
+
 InputDescriptor input_descriptor_from_input_socket(const bNodeSocket *socket)
 {
   using namespace nodes;
@@ -139,6 +190,68 @@ void compute_dispatch_threads_at_least(GPUShader *shader, int2 threads_range, in
   GPU_compute_dispatch(shader, groups_to_dispatch.x, groups_to_dispatch.y, 1);
 }
 
+void parallel_for(const int2 range, const FunctionRef<void(int2)> function, const int tile_size)
+{
+  /* Process the range in square tiles to keep the memory accessed by each task local. */
+  const int2 tiles_count = math::divide_ceil(range, int2(tile_size));
+  const int64_t tiles_total = int64_t(tiles_count.x) * tiles_count.y;
+
+  threading::parallel_for(IndexRange(tiles_total), 1, [&](const IndexRange sub_range) {
+    for (const int64_t tile_index : sub_range) {
+      const int2 tile = int2(tile_index % tiles_count.x, tile_index / tiles_count.x);
+      const int2 start = tile * tile_size;
+      const int2 end = math::min(start + int2(tile_size), range);
+
+      for (int y = start.y; y < end.y; y++) {
+        for (int x = start.x; x < end.x; x++) {
+          function(int2(x, y));
+        }
+      }
+    }
+  });
+}
+
+float4 load_image_buffer_pixel(const ImBuf &image_buffer, const int2 texel)
+{
+  const int2 size = int2(image_buffer.x, image_buffer.y);
+  const int2 clamped_texel = math::clamp(texel, int2(0), size - 1);
+  const int channels_count = image_buffer.channels;
+  const float *pixel = image_buffer.float_buffer.data +
+                       (int64_t(clamped_texel.y) * size.x + clamped_texel.x) * channels_count;
+
+  float4 color = float4(0.0f, 0.0f, 0.0f, 1.0f);
+  for (int i = 0; i < math::min(channels_count, 4); i++) {
+    color[i] = pixel[i];
+  }
+  return color;
+}
+
+void write_output_to_buffer(Context &context,
+                            const Result &image,
+                            const Result &alpha,
+                            const bool ignore_alpha,
+                            const bool use_alpha_input,
+                            float *output_buffer)
+{
+  const rcti compositing_region = context.get_compositing_region();
+  const int2 lower_bound = int2(compositing_region.xmin, compositing_region.ymin);
+  const int output_width = context.get_render_size().x;
+
+  parallel_for(context.get_compositing_region_size(), [&](const int2 texel) {
+    float4 color = image.load_pixel(texel);
+    if (ignore_alpha) {
+      color.w = 1.0f;
+    }
+    else if (use_alpha_input) {
+      color.w = alpha.load_pixel(texel).x;
+    }
+
+    const int2 output_texel = texel + lower_bound;
+    copy_v4_v4(output_buffer + (int64_t(output_texel.y) * output_width + output_texel.x) * 4,
+               color);
+  });
+}
+
 bool is_node_preview_needed(const DNode &node)
 {
   if (!(node->flag & NODE_PREVIEW)) {
@@ -173,22 +286,12 @@ static int2 compute_preview_size(int2 size)
   }
 }
 
-void compute_preview_from_result(Context &context, const DNode &node, Result &input_result)
+/* Computes the pixels of the preview by sampling the texture of the given result using a shader.
+ * The returned pixels should be freed by the caller. */
+static float *compute_preview_pixels_gpu(Context &context,
+                                         const Result &input_result,
+                                         const int2 preview_size)
 {
-  /* Initialize node tree previews if not already initialized. */
-  bNodeTree *root_tree = const_cast<bNodeTree *>(
-      &node.context()->derived_tree().root_context().btree());
-  if (!root_tree->previews) {
-    root_tree->previews = BKE_node_instance_hash_new("node previews");
-  }
-
-  const int2 preview_size = compute_preview_size(input_result.domain().size);
-  node->runtime->preview_xsize = preview_size.x;
-  node->runtime->preview_ysize = preview_size.y;
-
-  bNodePreview *preview = bke::node_preview_verify(
-      root_tree->previews, node.instance_key(), preview_size.x, preview_size.y, true);
-
   GPUShader *shader = context.shader_manager().get("compositor_compute_preview");
   GPU_shader_bind(shader);
 
@@ -213,6 +316,57 @@ void compute_preview_from_result(Context &context, const DNode &node, Result &in
       GPU_texture_read(preview_result.texture(), GPU_DATA_FLOAT, 0));
   preview_result.release();
 
+  /* Restore original swizzle mask set above. */
+  if (input_result.type() == ResultType::Float) {
+    GPU_texture_swizzle_set(input_result.texture(), "rgba");
+  }
+
+  return preview_pixels;
+}
+
+/* Computes the pixels of the preview by sampling the host-side buffer of the given result using
+ * nearest neighbour interpolation. The returned pixels should be freed by the caller. */
+static float *compute_preview_pixels_cpu(const Result &input_result, const int2 preview_size)
+{
+  float *preview_pixels = static_cast<float *>(MEM_malloc_arrayN(
+      size_t(preview_size.x) * size_t(preview_size.y), sizeof(float4), __func__));
+
+  const int2 input_size = input_result.domain().size;
+  parallel_for(preview_size, [&](const int2 texel) {
+    const float2 coordinates = (float2(texel) + float2(0.5f)) / float2(preview_size);
+    const int2 input_texel = math::min(int2(coordinates * float2(input_size)), input_size - 1);
+
+    float4 color = input_result.load_pixel(input_texel);
+    if (input_result.type() == ResultType::Float) {
+      color = float4(float3(color.x), 1.0f);
+    }
+
+    copy_v4_v4(preview_pixels + (int64_t(texel.y) * preview_size.x + texel.x) * 4, color);
+  });
+
+  return preview_pixels;
+}
+
+void compute_preview_from_result(Context &context, const DNode &node, Result &input_result)
+{
+  /* Initialize node tree previews if not already initialized. */
+  bNodeTree *root_tree = const_cast<bNodeTree *>(
+      &node.context()->derived_tree().root_context().btree());
+  if (!root_tree->previews) {
+    root_tree->previews = BKE_node_instance_hash_new("node previews");
+  }
+
+  const int2 preview_size = compute_preview_size(input_result.domain().size);
+  node->runtime->preview_xsize = preview_size.x;
+  node->runtime->preview_ysize = preview_size.y;
+
+  bNodePreview *preview = bke::node_preview_verify(
+      root_tree->previews, node.instance_key(), preview_size.x, preview_size.y, true);
+
+  float *preview_pixels = context.use_gpu() ?
+                             compute_preview_pixels_gpu(context, input_result, preview_size) :
+                             compute_preview_pixels_cpu(input_result, preview_size);
+
   ColormanageProcessor *color_processor = IMB_colormanagement_display_processor_new(
       &context.get_scene().view_settings, &context.get_scene().display_settings);
 
@@ -226,11 +380,6 @@ void compute_preview_from_result(Context &context, const DNode &node, Result &in
     }
   });
 
-  /* Restore original swizzle mask set above. */
-  if (input_result.type() == ResultType::Float) {
-    GPU_texture_swizzle_set(input_result.texture(), "rgba");
-  }
-
   IMB_colormanagement_processor_free(color_processor);
   MEM_freeN(preview_pixels);
 }
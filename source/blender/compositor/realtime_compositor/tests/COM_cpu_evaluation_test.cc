@@ -0,0 +1,452 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <cmath>
+#include <string>
+
+#include "BLI_array.hh"
+#include "BLI_assert.h"
+#include "BLI_math_vector.h"
+#include "BLI_math_vector.hh"
+#include "BLI_math_vector_types.hh"
+#include "BLI_string_ref.hh"
+
+#include "CLG_log.h"
+
+#include "DNA_material_types.h"
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+
+#include "RNA_define.h"
+
+#include "BKE_appdir.h"
+#include "BKE_context.h"
+#include "BKE_global.h"
+#include "BKE_idtype.h"
+#include "BKE_main.h"
+#include "BKE_node.h"
+#include "BKE_node.hh"
+#include "BKE_node_tree_update.h"
+#include "BKE_scene.h"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+
+#include "NOD_composite.h"
+
+#include "COM_context.hh"
+#include "COM_evaluator.hh"
+#include "COM_symmetric_separable_blur_weights.hh"
+#include "COM_texture_pool.hh"
+
+namespace blender::realtime_compositor::tests {
+
+static const int2 render_size = int2(16, 16);
+
+/* A texture pool that makes the compositor evaluate on the CPU. */
+class CPUTexturePool : public TexturePool {
+ public:
+  bool use_gpu() const override
+  {
+    return false;
+  }
+
+  GPUTexture *allocate_texture(int2 /*size*/, eGPUTextureFormat /*format*/) override
+  {
+    BLI_assert_unreachable();
+    return nullptr;
+  }
+};
+
+/* A context that writes the composite output to a host buffer and provides a single combined
+ * render pass. */
+class CPUTestContext : public Context {
+ public:
+  const Scene *scene;
+  const bNodeTree *node_tree;
+  /* The combined pass returned for all render layers, not owned by the context. */
+  ImBuf *combined_pass = nullptr;
+  /* The output of the composite node, initialized to a value that no test produces. */
+  Array<float4> output = Array<float4>(render_size.x * render_size.y, float4(-1.0f));
+  mutable std::string info_message;
+
+  CPUTestContext(TexturePool &texture_pool, const Scene *scene, const bNodeTree *node_tree)
+      : Context(texture_pool), scene(scene), node_tree(node_tree)
+  {
+  }
+
+  const Scene &get_scene() const override
+  {
+    return *scene;
+  }
+
+  const bNodeTree &get_node_tree() const override
+  {
+    return *node_tree;
+  }
+
+  bool use_file_output() const override
+  {
+    return false;
+  }
+
+  bool use_composite_output() const override
+  {
+    return true;
+  }
+
+  const RenderData &get_render_data() const override
+  {
+    return scene->r;
+  }
+
+  int2 get_render_size() const override
+  {
+    return render_size;
+  }
+
+  rcti get_compositing_region() const override
+  {
+    return rcti{0, render_size.x, 0, render_size.y};
+  }
+
+  GPUTexture *get_output_texture() override
+  {
+    return nullptr;
+  }
+
+  GPUTexture *get_viewer_output_texture() override
+  {
+    return nullptr;
+  }
+
+  float *get_output_buffer() override
+  {
+    return reinterpret_cast<float *>(output.data());
+  }
+
+  GPUTexture *get_input_texture(const Scene * /*scene*/,
+                                int /*view_layer*/,
+                                const char * /*pass_name*/) override
+  {
+    return nullptr;
+  }
+
+  const ImBuf *get_input_image_buffer(const Scene * /*scene*/,
+                                      int /*view_layer*/,
+                                      const char *pass_name) override
+  {
+    return StringRef(pass_name) == RE_PASSNAME_COMBINED ? combined_pass : nullptr;
+  }
+
+  StringRef get_view_name() override
+  {
+    return "";
+  }
+
+  void set_info_message(StringRef message) const override
+  {
+    info_message = message;
+  }
+
+  IDRecalcFlag query_id_recalc_flag(ID * /*id*/) const override
+  {
+    return IDRecalcFlag(0);
+  }
+
+  float4 get_output_pixel(const int2 texel) const
+  {
+    return output[texel.y * render_size.x + texel.x];
+  }
+};
+
+class CPUEvaluationTest : public testing::Test {
+ public:
+  Main *bmain = nullptr;
+  bContext *C = nullptr;
+  Scene *scene = nullptr;
+  bNodeTree *node_tree = nullptr;
+  ImBuf *combined_pass = nullptr;
+
+  static void SetUpTestSuite()
+  {
+    CLG_init();
+    BKE_idtype_init();
+    RNA_init();
+    BKE_node_system_init();
+    BKE_appdir_init();
+    IMB_init();
+  }
+
+  static void TearDownTestSuite()
+  {
+    BKE_node_system_exit();
+    RNA_exit();
+    IMB_exit();
+    BKE_appdir_exit();
+    CLG_exit();
+  }
+
+  void SetUp() override
+  {
+    bmain = BKE_main_new();
+    G.main = bmain;
+    scene = BKE_scene_add(bmain, "Scene");
+    C = CTX_create();
+    CTX_data_main_set(C, bmain);
+    CTX_data_scene_set(C, scene);
+
+    node_tree = bke::ntreeAddTreeEmbedded(
+        bmain, &scene->id, "Compositing Nodetree", ntreeType_Composite->idname);
+
+    combined_pass = IMB_allocImBuf(render_size.x, render_size.y, 32, IB_rectfloat);
+  }
+
+  void TearDown() override
+  {
+    IMB_freeImBuf(combined_pass);
+    CTX_free(C);
+    BKE_main_free(bmain);
+    G.main = nullptr;
+  }
+
+  bNode *add_node(const int type)
+  {
+    bNode *node = nodeAddStaticNode(C, node_tree, type);
+    /* Previews need color management, which is not needed for those tests. */
+    node->flag &= ~NODE_PREVIEW;
+    return node;
+  }
+
+  bNode *add_composite_node()
+  {
+    bNode *node = add_node(CMP_NODE_COMPOSITE);
+    node->flag |= NODE_DO_OUTPUT;
+    return node;
+  }
+
+  void link(bNode *from_node, const char *from_socket, bNode *to_node, const char *to_socket)
+  {
+    nodeAddLink(node_tree,
+                from_node,
+                nodeFindSocket(from_node, SOCK_OUT, from_socket),
+                to_node,
+                nodeFindSocket(to_node, SOCK_IN, to_socket));
+  }
+
+  void set_input_value(bNode *node, const char *identifier, const float value)
+  {
+    bNodeSocket *socket = nodeFindSocket(node, SOCK_IN, identifier);
+    socket->default_value_typed<bNodeSocketValueFloat>()->value = value;
+  }
+
+  void set_rgb_value(bNode *rgb_node, const float4 &color)
+  {
+    bNodeSocket *socket = nodeFindSocket(rgb_node, SOCK_OUT, "RGBA");
+    copy_v4_v4(socket->default_value_typed<bNodeSocketValueRGBA>()->value, color);
+  }
+
+  void set_combined_pass_pixel(const int2 texel, const float4 &color)
+  {
+    const int64_t index = (int64_t(texel.y) * render_size.x + texel.x) * 4;
+    copy_v4_v4(combined_pass->float_buffer.data + index, color);
+  }
+
+  /* Evaluate the node tree on the CPU and return the context holding the output. */
+  std::unique_ptr<CPUTestContext> evaluate()
+  {
+    BKE_ntree_update_main_tree(bmain, node_tree, nullptr);
+
+    CPUTexturePool texture_pool;
+    std::unique_ptr<CPUTestContext> context = std::make_unique<CPUTestContext>(
+        texture_pool, scene, node_tree);
+    context->combined_pass = combined_pass;
+
+    Evaluator evaluator(*context);
+    evaluator.evaluate();
+
+    return context;
+  }
+};
+
+TEST_F(CPUEvaluationTest, single_value_color_nodes)
+{
+  bNode *rgb = add_node(CMP_NODE_RGB);
+  set_rgb_value(rgb, float4(0.2f, 0.4f, 0.6f, 1.0f));
+
+  bNode *exposure = add_node(CMP_NODE_EXPOSURE);
+  set_input_value(exposure, "Exposure", 1.0f);
+  link(rgb, "RGBA", exposure, "Image");
+
+  bNode *invert = add_node(CMP_NODE_INVERT);
+  set_input_value(invert, "Fac", 1.0f);
+  link(exposure, "Image", invert, "Color");
+
+  bNode *bright_contrast = add_node(CMP_NODE_BRIGHTCONTRAST);
+  set_input_value(bright_contrast, "Bright", 10.0f);
+  set_input_value(bright_contrast, "Contrast", 0.0f);
+  link(invert, "Color", bright_contrast, "Image");
+
+  bNode *composite = add_composite_node();
+  link(bright_contrast, "Image", composite, "Image");
+
+  std::unique_ptr<CPUTestContext> context = evaluate();
+  EXPECT_TRUE(context->info_message.empty());
+
+  /* Exposure doubles the color, invert subtracts it from one and brightness adds a tenth. */
+  const float4 expected = float4(1.0f - 0.4f + 0.1f, 1.0f - 0.8f + 0.1f, 1.0f - 1.2f + 0.1f, 1.0f);
+  for (int y = 0; y < render_size.y; y++) {
+    for (int x = 0; x < render_size.x; x++) {
+      const float4 pixel = context->get_output_pixel(int2(x, y));
+      EXPECT_NEAR(pixel.x, expected.x, 1e-5f);
+      EXPECT_NEAR(pixel.y, expected.y, 1e-5f);
+      EXPECT_NEAR(pixel.z, expected.z, 1e-5f);
+      EXPECT_NEAR(pixel.w, expected.w, 1e-5f);
+    }
+  }
+}
+
+TEST_F(CPUEvaluationTest, render_layer_mix_gamma)
+{
+  for (int y = 0; y < render_size.y; y++) {
+    for (int x = 0; x < render_size.x; x++) {
+      set_combined_pass_pixel(int2(x, y), float4(x / 16.0f, y / 16.0f, 0.5f, 0.75f));
+    }
+  }
+
+  bNode *render_layers = add_node(CMP_NODE_R_LAYERS);
+
+  bNode *rgb = add_node(CMP_NODE_RGB);
+  set_rgb_value(rgb, float4(0.25f, 0.25f, 0.25f, 1.0f));
+
+  bNode *mix = add_node(CMP_NODE_MIX_RGB);
+  mix->custom1 = MA_RAMP_ADD;
+  set_input_value(mix, "Fac", 1.0f);
+  link(render_layers, "Image", mix, "Image");
+  link(rgb, "RGBA", mix, "Image_001");
+
+  bNode *gamma = add_node(CMP_NODE_GAMMA);
+  set_input_value(gamma, "Gamma", 2.0f);
+  link(mix, "Image", gamma, "Image");
+
+  bNode *composite = add_composite_node();
+  link(gamma, "Image", composite, "Image");
+
+  std::unique_ptr<CPUTestContext> context = evaluate();
+  EXPECT_TRUE(context->info_message.empty());
+
+  for (int y = 0; y < render_size.y; y++) {
+    for (int x = 0; x < render_size.x; x++) {
+      const float4 pixel = context->get_output_pixel(int2(x, y));
+      EXPECT_NEAR(pixel.x, std::pow(x / 16.0f + 0.25f, 2.0f), 1e-5f);
+      EXPECT_NEAR(pixel.y, std::pow(y / 16.0f + 0.25f, 2.0f), 1e-5f);
+      EXPECT_NEAR(pixel.z, std::pow(0.5f + 0.25f, 2.0f), 1e-5f);
+      /* The mix keeps the alpha of the first color. */
+      EXPECT_NEAR(pixel.w, 0.75f, 1e-5f);
+    }
+  }
+}
+
+TEST_F(CPUEvaluationTest, render_layer_blur)
+{
+  /* A single white pixel in the middle of a transparent pass, so the output is the filter. */
+  const int2 center = render_size / 2;
+  set_combined_pass_pixel(center, float4(1.0f));
+
+  bNode *render_layers = add_node(CMP_NODE_R_LAYERS);
+
+  bNode *blur = add_node(CMP_NODE_BLUR);
+  NodeBlurData *blur_data = static_cast<NodeBlurData *>(blur->storage);
+  blur_data->filtertype = R_FILTER_GAUSS;
+  blur_data->sizex = 3;
+  blur_data->sizey = 2;
+  link(render_layers, "Image", blur, "Image");
+
+  bNode *composite = add_composite_node();
+  link(blur, "Image", composite, "Image");
+
+  std::unique_ptr<CPUTestContext> context = evaluate();
+  EXPECT_TRUE(context->info_message.empty());
+
+  const Array<float> weights_x = SymmetricSeparableBlurWeights::compute_weights(R_FILTER_GAUSS,
+                                                                                3.0f);
+  const Array<float> weights_y = SymmetricSeparableBlurWeights::compute_weights(R_FILTER_GAUSS,
+                                                                                2.0f);
+
+  float sum = 0.0f;
+  for (int y = 0; y < render_size.y; y++) {
+    for (int x = 0; x < render_size.x; x++) {
+      const int2 offset = math::abs(int2(x, y) - center);
+      const float weight_x = offset.x < weights_x.size() ? weights_x[offset.x] : 0.0f;
+      const float weight_y = offset.y < weights_y.size() ? weights_y[offset.y] : 0.0f;
+
+      const float4 pixel = context->get_output_pixel(int2(x, y));
+      EXPECT_NEAR(pixel.x, weight_x * weight_y, 1e-6f);
+      EXPECT_NEAR(pixel.w, weight_x * weight_y, 1e-6f);
+      sum += pixel.x;
+    }
+  }
+
+  /* The filter is normalized, so the energy of the pixel is preserved. */
+  EXPECT_NEAR(sum, 1.0f, 1e-5f);
+}
+
+TEST_F(CPUEvaluationTest, blur_unsupported_settings)
+{
+  bNode *render_layers = add_node(CMP_NODE_R_LAYERS);
+
+  bNode *blur = add_node(CMP_NODE_BLUR);
+  NodeBlurData *blur_data = static_cast<NodeBlurData *>(blur->storage);
+  blur_data->filtertype = R_FILTER_TENT;
+  blur_data->sizex = 3;
+  blur_data->sizey = 3;
+  link(render_layers, "Image", blur, "Image");
+
+  bNode *composite = add_composite_node();
+  link(blur, "Image", composite, "Image");
+
+  /* The separable approximation of the filter is supported. */
+  EXPECT_TRUE(evaluate()->info_message.empty());
+
+  /* Non separable filters are not. */
+  blur_data->bokeh = 1;
+  std::unique_ptr<CPUTestContext> context = evaluate();
+  EXPECT_FALSE(context->info_message.empty());
+  EXPECT_EQ(context->get_output_pixel(int2(0)), float4(-1.0f));
+
+  /* Separable filters are supported with the bokeh option. */
+  blur_data->filtertype = R_FILTER_GAUSS;
+  EXPECT_TRUE(evaluate()->info_message.empty());
+
+  /* The variable size option is ignored while the size input is unlinked. */
+  blur->custom1 |= CMP_NODEFLAG_BLUR_VARIABLE_SIZE;
+  EXPECT_TRUE(evaluate()->info_message.empty());
+
+  /* Variable size blur is not supported. */
+  link(render_layers, "Alpha", blur, "Size");
+  context = evaluate();
+  EXPECT_FALSE(context->info_message.empty());
+  EXPECT_EQ(context->get_output_pixel(int2(0)), float4(-1.0f));
+}
+
+TEST_F(CPUEvaluationTest, unsupported_node)
+{
+  bNode *render_layers = add_node(CMP_NODE_R_LAYERS);
+
+  bNode *dilate_erode = add_node(CMP_NODE_DILATEERODE);
+  link(render_layers, "Alpha", dilate_erode, "Mask");
+
+  bNode *composite = add_composite_node();
+  link(dilate_erode, "Mask", composite, "Image");
+
+  std::unique_ptr<CPUTestContext> context = evaluate();
+
+  /* The tree is rejected before evaluation and the output is left untouched. */
+  EXPECT_FALSE(context->info_message.empty());
+  EXPECT_EQ(context->get_output_pixel(int2(0)), float4(-1.0f));
+}
+
+}  // namespace blender::realtime_compositor::tests
@@ -0,0 +1,193 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_rect.h"
+
+#include "COM_FastGaussianBlurOperation.h"
+
+namespace blender::compositor::tests {
+
+/**
+ * Young/van Vliet recursive gaussian with Triggs/Sdika border corrections, filtering a single
+ * line of at least 3 values at a time. Reference for #FastGaussianBlurOperation::IIR_gauss.
+ */
+class ReferenceIIRGauss {
+  double cf_[4];
+  double tsM_[9];
+
+ public:
+  ReferenceIIRGauss(const float sigma)
+  {
+    double q;
+    if (sigma >= 3.556f) {
+      q = 0.9804f * (sigma - 3.556f) + 2.5091f;
+    }
+    else {
+      q = (0.0561f * sigma + 0.5784f) * sigma - 0.2568f;
+    }
+    const double q2 = q * q;
+    double sc = (1.1668 + q) * (3.203729649 + (2.21566 + q) * q);
+    double *cf = cf_;
+    cf[1] = q * (5.788961737 + (6.76492 + 3.0 * q) * q) / sc;
+    cf[2] = -q2 * (3.38246 + 3.0 * q) / sc;
+    cf[3] = q2 * q / sc;
+    cf[0] = 1.0 - cf[1] - cf[2] - cf[3];
+
+    sc = cf[0] / ((1.0 + cf[1] - cf[2] + cf[3]) * (1.0 - cf[1] - cf[2] - cf[3]) *
+                  (1.0 + cf[2] + (cf[1] - cf[3]) * cf[3]));
+    double *tsM = tsM_;
+    tsM[0] = sc * (-cf[3] * cf[1] + 1.0 - cf[3] * cf[3] - cf[2]);
+    tsM[1] = sc * ((cf[3] + cf[1]) * (cf[2] + cf[3] * cf[1]));
+    tsM[2] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
+    tsM[3] = sc * (cf[1] + cf[3] * cf[2]);
+    tsM[4] = sc * (-(cf[2] - 1.0) * (cf[2] + cf[3] * cf[1]));
+    tsM[5] = sc * (-(cf[3] * cf[1] + cf[3] * cf[3] + cf[2] - 1.0) * cf[3]);
+    tsM[6] = sc * (cf[3] * cf[1] + cf[2] + cf[1] * cf[1] - cf[2] * cf[2]);
+    tsM[7] = sc * (cf[1] * cf[2] + cf[3] * cf[2] * cf[2] - cf[1] * cf[3] * cf[3] -
+                   cf[3] * cf[3] * cf[3] - cf[3] * cf[2] + cf[3]);
+    tsM[8] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
+  }
+
+  void filter_line(const Span<double> X, MutableSpan<double> Y) const
+  {
+    const double *cf = cf_;
+    const double *tsM = tsM_;
+    const int L = X.size();
+    Array<double> W(L);
+    W[0] = cf[0] * X[0] + cf[1] * X[0] + cf[2] * X[0] + cf[3] * X[0];
+    W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * X[0] + cf[3] * X[0];
+    W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * X[0];
+    for (int i = 3; i < L; i++) {
+      W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3];
+    }
+    const double tsu[3] = {W[L - 1] - X[L - 1], W[L - 2] - X[L - 1], W[L - 3] - X[L - 1]};
+    double tsv[3];
+    tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + X[L - 1];
+    tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + X[L - 1];
+    tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + X[L - 1];
+    Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2];
+    Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1];
+    Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0];
+    for (int i = L - 4; i >= 0; i--) {
+      Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3];
+    }
+  }
+};
+
+/** Blur a single channel along one axis, like the previous per channel implementation. */
+static void reference_iir_gauss(MemoryBuffer &buffer,
+                                const float sigma,
+                                const int channel,
+                                const eDimension dimension)
+{
+  const int width = buffer.get_width();
+  const int height = buffer.get_height();
+  const bool is_x = dimension == eDimension::X;
+  const int lines_num = is_x ? height : width;
+  const int length = is_x ? width : height;
+  if (sigma < 0.5f || length < 3) {
+    return;
+  }
+
+  const ReferenceIIRGauss filter(sigma);
+  float *data = buffer.get_buffer();
+  const int line_stride = is_x ? buffer.row_stride : buffer.elem_stride;
+  const int stride = is_x ? buffer.elem_stride : buffer.row_stride;
+  Array<double> X(length);
+  Array<double> Y(length);
+  for (const int line : IndexRange(lines_num)) {
+    float *line_data = data + line * line_stride + channel;
+    for (const int i : IndexRange(length)) {
+      X[i] = line_data[i * stride];
+    }
+    filter.filter_line(X, Y);
+    for (const int i : IndexRange(length)) {
+      line_data[i * stride] = Y[i];
+    }
+  }
+}
+
+static void fill_image(MemoryBuffer &buffer)
+{
+  const rcti &rect = buffer.get_rect();
+  for (int y = rect.ymin; y < rect.ymax; y++) {
+    for (int x = rect.xmin; x < rect.xmax; x++) {
+      float *elem = buffer.get_elem(x, y);
+      for (int channel = 0; channel < buffer.get_num_channels(); channel++) {
+        elem[channel] = float((x * 7 + y * 13 + channel * 5) % 17) / 16.0f;
+      }
+    }
+  }
+}
+
+static void test_iir_gauss_matches_reference(const DataType data_type,
+                                             const int width,
+                                             const int height,
+                                             const float sigma_x,
+                                             const float sigma_y,
+                                             const int num_channels)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, width, 0, height);
+  MemoryBuffer expected(data_type, rect);
+  fill_image(expected);
+  MemoryBuffer result(expected);
+
+  for (const int channel : IndexRange(num_channels)) {
+    reference_iir_gauss(expected, sigma_x, channel, eDimension::X);
+    reference_iir_gauss(expected, sigma_y, channel, eDimension::Y);
+  }
+  FastGaussianBlurOperation::IIR_gauss(&result, sigma_x, sigma_y, num_channels);
+
+  /* Channels after the blurred ones are left unchanged by both. */
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      for (int channel = 0; channel < result.get_num_channels(); channel++) {
+        EXPECT_NEAR(result.get_elem(x, y)[channel], expected.get_elem(x, y)[channel], 1e-5f);
+      }
+    }
+  }
+}
+
+TEST(FastGaussianBlurOperation, IIRGaussColor)
+{
+  for (const float sigma : {0.5f, 1.7f, 3.556f, 12.0f, 250.0f}) {
+    test_iir_gauss_matches_reference(DataType::Color, 67, 45, sigma, sigma, 4);
+  }
+}
+
+TEST(FastGaussianBlurOperation, IIRGaussChannelsSubset)
+{
+  test_iir_gauss_matches_reference(DataType::Color, 67, 45, 4.0f, 4.0f, 3);
+  test_iir_gauss_matches_reference(DataType::Color, 20, 9, 2.0f, 2.0f, 1);
+}
+
+TEST(FastGaussianBlurOperation, IIRGaussValue)
+{
+  /* More lines than a multiple of the number of lines filtered together. */
+  test_iir_gauss_matches_reference(DataType::Value, 35, 19, 3.0f, 3.0f, 1);
+}
+
+TEST(FastGaussianBlurOperation, IIRGaussDifferentSigmas)
+{
+  test_iir_gauss_matches_reference(DataType::Color, 40, 31, 1.2f, 9.0f, 4);
+  /* Sigmas under 0.5 don't blur along their axis. */
+  test_iir_gauss_matches_reference(DataType::Color, 40, 31, 0.3f, 5.0f, 4);
+  test_iir_gauss_matches_reference(DataType::Color, 40, 31, 5.0f, 0.0f, 4);
+}
+
+TEST(FastGaussianBlurOperation, IIRGaussSmallSizes)
+{
+  /* Lines shorter than 3 pixels are not blurred. */
+  test_iir_gauss_matches_reference(DataType::Color, 1, 1, 2.0f, 2.0f, 4);
+  test_iir_gauss_matches_reference(DataType::Color, 2, 7, 2.0f, 2.0f, 4);
+  test_iir_gauss_matches_reference(DataType::Color, 7, 2, 2.0f, 2.0f, 4);
+  test_iir_gauss_matches_reference(DataType::Color, 3, 3, 2.0f, 2.0f, 4);
+  test_iir_gauss_matches_reference(DataType::Color, 1, 12, 6.0f, 6.0f, 4);
+}
+
+}  // namespace blender::compositor::tests
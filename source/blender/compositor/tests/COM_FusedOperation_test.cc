@@ -0,0 +1,212 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include <memory>
+
+#include "BLI_map.hh"
+#include "BLI_rect.h"
+
+#include "COM_FusedOperation.h"
+#include "COM_MixOperation.h"
+
+namespace blender::compositor::tests {
+
+/** Only used as the source of links, the data of its output is given as an input buffer. */
+class SourceOperation : public NodeOperation {
+ public:
+  SourceOperation(DataType data_type)
+  {
+    add_output_socket(data_type);
+  }
+};
+
+/** Exposes the execution of a fused operation on a single area. */
+class TestFusedOperation : public FusedOperation {
+ public:
+  using FusedOperation::FusedOperation;
+  using FusedOperation::update_memory_buffer_partial;
+};
+
+static std::unique_ptr<MemoryBuffer> create_image(const DataType data_type,
+                                                  const rcti &canvas,
+                                                  const int seed)
+{
+  std::unique_ptr<MemoryBuffer> buffer = std::make_unique<MemoryBuffer>(data_type, canvas);
+  for (int y = canvas.ymin; y < canvas.ymax; y++) {
+    for (int x = canvas.xmin; x < canvas.xmax; x++) {
+      float *elem = buffer->get_elem(x, y);
+      for (int channel = 0; channel < buffer->get_num_channels(); channel++) {
+        elem[channel] = float((x * 7 + y * 13 + channel * 5 + seed * 3) % 17) / 16.0f;
+      }
+    }
+  }
+  return buffer;
+}
+
+static std::unique_ptr<MemoryBuffer> create_constant(const DataType data_type,
+                                                     const rcti &canvas,
+                                                     const float value)
+{
+  std::unique_ptr<MemoryBuffer> buffer = std::make_unique<MemoryBuffer>(data_type, canvas, true);
+  float *elem = buffer->get_buffer();
+  for (int channel = 0; channel < buffer->get_num_channels(); channel++) {
+    elem[channel] = value + channel * 0.1f;
+  }
+  return buffer;
+}
+
+/**
+ * Inputs of a tree of mix operations, `blend(add(a, b), multiply(c, d))`, with constant and
+ * image inputs.
+ */
+class FusedMixTree {
+ public:
+  SourceOperation add_value{DataType::Value};
+  SourceOperation add_color1{DataType::Color};
+  SourceOperation add_color2{DataType::Color};
+  SourceOperation multiply_value{DataType::Value};
+  SourceOperation multiply_color1{DataType::Color};
+  SourceOperation multiply_color2{DataType::Color};
+  SourceOperation blend_value{DataType::Value};
+
+  Map<const NodeOperation *, std::unique_ptr<MemoryBuffer>> buffers;
+
+  FusedMixTree(const rcti &canvas)
+  {
+    buffers.add_new(&add_value, create_constant(DataType::Value, canvas, 0.7f));
+    buffers.add_new(&add_color1, create_image(DataType::Color, canvas, 0));
+    buffers.add_new(&add_color2, create_image(DataType::Color, canvas, 1));
+    buffers.add_new(&multiply_value, create_image(DataType::Value, canvas, 2));
+    buffers.add_new(&multiply_color1, create_constant(DataType::Color, canvas, 0.4f));
+    buffers.add_new(&multiply_color2, create_image(DataType::Color, canvas, 3));
+    buffers.add_new(&blend_value, create_constant(DataType::Value, canvas, 0.25f));
+  }
+
+  MemoryBuffer *buffer(const NodeOperation &operation)
+  {
+    return buffers.lookup(&operation).get();
+  }
+
+  /** Create the mix operations with their inputs linked, in execution order. */
+  void create_operations(MixBaseOperation *r_operations[3])
+  {
+    MixBaseOperation *add = new MixAddOperation();
+    add->set_use_clamp(true);
+    link(*add, {&add_value, &add_color1, &add_color2});
+
+    MixBaseOperation *multiply = new MixMultiplyOperation();
+    multiply->set_use_value_alpha_multiply(true);
+    link(*multiply, {&multiply_value, &multiply_color1, &multiply_color2});
+
+    MixBaseOperation *blend = new MixBlendOperation();
+    link(*blend, {&blend_value, add, multiply});
+
+    r_operations[0] = add;
+    r_operations[1] = multiply;
+    r_operations[2] = blend;
+  }
+
+ private:
+  static void link(NodeOperation &operation, const Span<NodeOperation *> inputs)
+  {
+    for (const int i : inputs.index_range()) {
+      operation.get_input_socket(i)->set_link(inputs[i]->get_output_socket());
+    }
+  }
+};
+
+static void test_fused_matches_unfused(const rcti &canvas, const rcti &area)
+{
+  FusedMixTree tree(canvas);
+
+  /* Execute every operation on its own, with full size intermediate buffers. */
+  MixBaseOperation *unfused[3];
+  tree.create_operations(unfused);
+  MemoryBuffer add_result(DataType::Color, canvas);
+  MemoryBuffer multiply_result(DataType::Color, canvas);
+  MemoryBuffer unfused_result(DataType::Color, canvas);
+  add_result.clear();
+  multiply_result.clear();
+  unfused_result.clear();
+  unfused[0]->update_memory_buffer_partial(
+      &add_result,
+      area,
+      {tree.buffer(tree.add_value), tree.buffer(tree.add_color1), tree.buffer(tree.add_color2)});
+  unfused[1]->update_memory_buffer_partial(&multiply_result,
+                                           area,
+                                           {tree.buffer(tree.multiply_value),
+                                            tree.buffer(tree.multiply_color1),
+                                            tree.buffer(tree.multiply_color2)});
+  unfused[2]->update_memory_buffer_partial(
+      &unfused_result, area, {tree.buffer(tree.blend_value), &add_result, &multiply_result});
+  for (MixBaseOperation *operation : unfused) {
+    delete operation;
+  }
+
+  /* Execute the same operations fused. */
+  MixBaseOperation *operations[3];
+  tree.create_operations(operations);
+  TestFusedOperation fused(DataType::Color);
+  for (MixBaseOperation *operation : operations) {
+    fused.add_fused_operation(operation);
+  }
+  ASSERT_EQ(fused.get_number_of_input_sockets(), 7);
+  Vector<MemoryBuffer *> fused_inputs;
+  for (int i = 0; i < fused.get_number_of_input_sockets(); i++) {
+    fused_inputs.append(tree.buffer(fused.get_fused_input(i)->get_link()->get_operation()));
+  }
+  MemoryBuffer fused_result(DataType::Color, canvas);
+  fused_result.clear();
+  fused.update_memory_buffer_partial(&fused_result, area, fused_inputs);
+
+  /* Pixels outside of the area are not written by either. */
+  for (int y = canvas.ymin; y < canvas.ymax; y++) {
+    for (int x = canvas.xmin; x < canvas.xmax; x++) {
+      const float *expected = unfused_result.get_elem(x, y);
+      const float *result = fused_result.get_elem(x, y);
+      for (int channel = 0; channel < 4; channel++) {
+        EXPECT_FLOAT_EQ(result[channel], expected[channel]);
+      }
+    }
+  }
+}
+
+TEST(FusedOperation, FullCanvas)
+{
+  rcti canvas;
+  BLI_rcti_init(&canvas, 0, 150, 0, 90);
+  test_fused_matches_unfused(canvas, canvas);
+}
+
+TEST(FusedOperation, AreaSmallerThanCanvas)
+{
+  rcti canvas;
+  BLI_rcti_init(&canvas, 0, 150, 0, 90);
+  /* Large enough to be processed in more than one strip. */
+  rcti area;
+  BLI_rcti_init(&area, 17, 143, 5, 83);
+  test_fused_matches_unfused(canvas, area);
+}
+
+TEST(FusedOperation, SingleRowArea)
+{
+  rcti canvas;
+  BLI_rcti_init(&canvas, 0, 150, 0, 90);
+  rcti area;
+  BLI_rcti_init(&area, 3, 140, 41, 42);
+  test_fused_matches_unfused(canvas, area);
+}
+
+TEST(FusedOperation, CanvasWithOffset)
+{
+  rcti canvas;
+  BLI_rcti_init(&canvas, -20, 30, 10, 60);
+  rcti area;
+  BLI_rcti_init(&area, -7, 12, 11, 59);
+  test_fused_matches_unfused(canvas, area);
+}
+
+}  // namespace blender::compositor::tests
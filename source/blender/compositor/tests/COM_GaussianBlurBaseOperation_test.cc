@@ -0,0 +1,135 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_rect.h"
+
+#include "COM_GaussianBlurBaseOperation.h"
+
+namespace blender::compositor::tests {
+
+/**
+ * Box blur with a filter table of the given radius, which can be executed either with running
+ * sums or by weighting with the table.
+ */
+class TestBoxBlurOperation : public GaussianBlurBaseOperation {
+ public:
+  TestBoxBlurOperation(const eDimension dimension, const float radius)
+      : GaussianBlurBaseOperation(dimension)
+  {
+    data_.filtertype = R_FILTER_BOX;
+    rad_ = radius;
+    filtersize_ = min_ii(ceil(rad_), MAX_GAUSSTAB_RADIUS);
+    gausstab_ = make_gausstab(rad_, filtersize_);
+#if BLI_HAVE_SSE2
+    gausstab_sse_ = convert_gausstab_sse(gausstab_, filtersize_);
+#endif
+  }
+
+  ~TestBoxBlurOperation()
+  {
+    deinit_execution();
+  }
+
+  /** Any other filter type uses the weights of the box filter table built on construction. */
+  void use_table_weights()
+  {
+    data_.filtertype = R_FILTER_TENT;
+  }
+};
+
+static void fill_image(MemoryBuffer &buffer)
+{
+  const rcti &rect = buffer.get_rect();
+  for (int y = rect.ymin; y < rect.ymax; y++) {
+    for (int x = rect.xmin; x < rect.xmax; x++) {
+      float *elem = buffer.get_elem(x, y);
+      for (int channel = 0; channel < buffer.get_num_channels(); channel++) {
+        elem[channel] = float((x * 7 + y * 13 + channel * 5) % 17) / 16.0f;
+      }
+    }
+  }
+}
+
+static void test_box_matches_table(const eDimension dimension,
+                                   const float radius,
+                                   const rcti &canvas,
+                                   const rcti &area)
+{
+  MemoryBuffer input(DataType::Color, canvas);
+  fill_image(input);
+
+  TestBoxBlurOperation operation(dimension, radius);
+  MemoryBuffer running_result(DataType::Color, canvas);
+  running_result.clear();
+  operation.update_memory_buffer_partial(&running_result, area, {&input});
+
+  operation.use_table_weights();
+  MemoryBuffer table_result(DataType::Color, canvas);
+  table_result.clear();
+  operation.update_memory_buffer_partial(&table_result, area, {&input});
+
+  /* Pixels outside of the area are not written by either. */
+  for (int y = canvas.ymin; y < canvas.ymax; y++) {
+    for (int x = canvas.xmin; x < canvas.xmax; x++) {
+      const float *expected = table_result.get_elem(x, y);
+      const float *result = running_result.get_elem(x, y);
+      for (int channel = 0; channel < 4; channel++) {
+        EXPECT_NEAR(result[channel], expected[channel], 1e-5f);
+      }
+    }
+  }
+}
+
+static void test_box_matches_table(const float radius, const rcti &canvas, const rcti &area)
+{
+  test_box_matches_table(eDimension::X, radius, canvas, area);
+  test_box_matches_table(eDimension::Y, radius, canvas, area);
+}
+
+TEST(GaussianBlurBaseOperation, BoxIntegerRadius)
+{
+  rcti canvas;
+  BLI_rcti_init(&canvas, 0, 53, 0, 41);
+  for (const float radius : {1.0f, 4.0f, 20.0f, 60.0f}) {
+    test_box_matches_table(radius, canvas, canvas);
+  }
+}
+
+TEST(GaussianBlurBaseOperation, BoxNonIntegerRadius)
+{
+  /* The last entry of the filter table has no weight, except when rounding to the radius. */
+  rcti canvas;
+  BLI_rcti_init(&canvas, 0, 53, 0, 41);
+  for (const float radius : {0.0f, 0.5f, 1.5f, 2.3f, 7.9f}) {
+    test_box_matches_table(radius, canvas, canvas);
+  }
+}
+
+TEST(GaussianBlurBaseOperation, BoxSmallSizes)
+{
+  for (const int size : {1, 2, 3}) {
+    rcti canvas;
+    BLI_rcti_init(&canvas, 0, size, 0, size);
+    test_box_matches_table(2.5f, canvas, canvas);
+    BLI_rcti_init(&canvas, 0, size, 0, 17);
+    test_box_matches_table(3.0f, canvas, canvas);
+    BLI_rcti_init(&canvas, 0, 17, 0, size);
+    test_box_matches_table(3.0f, canvas, canvas);
+  }
+}
+
+TEST(GaussianBlurBaseOperation, BoxAreaSmallerThanCanvas)
+{
+  rcti canvas;
+  BLI_rcti_init(&canvas, -10, 45, 5, 50);
+  rcti area;
+  BLI_rcti_init(&area, -3, 31, 12, 40);
+  test_box_matches_table(5.5f, canvas, area);
+  BLI_rcti_init(&area, 7, 8, 20, 21);
+  test_box_matches_table(3.0f, canvas, area);
+}
+
+}  // namespace blender::compositor::tests
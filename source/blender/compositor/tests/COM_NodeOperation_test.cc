@@ -152,4 +152,40 @@ TEST(NodeOperation, generate_hash)
   }
 }
 
+TEST(NodeOperation, generate_result_hash)
+{
+  Map<NodeOperation *, NodeOperationHash> result_hashes;
+
+  /* Inputs without result hash. */
+  {
+    NonHashedOperation input_op(1);
+    HashedOperation op(input_op, 6, 4);
+    EXPECT_EQ(op.generate_result_hash(result_hashes), std::nullopt);
+  }
+
+  /* Inputs are identified by their result hashes instead of their ids. */
+  {
+    NonHashedConstantOperation constant_op1(1);
+    HashedOperation input_op1(constant_op1, 6, 4);
+    input_op1.set_id(2);
+    HashedOperation op1(input_op1, 6, 4);
+    result_hashes.add_new(&input_op1, *input_op1.generate_result_hash(result_hashes));
+    NodeOperationHash hash1 = *op1.generate_result_hash(result_hashes);
+
+    NonHashedConstantOperation constant_op2(3);
+    HashedOperation input_op2(constant_op2, 6, 4);
+    input_op2.set_id(4);
+    HashedOperation op2(input_op2, 6, 4);
+    result_hashes.add_new(&input_op2, *input_op2.generate_result_hash(result_hashes));
+    NodeOperationHash hash2 = *op2.generate_result_hash(result_hashes);
+    EXPECT_EQ(hash1, hash2);
+
+    /* Upstream changes change the hash. */
+    input_op2.set_param1(-1);
+    result_hashes.add_overwrite(&input_op2, *input_op2.generate_result_hash(result_hashes));
+    hash2 = *op2.generate_result_hash(result_hashes);
+    EXPECT_NE(hash1, hash2);
+  }
+}
+
 }  // namespace blender::compositor::tests
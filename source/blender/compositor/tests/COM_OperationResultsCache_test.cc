@@ -0,0 +1,237 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BKE_idtype.h"
+#include "BKE_image.h"
+#include "BKE_lib_id.h"
+#include "BKE_main.h"
+
+#include "DNA_image_types.h"
+#include "DNA_scene_types.h"
+
+#include "COM_BokehImageOperation.h"
+#include "COM_ConstantOperation.h"
+#include "COM_ImageOperation.h"
+#include "COM_OperationResultsCache.h"
+#include "COM_SetValueOperation.h"
+#include "COM_SharedOperationBuffers.h"
+#include "COM_VariableSizeBokehBlurOperation.h"
+
+namespace blender::compositor::tests {
+
+class CachedOperation : public NodeOperation {
+ private:
+  int param_;
+
+ public:
+  CachedOperation(NodeOperation &input, int param)
+  {
+    add_input_socket(DataType::Value);
+    add_output_socket(DataType::Value);
+    set_width(4);
+    set_height(4);
+    param_ = param;
+
+    get_input_socket(0)->set_link(input.get_output_socket());
+  }
+
+  void hash_output_params() override
+  {
+    hash_param(param_);
+  }
+};
+
+class CacheInputOperation : public ConstantOperation {
+  float constant_ = 0.0f;
+
+ public:
+  CacheInputOperation()
+  {
+    add_output_socket(DataType::Value);
+    set_width(4);
+    set_height(4);
+  }
+
+  const float *get_constant_elem() override
+  {
+    return &constant_;
+  }
+};
+
+static std::unique_ptr<MemoryBuffer> create_buffer()
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, 4, 0, 4);
+  return std::make_unique<MemoryBuffer>(DataType::Value, rect);
+}
+
+/* Size of the buffers returned by #create_buffer. */
+constexpr int64_t BUFFER_SIZE = 4 * 4 * sizeof(float);
+
+TEST(OperationResultsCache, take_result)
+{
+  CacheInputOperation input_op;
+  CachedOperation op1(input_op, 1);
+  CachedOperation op2(input_op, 2);
+  const NodeOperationHash hash1 = *op1.generate_hash();
+  const NodeOperationHash hash2 = *op2.generate_hash();
+
+  OperationResultsCache cache(BUFFER_SIZE * 2);
+  EXPECT_EQ(cache.take_result(hash1), nullptr);
+
+  std::unique_ptr<MemoryBuffer> buffer = create_buffer();
+  MemoryBuffer *buffer_ptr = buffer.get();
+  cache.add_result(hash1, std::move(buffer));
+  EXPECT_EQ(cache.take_result(hash2), nullptr);
+  EXPECT_EQ(cache.take_result(hash1).get(), buffer_ptr);
+
+  /* Taken results are removed from the cache. */
+  EXPECT_EQ(cache.take_result(hash1), nullptr);
+}
+
+TEST(OperationResultsCache, memory_budget)
+{
+  CacheInputOperation input_op;
+  CachedOperation op1(input_op, 1);
+  CachedOperation op2(input_op, 2);
+  CachedOperation op3(input_op, 3);
+  const NodeOperationHash hash1 = *op1.generate_hash();
+  const NodeOperationHash hash2 = *op2.generate_hash();
+  const NodeOperationHash hash3 = *op3.generate_hash();
+
+  /* Least recently added results are freed first. */
+  OperationResultsCache cache(BUFFER_SIZE * 2);
+  cache.add_result(hash1, create_buffer());
+  cache.add_result(hash2, create_buffer());
+  cache.add_result(hash3, create_buffer());
+  EXPECT_EQ(cache.take_result(hash1), nullptr);
+  EXPECT_NE(cache.take_result(hash2), nullptr);
+  EXPECT_NE(cache.take_result(hash3), nullptr);
+
+  /* Results larger than the budget are not kept. */
+  OperationResultsCache small_cache(BUFFER_SIZE - 1);
+  small_cache.add_result(hash1, create_buffer());
+  EXPECT_EQ(small_cache.take_result(hash1), nullptr);
+
+  cache.add_result(hash1, create_buffer());
+  cache.clear();
+  EXPECT_EQ(cache.take_result(hash1), nullptr);
+}
+
+/** Operations of a defocus node on an image, created again on every compositor execution. */
+struct DefocusOperations {
+  ImageOperation image;
+  SetValueOperation size;
+  BokehImageOperation bokeh;
+  VariableSizeBokehBlurOperation defocus;
+
+  DefocusOperations(Image *ima,
+                    ImageUser *iuser,
+                    const RenderData *rd,
+                    const NodeBokehImage *bokeh_data,
+                    float threshold)
+  {
+    image.set_image(ima);
+    image.set_image_user(iuser);
+    image.set_render_data(rd);
+    size.set_value(2.0f);
+    bokeh.set_data(bokeh_data);
+    defocus.set_max_blur(16);
+    defocus.set_threshold(threshold);
+
+    defocus.get_input_socket(0)->set_link(image.get_output_socket());
+    defocus.get_input_socket(1)->set_link(bokeh.get_output_socket());
+    defocus.get_input_socket(2)->set_link(size.get_output_socket());
+
+    rcti canvas;
+    BLI_rcti_init(&canvas, 0, 4, 0, 4);
+    defocus.set_canvas(canvas);
+  }
+};
+
+/**
+ * Execute the defocus operation the way the full frame execution model does: take its result from
+ * the cache if possible, otherwise render it by setting its first element to \a render_value.
+ * The result is disposed afterwards. Returns the first element of the result.
+ */
+static float execute_defocus(DefocusOperations &ops,
+                             OperationResultsCache &cache,
+                             const float render_value)
+{
+  Map<NodeOperation *, NodeOperationHash> result_hashes;
+  for (NodeOperation *op : {(NodeOperation *)&ops.image,
+                            (NodeOperation *)&ops.size,
+                            (NodeOperation *)&ops.bokeh,
+                            (NodeOperation *)&ops.defocus})
+  {
+    std::optional<NodeOperationHash> hash = op->generate_result_hash(result_hashes);
+    if (hash) {
+      result_hashes.add_new(op, *hash);
+    }
+  }
+  EXPECT_TRUE(result_hashes.contains(&ops.defocus));
+
+  SharedOperationBuffers buffers;
+  buffers.set_results_cache(&cache);
+  buffers.set_result_hash(&ops.defocus, result_hashes.lookup(&ops.defocus));
+  buffers.register_read(&ops.defocus);
+  if (!buffers.use_cached_result(&ops.defocus)) {
+    buffers.register_area(&ops.defocus, ops.defocus.get_canvas());
+    auto buffer = std::make_unique<MemoryBuffer>(DataType::Color, ops.defocus.get_canvas());
+    buffer->get_elem(0, 0)[0] = render_value;
+    buffers.set_rendered_buffer(&ops.defocus, std::move(buffer));
+  }
+  const float result = buffers.get_rendered_buffer(&ops.defocus)->get_elem(0, 0)[0];
+  buffers.read_finished(&ops.defocus);
+  return result;
+}
+
+TEST(OperationResultsCache, reuse_defocus_result)
+{
+  BKE_idtype_init();
+  Main *bmain = BKE_main_new();
+  Image *ima = static_cast<Image *>(BKE_id_new(bmain, ID_IM, "Image"));
+  ImageUser iuser;
+  BKE_imageuser_default(&iuser);
+  RenderData rd = {};
+  NodeBokehImage bokeh_data = {};
+  bokeh_data.flaps = 5;
+
+  OperationResultsCache cache(COM_RESULTS_CACHE_MEMORY_BUDGET);
+  {
+    DefocusOperations ops(ima, &iuser, &rd, &bokeh_data, 1.0f);
+    EXPECT_EQ(execute_defocus(ops, cache, 1.0f), 1.0f);
+  }
+
+  /* Same parameters and image content on the next execution, the result is reused. */
+  {
+    DefocusOperations ops(ima, &iuser, &rd, &bokeh_data, 1.0f);
+    EXPECT_EQ(execute_defocus(ops, cache, 2.0f), 1.0f);
+  }
+
+  /* Changed defocus and bokeh parameters. */
+  {
+    DefocusOperations ops(ima, &iuser, &rd, &bokeh_data, 0.5f);
+    EXPECT_EQ(execute_defocus(ops, cache, 3.0f), 3.0f);
+  }
+  bokeh_data.flaps = 6;
+  {
+    DefocusOperations ops(ima, &iuser, &rd, &bokeh_data, 0.5f);
+    EXPECT_EQ(execute_defocus(ops, cache, 4.0f), 4.0f);
+    EXPECT_EQ(execute_defocus(ops, cache, 5.0f), 4.0f);
+  }
+
+  /* Changed image content, such as after painting. */
+  BKE_image_partial_update_mark_full_update(ima);
+  {
+    DefocusOperations ops(ima, &iuser, &rd, &bokeh_data, 0.5f);
+    EXPECT_EQ(execute_defocus(ops, cache, 6.0f), 6.0f);
+  }
+
+  BKE_main_free(bmain);
+}
+
+}  // namespace blender::compositor::tests
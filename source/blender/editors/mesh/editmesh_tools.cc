@@ -517,6 +517,11 @@ static int edbm_delete_exec(bContext *C, wmOperator *op)
 
     BM_custom_loop_normals_from_vector_layer(em->bm, false);
 
+    /* Deleting leaves the remaining custom-data blocks scattered over the pools,
+     * pack them so later per-layer operations and conversion to a mesh read them in order.
+     * Pools that are still mostly used are skipped. */
+    BM_mesh_customdata_compact(em->bm, BM_ALL_NOLOOP | BM_LOOP);
+
     EDBMUpdate_Params params{};
     params.calc_looptri = true;
     params.calc_normals = false;
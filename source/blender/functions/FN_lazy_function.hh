@@ -283,6 +283,12 @@ class LazyFunction {
    * Allow executing the function even if previously requested values are not yet available.
    */
   bool allow_missing_requested_inputs_ = false;
+  /**
+   * The function does very little work (e.g. it only forwards or combines a few small values).
+   * Executors may use this to avoid scheduling overhead, e.g. by never passing the function to
+   * another thread.
+   */
+  bool is_cheap_ = false;
 
  public:
   virtual ~LazyFunction() = default;
@@ -346,6 +352,14 @@ class LazyFunction {
     return allow_missing_requested_inputs_;
   }
 
+  /**
+   * See #is_cheap_.
+   */
+  bool is_cheap() const
+  {
+    return is_cheap_;
+  }
+
  private:
   /**
    * Needs to be implemented by subclasses. This is separate from #execute so that additional
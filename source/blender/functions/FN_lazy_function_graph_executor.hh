@@ -11,6 +11,7 @@
  * another #Graph again).
  */
 
+#include "BLI_timeit.hh"
 #include "BLI_vector.hh"
 #include "BLI_vector_set.hh"
 
@@ -18,6 +19,42 @@
 
 namespace blender::fn::lazy_function {
 
+/**
+ * Controls how the #GraphExecutor distributes nodes over threads once it uses multi-threading.
+ */
+enum class GraphExecutorSchedulingMode {
+  /**
+   * All nodes that are scheduled on a thread are passed to the task pool together, when a running
+   * node indicates that it will take a while.
+   */
+  Default,
+  /**
+   * Every thread uses its stack of scheduled nodes like a deque. The thread itself always
+   * continues with the most recently scheduled node (usually a consumer of an output it just
+   * computed), while the oldest nodes are handed to other threads as soon as more than one node is
+   * waiting. Cheap nodes (see #LazyFunction::is_cheap) are never handed to other threads, because
+   * that costs more than running them directly.
+   */
+  WorkStealing,
+};
+
+/**
+ * Counters that describe how often a node went through the scheduler. They are only gathered when
+ * enabled with #GraphExecutor::set_collect_scheduling_stats, because that adds overhead itself.
+ */
+struct GraphExecutorNodeSchedulingStats {
+  /** Number of times the node was added to the scheduled nodes of a thread. */
+  int schedule_count = 0;
+  /** Number of times the node has been run by the executor. */
+  int run_count = 0;
+  /** Number of runs in which the lazy-function was actually executed. */
+  int execute_count = 0;
+  /** Number of times the node was handed to another thread through the task pool. */
+  int shared_count = 0;
+  /** Time spent in the executor for this node, excluding the time spent in the function. */
+  timeit::Nanoseconds overhead{0};
+};
+
 /**
  * Can be implemented to log values produced during graph evaluation.
  */
@@ -37,6 +74,13 @@ class GraphExecutorLogger {
                                       const Params &params,
                                       const Context &context) const;
 
+  /**
+   * Called once a node has finished when #GraphExecutor::set_collect_scheduling_stats is enabled.
+   */
+  virtual void log_node_scheduling_stats(const FunctionNode &node,
+                                         const GraphExecutorNodeSchedulingStats &stats,
+                                         const Context &context) const;
+
   virtual void dump_when_outputs_are_missing(const FunctionNode &node,
                                              Span<const OutputSocket *> missing_sockets,
                                              const Context &context) const;
@@ -60,6 +104,7 @@ class GraphExecutor : public LazyFunction {
  public:
   using Logger = GraphExecutorLogger;
   using SideEffectProvider = GraphExecutorSideEffectProvider;
+  using SchedulingMode = GraphExecutorSchedulingMode;
 
  private:
   /**
@@ -80,6 +125,14 @@ class GraphExecutor : public LazyFunction {
    * during evaluation.
    */
   const SideEffectProvider *side_effect_provider_;
+  /**
+   * How nodes are distributed over threads.
+   */
+  SchedulingMode scheduling_mode_ = SchedulingMode::Default;
+  /**
+   * Gather #GraphExecutorNodeSchedulingStats and pass them to the logger.
+   */
+  bool collect_scheduling_stats_ = false;
 
   friend class Executor;
 
@@ -96,6 +149,15 @@ class GraphExecutor : public LazyFunction {
   std::string input_name(int index) const override;
   std::string output_name(int index) const override;
 
+  /**
+   * Should be called before the graph is executed for the first time.
+   */
+  void set_scheduling_mode(SchedulingMode mode);
+  /**
+   * Enabling this only has an effect when there is a logger.
+   */
+  void set_collect_scheduling_stats(bool collect);
+
  private:
   void execute_impl(Params &params, const Context &context) const override;
 };
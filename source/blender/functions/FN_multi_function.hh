@@ -143,6 +143,15 @@ inline ParamsBuilder::ParamsBuilder(const MultiFunction &fn, const IndexMask *ma
 {
 }
 
+/**
+ * Add the elements in #slice_range of all parameters in #full_params to #r_sliced_params. Only
+ * single-value parameters are supported.
+ */
+void add_sliced_parameters(const Signature &signature,
+                           Params &full_params,
+                           IndexRange slice_range,
+                           ParamsBuilder &r_sliced_params);
+
 }  // namespace blender::fn::multi_function
 
 namespace blender {
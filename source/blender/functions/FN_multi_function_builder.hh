@@ -36,6 +36,8 @@ enum class FallbackMode {
 struct Simple {
   static constexpr bool use_devirtualization = false;
   static constexpr FallbackMode fallback_mode = FallbackMode::Simple;
+  /** Number of consecutive elements that are processed together in contiguous ranges. */
+  static constexpr int lane_width = 1;
 };
 
 /**
@@ -47,6 +49,7 @@ struct Simple {
 struct Materialized {
   static constexpr bool use_devirtualization = false;
   static constexpr FallbackMode fallback_mode = FallbackMode::Materialized;
+  static constexpr int lane_width = 1;
 };
 
 /**
@@ -58,6 +61,7 @@ struct Materialized {
 struct AllSpanOrSingle {
   static constexpr bool use_devirtualization = true;
   static constexpr FallbackMode fallback_mode = FallbackMode::Materialized;
+  static constexpr int lane_width = 1;
 
   template<typename... ParamTags, typename... LoadedParams, size_t... I>
   auto create_devirtualizers(TypeSequence<ParamTags...> /*param_tags*/,
@@ -90,6 +94,7 @@ struct AllSpanOrSingle {
 template<size_t... Indices> struct SomeSpanOrSingle {
   static constexpr bool use_devirtualization = true;
   static constexpr FallbackMode fallback_mode = FallbackMode::Materialized;
+  static constexpr int lane_width = 1;
 
   template<typename... ParamTags, typename... LoadedParams, size_t... I>
   auto create_devirtualizers(TypeSequence<ParamTags...> /*param_tags*/,
@@ -116,6 +121,19 @@ template<size_t... Indices> struct SomeSpanOrSingle {
   }
 };
 
+/**
+ * Same as #AllSpanOrSingle, but contiguous ranges are processed in blocks of #lane_width
+ * elements. The element function is called for all elements of a block in fully unrolled code,
+ * which allows the compiler to combine the independent operations into SIMD instructions. Unlike
+ * vectorizing the loop itself, this also works well for types like `float3` whose components are
+ * interleaved in memory. This should be used for cheap math functions on `float` and `float3`
+ * that are often evaluated on large domains.
+ */
+struct AllSpanOrSingleSimd : public AllSpanOrSingle {
+  /** Enough lanes to fill a 256 bit register with `float` values. */
+  static constexpr int lane_width = 8;
+};
+
 }  // namespace exec_presets
 
 namespace detail {
@@ -155,6 +173,41 @@ execute_array(TypeSequence<ParamTags...> /*param_tags*/,
   }
 }
 
+/**
+ * Calls #element_fn for the elements starting at #start, one for every lane. The calls are
+ * unrolled, so that the compiler can vectorize the independent operations on consecutive elements.
+ */
+template<typename ElementFn, typename... Args, int... Lanes>
+inline void execute_lanes(const ElementFn &element_fn,
+                          const int64_t start,
+                          std::integer_sequence<int, Lanes...> /*lanes*/,
+                          Args &&__restrict... args)
+{
+  ([&](const int64_t i) { element_fn(args[i]...); }(start + Lanes), ...);
+}
+
+/**
+ * Similar to #execute_array, but only used with ranges. Elements are processed in blocks of
+ * #LaneWidth elements, see #exec_presets::AllSpanOrSingleSimd.
+ */
+template<int LaneWidth, typename... Args, typename ElementFn>
+#if (defined(__GNUC__) && !defined(__clang__))
+[[gnu::optimize("O3")]]
+#endif
+inline void
+execute_array_in_lanes(ElementFn element_fn, const IndexRange range, Args &&__restrict... args)
+{
+  int64_t i = range.start();
+  const int64_t end = range.one_after_last();
+  for (; i + LaneWidth <= end; i += LaneWidth) {
+    execute_lanes(element_fn, i, std::make_integer_sequence<int, LaneWidth>(), args...);
+  }
+  /* Process the remaining elements that don't fill a block. */
+  for (; i < end; i++) {
+    element_fn(args[i]...);
+  }
+}
+
 enum class MaterializeArgMode {
   Unknown,
   Single,
@@ -421,11 +474,17 @@ inline void execute_element_fn_as_multi_function(const ElementFn element_fn,
           for (const std::variant<IndexRange, IndexMaskSegment> &segment : mask_segments) {
             if (std::holds_alternative<IndexRange>(segment)) {
               const auto segment_range = std::get<IndexRange>(segment);
-              execute_array(TypeSequence<ParamTags...>(),
-                            std::index_sequence<I...>(),
-                            element_fn,
-                            segment_range,
-                            std::forward<decltype(args)>(args)...);
+              if constexpr (ExecPreset::lane_width > 1) {
+                execute_array_in_lanes<ExecPreset::lane_width>(
+                    element_fn, segment_range, std::forward<decltype(args)>(args)...);
+              }
+              else {
+                execute_array(TypeSequence<ParamTags...>(),
+                              std::index_sequence<I...>(),
+                              element_fn,
+                              segment_range,
+                              std::forward<decltype(args)>(args)...);
+              }
             }
             else {
               const auto segment_indices = std::get<IndexMaskSegment>(segment);
@@ -39,6 +39,12 @@
  * When all tasks are completed, the executor gives back control to the caller which may later
  * provide new inputs to the graph which in turn leads to new nodes being scheduled and the process
  * starts again.
+ *
+ * With #GraphExecutorSchedulingMode::WorkStealing, the nodes scheduled on a thread are treated
+ * like a work-stealing deque. The thread keeps working on the most recently scheduled nodes, which
+ * are often consumers of the values it just computed, while the oldest scheduled nodes are passed
+ * to the task pool where idle threads can pick them up. Cheap nodes always stay on the thread that
+ * scheduled them.
  */
 
 #include <mutex>
@@ -181,6 +187,12 @@ struct NodeState {
    * Custom storage of the node.
    */
   void *storage = nullptr;
+  /**
+   * Only updated when the executor collects scheduling statistics. Requires the node lock, except
+   * for #GraphExecutorNodeSchedulingStats::shared_count which is only changed while the node is
+   * scheduled on no thread.
+   */
+  GraphExecutorNodeSchedulingStats scheduling_stats;
 };
 
 /**
@@ -220,13 +232,21 @@ struct ScheduledNodes {
   /** Use two stacks of scheduled nodes for different priorities. */
   Vector<const FunctionNode *> priority_;
   Vector<const FunctionNode *> normal_;
+  /**
+   * Nodes that should not be passed to another thread when only some of the scheduled nodes are
+   * shared with other threads (see #split_off_oldest).
+   */
+  Vector<const FunctionNode *> pinned_;
 
  public:
-  void schedule(const FunctionNode &node, const bool is_priority)
+  void schedule(const FunctionNode &node, const bool is_priority, const bool is_pinned = false)
   {
     if (is_priority) {
       this->priority_.append(&node);
     }
+    else if (is_pinned) {
+      this->pinned_.append(&node);
+    }
     else {
       this->normal_.append(&node);
     }
@@ -237,6 +257,9 @@ struct ScheduledNodes {
     if (!this->priority_.is_empty()) {
       return this->priority_.pop_last();
     }
+    if (!this->pinned_.is_empty()) {
+      return this->pinned_.pop_last();
+    }
     if (!this->normal_.is_empty()) {
       return this->normal_.pop_last();
     }
@@ -245,7 +268,38 @@ struct ScheduledNodes {
 
   bool is_empty() const
   {
-    return this->priority_.is_empty() && this->normal_.is_empty();
+    return this->priority_.is_empty() && this->normal_.is_empty() && this->pinned_.is_empty();
+  }
+
+  /**
+   * Number of scheduled nodes that may be passed to another thread with #split_off_oldest.
+   */
+  int64_t shareable_nodes_num() const
+  {
+    return this->normal_.size();
+  }
+
+  /**
+   * Move the \a nodes_num nodes that have been scheduled first to \a r_dst. The most recently
+   * scheduled nodes stay, because they likely use values that were just computed on this thread.
+   */
+  void split_off_oldest(const int64_t nodes_num, ScheduledNodes &r_dst)
+  {
+    BLI_assert(nodes_num <= this->normal_.size());
+    r_dst.normal_.extend(this->normal_.as_span().take_front(nodes_num));
+    this->normal_.remove(0, nodes_num);
+  }
+
+  template<typename Fn> void foreach_node(Fn &&fn) const
+  {
+    for (const Span<const FunctionNode *> nodes : {this->priority_.as_span(),
+                                                   this->pinned_.as_span(),
+                                                   this->normal_.as_span()})
+    {
+      for (const FunctionNode *node : nodes) {
+        fn(*node);
+      }
+    }
   }
 };
 
@@ -715,13 +769,19 @@ class Executor {
     switch (locked_node.node_state.schedule_state) {
       case NodeScheduleState::NotScheduled: {
         locked_node.node_state.schedule_state = NodeScheduleState::Scheduled;
+        if (self_.collect_scheduling_stats_) {
+          locked_node.node_state.scheduling_stats.schedule_count++;
+        }
         const FunctionNode &node = static_cast<const FunctionNode &>(locked_node.node);
+        const bool is_pinned = self_.scheduling_mode_ ==
+                                   GraphExecutorSchedulingMode::WorkStealing &&
+                               node.function().is_cheap();
         if (this->use_multi_threading()) {
           std::lock_guard lock{current_task.mutex};
-          current_task.scheduled_nodes.schedule(node, is_priority);
+          current_task.scheduled_nodes.schedule(node, is_priority, is_pinned);
         }
         else {
-          current_task.scheduled_nodes.schedule(node, is_priority);
+          current_task.scheduled_nodes.schedule(node, is_priority, is_pinned);
         }
         current_task.has_scheduled_nodes.store(true, std::memory_order_relaxed);
         break;
@@ -782,10 +842,21 @@ class Executor {
 
   void run_task(CurrentTask &current_task, const LocalData &local_data)
   {
+    const bool use_work_stealing = self_.scheduling_mode_ ==
+                                   GraphExecutorSchedulingMode::WorkStealing;
     while (const FunctionNode *node = current_task.scheduled_nodes.pop_next_node()) {
       if (current_task.scheduled_nodes.is_empty()) {
         current_task.has_scheduled_nodes.store(false, std::memory_order_relaxed);
       }
+      else if (use_work_stealing && this->use_multi_threading()) {
+        /* Keep the most recently scheduled half of the nodes on this thread and allow other
+         * threads to take the rest. No node is running on this task right now, so the scheduled
+         * nodes can't change concurrently. */
+        const int64_t shareable_nodes_num = current_task.scheduled_nodes.shareable_nodes_num();
+        if (shareable_nodes_num >= 2) {
+          this->move_scheduled_nodes_to_task_pool(current_task, shareable_nodes_num / 2);
+        }
+      }
       this->run_node_task(*node, current_task, local_data);
     }
   }
@@ -795,6 +866,10 @@ class Executor {
                      const LocalData &local_data)
   {
     NodeState &node_state = *node_states_[node.index_in_graph()];
+    const bool collect_stats = self_.collect_scheduling_stats_ && self_.logger_ != nullptr;
+    const timeit::TimePoint start_time = collect_stats ? timeit::Clock::now() :
+                                                         timeit::TimePoint();
+    timeit::Nanoseconds execute_duration{0};
     LinearAllocator<> &allocator = *local_data.allocator;
     Context local_context{context_->storage, context_->user_data, local_data.local_user_data};
     const LazyFunction &fn = node.function();
@@ -885,9 +960,15 @@ class Executor {
       /* Importantly, the node must not be locked when it is executed. That would result in locks
        * being hold very long in some cases and results in multiple locks being hold by the same
        * thread in the same graph which can lead to deadlocks. */
+      const timeit::TimePoint execute_start_time = collect_stats ? timeit::Clock::now() :
+                                                                   timeit::TimePoint();
       this->execute_node(node, node_state, current_task, local_data);
+      if (collect_stats) {
+        execute_duration = timeit::Clock::now() - execute_start_time;
+      }
     }
 
+    bool node_finished_in_this_run = false;
     this->with_locked_node(
         node, node_state, current_task, local_data, [&](LockedNode &locked_node) {
 #ifdef DEBUG
@@ -895,14 +976,31 @@ class Executor {
             this->assert_expected_outputs_have_been_computed(locked_node, local_data);
           }
 #endif
+          const bool node_had_finished = node_state.node_has_finished;
           this->finish_node_if_possible(locked_node);
+          node_finished_in_this_run = !node_had_finished && node_state.node_has_finished;
           const bool reschedule_requested = node_state.schedule_state ==
                                             NodeScheduleState::RunningAndRescheduled;
           node_state.schedule_state = NodeScheduleState::NotScheduled;
           if (reschedule_requested && !node_state.node_has_finished) {
             this->schedule_node(locked_node, current_task, false);
           }
+          if (collect_stats) {
+            GraphExecutorNodeSchedulingStats &stats = node_state.scheduling_stats;
+            stats.run_count++;
+            if (node_needs_execution) {
+              stats.execute_count++;
+            }
+            stats.overhead += timeit::Clock::now() - start_time - execute_duration;
+          }
         });
+
+    if (collect_stats && node_finished_in_this_run) {
+      /* The stats are not changed anymore once the node has finished. */
+      const Context local_context{
+          context_->storage, context_->user_data, local_data.local_user_data};
+      self_.logger_->log_node_scheduling_stats(node, node_state.scheduling_stats, local_context);
+    }
   }
 
   void assert_expected_outputs_have_been_computed(LockedNode &locked_node,
@@ -1221,15 +1319,58 @@ class Executor {
   void move_scheduled_nodes_to_task_pool(CurrentTask &current_task)
   {
     BLI_assert(this->use_multi_threading());
+    if (self_.scheduling_mode_ == GraphExecutorSchedulingMode::WorkStealing) {
+      /* Pinned nodes stay on this thread. They are cheap and can be run once the current node is
+       * done. */
+      int64_t shareable_nodes_num;
+      {
+        std::lock_guard lock{current_task.mutex};
+        shareable_nodes_num = current_task.scheduled_nodes.shareable_nodes_num();
+      }
+      if (shareable_nodes_num > 0) {
+        this->move_scheduled_nodes_to_task_pool(current_task, shareable_nodes_num);
+      }
+      return;
+    }
     ScheduledNodes *scheduled_nodes = MEM_new<ScheduledNodes>(__func__);
     {
       std::lock_guard lock{current_task.mutex};
       if (current_task.scheduled_nodes.is_empty()) {
+        MEM_delete(scheduled_nodes);
         return;
       }
       *scheduled_nodes = std::move(current_task.scheduled_nodes);
       current_task.has_scheduled_nodes.store(false, std::memory_order_relaxed);
     }
+    this->push_scheduled_nodes_to_task_pool(scheduled_nodes);
+  }
+
+  /**
+   * Allow other threads to steal the \a nodes_num oldest shareable nodes that are scheduled on
+   * this thread.
+   */
+  void move_scheduled_nodes_to_task_pool(CurrentTask &current_task, const int64_t nodes_num)
+  {
+    BLI_assert(this->use_multi_threading());
+    ScheduledNodes *scheduled_nodes = MEM_new<ScheduledNodes>(__func__);
+    {
+      std::lock_guard lock{current_task.mutex};
+      current_task.scheduled_nodes.split_off_oldest(nodes_num, *scheduled_nodes);
+      if (current_task.scheduled_nodes.is_empty()) {
+        current_task.has_scheduled_nodes.store(false, std::memory_order_relaxed);
+      }
+    }
+    this->push_scheduled_nodes_to_task_pool(scheduled_nodes);
+  }
+
+  void push_scheduled_nodes_to_task_pool(ScheduledNodes *scheduled_nodes)
+  {
+    if (self_.collect_scheduling_stats_) {
+      /* The nodes are scheduled but not running, so no other thread changes their stats. */
+      scheduled_nodes->foreach_node([&](const FunctionNode &node) {
+        node_states_[node.index_in_graph()]->scheduling_stats.shared_count++;
+      });
+    }
     /* All nodes are pushed as a single task in the pool. This avoids unnecessary threading
      * overhead when the nodes are fast to compute. */
     BLI_task_pool_push(
@@ -1467,6 +1608,16 @@ std::string GraphExecutor::output_name(const int index) const
   return ss.str();
 }
 
+void GraphExecutor::set_scheduling_mode(const SchedulingMode mode)
+{
+  scheduling_mode_ = mode;
+}
+
+void GraphExecutor::set_collect_scheduling_stats(const bool collect)
+{
+  collect_scheduling_stats_ = collect;
+}
+
 void GraphExecutorLogger::log_socket_value(const Socket &socket,
                                            const GPointer value,
                                            const Context &context) const
@@ -1495,6 +1646,14 @@ Vector<const FunctionNode *> GraphExecutorSideEffectProvider::get_nodes_with_sid
   return {};
 }
 
+void GraphExecutorLogger::log_node_scheduling_stats(
+    const FunctionNode &node,
+    const GraphExecutorNodeSchedulingStats &stats,
+    const Context &context) const
+{
+  UNUSED_VARS(node, stats, context);
+}
+
 void GraphExecutorLogger::dump_when_outputs_are_missing(const FunctionNode &node,
                                                         Span<const OutputSocket *> missing_sockets,
                                                         const Context &context) const
@@ -4,6 +4,7 @@
 
 #include "FN_multi_function_procedure_executor.hh"
 
+#include "BLI_math_base.h"
 #include "BLI_stack.hh"
 
 namespace blender::fn::multi_function {
@@ -148,9 +149,20 @@ class ValueAllocator : NonCopyable, NonMovable {
   Stack<void *> small_single_value_free_list_;
   Map<const CPPType *, Stack<void *>> single_value_free_lists_;
 
+  /**
+   * Span buffers are allocated with at least this many elements. This allows reusing buffers when
+   * the procedure is executed for multiple masks with different sizes.
+   */
+  int min_span_size_ = 0;
+
  public:
   ValueAllocator(LinearAllocator<> &linear_allocator) : linear_allocator_(linear_allocator) {}
 
+  void set_min_span_size(const int size)
+  {
+    min_span_size_ = size;
+  }
+
   VariableValue_GVArray *obtain_GVArray(const GVArray &varray)
   {
     return this->obtain<VariableValue_GVArray>(varray);
@@ -169,6 +181,7 @@ class ValueAllocator : NonCopyable, NonMovable {
   VariableValue_Span *obtain_Span(const CPPType &type, int size)
   {
     void *buffer = nullptr;
+    size = std::max(size, min_span_size_);
 
     const int64_t element_size = type.size();
     const int64_t alignment = type.alignment();
@@ -813,17 +826,17 @@ class VariableState : NonCopyable, NonMovable {
 /** Keeps track of the states of all variables during evaluation. */
 class VariableStates {
  private:
-  ValueAllocator value_allocator_;
+  ValueAllocator &value_allocator_;
   const Procedure &procedure_;
   /** The state of every variable, indexed by #Variable::index_in_procedure(). */
   Array<VariableState> variable_states_;
   const IndexMask &full_mask_;
 
  public:
-  VariableStates(LinearAllocator<> &linear_allocator,
+  VariableStates(ValueAllocator &value_allocator,
                  const Procedure &procedure,
                  const IndexMask &full_mask)
-      : value_allocator_(linear_allocator),
+      : value_allocator_(value_allocator),
         procedure_(procedure),
         variable_states_(procedure.variables().size()),
         full_mask_(full_mask)
@@ -1157,19 +1170,18 @@ class InstructionScheduler {
   }
 };
 
-void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context context) const
+static void execute_procedure(const ProcedureExecutor &fn,
+                              const Procedure &procedure,
+                              const IndexMask &full_mask,
+                              Params &params,
+                              const Context &context,
+                              ValueAllocator &value_allocator)
 {
-  BLI_assert(procedure_.validate());
-
-  AlignedBuffer<512, 64> local_buffer;
-  LinearAllocator<> linear_allocator;
-  linear_allocator.provide_buffer(local_buffer);
-
-  VariableStates variable_states{linear_allocator, procedure_, full_mask};
-  variable_states.add_initial_variable_states(*this, procedure_, params);
+  VariableStates variable_states{value_allocator, procedure, full_mask};
+  variable_states.add_initial_variable_states(fn, procedure, params);
 
   InstructionScheduler scheduler;
-  scheduler.add_referenced_indices(*procedure_.entry(), full_mask);
+  scheduler.add_referenced_indices(*procedure.entry(), full_mask);
 
   /* Loop until all indices got to a return instruction. */
   while (!scheduler.is_done()) {
@@ -1218,9 +1230,9 @@ void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context
     }
   }
 
-  for (const int param_index : this->param_indices()) {
-    const ParamType param_type = this->param_type(param_index);
-    const Variable *variable = procedure_.params()[param_index].variable;
+  for (const int param_index : fn.param_indices()) {
+    const ParamType param_type = fn.param_type(param_index);
+    const Variable *variable = procedure.params()[param_index].variable;
     VariableState &variable_state = variable_states.get_variable_state(*variable);
     switch (param_type.interface_type()) {
       case ParamType::Input: {
@@ -1241,6 +1253,67 @@ void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context
   }
 }
 
+/**
+ * Intermediate buffers are as large as the mask that the procedure is executed on. For large
+ * masks, those buffers don't fit into the CPU caches anymore, so every instruction has to read
+ * and write all of its inputs and outputs from and to main memory. To avoid that, large masks are
+ * split into chunks that are executed one after another, reusing the same small buffers.
+ */
+static constexpr int64_t chunk_size = 2048;
+
+static bool supports_chunked_execution(const MultiFunction &fn)
+{
+  for (const int param_index : fn.param_indices()) {
+    if (fn.param_type(param_index).data_type().is_vector()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ProcedureExecutor::call(const IndexMask &full_mask, Params params, Context context) const
+{
+  BLI_assert(procedure_.validate());
+
+  AlignedBuffer<512, 64> local_buffer;
+  LinearAllocator<> linear_allocator;
+  linear_allocator.provide_buffer(local_buffer);
+  ValueAllocator value_allocator{linear_allocator};
+
+  if (full_mask.size() <= chunk_size * 2 || !supports_chunked_execution(*this)) {
+    execute_procedure(*this, procedure_, full_mask, params, context, value_allocator);
+    return;
+  }
+
+  const int64_t chunks_num = divide_ceil_ul(full_mask.size(), chunk_size);
+  auto chunk_positions = [&](const int64_t chunk) {
+    const int64_t start = chunk * chunk_size;
+    return IndexRange(start, std::min(chunk_size, full_mask.size() - start));
+  };
+
+  /* Allocate all buffers large enough for every chunk, so that they can be reused. */
+  int64_t max_chunk_array_size = 0;
+  for (const int64_t chunk : IndexRange(chunks_num)) {
+    const IndexRange positions = chunk_positions(chunk);
+    const int64_t array_size = full_mask[positions.last()] - full_mask[positions.first()] + 1;
+    max_chunk_array_size = std::max(max_chunk_array_size, array_size);
+  }
+  value_allocator.set_min_span_size(int(max_chunk_array_size));
+
+  for (const int64_t chunk : IndexRange(chunks_num)) {
+    const IndexRange positions = chunk_positions(chunk);
+    const int64_t offset = -full_mask[positions.first()];
+    const IndexRange slice_range(-offset, full_mask[positions.last()] + offset + 1);
+
+    IndexMaskMemory memory;
+    const IndexMask chunk_mask = full_mask.slice_and_offset(positions, offset, memory);
+    ParamsBuilder chunk_params{*this, &chunk_mask};
+    add_sliced_parameters(this->signature(), params, slice_range, chunk_params);
+    Params sliced_params{chunk_params};
+    execute_procedure(*this, procedure_, chunk_mask, sliced_params, context, value_allocator);
+  }
+}
+
 MultiFunction::ExecutionHints ProcedureExecutor::get_execution_hints() const
 {
   ExecutionHints hints;
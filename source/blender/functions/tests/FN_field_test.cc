@@ -5,6 +5,7 @@
 #include "testing/testing.h"
 
 #include "BLI_cpp_type.hh"
+#include "BLI_timeit.hh"
 #include "FN_field.hh"
 #include "FN_multi_function_builder.hh"
 #include "FN_multi_function_test_common.hh"
@@ -281,4 +282,64 @@ TEST(field, IgnoredOutput)
   EXPECT_EQ(results.get(3), 5);
 }
 
+TEST(field, LongFunctionChainLargeMask)
+{
+  GField index_field{std::make_shared<IndexFieldInput>()};
+
+  auto add_fn = mf::build::SI2_SO<int, int, int>("add", [](int a, int b) { return a + b; });
+  auto add_10_fn = mf::build::SI1_SO<int, int>("add_10", [](int a) { return a + 10; });
+  GField field = index_field;
+  for ([[maybe_unused]] const int i : IndexRange(5)) {
+    field = GField(FieldOperation::Create(add_fn, {field, index_field}), 0);
+    field = GField(FieldOperation::Create(add_10_fn, {field}), 0);
+  }
+
+  const int size = 100000;
+  IndexMaskMemory memory;
+  const IndexMask mask = IndexMask::from_predicate(
+      IndexRange(size), GrainSize(4096), memory, [](const int64_t i) { return i % 3 != 1; });
+
+  Array<int> result(size, -1);
+  FieldContext context;
+  FieldEvaluator evaluator{context, &mask};
+  evaluator.add_with_destination(field, result.as_mutable_span());
+  evaluator.evaluate();
+  for (const int i : IndexRange(size)) {
+    EXPECT_EQ(result[i], i % 3 == 1 ? -1 : i * 6 + 50);
+  }
+}
+
+#if 0
+TEST(field, LongFunctionChainBenchmark)
+{
+  GField index_field{std::make_shared<IndexFieldInput>()};
+
+  auto add_fn = mf::build::SI2_SO<float, float, float>(
+      "add", [](float a, float b) { return a + b; }, mf::build::exec_presets::AllSpanOrSingle());
+  auto mul_fn = mf::build::SI2_SO<float, float, float>(
+      "mul", [](float a, float b) { return a * b; }, mf::build::exec_presets::AllSpanOrSingle());
+  auto to_float_fn = mf::build::SI1_SO<int, float>("to_float", [](int a) { return float(a); });
+
+  Field<float> factor = Field<float>(FieldOperation::Create(to_float_fn, {index_field}), 0);
+  Field<float> field = factor;
+  for ([[maybe_unused]] const int i : IndexRange(20)) {
+    field = Field<float>(FieldOperation::Create(mul_fn, {field, factor}), 0);
+    field = Field<float>(FieldOperation::Create(add_fn, {field, factor}), 0);
+  }
+
+  const int size = 10'000'000;
+  Array<float> result(size);
+  for ([[maybe_unused]] const int i : IndexRange(5)) {
+    SCOPED_TIMER("Evaluate long function chain");
+    FieldContext context;
+    FieldEvaluator evaluator{context, size};
+    evaluator.add_with_destination(field, result.as_mutable_span());
+    evaluator.evaluate();
+  }
+
+  /* Print a value to avoid some compiler optimizations. */
+  std::cout << "Result: " << result[size / 2] << "\n";
+}
+#endif /* Benchmark */
+
 }  // namespace blender::fn::tests
@@ -8,9 +8,17 @@
 #include "FN_lazy_function_graph.hh"
 #include "FN_lazy_function_graph_executor.hh"
 
+#include "BLI_lazy_threading.hh"
+#include "BLI_map.hh"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_timeit.hh"
 
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
 namespace blender::fn::lazy_function::tests {
 
 class AddLazyFunction : public LazyFunction {
@@ -180,4 +188,169 @@ TEST(lazy_function, GraphWithCycle)
   EXPECT_EQ(result, 10 * 2 * 5);
 }
 
+class SchedulingStatsLogger : public GraphExecutor::Logger {
+ public:
+  mutable std::mutex mutex;
+  mutable Map<const FunctionNode *, GraphExecutorNodeSchedulingStats> stats_by_node;
+
+  void log_node_scheduling_stats(const FunctionNode &node,
+                                 const GraphExecutorNodeSchedulingStats &stats,
+                                 const Context & /*context*/) const override
+  {
+    std::lock_guard lock{mutex};
+    stats_by_node.add_new(&node, stats);
+  }
+};
+
+TEST(lazy_function, WorkStealingChain)
+{
+  BLI_task_scheduler_init();
+  const AddLazyFunction add_fn;
+
+  Graph graph;
+  DummyNode &input_node = graph.add_dummy({}, {&CPPType::get<int>()});
+  DummyNode &output_node = graph.add_dummy({&CPPType::get<int>()}, {});
+
+  const int value_1 = 1;
+  const int chain_length = 100;
+  OutputSocket *prev_socket = &input_node.output(0);
+  for ([[maybe_unused]] const int i : IndexRange(chain_length)) {
+    FunctionNode &add_node = graph.add_function(add_fn);
+    graph.add_link(*prev_socket, add_node.input(0));
+    add_node.input(1).set_default_value(&value_1);
+    prev_socket = &add_node.output(0);
+  }
+  graph.add_link(*prev_socket, output_node.input(0));
+
+  graph.update_node_indices();
+
+  SchedulingStatsLogger logger;
+  GraphExecutor executor_fn{
+      graph, {&input_node.output(0)}, {&output_node.input(0)}, &logger, nullptr};
+  executor_fn.set_scheduling_mode(GraphExecutor::SchedulingMode::WorkStealing);
+  executor_fn.set_collect_scheduling_stats(true);
+
+  int result = 0;
+  execute_lazy_function_eagerly(
+      executor_fn, nullptr, nullptr, std::make_tuple(5), std::make_tuple(&result));
+
+  EXPECT_EQ(result, 5 + chain_length);
+  EXPECT_EQ(logger.stats_by_node.size(), chain_length);
+  for (const GraphExecutorNodeSchedulingStats &stats : logger.stats_by_node.values()) {
+    EXPECT_GE(stats.schedule_count, 1);
+    EXPECT_GE(stats.run_count, stats.execute_count);
+    EXPECT_EQ(stats.execute_count, 1);
+  }
+}
+
+/**
+ * Takes a while and hints that to the executor, so that the other scheduled nodes are shared with
+ * other threads.
+ */
+class SlowPassThroughFunction : public LazyFunction {
+ private:
+  std::thread::id *r_thread_;
+
+ public:
+  SlowPassThroughFunction(std::thread::id *r_thread) : r_thread_(r_thread)
+  {
+    debug_name_ = "Slow Pass Through";
+    inputs_.append({"A", CPPType::get<int>()});
+    outputs_.append({"A", CPPType::get<int>()});
+  }
+
+  void execute_impl(Params &params, const Context & /*context*/) const override
+  {
+    lazy_threading::send_hint();
+    *r_thread_ = std::this_thread::get_id();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    params.set_output(0, params.get_input<int>(0));
+  }
+};
+
+/** A cheap function that remembers the thread it was executed on. */
+class RecordThreadFunction : public LazyFunction {
+ private:
+  std::thread::id *r_thread_;
+
+ public:
+  RecordThreadFunction(std::thread::id *r_thread) : r_thread_(r_thread)
+  {
+    debug_name_ = "Record Thread";
+    is_cheap_ = true;
+    inputs_.append({"A", CPPType::get<int>()});
+  }
+
+  void execute_impl(Params &params, const Context & /*context*/) const override
+  {
+    params.get_input<int>(0);
+    *r_thread_ = std::this_thread::get_id();
+  }
+};
+
+TEST(lazy_function, WorkStealingPinnedNodes)
+{
+  BLI_task_scheduler_init();
+  const int branches_num = 16;
+  Array<std::thread::id> slow_threads(branches_num);
+  Array<std::thread::id> record_threads(branches_num);
+  Vector<std::unique_ptr<LazyFunction>> functions;
+
+  /* Every branch has a slow node that is shared with other threads, followed by a cheap node that
+   * is pinned to the thread that computed its input. */
+  Graph graph;
+  DummyNode &input_node = graph.add_dummy({}, {&CPPType::get<int>()});
+  Vector<const FunctionNode *> slow_nodes;
+  Vector<const FunctionNode *> record_nodes;
+  for (const int i : IndexRange(branches_num)) {
+    functions.append(std::make_unique<SlowPassThroughFunction>(&slow_threads[i]));
+    FunctionNode &slow_node = graph.add_function(*functions.last());
+    functions.append(std::make_unique<RecordThreadFunction>(&record_threads[i]));
+    FunctionNode &record_node = graph.add_function(*functions.last());
+    graph.add_link(input_node.output(0), slow_node.input(0));
+    graph.add_link(slow_node.output(0), record_node.input(0));
+    slow_nodes.append(&slow_node);
+    record_nodes.append(&record_node);
+  }
+
+  graph.update_node_indices();
+
+  SchedulingStatsLogger logger;
+  SimpleSideEffectProvider side_effect_provider{record_nodes};
+  GraphExecutor executor_fn{graph, {&input_node.output(0)}, {}, &logger, &side_effect_provider};
+  executor_fn.set_scheduling_mode(GraphExecutor::SchedulingMode::WorkStealing);
+  executor_fn.set_collect_scheduling_stats(true);
+
+  /* The executor needs user data once it uses multiple threads. */
+  UserData user_data;
+  execute_lazy_function_eagerly(
+      executor_fn, &user_data, nullptr, std::make_tuple(5), std::make_tuple());
+
+  for (const int i : IndexRange(branches_num)) {
+    /* The cheap node ran directly after its input was computed, on the same thread. */
+    EXPECT_EQ(record_threads[i], slow_threads[i]);
+    EXPECT_EQ(logger.stats_by_node.lookup(record_nodes[i]).shared_count, 0);
+    EXPECT_EQ(logger.stats_by_node.lookup(record_nodes[i]).execute_count, 1);
+    EXPECT_EQ(logger.stats_by_node.lookup(slow_nodes[i]).execute_count, 1);
+  }
+
+#ifdef WITH_TBB
+  if (BLI_system_thread_count() > 1) {
+    int shared_slow_nodes_num = 0;
+    for (const FunctionNode *node : slow_nodes) {
+      if (logger.stats_by_node.lookup(node).shared_count > 0) {
+        shared_slow_nodes_num++;
+      }
+    }
+    EXPECT_GT(shared_slow_nodes_num, 0);
+
+    const bool uses_several_threads = std::any_of(
+        slow_threads.begin(), slow_threads.end(), [&](const std::thread::id thread) {
+          return thread != slow_threads[0];
+        });
+    EXPECT_TRUE(uses_several_threads);
+  }
+#endif
+}
+
 }  // namespace blender::fn::lazy_function::tests
@@ -4,6 +4,8 @@
 
 #include "testing/testing.h"
 
+#include "BLI_math_vector.hh"
+
 #include "FN_multi_function.hh"
 #include "FN_multi_function_builder.hh"
 #include "FN_multi_function_test_common.hh"
@@ -255,5 +257,83 @@ TEST(multi_function, IgnoredOutputs)
   }
 }
 
+/**
+ * Check that a function built with #exec_presets::AllSpanOrSingleSimd computes the same values as
+ * the same element function built with the scalar #exec_presets::AllSpanOrSingle, for masks with
+ * ranges that do and don't fill whole blocks of lanes and for masks with gaps.
+ */
+template<typename In1, typename In2, typename Out, typename ElementFn>
+void expect_simd_preset_matches_scalar(const ElementFn element_fn,
+                                       const Span<In1> inputs1,
+                                       const Span<In2> inputs2)
+{
+  const auto simd_fn = build::SI2_SO<In1, In2, Out>(
+      "Simd", element_fn, build::exec_presets::AllSpanOrSingleSimd());
+  const auto scalar_fn = build::SI2_SO<In1, In2, Out>(
+      "Scalar", element_fn, build::exec_presets::AllSpanOrSingle());
+
+  const int size = inputs1.size();
+  IndexMaskMemory memory;
+  const Array<IndexMask> masks = {
+      IndexMask(size),
+      IndexMask(IndexRange(3, size - 8)),
+      IndexMask(IndexRange(5, 6)),
+      IndexMask::from_predicate(IndexRange(size), GrainSize(1), memory, [](const int64_t i) {
+        return i < 20 || i % 3 != 0;
+      }),
+  };
+
+  for (const IndexMask &mask : masks) {
+    for (const bool single_input2 : {false, true}) {
+      auto call_fn = [&](const MultiFunction &fn, MutableSpan<Out> output) {
+        ParamsBuilder params(fn, &mask);
+        params.add_readonly_single_input(inputs1);
+        if (single_input2) {
+          params.add_readonly_single_input(&inputs2[1]);
+        }
+        else {
+          params.add_readonly_single_input(inputs2);
+        }
+        params.add_uninitialized_single_output(output);
+        ContextBuilder context;
+        fn.call(mask, params, context);
+      };
+      Array<Out> simd_output(size, Out(-1.0f));
+      Array<Out> scalar_output(size, Out(-1.0f));
+      call_fn(simd_fn, simd_output);
+      call_fn(scalar_fn, scalar_output);
+      for (const int i : IndexRange(size)) {
+        EXPECT_EQ(simd_output[i], scalar_output[i]) << i;
+      }
+      mask.foreach_index([&](const int64_t i) { EXPECT_NE(simd_output[i], Out(-1.0f)); });
+    }
+  }
+}
+
+TEST(multi_function, SimdPresetMatchesScalar)
+{
+  /* Use a size that is not a multiple of the lane width. */
+  const int size = 53;
+  Array<float> floats1(size);
+  Array<float> floats2(size);
+  Array<float3> vectors1(size);
+  Array<float3> vectors2(size);
+  for (const int i : IndexRange(size)) {
+    floats1[i] = float(i) * 0.37f + 1.0f;
+    floats2[i] = float(i % 5) - 2.0f;
+    vectors1[i] = float3(i, 2 * i + 1, 0.5f * i + 3);
+    vectors2[i] = float3(i % 3, 1.5f, -0.25f * i);
+  }
+
+  expect_simd_preset_matches_scalar<float, float, float>(
+      [](const float a, const float b) { return b == 0.0f ? 0.0f : a / b; }, floats1, floats2);
+  expect_simd_preset_matches_scalar<float3, float, float3>(
+      [](const float3 &a, const float b) { return a * b + float3(1.0f); }, vectors1, floats2);
+  expect_simd_preset_matches_scalar<float3, float3, float3>(
+      [](const float3 &a, const float3 &b) { return math::cross(a, b); }, vectors1, vectors2);
+  expect_simd_preset_matches_scalar<float3, float3, float>(
+      [](const float3 &a, const float3 &b) { return math::dot(a, b); }, vectors1, vectors2);
+}
+
 }  // namespace
 }  // namespace blender::fn::multi_function::tests
@@ -11,6 +11,7 @@
 #include "DNA_object_types.h"
 #include "DNA_pointcloud_types.h"
 
+#include "BLI_math_base.h"
 #include "BLI_math_matrix.hh"
 #include "BLI_noise.hh"
 #include "BLI_task.hh"
@@ -321,6 +322,10 @@ static void copy_generic_attributes_to_result(
   threading::parallel_for(
       dst_attribute_writers.index_range(), 10, [&](const IndexRange attribute_range) {
         for (const int attribute_index : attribute_range) {
+          if (!dst_attribute_writers[attribute_index]) {
+            /* The attribute is shared with the source geometry already. */
+            continue;
+          }
           const eAttrDomain domain = ordered_attributes.kinds[attribute_index].domain;
           const IndexRange element_slice = range_fn(domain);
 
@@ -339,6 +344,61 @@ static void copy_generic_attributes_to_result(
       });
 }
 
+/**
+ * Add the attribute of the source geometry to the result without copying its values. This is only
+ * valid when the source geometry is the only geometry that contributes to the result.
+ */
+static bool try_share_attribute(const bke::AttributeAccessor src_attributes,
+                                const AttributeIDRef &attribute_id,
+                                const eAttrDomain domain,
+                                const eCustomDataType data_type,
+                                bke::MutableAttributeAccessor dst_attributes)
+{
+  const bke::GAttributeReader src_attribute = src_attributes.lookup(attribute_id);
+  if (!src_attribute || src_attribute.sharing_info == nullptr || src_attribute.domain != domain ||
+      !src_attribute.varray.is_span())
+  {
+    return false;
+  }
+  if (src_attribute.varray.type() != *custom_data_type_to_cpp_type(data_type)) {
+    return false;
+  }
+  return dst_attributes.add(
+      attribute_id,
+      domain,
+      data_type,
+      bke::AttributeInitShared(src_attribute.varray.get_internal_span().data(),
+                               *src_attribute.sharing_info));
+}
+
+/**
+ * Create writers for the generic attributes on the result. When all elements come from a single
+ * source geometry, its attributes are shared with the result where possible. The writers of shared
+ * attributes are empty.
+ */
+static Vector<GSpanAttributeWriter> create_generic_attribute_writers(
+    const OrderedAttributes &ordered_attributes,
+    const std::optional<bke::AttributeAccessor> &single_src_attributes,
+    bke::MutableAttributeAccessor dst_attributes)
+{
+  Vector<GSpanAttributeWriter> dst_attribute_writers;
+  for (const int attribute_index : ordered_attributes.index_range()) {
+    const AttributeIDRef &attribute_id = ordered_attributes.ids[attribute_index];
+    const eAttrDomain domain = ordered_attributes.kinds[attribute_index].domain;
+    const eCustomDataType data_type = ordered_attributes.kinds[attribute_index].data_type;
+    if (single_src_attributes.has_value() &&
+        try_share_attribute(
+            *single_src_attributes, attribute_id, domain, data_type, dst_attributes))
+    {
+      dst_attribute_writers.append({});
+      continue;
+    }
+    dst_attribute_writers.append(
+        dst_attributes.lookup_or_add_for_write_only_span(attribute_id, domain, data_type));
+  }
+  return dst_attribute_writers;
+}
+
 static void create_result_ids(const RealizeInstancesOptions &options,
                               Span<int> stored_ids,
                               const int task_id,
@@ -468,56 +528,75 @@ static void foreach_geometry_in_reference(
   }
 }
 
-static void gather_realize_tasks_for_instances(GatherTasksInfo &gather_info,
-                                               const Instances &instances,
-                                               const float4x4 &base_transform,
-                                               const InstanceContext &base_instance_context)
-{
-  const Span<InstanceReference> references = instances.references();
-  const Span<int> handles = instances.reference_handles();
-  const Span<float4x4> transforms = instances.transforms();
-
+/**
+ * Data about an #Instances that is shared by all of its instances during the gather operation.
+ */
+struct PreparedInstances {
+  Vector<std::pair<int, GSpan>> pointcloud_attributes_to_override;
+  Vector<std::pair<int, GSpan>> mesh_attributes_to_override;
+  Vector<std::pair<int, GSpan>> curve_attributes_to_override;
+  /** Id attribute on the instances. If there are no ids, this #Span is empty. */
   Span<int> stored_instance_ids;
+};
+
+static PreparedInstances prepare_instances_for_gather(GatherTasksInfo &gather_info,
+                                                      const Instances &instances)
+{
+  PreparedInstances prepared;
   if (gather_info.create_id_attribute_on_any_component) {
     std::optional<GSpan> ids = instances.custom_data_attributes().get_for_read("id");
     if (ids.has_value()) {
-      stored_instance_ids = ids->typed<int>();
+      prepared.stored_instance_ids = ids->typed<int>();
     }
   }
 
   /* Prepare attribute fallbacks. */
-  InstanceContext instance_context = base_instance_context;
-  Vector<std::pair<int, GSpan>> pointcloud_attributes_to_override = prepare_attribute_fallbacks(
+  prepared.pointcloud_attributes_to_override = prepare_attribute_fallbacks(
       gather_info, instances, gather_info.pointclouds.attributes);
-  Vector<std::pair<int, GSpan>> mesh_attributes_to_override = prepare_attribute_fallbacks(
+  prepared.mesh_attributes_to_override = prepare_attribute_fallbacks(
       gather_info, instances, gather_info.meshes.attributes);
-  Vector<std::pair<int, GSpan>> curve_attributes_to_override = prepare_attribute_fallbacks(
+  prepared.curve_attributes_to_override = prepare_attribute_fallbacks(
       gather_info, instances, gather_info.curves.attributes);
+  return prepared;
+}
+
+static void gather_realize_tasks_for_instances(GatherTasksInfo &gather_info,
+                                               const Instances &instances,
+                                               const PreparedInstances &prepared,
+                                               const IndexRange instances_range,
+                                               const float4x4 &base_transform,
+                                               const InstanceContext &base_instance_context)
+{
+  const Span<InstanceReference> references = instances.references();
+  const Span<int> handles = instances.reference_handles();
+  const Span<float4x4> transforms = instances.transforms();
 
-  for (const int i : transforms.index_range()) {
+  InstanceContext instance_context = base_instance_context;
+
+  for (const int i : instances_range) {
     const int handle = handles[i];
     const float4x4 &transform = transforms[i];
     const InstanceReference &reference = references[handle];
     const float4x4 new_base_transform = base_transform * transform;
 
     /* Update attribute fallbacks for the current instance. */
-    for (const std::pair<int, GSpan> &pair : pointcloud_attributes_to_override) {
+    for (const std::pair<int, GSpan> &pair : prepared.pointcloud_attributes_to_override) {
       instance_context.pointclouds.array[pair.first] = pair.second[i];
     }
-    for (const std::pair<int, GSpan> &pair : mesh_attributes_to_override) {
+    for (const std::pair<int, GSpan> &pair : prepared.mesh_attributes_to_override) {
       instance_context.meshes.array[pair.first] = pair.second[i];
     }
-    for (const std::pair<int, GSpan> &pair : curve_attributes_to_override) {
+    for (const std::pair<int, GSpan> &pair : prepared.curve_attributes_to_override) {
       instance_context.curves.array[pair.first] = pair.second[i];
     }
 
     uint32_t local_instance_id = 0;
     if (gather_info.create_id_attribute_on_any_component) {
-      if (stored_instance_ids.is_empty()) {
+      if (prepared.stored_instance_ids.is_empty()) {
         local_instance_id = uint32_t(i);
       }
       else {
-        local_instance_id = uint32_t(stored_instance_ids[i]);
+        local_instance_id = uint32_t(prepared.stored_instance_ids[i]);
       }
     }
     const uint32_t instance_id = noise::hash(base_instance_context.id, local_instance_id);
@@ -539,99 +618,115 @@ static void gather_realize_tasks_for_instances(GatherTasksInfo &gather_info,
 }
 
 /**
- * Gather tasks for all geometries in the #geometry_set.
+ * Gather tasks for a single component. Instances are gathered recursively.
  */
-static void gather_realize_tasks_recursive(GatherTasksInfo &gather_info,
-                                           const bke::GeometrySet &geometry_set,
-                                           const float4x4 &base_transform,
-                                           const InstanceContext &base_instance_context)
+static void gather_realize_tasks_for_component(GatherTasksInfo &gather_info,
+                                               const bke::GeometryComponent *component,
+                                               const float4x4 &base_transform,
+                                               const InstanceContext &base_instance_context)
 {
-  for (const bke::GeometryComponent *component : geometry_set.get_components()) {
-    const bke::GeometryComponent::Type type = component->type();
-    switch (type) {
-      case bke::GeometryComponent::Type::Mesh: {
-        const bke::MeshComponent &mesh_component = *static_cast<const bke::MeshComponent *>(
-            component);
-        const Mesh *mesh = mesh_component.get();
-        if (mesh != nullptr && mesh->totvert > 0) {
-          const int mesh_index = gather_info.meshes.order.index_of(mesh);
-          const MeshRealizeInfo &mesh_info = gather_info.meshes.realize_info[mesh_index];
-          gather_info.r_tasks.mesh_tasks.append({gather_info.r_offsets.mesh_offsets,
-                                                 &mesh_info,
-                                                 base_transform,
-                                                 base_instance_context.meshes,
-                                                 base_instance_context.id});
-          gather_info.r_offsets.mesh_offsets.vertex += mesh->totvert;
-          gather_info.r_offsets.mesh_offsets.edge += mesh->totedge;
-          gather_info.r_offsets.mesh_offsets.loop += mesh->totloop;
-          gather_info.r_offsets.mesh_offsets.face += mesh->faces_num;
-        }
-        break;
+  const bke::GeometryComponent::Type type = component->type();
+  switch (type) {
+    case bke::GeometryComponent::Type::Mesh: {
+      const bke::MeshComponent &mesh_component = *static_cast<const bke::MeshComponent *>(
+          component);
+      const Mesh *mesh = mesh_component.get();
+      if (mesh != nullptr && mesh->totvert > 0) {
+        const int mesh_index = gather_info.meshes.order.index_of(mesh);
+        const MeshRealizeInfo &mesh_info = gather_info.meshes.realize_info[mesh_index];
+        gather_info.r_tasks.mesh_tasks.append({gather_info.r_offsets.mesh_offsets,
+                                               &mesh_info,
+                                               base_transform,
+                                               base_instance_context.meshes,
+                                               base_instance_context.id});
+        gather_info.r_offsets.mesh_offsets.vertex += mesh->totvert;
+        gather_info.r_offsets.mesh_offsets.edge += mesh->totedge;
+        gather_info.r_offsets.mesh_offsets.loop += mesh->totloop;
+        gather_info.r_offsets.mesh_offsets.face += mesh->faces_num;
       }
-      case bke::GeometryComponent::Type::PointCloud: {
-        const auto &pointcloud_component = *static_cast<const bke::PointCloudComponent *>(
-            component);
-        const PointCloud *pointcloud = pointcloud_component.get();
-        if (pointcloud != nullptr && pointcloud->totpoint > 0) {
-          const int pointcloud_index = gather_info.pointclouds.order.index_of(pointcloud);
-          const PointCloudRealizeInfo &pointcloud_info =
-              gather_info.pointclouds.realize_info[pointcloud_index];
-          gather_info.r_tasks.pointcloud_tasks.append({gather_info.r_offsets.pointcloud_offset,
-                                                       &pointcloud_info,
-                                                       base_transform,
-                                                       base_instance_context.pointclouds,
-                                                       base_instance_context.id});
-          gather_info.r_offsets.pointcloud_offset += pointcloud->totpoint;
-        }
-        break;
-      }
-      case bke::GeometryComponent::Type::Curve: {
-        const auto &curve_component = *static_cast<const bke::CurveComponent *>(component);
-        const Curves *curves = curve_component.get();
-        if (curves != nullptr && curves->geometry.curve_num > 0) {
-          const int curve_index = gather_info.curves.order.index_of(curves);
-          const RealizeCurveInfo &curve_info = gather_info.curves.realize_info[curve_index];
-          gather_info.r_tasks.curve_tasks.append({gather_info.r_offsets.curves_offsets,
-                                                  &curve_info,
-                                                  base_transform,
-                                                  base_instance_context.curves,
-                                                  base_instance_context.id});
-          gather_info.r_offsets.curves_offsets.point += curves->geometry.point_num;
-          gather_info.r_offsets.curves_offsets.curve += curves->geometry.curve_num;
-        }
-        break;
+      break;
+    }
+    case bke::GeometryComponent::Type::PointCloud: {
+      const auto &pointcloud_component = *static_cast<const bke::PointCloudComponent *>(component);
+      const PointCloud *pointcloud = pointcloud_component.get();
+      if (pointcloud != nullptr && pointcloud->totpoint > 0) {
+        const int pointcloud_index = gather_info.pointclouds.order.index_of(pointcloud);
+        const PointCloudRealizeInfo &pointcloud_info =
+            gather_info.pointclouds.realize_info[pointcloud_index];
+        gather_info.r_tasks.pointcloud_tasks.append({gather_info.r_offsets.pointcloud_offset,
+                                                     &pointcloud_info,
+                                                     base_transform,
+                                                     base_instance_context.pointclouds,
+                                                     base_instance_context.id});
+        gather_info.r_offsets.pointcloud_offset += pointcloud->totpoint;
       }
-      case bke::GeometryComponent::Type::Instance: {
-        const auto &instances_component = *static_cast<const bke::InstancesComponent *>(component);
-        const Instances *instances = instances_component.get();
-        if (instances != nullptr && instances->instances_num() > 0) {
-          gather_realize_tasks_for_instances(
-              gather_info, *instances, base_transform, base_instance_context);
-        }
-        break;
+      break;
+    }
+    case bke::GeometryComponent::Type::Curve: {
+      const auto &curve_component = *static_cast<const bke::CurveComponent *>(component);
+      const Curves *curves = curve_component.get();
+      if (curves != nullptr && curves->geometry.curve_num > 0) {
+        const int curve_index = gather_info.curves.order.index_of(curves);
+        const RealizeCurveInfo &curve_info = gather_info.curves.realize_info[curve_index];
+        gather_info.r_tasks.curve_tasks.append({gather_info.r_offsets.curves_offsets,
+                                                &curve_info,
+                                                base_transform,
+                                                base_instance_context.curves,
+                                                base_instance_context.id});
+        gather_info.r_offsets.curves_offsets.point += curves->geometry.point_num;
+        gather_info.r_offsets.curves_offsets.curve += curves->geometry.curve_num;
       }
-      case bke::GeometryComponent::Type::Volume: {
-        const auto *volume_component = static_cast<const bke::VolumeComponent *>(component);
-        if (!gather_info.r_tasks.first_volume) {
-          volume_component->add_user();
-          gather_info.r_tasks.first_volume = volume_component;
-        }
-        break;
+      break;
+    }
+    case bke::GeometryComponent::Type::Instance: {
+      const auto &instances_component = *static_cast<const bke::InstancesComponent *>(component);
+      const Instances *instances = instances_component.get();
+      if (instances != nullptr && instances->instances_num() > 0) {
+        const PreparedInstances prepared = prepare_instances_for_gather(gather_info,
+                                                                        *instances);
+        gather_realize_tasks_for_instances(gather_info,
+                                           *instances,
+                                           prepared,
+                                           IndexRange(instances->instances_num()),
+                                           base_transform,
+                                           base_instance_context);
       }
-      case bke::GeometryComponent::Type::Edit: {
-        const auto *edit_component = static_cast<const bke::GeometryComponentEditData *>(
-            component);
-        if (!gather_info.r_tasks.first_edit_data) {
-          edit_component->add_user();
-          gather_info.r_tasks.first_edit_data = edit_component;
-        }
-        break;
+      break;
+    }
+    case bke::GeometryComponent::Type::Volume: {
+      const auto *volume_component = static_cast<const bke::VolumeComponent *>(component);
+      if (!gather_info.r_tasks.first_volume) {
+        volume_component->add_user();
+        gather_info.r_tasks.first_volume = volume_component;
       }
-      case bke::GeometryComponent::Type::GreasePencil: {
-        /* TODO. Do nothing for now. */
-        break;
+      break;
+    }
+    case bke::GeometryComponent::Type::Edit: {
+      const auto *edit_component = static_cast<const bke::GeometryComponentEditData *>(component);
+      if (!gather_info.r_tasks.first_edit_data) {
+        edit_component->add_user();
+        gather_info.r_tasks.first_edit_data = edit_component;
       }
+      break;
     }
+    case bke::GeometryComponent::Type::GreasePencil: {
+      /* TODO. Do nothing for now. */
+      break;
+    }
+  }
+}
+
+/**
+ * Gather tasks for all geometries in the #geometry_set.
+ */
+static void gather_realize_tasks_recursive(GatherTasksInfo &gather_info,
+                                           const bke::GeometrySet &geometry_set,
+                                           const float4x4 &base_transform,
+                                           const InstanceContext &base_instance_context)
+{
+  for (const bke::GeometryComponent *component : geometry_set.get_components()) {
+    gather_realize_tasks_for_component(
+        gather_info, component, base_transform, base_instance_context);
   }
 }
 
@@ -764,74 +859,102 @@ static void execute_realize_pointcloud_task(
       dst_attribute_writers);
 }
 
-static void execute_realize_pointcloud_tasks(const RealizeInstancesOptions &options,
-                                             const AllPointCloudsInfo &all_pointclouds_info,
-                                             const Span<RealizePointCloudTask> tasks,
-                                             const OrderedAttributes &ordered_attributes,
-                                             bke::GeometrySet &r_realized_geometry)
-{
-  if (tasks.is_empty()) {
-    return;
-  }
-
-  const RealizePointCloudTask &last_task = tasks.last();
-  const PointCloud &last_pointcloud = *last_task.pointcloud_info->pointcloud;
-  const int tot_points = last_task.start_index + last_pointcloud.totpoint;
+/** The realized point cloud and writers for all attributes that are filled by realize tasks. */
+struct PointCloudOutput {
+  SpanAttributeWriter<float3> positions;
+  SpanAttributeWriter<int> ids;
+  SpanAttributeWriter<float> radii;
+  Vector<GSpanAttributeWriter> attribute_writers;
+};
 
+static PointCloudOutput create_pointcloud_output(const AllPointCloudsInfo &all_pointclouds_info,
+                                                 const PointCloud &first_pointcloud,
+                                                 const PointCloud *single_src_pointcloud,
+                                                 const int tot_points,
+                                                 bke::GeometrySet &r_realized_geometry)
+{
   /* Allocate new point cloud. */
   PointCloud *dst_pointcloud = BKE_pointcloud_new_nomain(tot_points);
   r_realized_geometry.replace_pointcloud(dst_pointcloud);
   bke::MutableAttributeAccessor dst_attributes = dst_pointcloud->attributes_for_write();
 
-  const RealizePointCloudTask &first_task = tasks.first();
-  const PointCloud &first_pointcloud = *first_task.pointcloud_info->pointcloud;
   dst_pointcloud->mat = static_cast<Material **>(MEM_dupallocN(first_pointcloud.mat));
   dst_pointcloud->totcol = first_pointcloud.totcol;
 
-  SpanAttributeWriter<float3> positions = dst_attributes.lookup_or_add_for_write_only_span<float3>(
-      "position", ATTR_DOMAIN_POINT);
+  PointCloudOutput output;
+  output.positions = dst_attributes.lookup_or_add_for_write_only_span<float3>("position",
+                                                                            ATTR_DOMAIN_POINT);
 
   /* Prepare id attribute. */
-  SpanAttributeWriter<int> point_ids;
   if (all_pointclouds_info.create_id_attribute) {
-    point_ids = dst_attributes.lookup_or_add_for_write_only_span<int>("id", ATTR_DOMAIN_POINT);
+    output.ids = dst_attributes.lookup_or_add_for_write_only_span<int>("id", ATTR_DOMAIN_POINT);
   }
-  SpanAttributeWriter<float> point_radii;
   if (all_pointclouds_info.create_radius_attribute) {
-    point_radii = dst_attributes.lookup_or_add_for_write_only_span<float>("radius",
-                                                                          ATTR_DOMAIN_POINT);
+    output.radii = dst_attributes.lookup_or_add_for_write_only_span<float>("radius",
+                                                                         ATTR_DOMAIN_POINT);
   }
 
   /* Prepare generic output attributes. */
-  Vector<GSpanAttributeWriter> dst_attribute_writers;
-  for (const int attribute_index : ordered_attributes.index_range()) {
-    const AttributeIDRef &attribute_id = ordered_attributes.ids[attribute_index];
-    const eCustomDataType data_type = ordered_attributes.kinds[attribute_index].data_type;
-    dst_attribute_writers.append(dst_attributes.lookup_or_add_for_write_only_span(
-        attribute_id, ATTR_DOMAIN_POINT, data_type));
-  }
+  output.attribute_writers = create_generic_attribute_writers(
+      all_pointclouds_info.attributes,
+      single_src_pointcloud ? std::make_optional(single_src_pointcloud->attributes()) :
+                              std::nullopt,
+      dst_attributes);
+  return output;
+}
 
-  /* Actually execute all tasks. */
+static void execute_realize_pointcloud_tasks(const RealizeInstancesOptions &options,
+                                             const AllPointCloudsInfo &all_pointclouds_info,
+                                             const Span<RealizePointCloudTask> tasks,
+                                             PointCloudOutput &output)
+{
   threading::parallel_for(tasks.index_range(), 100, [&](const IndexRange task_range) {
     for (const int task_index : task_range) {
       const RealizePointCloudTask &task = tasks[task_index];
       execute_realize_pointcloud_task(options,
                                       task,
-                                      ordered_attributes,
-                                      dst_attribute_writers,
-                                      point_radii.span,
-                                      point_ids.span,
-                                      positions.span);
+                                      all_pointclouds_info.attributes,
+                                      output.attribute_writers,
+                                      output.radii.span,
+                                      output.ids.span,
+                                      output.positions.span);
     }
   });
+}
 
+static void finish_pointcloud_output(PointCloudOutput &output)
+{
   /* Tag modified attributes. */
-  for (GSpanAttributeWriter &dst_attribute : dst_attribute_writers) {
+  for (GSpanAttributeWriter &dst_attribute : output.attribute_writers) {
     dst_attribute.finish();
   }
-  positions.finish();
-  point_radii.finish();
-  point_ids.finish();
+  output.positions.finish();
+  output.radii.finish();
+  output.ids.finish();
+}
+
+static void realize_pointcloud_tasks(const RealizeInstancesOptions &options,
+                                     const AllPointCloudsInfo &all_pointclouds_info,
+                                     const Span<RealizePointCloudTask> tasks,
+                                     bke::GeometrySet &r_realized_geometry)
+{
+  if (tasks.is_empty()) {
+    return;
+  }
+
+  const RealizePointCloudTask &last_task = tasks.last();
+  const PointCloud &last_pointcloud = *last_task.pointcloud_info->pointcloud;
+  const int tot_points = last_task.start_index + last_pointcloud.totpoint;
+
+  const PointCloud &first_pointcloud = *tasks.first().pointcloud_info->pointcloud;
+  PointCloudOutput output = create_pointcloud_output(all_pointclouds_info,
+                                                     first_pointcloud,
+                                                     tasks.size() == 1 ? &first_pointcloud :
+                                                                         nullptr,
+                                                     tot_points,
+                                                     r_realized_geometry);
+  execute_realize_pointcloud_tasks(options, all_pointclouds_info, tasks, output);
+  finish_pointcloud_output(output);
 }
 
 /** \} */
@@ -1078,100 +1201,133 @@ static void execute_realize_mesh_task(const RealizeInstancesOptions &options,
       dst_attribute_writers);
 }
 
-static void execute_realize_mesh_tasks(const RealizeInstancesOptions &options,
-                                       const AllMeshesInfo &all_meshes_info,
-                                       const Span<RealizeMeshTask> tasks,
-                                       const OrderedAttributes &ordered_attributes,
-                                       const VectorSet<Material *> &ordered_materials,
-                                       bke::GeometrySet &r_realized_geometry)
-{
-  if (tasks.is_empty()) {
-    return;
-  }
-
-  const RealizeMeshTask &last_task = tasks.last();
-  const Mesh &last_mesh = *last_task.mesh_info->mesh;
-  const int tot_vertices = last_task.start_indices.vertex + last_mesh.totvert;
-  const int tot_edges = last_task.start_indices.edge + last_mesh.totedge;
-  const int tot_loops = last_task.start_indices.loop + last_mesh.totloop;
-  const int tot_faces = last_task.start_indices.face + last_mesh.faces_num;
+/** The realized mesh and writers for all attributes that are filled by realize tasks. */
+struct MeshOutput {
+  Mesh *mesh = nullptr;
+  MutableSpan<float3> positions;
+  MutableSpan<int2> edges;
+  MutableSpan<int> face_offsets;
+  MutableSpan<int> corner_verts;
+  MutableSpan<int> corner_edges;
+  SpanAttributeWriter<int> vertex_ids;
+  SpanAttributeWriter<int> material_indices;
+  Vector<GSpanAttributeWriter> attribute_writers;
+};
 
-  Mesh *dst_mesh = BKE_mesh_new_nomain(tot_vertices, tot_edges, tot_faces, tot_loops);
+static MeshOutput create_mesh_output(const AllMeshesInfo &all_meshes_info,
+                                     const Mesh &first_mesh,
+                                     const Mesh *single_src_mesh,
+                                     const MeshElementStartIndices &totals,
+                                     bke::GeometrySet &r_realized_geometry)
+{
+  Mesh *dst_mesh = BKE_mesh_new_nomain(totals.vertex, totals.edge, totals.face, totals.loop);
   r_realized_geometry.replace_mesh(dst_mesh);
   bke::MutableAttributeAccessor dst_attributes = dst_mesh->attributes_for_write();
-  MutableSpan<float3> dst_positions = dst_mesh->vert_positions_for_write();
-  MutableSpan<int2> dst_edges = dst_mesh->edges_for_write();
-  MutableSpan<int> dst_face_offsets = dst_mesh->face_offsets_for_write();
-  MutableSpan<int> dst_corner_verts = dst_mesh->corner_verts_for_write();
-  MutableSpan<int> dst_corner_edges = dst_mesh->corner_edges_for_write();
+
+  MeshOutput output;
+  output.mesh = dst_mesh;
+  output.positions = dst_mesh->vert_positions_for_write();
+  output.edges = dst_mesh->edges_for_write();
+  output.face_offsets = dst_mesh->face_offsets_for_write();
+  output.corner_verts = dst_mesh->corner_verts_for_write();
+  output.corner_edges = dst_mesh->corner_edges_for_write();
 
   /* Copy settings from the first input geometry set with a mesh. */
-  const RealizeMeshTask &first_task = tasks.first();
-  const Mesh &first_mesh = *first_task.mesh_info->mesh;
   BKE_mesh_copy_parameters_for_eval(dst_mesh, &first_mesh);
   /* The above line also copies vertex group names. We don't want that here because the new
    * attributes are added explicitly below. */
   BLI_freelistN(&dst_mesh->vertex_group_names);
 
   /* Add materials. */
-  for (const int i : IndexRange(ordered_materials.size())) {
-    Material *material = ordered_materials[i];
+  for (const int i : IndexRange(all_meshes_info.materials.size())) {
+    Material *material = all_meshes_info.materials[i];
     BKE_id_material_eval_assign(&dst_mesh->id, i + 1, material);
   }
 
   /* Prepare id attribute. */
-  SpanAttributeWriter<int> vertex_ids;
   if (all_meshes_info.create_id_attribute) {
-    vertex_ids = dst_attributes.lookup_or_add_for_write_only_span<int>("id", ATTR_DOMAIN_POINT);
+    output.vertex_ids = dst_attributes.lookup_or_add_for_write_only_span<int>("id",
+                                                                            ATTR_DOMAIN_POINT);
   }
   /* Prepare material indices. */
-  SpanAttributeWriter<int> material_indices;
   if (all_meshes_info.create_material_index_attribute) {
-    material_indices = dst_attributes.lookup_or_add_for_write_only_span<int>("material_index",
-                                                                             ATTR_DOMAIN_FACE);
+    output.material_indices = dst_attributes.lookup_or_add_for_write_only_span<int>(
+        "material_index", ATTR_DOMAIN_FACE);
   }
 
   /* Prepare generic output attributes. */
-  Vector<GSpanAttributeWriter> dst_attribute_writers;
-  for (const int attribute_index : ordered_attributes.index_range()) {
-    const AttributeIDRef &attribute_id = ordered_attributes.ids[attribute_index];
-    const eAttrDomain domain = ordered_attributes.kinds[attribute_index].domain;
-    const eCustomDataType data_type = ordered_attributes.kinds[attribute_index].data_type;
-    dst_attribute_writers.append(
-        dst_attributes.lookup_or_add_for_write_only_span(attribute_id, domain, data_type));
-  }
+  output.attribute_writers = create_generic_attribute_writers(
+      all_meshes_info.attributes,
+      single_src_mesh ? std::make_optional(single_src_mesh->attributes()) : std::nullopt,
+      dst_attributes);
+  return output;
+}
 
-  /* Actually execute all tasks. */
+static void execute_realize_mesh_tasks(const RealizeInstancesOptions &options,
+                                       const AllMeshesInfo &all_meshes_info,
+                                       const Span<RealizeMeshTask> tasks,
+                                       MeshOutput &output)
+{
   threading::parallel_for(tasks.index_range(), 100, [&](const IndexRange task_range) {
     for (const int task_index : task_range) {
       const RealizeMeshTask &task = tasks[task_index];
       execute_realize_mesh_task(options,
                                 task,
-                                ordered_attributes,
-                                dst_attribute_writers,
-                                dst_positions,
-                                dst_edges,
-                                dst_face_offsets,
-                                dst_corner_verts,
-                                dst_corner_edges,
-                                vertex_ids.span,
-                                material_indices.span);
+                                all_meshes_info.attributes,
+                                output.attribute_writers,
+                                output.positions,
+                                output.edges,
+                                output.face_offsets,
+                                output.corner_verts,
+                                output.corner_edges,
+                                output.vertex_ids.span,
+                                output.material_indices.span);
     }
   });
+}
 
+static void finish_mesh_output(const AllMeshesInfo &all_meshes_info, MeshOutput &output)
+{
   /* Tag modified attributes. */
-  for (GSpanAttributeWriter &dst_attribute : dst_attribute_writers) {
+  for (GSpanAttributeWriter &dst_attribute : output.attribute_writers) {
     dst_attribute.finish();
   }
-  vertex_ids.finish();
-  material_indices.finish();
+  output.vertex_ids.finish();
+  output.material_indices.finish();
 
   if (all_meshes_info.no_loose_edges_hint) {
-    dst_mesh->tag_loose_edges_none();
+    output.mesh->tag_loose_edges_none();
   }
   if (all_meshes_info.no_loose_verts_hint) {
-    dst_mesh->tag_loose_verts_none();
+    output.mesh->tag_loose_verts_none();
+  }
+}
+
+static void realize_mesh_tasks(const RealizeInstancesOptions &options,
+                               const AllMeshesInfo &all_meshes_info,
+                               const Span<RealizeMeshTask> tasks,
+                               bke::GeometrySet &r_realized_geometry)
+{
+  if (tasks.is_empty()) {
+    return;
   }
+
+  const RealizeMeshTask &last_task = tasks.last();
+  const Mesh &last_mesh = *last_task.mesh_info->mesh;
+  MeshElementStartIndices totals;
+  totals.vertex = last_task.start_indices.vertex + last_mesh.totvert;
+  totals.edge = last_task.start_indices.edge + last_mesh.totedge;
+  totals.loop = last_task.start_indices.loop + last_mesh.totloop;
+  totals.face = last_task.start_indices.face + last_mesh.faces_num;
+
+  const Mesh &first_mesh = *tasks.first().mesh_info->mesh;
+  MeshOutput output = create_mesh_output(all_meshes_info,
+                                         first_mesh,
+                                         tasks.size() == 1 ? &first_mesh : nullptr,
+                                         totals,
+                                         r_realized_geometry);
+  execute_realize_mesh_tasks(options, all_meshes_info, tasks, output);
+  finish_mesh_output(all_meshes_info, output);
 }
 
 /** \} */
@@ -1379,112 +1535,506 @@ static void execute_realize_curve_task(const RealizeInstancesOptions &options,
       dst_attribute_writers);
 }
 
-static void execute_realize_curve_tasks(const RealizeInstancesOptions &options,
-                                        const AllCurvesInfo &all_curves_info,
-                                        const Span<RealizeCurveTask> tasks,
-                                        const OrderedAttributes &ordered_attributes,
-                                        bke::GeometrySet &r_realized_geometry)
-{
-  if (tasks.is_empty()) {
-    return;
-  }
-
-  const RealizeCurveTask &last_task = tasks.last();
-  const Curves &last_curves = *last_task.curve_info->curves;
-  const int points_num = last_task.start_indices.point + last_curves.geometry.point_num;
-  const int curves_num = last_task.start_indices.curve + last_curves.geometry.curve_num;
+/** The realized curves and writers for all attributes that are filled by realize tasks. */
+struct CurvesOutput {
+  bke::CurvesGeometry *curves = nullptr;
+  SpanAttributeWriter<int> point_ids;
+  SpanAttributeWriter<float3> handle_left;
+  SpanAttributeWriter<float3> handle_right;
+  SpanAttributeWriter<float> radius;
+  SpanAttributeWriter<float> nurbs_weight;
+  SpanAttributeWriter<int> resolution;
+  Vector<GSpanAttributeWriter> attribute_writers;
+};
 
+static CurvesOutput create_curves_output(const AllCurvesInfo &all_curves_info,
+                                         const Curves &first_curves_id,
+                                         const Curves *single_src_curves_id,
+                                         const CurvesElementStartIndices &totals,
+                                         bke::GeometrySet &r_realized_geometry)
+{
   /* Allocate new curves data-block. */
-  Curves *dst_curves_id = bke::curves_new_nomain(points_num, curves_num);
+  Curves *dst_curves_id = bke::curves_new_nomain(totals.point, totals.curve);
   bke::CurvesGeometry &dst_curves = dst_curves_id->geometry.wrap();
-  dst_curves.offsets_for_write().last() = points_num;
+  dst_curves.offsets_for_write().last() = totals.point;
   r_realized_geometry.replace_curves(dst_curves_id);
   bke::MutableAttributeAccessor dst_attributes = dst_curves.attributes_for_write();
 
   /* Copy settings from the first input geometry set with curves. */
-  const RealizeCurveTask &first_task = tasks.first();
-  const Curves &first_curves_id = *first_task.curve_info->curves;
   bke::curves_copy_parameters(first_curves_id, *dst_curves_id);
 
+  CurvesOutput output;
+  output.curves = &dst_curves;
+
   /* Prepare id attribute. */
-  SpanAttributeWriter<int> point_ids;
   if (all_curves_info.create_id_attribute) {
-    point_ids = dst_attributes.lookup_or_add_for_write_only_span<int>("id", ATTR_DOMAIN_POINT);
+    output.point_ids = dst_attributes.lookup_or_add_for_write_only_span<int>("id",
+                                                                           ATTR_DOMAIN_POINT);
   }
 
   /* Prepare generic output attributes. */
-  Vector<GSpanAttributeWriter> dst_attribute_writers;
-  for (const int attribute_index : ordered_attributes.index_range()) {
-    const AttributeIDRef &attribute_id = ordered_attributes.ids[attribute_index];
-    const eAttrDomain domain = ordered_attributes.kinds[attribute_index].domain;
-    const eCustomDataType data_type = ordered_attributes.kinds[attribute_index].data_type;
-    dst_attribute_writers.append(
-        dst_attributes.lookup_or_add_for_write_only_span(attribute_id, domain, data_type));
-  }
+  output.attribute_writers = create_generic_attribute_writers(
+      all_curves_info.attributes,
+      single_src_curves_id ?
+          std::make_optional(single_src_curves_id->geometry.wrap().attributes()) :
+          std::nullopt,
+      dst_attributes);
 
   /* Prepare handle position attributes if necessary. */
-  SpanAttributeWriter<float3> handle_left;
-  SpanAttributeWriter<float3> handle_right;
   if (all_curves_info.create_handle_postion_attributes) {
-    handle_left = dst_attributes.lookup_or_add_for_write_only_span<float3>("handle_left",
-                                                                           ATTR_DOMAIN_POINT);
-    handle_right = dst_attributes.lookup_or_add_for_write_only_span<float3>("handle_right",
-                                                                            ATTR_DOMAIN_POINT);
+    output.handle_left = dst_attributes.lookup_or_add_for_write_only_span<float3>(
+        "handle_left", ATTR_DOMAIN_POINT);
+    output.handle_right = dst_attributes.lookup_or_add_for_write_only_span<float3>(
+        "handle_right", ATTR_DOMAIN_POINT);
   }
 
-  SpanAttributeWriter<float> radius;
   if (all_curves_info.create_radius_attribute) {
-    radius = dst_attributes.lookup_or_add_for_write_only_span<float>("radius", ATTR_DOMAIN_POINT);
+    output.radius = dst_attributes.lookup_or_add_for_write_only_span<float>("radius",
+                                                                          ATTR_DOMAIN_POINT);
   }
-  SpanAttributeWriter<float> nurbs_weight;
   if (all_curves_info.create_nurbs_weight_attribute) {
-    nurbs_weight = dst_attributes.lookup_or_add_for_write_only_span<float>("nurbs_weight",
-                                                                           ATTR_DOMAIN_POINT);
+    output.nurbs_weight = dst_attributes.lookup_or_add_for_write_only_span<float>(
+        "nurbs_weight", ATTR_DOMAIN_POINT);
   }
-  SpanAttributeWriter<int> resolution;
   if (all_curves_info.create_resolution_attribute) {
-    resolution = dst_attributes.lookup_or_add_for_write_only_span<int>("resolution",
-                                                                       ATTR_DOMAIN_CURVE);
+    output.resolution = dst_attributes.lookup_or_add_for_write_only_span<int>("resolution",
+                                                                            ATTR_DOMAIN_CURVE);
   }
+  return output;
+}
 
-  /* Actually execute all tasks. */
+static void execute_realize_curve_tasks(const RealizeInstancesOptions &options,
+                                        const AllCurvesInfo &all_curves_info,
+                                        const Span<RealizeCurveTask> tasks,
+                                        CurvesOutput &output)
+{
   threading::parallel_for(tasks.index_range(), 100, [&](const IndexRange task_range) {
     for (const int task_index : task_range) {
       const RealizeCurveTask &task = tasks[task_index];
       execute_realize_curve_task(options,
                                  all_curves_info,
                                  task,
-                                 ordered_attributes,
-                                 dst_curves,
-                                 dst_attribute_writers,
-                                 point_ids.span,
-                                 handle_left.span,
-                                 handle_right.span,
-                                 radius.span,
-                                 nurbs_weight.span,
-                                 resolution.span);
+                                 all_curves_info.attributes,
+                                 *output.curves,
+                                 output.attribute_writers,
+                                 output.point_ids.span,
+                                 output.handle_left.span,
+                                 output.handle_right.span,
+                                 output.radius.span,
+                                 output.nurbs_weight.span,
+                                 output.resolution.span);
     }
   });
+}
 
-  /* Type counts have to be updated eagerly. */
-  dst_curves.runtime->type_counts.fill(0);
+static void add_curve_type_counts(const Span<RealizeCurveTask> tasks,
+                                  std::array<int, CURVE_TYPES_NUM> &r_type_counts)
+{
   for (const RealizeCurveTask &task : tasks) {
     for (const int i : IndexRange(CURVE_TYPES_NUM)) {
-      dst_curves.runtime->type_counts[i] +=
-          task.curve_info->curves->geometry.runtime->type_counts[i];
+      r_type_counts[i] += task.curve_info->curves->geometry.runtime->type_counts[i];
     }
   }
+}
+
+static void finish_curves_output(const std::array<int, CURVE_TYPES_NUM> &type_counts,
+                                 CurvesOutput &output)
+{
+  /* Type counts have to be updated eagerly. */
+  output.curves->runtime->type_counts = type_counts;
 
   /* Tag modified attributes. */
-  for (GSpanAttributeWriter &dst_attribute : dst_attribute_writers) {
+  for (GSpanAttributeWriter &dst_attribute : output.attribute_writers) {
     dst_attribute.finish();
   }
-  point_ids.finish();
-  radius.finish();
-  resolution.finish();
-  nurbs_weight.finish();
-  handle_left.finish();
-  handle_right.finish();
+  output.point_ids.finish();
+  output.radius.finish();
+  output.resolution.finish();
+  output.nurbs_weight.finish();
+  output.handle_left.finish();
+  output.handle_right.finish();
+}
+
+static void realize_curve_tasks(const RealizeInstancesOptions &options,
+                                const AllCurvesInfo &all_curves_info,
+                                const Span<RealizeCurveTask> tasks,
+                                bke::GeometrySet &r_realized_geometry)
+{
+  if (tasks.is_empty()) {
+    return;
+  }
+
+  const RealizeCurveTask &last_task = tasks.last();
+  const Curves &last_curves = *last_task.curve_info->curves;
+  CurvesElementStartIndices totals;
+  totals.point = last_task.start_indices.point + last_curves.geometry.point_num;
+  totals.curve = last_task.start_indices.curve + last_curves.geometry.curve_num;
+
+  const Curves &first_curves_id = *tasks.first().curve_info->curves;
+  CurvesOutput output = create_curves_output(all_curves_info,
+                                             first_curves_id,
+                                             tasks.size() == 1 ? &first_curves_id : nullptr,
+                                             totals,
+                                             r_realized_geometry);
+  execute_realize_curve_tasks(options, all_curves_info, tasks, output);
+
+  std::array<int, CURVE_TYPES_NUM> type_counts{};
+  add_curve_type_counts(tasks, type_counts);
+  finish_curves_output(type_counts, output);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Chunked Realize
+ *
+ * Gathering all tasks before executing them requires memory proportional to the number of
+ * instances on top of the output, and the gather operation is single threaded. For geometries
+ * with many instances, the number of elements that every instance reference contributes to the
+ * output is counted first instead. Accumulating these counts gives the start offsets of chunks
+ * of instances, which then gather and execute their tasks independently and in parallel, writing
+ * directly into the final output arrays.
+ * \{ */
+
+/** Below this number of top-level instances, all tasks are gathered up-front. */
+static constexpr int chunked_realize_min_instances = 4096;
+/** Number of top-level components or instances that are gathered and realized at once. */
+static constexpr int chunked_realize_chunk_size = 512;
+
+static void add_element_counts(const GatherOffsets &counts, GatherOffsets &r_counts)
+{
+  r_counts.pointcloud_offset += counts.pointcloud_offset;
+  r_counts.mesh_offsets.vertex += counts.mesh_offsets.vertex;
+  r_counts.mesh_offsets.edge += counts.mesh_offsets.edge;
+  r_counts.mesh_offsets.face += counts.mesh_offsets.face;
+  r_counts.mesh_offsets.loop += counts.mesh_offsets.loop;
+  r_counts.curves_offsets.point += counts.curves_offsets.point;
+  r_counts.curves_offsets.curve += counts.curves_offsets.curve;
+}
+
+static GatherOffsets count_realized_elements(const bke::GeometryComponent &component);
+
+/**
+ * Count the elements that every instance reference adds to the output, including all nested
+ * instances. This matches the offsets computed by #gather_realize_tasks_recursive.
+ */
+static Array<GatherOffsets> count_realized_elements_per_reference(const Instances &instances)
+{
+  const Span<InstanceReference> references = instances.references();
+  Array<GatherOffsets> counts(references.size());
+  for (const int i : references.index_range()) {
+    foreach_geometry_in_reference(references[i],
+                                  float4x4::identity(),
+                                  0,
+                                  [&](const bke::GeometrySet &geometry_set,
+                                      const float4x4 & /*transform*/,
+                                      const uint32_t /*id*/) {
+                                    for (const bke::GeometryComponent *component :
+                                         geometry_set.get_components())
+                                    {
+                                      add_element_counts(count_realized_elements(*component),
+                                                         counts[i]);
+                                    }
+                                  });
+  }
+  return counts;
+}
+
+static GatherOffsets count_realized_elements(const bke::GeometryComponent &component)
+{
+  GatherOffsets counts;
+  switch (component.type()) {
+    case bke::GeometryComponent::Type::Mesh: {
+      const Mesh *mesh = static_cast<const bke::MeshComponent &>(component).get();
+      if (mesh != nullptr && mesh->totvert > 0) {
+        counts.mesh_offsets.vertex = mesh->totvert;
+        counts.mesh_offsets.edge = mesh->totedge;
+        counts.mesh_offsets.face = mesh->faces_num;
+        counts.mesh_offsets.loop = mesh->totloop;
+      }
+      break;
+    }
+    case bke::GeometryComponent::Type::PointCloud: {
+      const PointCloud *pointcloud =
+          static_cast<const bke::PointCloudComponent &>(component).get();
+      if (pointcloud != nullptr && pointcloud->totpoint > 0) {
+        counts.pointcloud_offset = pointcloud->totpoint;
+      }
+      break;
+    }
+    case bke::GeometryComponent::Type::Curve: {
+      const Curves *curves = static_cast<const bke::CurveComponent &>(component).get();
+      if (curves != nullptr && curves->geometry.curve_num > 0) {
+        counts.curves_offsets.point = curves->geometry.point_num;
+        counts.curves_offsets.curve = curves->geometry.curve_num;
+      }
+      break;
+    }
+    case bke::GeometryComponent::Type::Instance: {
+      const Instances *instances = static_cast<const bke::InstancesComponent &>(component).get();
+      if (instances != nullptr && instances->instances_num() > 0) {
+        const Array<GatherOffsets> reference_counts = count_realized_elements_per_reference(
+            *instances);
+        for (const int handle : instances->reference_handles()) {
+          add_element_counts(reference_counts[handle], counts);
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return counts;
+}
+
+/**
+ * The input geometry split into units in the order in which they are realized: every top-level
+ * component except for the instances is a unit, and every top-level instance is a unit.
+ */
+struct RealizeUnits {
+  Vector<const bke::GeometryComponent *> components_before_instances;
+  const Instances *instances = nullptr;
+  Vector<const bke::GeometryComponent *> components_after_instances;
+
+  RealizeUnits(const bke::GeometrySet &geometry_set)
+  {
+    for (const bke::GeometryComponent *component : geometry_set.get_components()) {
+      if (component->type() == bke::GeometryComponent::Type::Instance) {
+        this->instances = static_cast<const bke::InstancesComponent *>(component)->get();
+      }
+      else if (this->instances == nullptr) {
+        this->components_before_instances.append(component);
+      }
+      else {
+        this->components_after_instances.append(component);
+      }
+    }
+  }
+
+  IndexRange before_range() const
+  {
+    return this->components_before_instances.index_range();
+  }
+
+  IndexRange instances_range() const
+  {
+    return this->before_range().after(this->instances->instances_num());
+  }
+
+  IndexRange after_range() const
+  {
+    return this->instances_range().after(this->components_after_instances.size());
+  }
+
+  int size() const
+  {
+    return int(this->after_range().one_after_last());
+  }
+};
+
+static void gather_realize_tasks_for_units(GatherTasksInfo &gather_info,
+                                           const RealizeUnits &units,
+                                           const PreparedInstances &prepared_instances,
+                                           const IndexRange units_range,
+                                           const InstanceContext &base_instance_context)
+{
+  const float4x4 transform = float4x4::identity();
+  for (const int i : units_range.intersect(units.before_range())) {
+    gather_realize_tasks_for_component(
+        gather_info, units.components_before_instances[i], transform, base_instance_context);
+  }
+  const IndexRange instances_range = units_range.intersect(units.instances_range());
+  if (!instances_range.is_empty()) {
+    gather_realize_tasks_for_instances(gather_info,
+                                       *units.instances,
+                                       prepared_instances,
+                                       instances_range.shift(-units.instances_range().start()),
+                                       transform,
+                                       base_instance_context);
+  }
+  for (const int i : units_range.intersect(units.after_range())) {
+    const bke::GeometryComponent *component =
+        units.components_after_instances[i - units.after_range().start()];
+    gather_realize_tasks_for_component(gather_info, component, transform, base_instance_context);
+  }
+}
+
+static bool use_chunked_realize(const bke::GeometrySet &geometry_set)
+{
+  const Instances *instances = geometry_set.get_instances();
+  return instances != nullptr && instances->instances_num() >= chunked_realize_min_instances;
+}
+
+static void realize_instances_chunked(const RealizeInstancesOptions &options,
+                                      const bke::GeometrySet &geometry_set,
+                                      const AllPointCloudsInfo &all_pointclouds_info,
+                                      const AllMeshesInfo &all_meshes_info,
+                                      const AllCurvesInfo &all_curves_info,
+                                      const bool create_id_attribute,
+                                      bke::GeometrySet &r_realized_geometry)
+{
+  const RealizeUnits units(geometry_set);
+  const Array<GatherOffsets> reference_counts = count_realized_elements_per_reference(
+      *units.instances);
+  const Span<int> handles = units.instances->reference_handles();
+
+  auto count_unit = [&](const int unit) -> GatherOffsets {
+    if (units.instances_range().contains(unit)) {
+      return reference_counts[handles[unit - units.instances_range().start()]];
+    }
+    if (units.before_range().contains(unit)) {
+      return count_realized_elements(*units.components_before_instances[unit]);
+    }
+    return count_realized_elements(
+        *units.components_after_instances[unit - units.after_range().start()]);
+  };
+
+  const IndexRange all_units(units.size());
+  const int chunks_num = divide_ceil_u(units.size(), chunked_realize_chunk_size);
+  auto chunk_units = [&](const int chunk) {
+    const int start = chunk * chunked_realize_chunk_size;
+    return IndexRange(start, std::min(chunked_realize_chunk_size, units.size() - start));
+  };
+
+  /* Compute the start offsets of all chunks with a prefix sum over their element counts. */
+  Array<GatherOffsets> chunk_offsets(chunks_num + 1);
+  threading::parallel_for(IndexRange(chunks_num), 64, [&](const IndexRange range) {
+    for (const int chunk : range) {
+      GatherOffsets counts;
+      for (const int unit : chunk_units(chunk)) {
+        add_element_counts(count_unit(unit), counts);
+      }
+      chunk_offsets[chunk + 1] = counts;
+    }
+  });
+  for (const int chunk : IndexRange(chunks_num)) {
+    add_element_counts(chunk_offsets[chunk], chunk_offsets[chunk + 1]);
+  }
+  const GatherOffsets &totals = chunk_offsets.last();
+
+  /* Instance attributes of the top-level instances are prepared once for all chunks. */
+  Vector<std::unique_ptr<GArray<>>> temporary_arrays;
+  GatherTasksInfo instances_gather_info = {all_pointclouds_info,
+                                           all_meshes_info,
+                                           all_curves_info,
+                                           create_id_attribute,
+                                           temporary_arrays};
+  const PreparedInstances prepared_instances = prepare_instances_for_gather(instances_gather_info,
+                                                                            *units.instances);
+  const InstanceContext instance_context(instances_gather_info);
+
+  auto gather_units = [&](const IndexRange units_range,
+                          const GatherOffsets &start_offsets,
+                          Vector<std::unique_ptr<GArray<>>> &r_temporary_arrays) {
+    GatherTasksInfo gather_info = {all_pointclouds_info,
+                                   all_meshes_info,
+                                   all_curves_info,
+                                   create_id_attribute,
+                                   r_temporary_arrays};
+    gather_info.r_offsets = start_offsets;
+    gather_realize_tasks_for_units(
+        gather_info, units, prepared_instances, units_range, instance_context);
+    return std::move(gather_info.r_tasks);
+  };
+
+  /* Settings of the output geometries are copied from the first input geometry of each type. */
+  auto gather_first_unit = [&](const FunctionRef<bool(const GatherOffsets &counts)> fn) {
+    Vector<std::unique_ptr<GArray<>>> unit_temporary_arrays;
+    for (const int unit : all_units) {
+      if (fn(count_unit(unit))) {
+        return gather_units(IndexRange(unit, 1), {}, unit_temporary_arrays);
+      }
+    }
+    return GatherTasks();
+  };
+
+  std::optional<PointCloudOutput> pointcloud_output;
+  if (totals.pointcloud_offset > 0) {
+    const GatherTasks first_tasks = gather_first_unit(
+        [](const GatherOffsets &counts) { return counts.pointcloud_offset > 0; });
+    pointcloud_output = create_pointcloud_output(
+        all_pointclouds_info,
+        *first_tasks.pointcloud_tasks.first().pointcloud_info->pointcloud,
+        nullptr,
+        totals.pointcloud_offset,
+        r_realized_geometry);
+  }
+  std::optional<MeshOutput> mesh_output;
+  if (totals.mesh_offsets.vertex > 0) {
+    const GatherTasks first_tasks = gather_first_unit(
+        [](const GatherOffsets &counts) { return counts.mesh_offsets.vertex > 0; });
+    mesh_output = create_mesh_output(all_meshes_info,
+                                     *first_tasks.mesh_tasks.first().mesh_info->mesh,
+                                     nullptr,
+                                     totals.mesh_offsets,
+                                     r_realized_geometry);
+  }
+  std::optional<CurvesOutput> curves_output;
+  if (totals.curves_offsets.curve > 0) {
+    const GatherTasks first_tasks = gather_first_unit(
+        [](const GatherOffsets &counts) { return counts.curves_offsets.curve > 0; });
+    curves_output = create_curves_output(all_curves_info,
+                                         *first_tasks.curve_tasks.first().curve_info->curves,
+                                         nullptr,
+                                         totals.curves_offsets,
+                                         r_realized_geometry);
+  }
+
+  /* The tasks of every chunk only exist while the chunk is realized. */
+  Array<ImplicitSharingPtr<const bke::VolumeComponent>> chunk_volumes(chunks_num);
+  Array<ImplicitSharingPtr<const bke::GeometryComponentEditData>> chunk_edit_data(chunks_num);
+  Array<std::array<int, CURVE_TYPES_NUM>> chunk_curve_type_counts(
+      chunks_num, std::array<int, CURVE_TYPES_NUM>{});
+  threading::parallel_for(IndexRange(chunks_num), 1, [&](const IndexRange range) {
+    for (const int chunk : range) {
+      Vector<std::unique_ptr<GArray<>>> chunk_temporary_arrays;
+      GatherTasks tasks = gather_units(
+          chunk_units(chunk), chunk_offsets[chunk], chunk_temporary_arrays);
+      if (pointcloud_output) {
+        execute_realize_pointcloud_tasks(
+            options, all_pointclouds_info, tasks.pointcloud_tasks, *pointcloud_output);
+      }
+      if (mesh_output) {
+        execute_realize_mesh_tasks(options, all_meshes_info, tasks.mesh_tasks, *mesh_output);
+      }
+      if (curves_output) {
+        execute_realize_curve_tasks(options, all_curves_info, tasks.curve_tasks, *curves_output);
+        add_curve_type_counts(tasks.curve_tasks, chunk_curve_type_counts[chunk]);
+      }
+      chunk_volumes[chunk] = std::move(tasks.first_volume);
+      chunk_edit_data[chunk] = std::move(tasks.first_edit_data);
+    }
+  });
+
+  if (pointcloud_output) {
+    finish_pointcloud_output(*pointcloud_output);
+  }
+  if (mesh_output) {
+    finish_mesh_output(all_meshes_info, *mesh_output);
+  }
+  if (curves_output) {
+    std::array<int, CURVE_TYPES_NUM> type_counts{};
+    for (const std::array<int, CURVE_TYPES_NUM> &counts : chunk_curve_type_counts) {
+      for (const int i : IndexRange(CURVE_TYPES_NUM)) {
+        type_counts[i] += counts[i];
+      }
+    }
+    finish_curves_output(type_counts, *curves_output);
+  }
+
+  /* Like when all tasks are gathered at once, only the first volume and edit data are kept. */
+  for (const int chunk : IndexRange(chunks_num)) {
+    if (chunk_volumes[chunk]) {
+      r_realized_geometry.add(*chunk_volumes[chunk]);
+      break;
+    }
+  }
+  for (const int chunk : IndexRange(chunks_num)) {
+    if (chunk_edit_data[chunk]) {
+      r_realized_geometry.add(*chunk_edit_data[chunk]);
+      break;
+    }
+  }
 }
 
 /** \} */
@@ -1510,6 +2060,9 @@ bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
    * 2. Gather "tasks" that need to be executed to realize the instances. Each task corresponds to
    *    instances of the previously preprocessed geometry.
    * 3. Execute all tasks in parallel.
+   *
+   * With many instances, steps 2 and 3 are done in chunks of instances instead, see
+   * #realize_instances_chunked.
    */
 
   if (!geometry_set.has_instances()) {
@@ -1524,10 +2077,23 @@ bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
   AllMeshesInfo all_meshes_info = preprocess_meshes(geometry_set, options);
   AllCurvesInfo all_curves_info = preprocess_curves(geometry_set, options);
 
-  Vector<std::unique_ptr<GArray<>>> temporary_arrays;
   const bool create_id_attribute = all_pointclouds_info.create_id_attribute ||
                                    all_meshes_info.create_id_attribute ||
                                    all_curves_info.create_id_attribute;
+
+  bke::GeometrySet new_geometry_set;
+  if (use_chunked_realize(geometry_set)) {
+    realize_instances_chunked(options,
+                              geometry_set,
+                              all_pointclouds_info,
+                              all_meshes_info,
+                              all_curves_info,
+                              create_id_attribute,
+                              new_geometry_set);
+    return new_geometry_set;
+  }
+
+  Vector<std::unique_ptr<GArray<>>> temporary_arrays;
   GatherTasksInfo gather_info = {all_pointclouds_info,
                                  all_meshes_info,
                                  all_curves_info,
@@ -1537,23 +2103,10 @@ bke::GeometrySet realize_instances(bke::GeometrySet geometry_set,
   InstanceContext attribute_fallbacks(gather_info);
   gather_realize_tasks_recursive(gather_info, geometry_set, transform, attribute_fallbacks);
 
-  bke::GeometrySet new_geometry_set;
-  execute_realize_pointcloud_tasks(options,
-                                   all_pointclouds_info,
-                                   gather_info.r_tasks.pointcloud_tasks,
-                                   all_pointclouds_info.attributes,
-                                   new_geometry_set);
-  execute_realize_mesh_tasks(options,
-                             all_meshes_info,
-                             gather_info.r_tasks.mesh_tasks,
-                             all_meshes_info.attributes,
-                             all_meshes_info.materials,
-                             new_geometry_set);
-  execute_realize_curve_tasks(options,
-                              all_curves_info,
-                              gather_info.r_tasks.curve_tasks,
-                              all_curves_info.attributes,
-                              new_geometry_set);
+  realize_pointcloud_tasks(
+      options, all_pointclouds_info, gather_info.r_tasks.pointcloud_tasks, new_geometry_set);
+  realize_mesh_tasks(options, all_meshes_info, gather_info.r_tasks.mesh_tasks, new_geometry_set);
+  realize_curve_tasks(options, all_curves_info, gather_info.r_tasks.curve_tasks, new_geometry_set);
 
   if (gather_info.r_tasks.first_volume) {
     new_geometry_set.add(*gather_info.r_tasks.first_volume);
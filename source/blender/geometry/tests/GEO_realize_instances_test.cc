@@ -0,0 +1,369 @@
+/* SPDX-FileCopyrightText: 2023 Blender Foundation
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later */
+
+#include "testing/testing.h"
+
+#include "BLI_generic_virtual_array.hh"
+#include "BLI_math_euler_types.hh"
+#include "BLI_math_matrix.hh"
+
+#include "DNA_mesh_types.h"
+#include "DNA_pointcloud_types.h"
+
+#include "BKE_attribute.hh"
+#include "BKE_curves.hh"
+#include "BKE_geometry_set.hh"
+#include "BKE_idtype.h"
+#include "BKE_instances.hh"
+#include "BKE_mesh.hh"
+#include "BKE_pointcloud.h"
+
+#include "GEO_realize_instances.hh"
+
+namespace blender::geometry::tests {
+
+/** A quad and a triangle, with an id attribute and a generic face attribute. */
+static Mesh *create_mesh()
+{
+  Mesh *mesh = BKE_mesh_new_nomain(5, 0, 2, 7);
+  mesh->vert_positions_for_write().copy_from(
+      {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {2, 0.5f, 0.3f}});
+  mesh->face_offsets_for_write().copy_from({0, 4, 7});
+  mesh->corner_verts_for_write().copy_from({0, 1, 2, 3, 1, 4, 2});
+  BKE_mesh_calc_edges(mesh, false, false);
+
+  bke::MutableAttributeAccessor attributes = mesh->attributes_for_write();
+  bke::SpanAttributeWriter<int> ids = attributes.lookup_or_add_for_write_only_span<int>(
+      "id", ATTR_DOMAIN_POINT);
+  ids.span.copy_from({3, 1, 4, 1, 5});
+  ids.finish();
+  bke::SpanAttributeWriter<float> weights = attributes.lookup_or_add_for_write_only_span<float>(
+      "weight", ATTR_DOMAIN_FACE);
+  weights.span.copy_from({0.5f, 2.0f});
+  weights.finish();
+  return mesh;
+}
+
+/** Two curves of different types and sizes, with a generic point attribute. */
+static Curves *create_curves()
+{
+  Curves *curves_id = bke::curves_new_nomain(7, 2);
+  bke::CurvesGeometry &curves = curves_id->geometry.wrap();
+  curves.offsets_for_write().copy_from({0, 3, 7});
+  for (const int point : curves.points_range()) {
+    curves.positions_for_write()[point] = float3(point, point % 2, 0.0f);
+  }
+  curves.curve_types_for_write().copy_from({CURVE_TYPE_POLY, CURVE_TYPE_CATMULL_ROM});
+  curves.update_curve_types();
+
+  bke::SpanAttributeWriter<float> weights =
+      curves.attributes_for_write().lookup_or_add_for_write_only_span<float>("weight",
+                                                                             ATTR_DOMAIN_POINT);
+  for (const int point : curves.points_range()) {
+    weights.span[point] = point * 0.1f;
+  }
+  weights.finish();
+  return curves_id;
+}
+
+static PointCloud *create_pointcloud()
+{
+  PointCloud *pointcloud = BKE_pointcloud_new_nomain(3);
+  pointcloud->positions_for_write().copy_from({{0, 0, 1}, {0, 1, 1}, {1, 0, 1}});
+  return pointcloud;
+}
+
+/**
+ * Instances of a mesh, curves, a point cloud and nested mesh instances, for the given range of
+ * instance indices. The same index always gives the same instance, so that the instances of a
+ * range can be realized on their own and compared with the instances of a larger range.
+ */
+static bke::GeometrySet create_instances(const IndexRange range, const bool use_instance_ids)
+{
+  bke::Instances *nested_instances = new bke::Instances();
+  const int nested_handle = nested_instances->add_reference(
+      bke::GeometrySet::from_mesh(create_mesh()));
+  nested_instances->add_instance(nested_handle, float4x4::identity());
+  nested_instances->add_instance(nested_handle,
+                                 math::from_location<float4x4>(float3(0.0f, 0.0f, 2.0f)));
+
+  bke::Instances *instances = new bke::Instances();
+  const std::array<int, 4> handles = {
+      instances->add_reference(bke::GeometrySet::from_mesh(create_mesh())),
+      instances->add_reference(bke::GeometrySet::from_curves(create_curves())),
+      instances->add_reference(bke::GeometrySet::from_pointcloud(create_pointcloud())),
+      instances->add_reference(bke::GeometrySet::from_instances(nested_instances)),
+  };
+  for (const int i : range) {
+    const float4x4 transform = math::from_loc_rot<float4x4>(
+        float3(i % 71, i / 71, 0.0f), math::EulerXYZ(0.0f, 0.0f, i * 0.01f));
+    instances->add_instance(handles[i % handles.size()], transform);
+  }
+
+  bke::MutableAttributeAccessor attributes = instances->attributes_for_write();
+  bke::SpanAttributeWriter<float> weights = attributes.lookup_or_add_for_write_only_span<float>(
+      "instance_weight", ATTR_DOMAIN_INSTANCE);
+  for (const int i : range.index_range()) {
+    weights.span[i] = range[i] * 0.25f;
+  }
+  weights.finish();
+  if (use_instance_ids) {
+    bke::SpanAttributeWriter<int> ids = attributes.lookup_or_add_for_write_only_span<int>(
+        "id", ATTR_DOMAIN_INSTANCE);
+    for (const int i : range.index_range()) {
+      ids.span[i] = range[i] * 3 + 1;
+    }
+    ids.finish();
+  }
+
+  return bke::GeometrySet::from_instances(instances);
+}
+
+/**
+ * Check that the attributes of a part of the instances are the same as the elements of the whole
+ * result that start at the given index of every domain.
+ */
+static void expect_attributes_slice_equal(const bke::AttributeAccessor full,
+                                          const bke::AttributeAccessor part,
+                                          const FunctionRef<int(eAttrDomain)> domain_start,
+                                          const Span<StringRef> skip = {})
+{
+  part.for_all([&](const bke::AttributeIDRef &id, const bke::AttributeMetaData &meta_data) {
+    if (skip.contains(id.name())) {
+      return true;
+    }
+    const bke::GAttributeReader full_attribute = full.lookup(id);
+    EXPECT_TRUE(full_attribute) << id.name();
+    if (!full_attribute) {
+      return true;
+    }
+    EXPECT_EQ(full_attribute.domain, meta_data.domain) << id.name();
+    const GVArraySpan full_values(full_attribute.varray);
+    const GVArraySpan part_values(*part.lookup(id));
+    const CPPType &type = part_values.type();
+    EXPECT_EQ(full_values.type(), type);
+    const int start = domain_start(meta_data.domain);
+    for (const int i : IndexRange(part_values.size())) {
+      EXPECT_TRUE(type.is_equal(full_values[start + i], part_values[i]))
+          << id.name() << " " << i;
+    }
+    return true;
+  });
+}
+
+struct ResultStarts {
+  int point = 0;
+  int vert = 0;
+  int edge = 0;
+  int face = 0;
+  int corner = 0;
+  int curve_point = 0;
+  int curve = 0;
+};
+
+static void expect_mesh_slice_equal(const Mesh &full, const Mesh &part, const ResultStarts &starts)
+{
+  const Span<int2> full_edges = full.edges();
+  const Span<int2> part_edges = part.edges();
+  for (const int i : part_edges.index_range()) {
+    EXPECT_EQ(full_edges[starts.edge + i], part_edges[i] + int2(starts.vert));
+  }
+  const Span<int> full_face_offsets = full.face_offsets();
+  const Span<int> part_face_offsets = part.face_offsets();
+  for (const int i : part_face_offsets.index_range()) {
+    EXPECT_EQ(full_face_offsets[starts.face + i], part_face_offsets[i] + starts.corner);
+  }
+  const Span<int> full_corner_verts = full.corner_verts();
+  const Span<int> full_corner_edges = full.corner_edges();
+  const Span<int> part_corner_verts = part.corner_verts();
+  const Span<int> part_corner_edges = part.corner_edges();
+  for (const int i : part_corner_verts.index_range()) {
+    EXPECT_EQ(full_corner_verts[starts.corner + i], part_corner_verts[i] + starts.vert);
+    EXPECT_EQ(full_corner_edges[starts.corner + i], part_corner_edges[i] + starts.edge);
+  }
+
+  expect_attributes_slice_equal(
+      full.attributes(),
+      part.attributes(),
+      [&](const eAttrDomain domain) {
+        switch (domain) {
+          case ATTR_DOMAIN_POINT:
+            return starts.vert;
+          case ATTR_DOMAIN_EDGE:
+            return starts.edge;
+          case ATTR_DOMAIN_FACE:
+            return starts.face;
+          case ATTR_DOMAIN_CORNER:
+            return starts.corner;
+          default:
+            BLI_assert_unreachable();
+            return 0;
+        }
+      },
+      {".edge_verts", ".corner_vert", ".corner_edge"});
+}
+
+static void expect_curves_slice_equal(const bke::CurvesGeometry &full,
+                                      const bke::CurvesGeometry &part,
+                                      const ResultStarts &starts)
+{
+  const Span<int> full_offsets = full.offsets();
+  const Span<int> part_offsets = part.offsets();
+  for (const int i : part_offsets.index_range()) {
+    EXPECT_EQ(full_offsets[starts.curve + i], part_offsets[i] + starts.curve_point);
+  }
+
+  const auto domain_start = [&](const eAttrDomain domain) {
+    return domain == ATTR_DOMAIN_CURVE ? starts.curve : starts.curve_point;
+  };
+  expect_attributes_slice_equal(full.attributes(), part.attributes(), domain_start);
+}
+
+/**
+ * Check that the results of realizing consecutive parts of the instances are the same as the
+ * start of the result of realizing all instances at once.
+ */
+static void expect_parts_equal(const bke::GeometrySet &full,
+                               const Span<bke::GeometrySet> parts,
+                               const bool parts_cover_full)
+{
+  const Mesh &full_mesh = *full.get_mesh();
+  const bke::CurvesGeometry &full_curves = full.get_curves()->geometry.wrap();
+  const PointCloud &full_pointcloud = *full.get_pointcloud();
+
+  ResultStarts starts;
+  for (const bke::GeometrySet &part : parts) {
+    const Mesh &mesh = *part.get_mesh();
+    const bke::CurvesGeometry &curves = part.get_curves()->geometry.wrap();
+    const PointCloud &pointcloud = *part.get_pointcloud();
+
+    expect_mesh_slice_equal(full_mesh, mesh, starts);
+    expect_curves_slice_equal(full_curves, curves, starts);
+    expect_attributes_slice_equal(
+        full_pointcloud.attributes(), pointcloud.attributes(), [&](const eAttrDomain /*domain*/) {
+          return starts.point;
+        });
+
+    starts.vert += mesh.totvert;
+    starts.edge += mesh.totedge;
+    starts.face += mesh.faces_num;
+    starts.corner += mesh.totloop;
+    starts.curve_point += curves.points_num();
+    starts.curve += curves.curves_num();
+    starts.point += pointcloud.totpoint;
+  }
+
+  if (parts_cover_full) {
+    EXPECT_EQ(full_mesh.totvert, starts.vert);
+    EXPECT_EQ(full_mesh.totedge, starts.edge);
+    EXPECT_EQ(full_mesh.faces_num, starts.face);
+    EXPECT_EQ(full_mesh.totloop, starts.corner);
+    EXPECT_EQ(full_curves.points_num(), starts.curve_point);
+    EXPECT_EQ(full_curves.curves_num(), starts.curve);
+    EXPECT_EQ(full_pointcloud.totpoint, starts.point);
+  }
+}
+
+class RealizeInstancesTest : public testing::Test {
+ public:
+  static void SetUpTestSuite()
+  {
+    BKE_idtype_init();
+  }
+};
+
+/* Enough top-level instances to be realized in several chunks, the last one being partial. Parts
+ * of them have few enough instances to be realized with all tasks gathered at once. */
+static constexpr int chunked_instances_num = 5000;
+static constexpr int unchunked_instances_num = 2500;
+
+TEST_F(RealizeInstancesTest, ChunkedMatchesUnchunked)
+{
+  for (const bool keep_original_ids : {false, true}) {
+    RealizeInstancesOptions options;
+    options.keep_original_ids = keep_original_ids;
+
+    /* With ids on the instances, the ids of realized elements only depend on the instance. */
+    const bke::GeometrySet full = realize_instances(
+        create_instances(IndexRange(chunked_instances_num), true), options);
+    const std::array<bke::GeometrySet, 2> parts = {
+        realize_instances(create_instances(IndexRange(unchunked_instances_num), true), options),
+        realize_instances(create_instances(IndexRange(unchunked_instances_num,
+                                                      chunked_instances_num -
+                                                          unchunked_instances_num),
+                                           true),
+                          options)};
+    expect_parts_equal(full, parts, true);
+  }
+}
+
+TEST_F(RealizeInstancesTest, ChunkedMatchesUnchunkedWithoutInstanceIds)
+{
+  /* Without ids on the instances, the ids of realized elements depend on the instance indices,
+   * so only the first instances can be realized on their own. */
+  const RealizeInstancesOptions options;
+  const bke::GeometrySet full = realize_instances(
+      create_instances(IndexRange(chunked_instances_num), false), options);
+  const bke::GeometrySet part = realize_instances(
+      create_instances(IndexRange(unchunked_instances_num), false), options);
+  expect_parts_equal(full, {part}, false);
+}
+
+TEST_F(RealizeInstancesTest, SingleTaskSharesAttributes)
+{
+  const Mesh *src_mesh = create_mesh();
+  bke::Instances *instances = new bke::Instances();
+  const int handle = instances->add_reference(
+      bke::GeometrySet::from_mesh(const_cast<Mesh *>(src_mesh)));
+  instances->add_instance(handle, math::from_location<float4x4>(float3(1.0f, 2.0f, 3.0f)));
+  const bke::GeometrySet geometry = bke::GeometrySet::from_instances(instances);
+
+  bke::GeometrySet result = realize_instances(geometry, {});
+  const bke::GAttributeReader src_weights = src_mesh->attributes().lookup("weight");
+  const bke::GAttributeReader result_weights = result.get_mesh()->attributes().lookup("weight");
+  ASSERT_TRUE(result_weights);
+  EXPECT_EQ(result_weights.sharing_info, src_weights.sharing_info);
+  EXPECT_EQ(result_weights.varray.get_internal_span().data(),
+            src_weights.varray.get_internal_span().data());
+
+  /* The positions are transformed, so they are not shared. */
+  EXPECT_EQ(result.get_mesh()->vert_positions()[0], float3(1.0f, 2.0f, 3.0f));
+  EXPECT_EQ(src_mesh->vert_positions()[0], float3(0.0f));
+
+  /* Writing to the result makes a copy of the shared attribute. */
+  bke::SpanAttributeWriter<float> weights =
+      result.get_mesh_for_write()->attributes_for_write().lookup_for_write_span<float>("weight");
+  weights.span.fill(7.0f);
+  weights.finish();
+  const VArraySpan<float> src_values = *src_mesh->attributes().lookup<float>("weight");
+  EXPECT_EQ(src_values[0], 0.5f);
+  EXPECT_EQ(src_values[1], 2.0f);
+  EXPECT_EQ(result.get_mesh()->attributes().lookup<float>("weight").varray[1], 7.0f);
+}
+
+TEST_F(RealizeInstancesTest, MultipleTasksCopyAttributes)
+{
+  const Mesh *src_mesh = create_mesh();
+  bke::Instances *instances = new bke::Instances();
+  const int handle = instances->add_reference(
+      bke::GeometrySet::from_mesh(const_cast<Mesh *>(src_mesh)));
+  instances->add_instance(handle, float4x4::identity());
+  instances->add_instance(handle, math::from_location<float4x4>(float3(1.0f, 0.0f, 0.0f)));
+  const bke::GeometrySet geometry = bke::GeometrySet::from_instances(instances);
+
+  const bke::GeometrySet result = realize_instances(geometry, {});
+  const bke::GAttributeReader src_weights = src_mesh->attributes().lookup("weight");
+  const bke::GAttributeReader result_weights = result.get_mesh()->attributes().lookup("weight");
+  ASSERT_TRUE(result_weights);
+  EXPECT_NE(result_weights.varray.get_internal_span().data(),
+            src_weights.varray.get_internal_span().data());
+  const VArraySpan<float> values(result_weights.varray.typed<float>());
+  EXPECT_EQ(values.size(), 4);
+  EXPECT_EQ(values[0], 0.5f);
+  EXPECT_EQ(values[1], 2.0f);
+  EXPECT_EQ(values[2], 0.5f);
+  EXPECT_EQ(values[3], 2.0f);
+}
+
+}  // namespace blender::geometry::tests
@@ -135,6 +135,12 @@ typedef struct Image_Runtime {
   struct PartialUpdateRegister *partial_update_register;
   /** \brief Partial update user for GPUTextures stored inside the Image. */
   struct PartialUpdateUser *partial_update_user;
+  /**
+   * Changes whenever the image buffers are freed or updated, unique across all images, so that
+   * users caching data derived from the buffers can detect changes.
+   * See #BKE_image_update_count_bump.
+   */
+  uint64_t update_count;
 
 } Image_Runtime;
 
@@ -328,6 +328,16 @@ typedef struct Mesh {
    * Cached information about vertices that aren't used by faces (but may be used by loose edges).
    */
   const blender::bke::LooseVertCache &verts_no_face() const;
+  /**
+   * Cached map of the faces that use each vertex, in increasing face index order.
+   * Depends only on the face topology, so it is shared between meshes with the same topology.
+   */
+  blender::GroupedSpan<int> vert_to_face_map() const;
+  /**
+   * Cached map of the corners that use each vertex, in increasing corner index order. The groups
+   * match those of #vert_to_face_map(), each corner belonging to the face at the same position.
+   */
+  blender::GroupedSpan<int> vert_to_corner_map() const;
 
   /**
    * Explicitly set the cached number of loose edges to zero. This can improve performance
@@ -787,6 +787,8 @@ enum {
    * NOTE: DEPRECATED, use (id->tag & LIB_TAG_LOCALIZED) instead.
    */
   // NTREE_IS_LOCALIZED = 1 << 5,
+  /** Geometry nodes: reuse the outputs of the node group when its inputs did not change. */
+  NTREE_CACHE_EVALUATION = 1 << 6,
 };
 
 /* tree->execution_mode */
@@ -694,7 +694,9 @@ typedef struct UserDef_Experimental {
   char use_rotation_socket;
   char use_node_group_operators;
   char use_asset_shelf;
-  char _pad[7];
+  char use_realtime_compositor_cpu;
+  char use_sculpt_pbvh_sah;
+  char _pad[5];
   /** `makesdna` does not allow empty structs. */
 } UserDef_Experimental;
 
@@ -1793,6 +1793,15 @@ static void rna_def_modifier_subsurf(BlenderRNA *brna)
                            "levels of subdivision (smoothest possible shape)");
   RNA_def_property_update(prop, 0, "rna_Modifier_update");
 
+  prop = RNA_def_property(srna, "use_topology_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "flags", eSubsurfModifierFlag_UseTopologyCache);
+  RNA_def_property_ui_text(prop,
+                           "Cache Topology",
+                           "Keep the subdivided mesh and the limit surface weights of its "
+                           "vertices, so that when only the positions of the input mesh change, "
+                           "the result can be updated much faster, at the cost of more memory");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
   RNA_define_lib_overridable(false);
 }
 
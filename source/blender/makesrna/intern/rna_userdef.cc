@@ -6691,6 +6691,14 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
       "reduces execution time and memory usage)");
   RNA_def_property_update(prop, 0, "rna_userdef_update");
 
+  prop = RNA_def_property(srna, "use_realtime_compositor_cpu", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "use_realtime_compositor_cpu", 1);
+  RNA_def_property_ui_text(prop,
+                           "Realtime Compositor on CPU",
+                           "Evaluate the realtime compositor execution mode on the CPU instead of "
+                           "the GPU, only a subset of the nodes is supported");
+  RNA_def_property_update(prop, 0, "rna_userdef_update");
+
   prop = RNA_def_property(srna, "use_new_curves_tools", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, nullptr, "use_new_curves_tools", 1);
   RNA_def_property_ui_text(
@@ -6715,6 +6723,13 @@ static void rna_def_userdef_experimental(BlenderRNA *brna)
   RNA_def_property_boolean_sdna(prop, nullptr, "use_sculpt_texture_paint", 1);
   RNA_def_property_ui_text(prop, "Sculpt Texture Paint", "Use texture painting in Sculpt Mode");
 
+  prop = RNA_def_property(srna, "use_sculpt_pbvh_sah", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, nullptr, "use_sculpt_pbvh_sah", 1);
+  RNA_def_property_ui_text(prop,
+                           "Sculpt SAH Tree",
+                           "Split the Sculpt Mode acceleration structure with the surface area "
+                           "heuristic, giving tighter nodes at the cost of a slower build");
+
   prop = RNA_def_property(srna, "use_extended_asset_browser", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_ui_text(prop,
                            "Extended Asset Browser",
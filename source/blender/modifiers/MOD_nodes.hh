@@ -7,6 +7,9 @@
 struct NodesModifierData;
 struct Object;
 
+namespace blender::bke {
+class NodeGroupEvaluationCache;
+}
 namespace blender::bke::sim {
 class ModifierSimulationCache;
 }
@@ -35,6 +38,11 @@ struct NodesModifierRuntime {
    * used by the evaluated modifier.
    */
   std::shared_ptr<bke::sim::ModifierSimulationCache> simulation_cache;
+  /**
+   * Outputs of node groups that are reused when they are evaluated with the same inputs again.
+   * Like the simulation cache, it is shared between the original and evaluated modifier.
+   */
+  std::shared_ptr<bke::NodeGroupEvaluationCache> node_group_cache;
 };
 
 }  // namespace blender
@@ -110,6 +110,7 @@ static void init_data(ModifierData *md)
   MEMCPY_STRUCT_AFTER(nmd, DNA_struct_default_get(NodesModifierData), modifier);
   nmd->runtime = MEM_new<NodesModifierRuntime>(__func__);
   nmd->runtime->simulation_cache = std::make_shared<blender::bke::sim::ModifierSimulationCache>();
+  nmd->runtime->node_group_cache = std::make_shared<blender::bke::NodeGroupEvaluationCache>();
 }
 
 static void add_used_ids_from_sockets(const ListBase &sockets, Set<ID *> &ids)
@@ -875,6 +876,13 @@ static void modifyGeometry(ModifierData *md,
   find_side_effect_nodes(*nmd, *ctx, side_effect_nodes);
   modifier_eval_data.side_effect_nodes = &side_effect_nodes;
 
+  /* Only cache node group outputs for interactive updates. Otherwise, the active and render
+   * depsgraph would replace each other's entries in the shared cache. */
+  bke::NodeGroupEvaluationCache *node_group_cache = DEG_is_active(ctx->depsgraph) ?
+                                                        nmd->runtime->node_group_cache.get() :
+                                                        nullptr;
+  modifier_eval_data.node_group_cache = node_group_cache;
+
   bke::ModifierComputeContext modifier_compute_context{nullptr, nmd->modifier.name};
 
   geometry_set = nodes::execute_geometry_nodes_on_geometry(
@@ -889,6 +897,10 @@ static void modifyGeometry(ModifierData *md,
   if (logging_enabled(ctx)) {
     nmd_orig->runtime->eval_log = std::move(eval_log);
   }
+  if (node_group_cache) {
+    /* Free cached outputs of node groups that are not evaluated anymore. */
+    node_group_cache->remove_unused();
+  }
 
   if (use_orig_index_verts || use_orig_index_edges || use_orig_index_faces) {
     if (Mesh *mesh = geometry_set.get_mesh_for_write()) {
@@ -1481,6 +1493,7 @@ static void blend_read(BlendDataReader *reader, ModifierData *md)
   }
   nmd->runtime = MEM_new<NodesModifierRuntime>(__func__);
   nmd->runtime->simulation_cache = std::make_shared<bke::sim::ModifierSimulationCache>();
+  nmd->runtime->node_group_cache = std::make_shared<bke::NodeGroupEvaluationCache>();
 }
 
 static void copy_data(const ModifierData *md, ModifierData *target, const int flag)
@@ -1495,6 +1508,7 @@ static void copy_data(const ModifierData *md, ModifierData *target, const int fl
   if (flag & LIB_ID_COPY_SET_COPIED_ON_WRITE) {
     /* Share the simulation cache between the original and evaluated modifier. */
     tnmd->runtime->simulation_cache = nmd->runtime->simulation_cache;
+    tnmd->runtime->node_group_cache = nmd->runtime->node_group_cache;
     /* Keep bake path in the evaluated modifier. */
     tnmd->simulation_bake_directory = nmd->simulation_bake_directory ?
                                           BLI_strdup(nmd->simulation_bake_directory) :
@@ -1502,6 +1516,7 @@ static void copy_data(const ModifierData *md, ModifierData *target, const int fl
   }
   else {
     tnmd->runtime->simulation_cache = std::make_shared<bke::sim::ModifierSimulationCache>();
+    tnmd->runtime->node_group_cache = std::make_shared<bke::NodeGroupEvaluationCache>();
     /* Clear the bake path when duplicating. */
     tnmd->simulation_bake_directory = nullptr;
   }
@@ -104,6 +104,9 @@ static void free_runtime_data(void *runtime_data_v)
   if (runtime_data->subdiv_gpu != nullptr) {
     BKE_subdiv_free(runtime_data->subdiv_gpu);
   }
+  if (runtime_data->mesh_cache != nullptr) {
+    BKE_subdiv_mesh_cache_free(runtime_data->mesh_cache);
+  }
   MEM_freeN(runtime_data);
 }
 
@@ -162,6 +165,17 @@ static Mesh *subdiv_as_mesh(SubsurfModifierData *smd,
   if (mesh_settings.resolution < 3) {
     return result;
   }
+  SubsurfRuntimeData *runtime_data = (SubsurfRuntimeData *)smd->modifier.runtime;
+  if (smd->flags & eSubsurfModifierFlag_UseTopologyCache) {
+    if (runtime_data->mesh_cache == nullptr) {
+      runtime_data->mesh_cache = BKE_subdiv_mesh_cache_new();
+    }
+    return BKE_subdiv_to_mesh_cached(subdiv, &mesh_settings, mesh, runtime_data->mesh_cache);
+  }
+  if (runtime_data->mesh_cache != nullptr) {
+    BKE_subdiv_mesh_cache_free(runtime_data->mesh_cache);
+    runtime_data->mesh_cache = nullptr;
+  }
   result = BKE_subdiv_to_mesh(subdiv, &mesh_settings, mesh);
   return result;
 }
@@ -474,6 +488,7 @@ static void advanced_panel_draw(const bContext *C, Panel *panel)
   uiItemR(layout, ptr, "boundary_smooth", UI_ITEM_NONE, nullptr, ICON_NONE);
   uiItemR(layout, ptr, "use_creases", UI_ITEM_NONE, nullptr, ICON_NONE);
   uiItemR(layout, ptr, "use_custom_normals", UI_ITEM_NONE, nullptr, ICON_NONE);
+  uiItemR(layout, ptr, "use_topology_cache", UI_ITEM_NONE, nullptr, ICON_NONE);
 }
 
 static void panel_register(ARegionType *region_type)
@@ -28,6 +28,7 @@
 
 #include "BLI_compute_context.hh"
 
+#include "BKE_compute_contexts.hh"
 #include "BKE_node_tree_zones.hh"
 #include "BKE_simulation_state.hh"
 
@@ -79,6 +80,11 @@ struct GeoNodesModifierData {
    * If this is null, all socket values will be logged.
    */
   const Set<ComputeContextHash> *socket_log_contexts = nullptr;
+  /**
+   * Caches the outputs of node groups that have #NTREE_CACHE_EVALUATION enabled. It is shared
+   * across evaluations of the modifier. May be null.
+   */
+  bke::NodeGroupEvaluationCache *node_group_cache = nullptr;
 };
 
 struct GeoNodesOperatorData {
@@ -230,6 +236,17 @@ struct GeometryNodesLazyFunctionGraphInfo {
    * This can be used as a simple heuristic for the complexity of the node group.
    */
   int num_inline_nodes_approximate = 0;
+  /**
+   * Unique for every built graph. The graph is rebuilt whenever the node tree changes, so this can
+   * be used to detect that cached evaluation results are outdated.
+   */
+  uint64_t build_id = 0;
+  /**
+   * True when the evaluation of the node tree only depends on its inputs, i.e. it does not access
+   * objects, collections, the scene time or simulation state. Only then, outputs can be reused for
+   * the same inputs.
+   */
+  bool only_depends_on_inputs = false;
 };
 
 /**
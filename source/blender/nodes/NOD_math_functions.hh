@@ -53,7 +53,7 @@ inline bool try_dispatch_float_math_fl_to_fl(const int operation, Callback &&cal
     return false;
   }
 
-  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingle();
+  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingleSimd();
   static auto exec_preset_slow = mf::build::exec_presets::Materialized();
 
   /* This is just an utility function to keep the individual cases smaller. */
@@ -120,7 +120,7 @@ inline bool try_dispatch_float_math_fl_fl_to_fl(const int operation, Callback &&
     return false;
   }
 
-  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingle();
+  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingleSimd();
   static auto exec_preset_slow = mf::build::exec_presets::Materialized();
 
   /* This is just an utility function to keep the individual cases smaller. */
@@ -182,7 +182,7 @@ inline bool try_dispatch_float_math_fl_fl_fl_to_fl(const int operation, Callback
 
   switch (operation) {
     case NODE_MATH_MULTIPLY_ADD:
-      return dispatch(mf::build::exec_presets::AllSpanOrSingle(),
+      return dispatch(mf::build::exec_presets::AllSpanOrSingleSimd(),
                       [](float a, float b, float c) { return a * b + c; });
     case NODE_MATH_COMPARE:
       return dispatch(mf::build::exec_presets::SomeSpanOrSingle<0, 1>(),
@@ -216,7 +216,7 @@ inline bool try_dispatch_float_math_fl3_fl3_to_fl3(const NodeVectorMathOperation
     return false;
   }
 
-  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingle();
+  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingleSimd();
   static auto exec_preset_slow = mf::build::exec_presets::Materialized();
 
   /* This is just a utility function to keep the individual cases smaller. */
@@ -271,7 +271,7 @@ inline bool try_dispatch_float_math_fl3_fl3_to_fl(const NodeVectorMathOperation
     return false;
   }
 
-  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingle();
+  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingleSimd();
 
   /* This is just a utility function to keep the individual cases smaller. */
   auto dispatch = [&](auto exec_preset, auto math_function) -> bool {
@@ -304,7 +304,7 @@ inline bool try_dispatch_float_math_fl3_fl3_fl3_to_fl3(const NodeVectorMathOpera
     return false;
   }
 
-  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingle();
+  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingleSimd();
   static auto exec_preset_slow = mf::build::exec_presets::Materialized();
 
   /* This is just a utility function to keep the individual cases smaller. */
@@ -375,7 +375,7 @@ inline bool try_dispatch_float_math_fl3_to_fl(const NodeVectorMathOperation oper
     return false;
   }
 
-  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingle();
+  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingleSimd();
 
   /* This is just a utility function to keep the individual cases smaller. */
   auto dispatch = [&](auto exec_preset, auto math_function) -> bool {
@@ -404,7 +404,7 @@ inline bool try_dispatch_float_math_fl3_fl_to_fl3(const NodeVectorMathOperation
     return false;
   }
 
-  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingle();
+  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingleSimd();
 
   /* This is just a utility function to keep the individual cases smaller. */
   auto dispatch = [&](auto exec_preset, auto math_function) -> bool {
@@ -435,7 +435,7 @@ inline bool try_dispatch_float_math_fl3_to_fl3(const NodeVectorMathOperation ope
     return false;
   }
 
-  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingle();
+  static auto exec_preset_fast = mf::build::exec_presets::AllSpanOrSingleSimd();
   static auto exec_preset_slow = mf::build::exec_presets::Materialized();
 
   /* This is just a utility function to keep the individual cases smaller. */
@@ -107,7 +107,9 @@ class BlurOperation : public NodeOperation {
       return;
     }
 
+    /* Only the separable blur is implemented on the CPU, see is_node_supported_on_cpu. */
     if (use_variable_size()) {
+      BLI_assert(context().use_gpu());
       execute_variable_size();
     }
     else if (use_separable_filter()) {
@@ -126,6 +128,7 @@ class BlurOperation : public NodeOperation {
 
   void execute_constant_size()
   {
+    BLI_assert(context().use_gpu());
     GPUShader *shader = shader_manager().get("compositor_symmetric_blur");
     GPU_shader_bind(shader);
 
@@ -9,6 +9,10 @@
 #include "UI_interface.hh"
 #include "UI_resources.hh"
 
+#include "BLI_math_base.hh"
+#include "BLI_math_color.h"
+#include "BLI_math_vector_types.hh"
+
 #include "GPU_material.h"
 
 #include "COM_shader_node.hh"
@@ -60,7 +64,37 @@ class BrightContrastShaderNode : public ShaderNode {
                    GPU_constant(&use_premultiply));
   }
 
-  bool get_use_premultiply()
+  void compute_pixel(Span<float4> inputs, MutableSpan<float4> outputs) const override
+  {
+    float4 color = inputs[0];
+    const float brightness = inputs[1].x / 100.0f;
+    const float delta = inputs[2].x / 200.0f;
+
+    /* See the node_composite_bright_contrast shader function. */
+    float multiplier, offset;
+    if (inputs[2].x > 0.0f) {
+      multiplier = 1.0f / math::max(1.0f - delta * 2.0f, FLT_EPSILON);
+      offset = multiplier * (brightness - delta);
+    }
+    else {
+      multiplier = math::max(1.0f + delta * 2.0f, 0.0f);
+      offset = multiplier * brightness - delta;
+    }
+
+    if (get_use_premultiply()) {
+      premul_to_straight_v4(color);
+    }
+
+    float4 result = float4(color.xyz() * multiplier + offset, color.w);
+
+    if (get_use_premultiply()) {
+      straight_to_premul_v4(result);
+    }
+
+    outputs[0] = result;
+  }
+
+  bool get_use_premultiply() const
   {
     return bnode().custom1;
   }
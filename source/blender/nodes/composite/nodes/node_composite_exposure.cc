@@ -6,6 +6,9 @@
  * \ingroup cmpnodes
  */
 
+#include "BLI_math_base.hh"
+#include "BLI_math_vector_types.hh"
+
 #include "GPU_material.h"
 
 #include "COM_shader_node.hh"
@@ -38,6 +41,13 @@ class ExposureShaderNode : public ShaderNode {
 
     GPU_stack_link(material, &bnode(), "node_composite_exposure", inputs, outputs);
   }
+
+  void compute_pixel(Span<float4> inputs, MutableSpan<float4> outputs) const override
+  {
+    const float4 &color = inputs[0];
+    const float multiplier = math::pow(2.0f, inputs[1].x);
+    outputs[0] = float4(color.xyz() * multiplier, color.w);
+  }
 };
 
 static ShaderNode *get_compositor_shader_node(DNode node)
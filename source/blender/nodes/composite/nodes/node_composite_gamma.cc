@@ -6,6 +6,9 @@
  * \ingroup cmpnodes
  */
 
+#include "BLI_math_base.hh"
+#include "BLI_math_vector_types.hh"
+
 #include "GPU_material.h"
 
 #include "COM_shader_node.hh"
@@ -43,6 +46,22 @@ class GammaShaderNode : public ShaderNode {
 
     GPU_stack_link(material, &bnode(), "node_composite_gamma", inputs, outputs);
   }
+
+  void compute_pixel(Span<float4> inputs, MutableSpan<float4> outputs) const override
+  {
+    const float4 &color = inputs[0];
+    const float gamma = inputs[1].x;
+
+    /* Negative values are passed through, see fallback_pow in the shader library. */
+    float4 result = color;
+    for (int i = 0; i < 3; i++) {
+      if (color[i] > 0.0f || (color[i] == 0.0f && gamma > 0.0f)) {
+        result[i] = math::pow(color[i], gamma);
+      }
+    }
+
+    outputs[0] = result;
+  }
 };
 
 static ShaderNode *get_compositor_shader_node(DNode node)
@@ -11,6 +11,7 @@
 #include "BLI_linklist.h"
 #include "BLI_math_vector_types.hh"
 #include "BLI_rect.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_context.h"
@@ -25,6 +26,9 @@
 #include "DNA_scene_types.h"
 #include "DNA_vec_types.h"
 
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+
 #include "RE_engine.h"
 #include "RE_pipeline.h"
 
@@ -505,6 +509,11 @@ class ImageOperation : public NodeOperation {
     }
 
     ImageUser image_user = compute_image_user_for_output(identifier);
+    if (!context().use_gpu()) {
+      compute_output_cpu(identifier, image_user);
+      return;
+    }
+
     BKE_image_ensure_gpu_texture(get_image(), &image_user);
     GPUTexture *image_texture = BKE_image_get_gpu_texture(get_image(), &image_user, nullptr);
 
@@ -527,6 +536,40 @@ class ImageOperation : public NodeOperation {
     result.unbind_as_image();
   }
 
+  /* Computes the output when the compositor evaluates on the CPU by reading the image buffer
+   * directly, converting byte buffers to linear float buffers first like the GPU texture does. */
+  void compute_output_cpu(StringRef identifier, ImageUser &image_user)
+  {
+    Result &result = get_result(identifier);
+
+    void *lock;
+    ImBuf *image_buffer = BKE_image_acquire_ibuf(get_image(), &image_user, &lock);
+    if (image_buffer && !image_buffer->float_buffer.data) {
+      BLI_thread_lock(LOCK_IMAGE);
+      if (!image_buffer->float_buffer.data) {
+        IMB_float_from_rect(image_buffer);
+      }
+      BLI_thread_unlock(LOCK_IMAGE);
+    }
+
+    if (!image_buffer || !image_buffer->float_buffer.data) {
+      BKE_image_release_ibuf(get_image(), image_buffer, lock);
+      result.allocate_invalid();
+      return;
+    }
+
+    const int2 size = int2(image_buffer->x, image_buffer->y);
+    result.allocate_texture(Domain(size));
+
+    const bool is_alpha = identifier == "Alpha";
+    parallel_for(size, [&](const int2 texel) {
+      const float4 color = load_image_buffer_pixel(*image_buffer, texel);
+      result.store_pixel(texel, is_alpha ? float4(color.w, 0.0f, 0.0f, 0.0f) : color);
+    });
+
+    BKE_image_release_ibuf(get_image(), image_buffer, lock);
+  }
+
   /* Get a copy of the image user that is appropriate to retrieve the image buffer for the output
    * with the given identifier. This essentially sets the appropriate pass and view indices that
    * corresponds to the output. */
@@ -819,6 +862,11 @@ class RenderLayerOperation : public NodeOperation {
 
   void execute() override
   {
+    if (!context().use_gpu()) {
+      execute_cpu();
+      return;
+    }
+
     const Scene *scene = reinterpret_cast<const Scene *>(bnode().id);
     const int view_layer = bnode().custom1;
 
@@ -895,6 +943,69 @@ class RenderLayerOperation : public NodeOperation {
     GPU_texture_unbind(pass_texture);
     result.unbind_as_image();
   }
+
+  /* Executes when the compositor evaluates on the CPU, in which case, the passes are read from
+   * their image buffers instead of their textures. */
+  void execute_cpu()
+  {
+    const Scene *scene = reinterpret_cast<const Scene *>(bnode().id);
+    const int view_layer = bnode().custom1;
+
+    Result &image_result = get_result("Image");
+    Result &alpha_result = get_result("Alpha");
+
+    if (image_result.should_compute() || alpha_result.should_compute()) {
+      const ImBuf *combined_buffer = context().get_input_image_buffer(
+          scene, view_layer, RE_PASSNAME_COMBINED);
+      if (image_result.should_compute()) {
+        execute_pass_cpu(image_result, combined_buffer, false);
+      }
+      if (alpha_result.should_compute()) {
+        execute_pass_cpu(alpha_result, combined_buffer, true);
+      }
+    }
+
+    for (const bNodeSocket *output : this->node()->output_sockets()) {
+      if (STR_ELEM(output->identifier, "Image", "Alpha")) {
+        continue;
+      }
+
+      Result &result = get_result(output->identifier);
+      if (!result.should_compute()) {
+        continue;
+      }
+
+      const ImBuf *pass_buffer = context().get_input_image_buffer(
+          scene, view_layer, output->identifier);
+      execute_pass_cpu(result, pass_buffer, false);
+    }
+  }
+
+  /* CPU counterpart of execute_pass. If read_alpha is true, the alpha of the pass is read into
+   * the float result, otherwise, the pass is read as is and the result stores the channels it
+   * needs. */
+  void execute_pass_cpu(Result &result, const ImBuf *pass_buffer, const bool read_alpha)
+  {
+    if (pass_buffer == nullptr || pass_buffer->float_buffer.data == nullptr) {
+      /* Pass not rendered yet. */
+      result.allocate_invalid();
+      context().set_info_message("Viewport compositor setup not fully supported");
+      return;
+    }
+
+    /* The compositing space might be limited to a subset of the pass, so only read that
+     * compositing region into an appropriately sized result. */
+    const rcti compositing_region = context().get_compositing_region();
+    const int2 lower_bound = int2(compositing_region.xmin, compositing_region.ymin);
+
+    const int2 compositing_region_size = context().get_compositing_region_size();
+    result.allocate_texture(Domain(compositing_region_size));
+
+    parallel_for(compositing_region_size, [&](const int2 texel) {
+      const float4 color = load_image_buffer_pixel(*pass_buffer, texel + lower_bound);
+      result.store_pixel(texel, read_alpha ? float4(color.w, 0.0f, 0.0f, 0.0f) : color);
+    });
+  }
 };
 
 static NodeOperation *get_compositor_operation(Context &context, DNode node)
@@ -9,6 +9,9 @@
 #include "UI_interface.hh"
 #include "UI_resources.hh"
 
+#include "BLI_math_vector.hh"
+#include "BLI_math_vector_types.hh"
+
 #include "GPU_material.h"
 
 #include "COM_shader_node.hh"
@@ -70,12 +73,28 @@ class InvertShaderNode : public ShaderNode {
                    GPU_constant(&do_alpha));
   }
 
-  bool get_do_rgb()
+  void compute_pixel(Span<float4> inputs, MutableSpan<float4> outputs) const override
+  {
+    const float factor = inputs[0].x;
+    const float4 &color = inputs[1];
+
+    float4 inverted = color;
+    if (get_do_rgb()) {
+      inverted = float4(1.0f - color.xyz(), inverted.w);
+    }
+    if (get_do_alpha()) {
+      inverted.w = 1.0f - color.w;
+    }
+
+    outputs[0] = math::interpolate(color, inverted, factor);
+  }
+
+  bool get_do_rgb() const
   {
     return bnode().custom1 & CMP_CHAN_RGB;
   }
 
-  bool get_do_alpha()
+  bool get_do_alpha() const
   {
     return bnode().custom1 & CMP_CHAN_A;
   }
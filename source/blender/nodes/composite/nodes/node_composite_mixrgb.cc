@@ -7,6 +7,10 @@
  */
 
 #include "BLI_assert.h"
+#include "BLI_math_vector.hh"
+#include "BLI_math_vector_types.hh"
+
+#include "BKE_material.h"
 
 #include "DNA_material_types.h"
 
@@ -102,7 +106,29 @@ class MixRGBShaderNode : public ShaderNode {
              &get_output("Image").link);
   }
 
-  int get_mode()
+  void compute_pixel(Span<float4> inputs, MutableSpan<float4> outputs) const override
+  {
+    float factor = inputs[0].x;
+    const float4 &color1 = inputs[1];
+    const float4 &color2 = inputs[2];
+
+    if (get_use_alpha()) {
+      factor *= color2.w;
+    }
+
+    /* The blend only affects the color channels, the alpha of the first color is kept like in the
+     * mix shader functions. */
+    float4 result = color1;
+    ramp_blend(get_mode(), result, factor, color2);
+
+    if (get_should_clamp()) {
+      result = math::clamp(result, 0.0f, 1.0f);
+    }
+
+    outputs[0] = result;
+  }
+
+  int get_mode() const
   {
     return bnode().custom1;
   }
@@ -154,12 +180,12 @@ class MixRGBShaderNode : public ShaderNode {
     return nullptr;
   }
 
-  bool get_use_alpha()
+  bool get_use_alpha() const
   {
     return bnode().custom2 & SHD_MIXRGB_USE_ALPHA;
   }
 
-  bool get_should_clamp()
+  bool get_should_clamp() const
   {
     return bnode().custom2 & SHD_MIXRGB_CLAMP;
   }
@@ -72,6 +72,11 @@ class ViewerOperation : public NodeOperation {
 
   void execute() override
   {
+    if (!context().use_gpu()) {
+      execute_cpu();
+      return;
+    }
+
     const Result &image = get_input("Image");
     const Result &alpha = get_input("Alpha");
 
@@ -89,6 +94,23 @@ class ViewerOperation : public NodeOperation {
     }
   }
 
+  /* Executes when the compositor evaluates on the CPU, in which case, the output is written to
+   * the host-side output buffer of the context. */
+  void execute_cpu()
+  {
+    float *output_buffer = context().get_viewer_output_buffer();
+    if (!output_buffer) {
+      return;
+    }
+
+    write_output_to_buffer(context(),
+                           get_input("Image"),
+                           get_input("Alpha"),
+                           ignore_alpha(),
+                           node().input_by_identifier("Alpha")->is_logically_linked(),
+                           output_buffer);
+  }
+
   /* Executes when all inputs are single values, in which case, the output texture can just be
    * cleared to the appropriate color. */
   void execute_clear()
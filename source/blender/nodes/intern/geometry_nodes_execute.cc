@@ -561,6 +561,7 @@ bke::GeometrySet execute_geometry_nodes_on_geometry(
 
   lf::GraphExecutor graph_executor{
       lf_graph_info.graph, graph_inputs, graph_outputs, &lf_logger, &lf_side_effect_provider};
+  graph_executor.set_scheduling_mode(lf::GraphExecutor::SchedulingMode::WorkStealing);
 
   nodes::GeoNodesLFUserData user_data;
   fill_user_data(user_data);
@@ -20,6 +20,10 @@
  * complexity. So far, this does not seem to be a performance issue.
  */
 
+#include <mutex>
+
+#include "MEM_guardedalloc.h"
+
 #include "NOD_geometry_exec.hh"
 #include "NOD_geometry_nodes_lazy_function.hh"
 #include "NOD_multi_function.hh"
@@ -439,6 +443,7 @@ class LazyFunctionForRerouteNode : public LazyFunction {
   LazyFunctionForRerouteNode(const CPPType &type)
   {
     debug_name_ = "Reroute";
+    is_cheap_ = true;
     inputs_.append({"Input", type});
     outputs_.append({"Output", type});
   }
@@ -902,11 +907,164 @@ class LazyFunctionForGroupNode : public LazyFunction {
   std::optional<GeometryNodesLazyFunctionLogger> lf_logger_;
   std::optional<GeometryNodesLazyFunctionSideEffectProvider> lf_side_effect_provider_;
   std::optional<lf::GraphExecutor> graph_executor_;
+  /** Used to detect outdated cached outputs, see #GeometryNodesLazyFunctionGraphInfo::build_id. */
+  uint64_t group_build_id_ = 0;
+  bool group_only_depends_on_inputs_ = false;
+  /** Outputs that correspond to sockets of the group node. */
+  IndexRange main_output_indices_;
+  /** Inputs that tell the group which outputs are used. */
+  Vector<int> output_usage_input_indices_;
+
+  /**
+   * State of an evaluation that uses the #bke::NodeGroupEvaluationCache, which is kept between
+   * executions of the group node. See #execute_with_cache.
+   */
+  struct CacheState {
+    /** Entry for the compute context that may be reused, until its inputs have been compared. */
+    std::shared_ptr<const bke::NodeGroupEvaluationCache::Entry> candidate;
+    /** True when the cache can't be used anymore and the graph is evaluated instead. */
+    bool cache_checked = false;
+    bool was_added = false;
+    /** Passed to the graph for the inputs that tell which outputs are used. */
+    bool output_is_used = true;
+
+    /** Protects the recorded values, the graph executor may use multiple threads. */
+    std::mutex mutex;
+    /** Copies of the inputs that the graph used, null for inputs it did not use. */
+    Vector<GMutablePointer> inputs;
+    /** Copies of the outputs corresponding to group node sockets, once they are computed. */
+    Vector<GMutablePointer> outputs;
+    int outputs_recorded_num = 0;
+
+    CacheState(const int inputs_num, const int outputs_num)
+        : inputs(inputs_num, GMutablePointer()), outputs(outputs_num, GMutablePointer())
+    {
+    }
+
+    ~CacheState()
+    {
+      for (Vector<GMutablePointer> *values : {&inputs, &outputs}) {
+        for (GMutablePointer &value : *values) {
+          if (value.get() != nullptr) {
+            value.destruct();
+            MEM_freeN(value.get());
+          }
+        }
+      }
+    }
+
+    static void record(GMutablePointer &r_copy, const CPPType &type, const void *value)
+    {
+      void *buffer = MEM_mallocN_aligned(type.size(), type.alignment(), __func__);
+      type.copy_construct(value, buffer);
+      r_copy = {type, buffer};
+    }
+  };
 
   struct Storage {
     void *graph_executor_storage = nullptr;
     /* To avoid computing the hash more than once. */
     std::optional<ComputeContextHash> context_hash_cache;
+    std::unique_ptr<CacheState> cache_state;
+  };
+
+  /**
+   * Forwards the parameters of the group node to the graph executor, while recording the inputs
+   * that the graph uses and the outputs that it computes. All outputs that correspond to group
+   * node sockets are computed, even when the caller does not use them, so that they can be
+   * cached.
+   */
+  class CacheRecordingParams final : public lf::Params {
+   private:
+    const LazyFunctionForGroupNode &group_fn_;
+    lf::Params &params_;
+    CacheState &state_;
+
+   public:
+    CacheRecordingParams(const LazyFunctionForGroupNode &group_fn,
+                         lf::Params &params,
+                         CacheState &state)
+        : lf::Params(*group_fn.graph_executor_, false),
+          group_fn_(group_fn),
+          params_(params),
+          state_(state)
+    {
+    }
+
+   private:
+    bool is_output_usage_input(const int index) const
+    {
+      return group_fn_.output_usage_input_indices_.as_span().contains(index);
+    }
+
+    void *record_input(const int index, void *value) const
+    {
+      if (value != nullptr) {
+        std::lock_guard lock{state_.mutex};
+        if (state_.inputs[index].get() == nullptr) {
+          CacheState::record(state_.inputs[index], *group_fn_.inputs_[index].type, value);
+        }
+      }
+      return value;
+    }
+
+    void *try_get_input_data_ptr_impl(const int index) const override
+    {
+      if (this->is_output_usage_input(index)) {
+        return &state_.output_is_used;
+      }
+      return this->record_input(index, params_.try_get_input_data_ptr(index));
+    }
+
+    void *try_get_input_data_ptr_or_request_impl(const int index) override
+    {
+      if (this->is_output_usage_input(index)) {
+        return &state_.output_is_used;
+      }
+      return this->record_input(index, params_.try_get_input_data_ptr_or_request(index));
+    }
+
+    void *get_output_data_ptr_impl(const int index) override
+    {
+      return params_.get_output_data_ptr(index);
+    }
+
+    void output_set_impl(const int index) override
+    {
+      if (group_fn_.main_output_indices_.contains(index)) {
+        std::lock_guard lock{state_.mutex};
+        CacheState::record(state_.outputs[index],
+                           *group_fn_.outputs_[index].type,
+                           params_.get_output_data_ptr(index));
+        state_.outputs_recorded_num++;
+      }
+      params_.output_set(index);
+    }
+
+    bool output_was_set_impl(const int index) const override
+    {
+      return params_.output_was_set(index);
+    }
+
+    lf::ValueUsage get_output_usage_impl(const int index) const override
+    {
+      if (group_fn_.main_output_indices_.contains(index)) {
+        return lf::ValueUsage::Used;
+      }
+      return params_.get_output_usage(index);
+    }
+
+    void set_input_unused_impl(const int index) override
+    {
+      if (!this->is_output_usage_input(index)) {
+        params_.set_input_unused(index);
+      }
+    }
+
+    bool try_enable_multi_threading_impl() override
+    {
+      return params_.try_enable_multi_threading();
+    }
   };
 
  public:
@@ -931,6 +1089,9 @@ class LazyFunctionForGroupNode : public LazyFunction {
     }
 
     has_many_nodes_ = group_lf_graph_info.num_inline_nodes_approximate > 1000;
+    group_build_id_ = group_lf_graph_info.build_id;
+    group_only_depends_on_inputs_ = group_lf_graph_info.only_depends_on_inputs;
+    main_output_indices_ = outputs_.index_range();
 
     Vector<const lf::OutputSocket *> graph_inputs;
     /* Add inputs that also exist on the bnode. */
@@ -941,7 +1102,8 @@ class LazyFunctionForGroupNode : public LazyFunction {
       own_lf_graph_info.mapping.lf_input_index_for_output_bsocket_usage
           [group_node.output_socket(i).index_in_all_outputs()] = graph_inputs.append_and_get_index(
           group_lf_graph_info.mapping.group_output_used_sockets[i]);
-      inputs_.append_as("Output is Used", CPPType::get<bool>(), lf::ValueUsage::Maybe);
+      output_usage_input_indices_.append(inputs_.append_and_get_index_as(
+          "Output is Used", CPPType::get<bool>(), lf::ValueUsage::Maybe));
     }
 
     /* Add an attribute set input for every output geometry socket that can propagate attributes
@@ -979,6 +1141,7 @@ class LazyFunctionForGroupNode : public LazyFunction {
                             std::move(graph_outputs),
                             &*lf_logger_,
                             &*lf_side_effect_provider_);
+    graph_executor_->set_scheduling_mode(lf::GraphExecutor::SchedulingMode::WorkStealing);
   }
 
   void execute_impl(lf::Params &params, const lf::Context &context) const override
@@ -1011,9 +1174,151 @@ class LazyFunctionForGroupNode : public LazyFunction {
     lf::Context group_context{
         storage->graph_executor_storage, &group_user_data, &group_local_user_data};
 
+    if (bke::NodeGroupEvaluationCache *cache = this->get_cache(group_user_data)) {
+      this->execute_with_cache(params, group_context, *cache, *storage);
+      return;
+    }
+
     graph_executor_->execute(params, group_context);
   }
 
+  /**
+   * The cache is only used when the group is evaluated as part of a modifier and the user can't
+   * expect to see values or side effects of nodes inside the group.
+   */
+  bke::NodeGroupEvaluationCache *get_cache(const GeoNodesLFUserData &group_user_data) const
+  {
+    if (!group_only_depends_on_inputs_) {
+      return nullptr;
+    }
+    const bNodeTree *group = reinterpret_cast<const bNodeTree *>(group_node_.id);
+    if (group == nullptr || !(group->flag & NTREE_CACHE_EVALUATION)) {
+      return nullptr;
+    }
+    const GeoNodesModifierData *modifier_data = group_user_data.modifier_data;
+    if (modifier_data == nullptr || modifier_data->node_group_cache == nullptr) {
+      return nullptr;
+    }
+    if (group_user_data.log_socket_values) {
+      return nullptr;
+    }
+    if (modifier_data->side_effect_nodes &&
+        !modifier_data->side_effect_nodes->lookup(group_user_data.compute_context->hash())
+             .is_empty())
+    {
+      return nullptr;
+    }
+    return modifier_data->node_group_cache;
+  }
+
+  /**
+   * Evaluate the group lazily like without the cache, but compute all outputs and record the
+   * inputs that the graph uses, so that the outputs can be reused when the group is evaluated
+   * with the same values for those inputs again. Inputs that the graph does not request don't
+   * have to be computed, and are ignored when comparing the inputs.
+   */
+  void execute_with_cache(lf::Params &params,
+                          const lf::Context &group_context,
+                          bke::NodeGroupEvaluationCache &cache,
+                          Storage &storage) const
+  {
+    const GeoNodesLFUserData &group_user_data = *static_cast<GeoNodesLFUserData *>(
+        group_context.user_data);
+    const ComputeContextHash &context_hash = group_user_data.compute_context->hash();
+
+    if (!storage.cache_state) {
+      storage.cache_state = std::make_unique<CacheState>(inputs_.size(),
+                                                         main_output_indices_.size());
+    }
+    CacheState &state = *storage.cache_state;
+
+    if (!state.cache_checked) {
+      if (!state.candidate) {
+        state.candidate = cache.find(context_hash);
+      }
+      if (state.candidate) {
+        /* The graph is deterministic, so it requests the same inputs as long as their values
+         * are the same. Only those inputs are needed to check whether the entry can be reused. */
+        bool all_inputs_available = true;
+        for (const int i : state.candidate->input_indices) {
+          if (params.try_get_input_data_ptr_or_request(i) == nullptr) {
+            all_inputs_available = false;
+          }
+        }
+        if (!all_inputs_available) {
+          /* Wait until the inputs are computed. */
+          return;
+        }
+        Vector<GPointer, 16> inputs;
+        bke::NodeGroupInputsHashBuilder inputs_hash_builder{group_build_id_};
+        for (const int i : state.candidate->input_indices) {
+          const GPointer value{inputs_[i].type, params.try_get_input_data_ptr(i)};
+          inputs.append(value);
+          inputs_hash_builder.mix_in(&i, sizeof(i));
+          inputs_hash_builder.mix_in_value(value);
+        }
+        if (inputs_hash_builder.is_cacheable()) {
+          if (const std::shared_ptr<const bke::NodeGroupEvaluationCache::Entry> entry =
+                  cache.lookup(context_hash, inputs_hash_builder.hash(), inputs))
+          {
+            this->set_outputs_from_cache(params, *entry);
+            return;
+          }
+        }
+      }
+      state.candidate.reset();
+      state.cache_checked = true;
+    }
+
+    CacheRecordingParams recording_params{*this, params, state};
+    graph_executor_->execute(recording_params, group_context);
+
+    if (state.outputs_recorded_num < main_output_indices_.size() || state.was_added) {
+      return;
+    }
+    state.was_added = true;
+
+    Vector<int, 16> input_indices;
+    Vector<GPointer, 16> inputs;
+    bke::NodeGroupInputsHashBuilder inputs_hash_builder{group_build_id_};
+    for (const int i : inputs_.index_range()) {
+      const GMutablePointer value = state.inputs[i];
+      if (value.get() == nullptr) {
+        continue;
+      }
+      input_indices.append(i);
+      inputs.append(value);
+      inputs_hash_builder.mix_in(&i, sizeof(i));
+      inputs_hash_builder.mix_in_value(value);
+    }
+    if (!inputs_hash_builder.is_cacheable()) {
+      return;
+    }
+    Vector<GPointer, 16> outputs;
+    for (const GMutablePointer value : state.outputs) {
+      outputs.append(value);
+    }
+    cache.add(context_hash, inputs_hash_builder.hash(), input_indices, inputs, outputs);
+  }
+
+  void set_outputs_from_cache(lf::Params &params,
+                              const bke::NodeGroupEvaluationCache::Entry &entry) const
+  {
+    for (const int i : main_output_indices_) {
+      if (params.output_was_set(i)) {
+        continue;
+      }
+      const CPPType &type = *outputs_[i].type;
+      type.copy_construct(entry.outputs[i].get(), params.get_output_data_ptr(i));
+      params.output_set(i);
+    }
+    for (const auto item : lf_output_for_input_bsocket_usage_.items()) {
+      if (!params.output_was_set(item.value)) {
+        params.set_output(item.value, entry.input_indices.as_span().contains(item.key));
+      }
+    }
+  }
+
   void *init_storage(LinearAllocator<> &allocator) const override
   {
     Storage *s = allocator.construct<Storage>().release();
@@ -1127,6 +1432,7 @@ class LazyFunctionForLogicalOr : public lf::LazyFunction {
   LazyFunctionForLogicalOr(const int inputs_num)
   {
     debug_name_ = "Logical Or";
+    is_cheap_ = true;
     for ([[maybe_unused]] const int i : IndexRange(inputs_num)) {
       inputs_.append_as("Input", CPPType::get<bool>(), lf::ValueUsage::Maybe);
     }
@@ -1164,6 +1470,7 @@ class LazyFunctionForSwitchSocketUsage : public lf::LazyFunction {
   LazyFunctionForSwitchSocketUsage()
   {
     debug_name_ = "Switch Socket Usage";
+    is_cheap_ = true;
     inputs_.append_as("Condition", CPPType::get<ValueOrField<bool>>());
     outputs_.append_as("False", CPPType::get<bool>());
     outputs_.append_as("True", CPPType::get<bool>());
@@ -1242,6 +1549,7 @@ class LazyFunctionForAnonymousAttributeSetJoin : public lf::LazyFunction {
   LazyFunctionForAnonymousAttributeSetJoin(const int amount) : amount_(amount)
   {
     debug_name_ = "Join Attribute Sets";
+    is_cheap_ = true;
     for ([[maybe_unused]] const int i : IndexRange(amount)) {
       inputs_.append_as("Use", CPPType::get<bool>());
       inputs_.append_as(
@@ -1974,8 +2282,9 @@ struct GeometryNodesLazyFunctionGraphBuilder {
     auto &logger = scope_.construct<GeometryNodesLazyFunctionLogger>(*lf_graph_info_);
     auto &side_effect_provider = scope_.construct<GeometryNodesLazyFunctionSideEffectProvider>();
 
-    const auto &lf_graph_fn = scope_.construct<lf::GraphExecutor>(
+    auto &lf_graph_fn = scope_.construct<lf::GraphExecutor>(
         lf_graph, lf_zone_inputs, lf_zone_outputs, &logger, &side_effect_provider);
+    lf_graph_fn.set_scheduling_mode(lf::GraphExecutor::SchedulingMode::WorkStealing);
     const auto &zone_function = scope_.construct<LazyFunctionForSimulationZone>(*zone.output_node,
                                                                                 lf_graph_fn);
     zone_info.lazy_function = &zone_function;
@@ -2102,8 +2411,9 @@ struct GeometryNodesLazyFunctionGraphBuilder {
 
     auto &logger = scope_.construct<GeometryNodesLazyFunctionLogger>(*lf_graph_info_);
     auto &side_effect_provider = scope_.construct<GeometryNodesLazyFunctionSideEffectProvider>();
-    LazyFunction &body_graph_fn = scope_.construct<lf::GraphExecutor>(
+    auto &body_graph_fn = scope_.construct<lf::GraphExecutor>(
         lf_body_graph, lf_body_inputs, lf_body_outputs, &logger, &side_effect_provider);
+    body_graph_fn.set_scheduling_mode(lf::GraphExecutor::SchedulingMode::WorkStealing);
 
     // std::cout << "\n\n" << lf_body_graph.to_dot() << "\n\n";
 
@@ -3799,6 +4109,50 @@ struct GeometryNodesLazyFunctionGraphBuilder {
   }
 };
 
+/**
+ * Check if evaluating the node tree gives the same result whenever the inputs are the same.
+ */
+static bool node_tree_only_depends_on_inputs(const bNodeTree &btree)
+{
+  for (const bNode *node : btree.all_nodes()) {
+    if (ELEM(node->type,
+             GEO_NODE_SIMULATION_INPUT,
+             GEO_NODE_SIMULATION_OUTPUT,
+             GEO_NODE_INPUT_SCENE_TIME,
+             GEO_NODE_IS_VIEWPORT))
+    {
+      return false;
+    }
+    for (const Span<const bNodeSocket *> sockets : {node->input_sockets(), node->output_sockets()})
+    {
+      for (const bNodeSocket *socket : sockets) {
+        if (ELEM(socket->type,
+                 SOCK_OBJECT,
+                 SOCK_COLLECTION,
+                 SOCK_IMAGE,
+                 SOCK_MATERIAL,
+                 SOCK_TEXTURE))
+        {
+          /* Referenced data-blocks may change without the node tree changing. */
+          return false;
+        }
+      }
+    }
+    if (node->is_group()) {
+      const bNodeTree *group = reinterpret_cast<const bNodeTree *>(node->id);
+      if (group == nullptr) {
+        continue;
+      }
+      const GeometryNodesLazyFunctionGraphInfo *group_lf_graph_info =
+          ensure_geometry_nodes_lazy_function_graph(*group);
+      if (group_lf_graph_info == nullptr || !group_lf_graph_info->only_depends_on_inputs) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 const GeometryNodesLazyFunctionGraphInfo *ensure_geometry_nodes_lazy_function_graph(
     const bNodeTree &btree)
 {
@@ -3847,6 +4201,10 @@ const GeometryNodesLazyFunctionGraphInfo *ensure_geometry_nodes_lazy_function_gr
   GeometryNodesLazyFunctionGraphBuilder builder{btree, *lf_graph_info};
   builder.build();
 
+  static std::atomic<uint64_t> build_counter = 0;
+  lf_graph_info->build_id = ++build_counter;
+  lf_graph_info->only_depends_on_inputs = node_tree_only_depends_on_inputs(btree);
+
   lf_graph_info_ptr = std::move(lf_graph_info);
   return lf_graph_info_ptr.get();
 }
@@ -136,6 +136,10 @@ typedef struct RenderResult {
   struct StampData *stamp_data;
 
   bool passes_allocated;
+
+  /* Changes whenever the passes are written, unique across all render results, so that users
+   * caching data derived from the passes can detect changes. */
+  uint64_t update_count;
 } RenderResult;
 
 typedef struct RenderStats {
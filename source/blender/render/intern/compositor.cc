@@ -15,6 +15,8 @@
 #include "BKE_node.hh"
 #include "BKE_scene.h"
 
+#include "DNA_userdef_types.h"
+
 #include "DRW_engine.h"
 
 #include "IMB_colormanagement.h"
@@ -35,9 +37,15 @@ namespace blender::render {
 /* Render Texture Pool */
 
 class TexturePool : public realtime_compositor::TexturePool {
+ private:
+  /* If false, no textures are allocated and the compositor evaluates on the CPU. */
+  bool use_gpu_;
+
  public:
   Vector<GPUTexture *> textures_;
 
+  TexturePool(const bool use_gpu) : use_gpu_(use_gpu) {}
+
   virtual ~TexturePool()
   {
     for (GPUTexture *texture : textures_) {
@@ -59,6 +67,11 @@ class TexturePool : public realtime_compositor::TexturePool {
     return texture;
 #endif
   }
+
+  bool use_gpu() const override
+  {
+    return use_gpu_;
+  }
 };
 
 /**
@@ -102,6 +115,14 @@ class Context : public realtime_compositor::Context {
   /* Viewer output texture. */
   GPUTexture *viewer_output_texture_ = nullptr;
 
+  /* Output combined and viewer buffers, used instead of the textures when the compositor
+   * evaluates on the CPU. */
+  float *output_buffer_ = nullptr;
+  float *viewer_output_buffer_ = nullptr;
+
+  /* Render pass image buffers referenced during the evaluation on the CPU. */
+  Vector<ImBuf *> input_image_buffers_;
+
   /* Texture pool. */
   TexturePool &render_texture_pool_;
 
@@ -117,6 +138,9 @@ class Context : public realtime_compositor::Context {
   {
     GPU_TEXTURE_FREE_SAFE(output_texture_);
     GPU_TEXTURE_FREE_SAFE(viewer_output_texture_);
+    MEM_SAFE_FREE(output_buffer_);
+    MEM_SAFE_FREE(viewer_output_buffer_);
+    release_input_image_buffers();
   }
 
   void update_input_data(const ContextInputData &input_data)
@@ -214,6 +238,74 @@ class Context : public realtime_compositor::Context {
     return viewer_output_texture_;
   }
 
+  float *get_output_buffer() override
+  {
+    if (output_buffer_ == nullptr) {
+      const int2 size = get_render_size();
+      output_buffer_ = static_cast<float *>(
+          MEM_calloc_arrayN(size_t(size.x) * size_t(size.y), sizeof(float[4]), __func__));
+    }
+
+    return output_buffer_;
+  }
+
+  float *get_viewer_output_buffer() override
+  {
+    if (viewer_output_buffer_ == nullptr) {
+      const int2 size = get_render_size();
+      viewer_output_buffer_ = static_cast<float *>(
+          MEM_calloc_arrayN(size_t(size.x) * size_t(size.y), sizeof(float[4]), __func__));
+    }
+
+    return viewer_output_buffer_;
+  }
+
+  const ImBuf *get_input_image_buffer(const Scene *scene,
+                                      int view_layer_id,
+                                      const char *pass_name) override
+  {
+    Render *re = RE_GetSceneRender(scene);
+    RenderResult *rr = nullptr;
+    ImBuf *input_buffer = nullptr;
+
+    if (re) {
+      rr = RE_AcquireResultRead(re);
+    }
+
+    if (rr) {
+      ViewLayer *view_layer = (ViewLayer *)BLI_findlink(&scene->view_layers, view_layer_id);
+      if (view_layer) {
+        RenderLayer *rl = RE_GetRenderLayer(rr, view_layer->name);
+        if (rl) {
+          RenderPass *rpass = (RenderPass *)BLI_findstring(
+              &rl->passes, pass_name, offsetof(RenderPass, name));
+
+          if (rpass && rpass->ibuf && rpass->ibuf->float_buffer.data) {
+            /* Don't assume render keeps the buffer around, add our own reference. */
+            input_buffer = rpass->ibuf;
+            IMB_refImBuf(input_buffer);
+            input_image_buffers_.append(input_buffer);
+          }
+        }
+      }
+    }
+
+    if (re) {
+      RE_ReleaseResult(re);
+      re = nullptr;
+    }
+
+    return input_buffer;
+  }
+
+  void release_input_image_buffers()
+  {
+    for (ImBuf *input_buffer : input_image_buffers_) {
+      IMB_freeImBuf(input_buffer);
+    }
+    input_image_buffers_.clear();
+  }
+
   GPUTexture *get_input_texture(const Scene *scene,
                                 int view_layer_id,
                                 const char *pass_name) override
@@ -277,7 +369,7 @@ class Context : public realtime_compositor::Context {
 
   void output_to_render_result()
   {
-    if (!output_texture_) {
+    if (!output_texture_ && !output_buffer_) {
       return;
     }
 
@@ -287,8 +379,16 @@ class Context : public realtime_compositor::Context {
     if (rr) {
       RenderView *rv = RE_RenderViewGetByName(rr, input_data_.view_name.c_str());
 
-      GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
-      float *output_buffer = (float *)GPU_texture_read(output_texture_, GPU_DATA_FLOAT, 0);
+      float *output_buffer = nullptr;
+      if (output_buffer_) {
+        /* The render result takes ownership of the buffer, a new one is allocated next time. */
+        output_buffer = output_buffer_;
+        output_buffer_ = nullptr;
+      }
+      else {
+        GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
+        output_buffer = (float *)GPU_texture_read(output_texture_, GPU_DATA_FLOAT, 0);
+      }
 
       if (output_buffer) {
         ImBuf *ibuf = RE_RenderViewEnsureImBuf(rr, rv);
@@ -314,7 +414,7 @@ class Context : public realtime_compositor::Context {
 
   void viewer_output_to_viewer_image()
   {
-    if (!viewer_output_texture_) {
+    if (!viewer_output_texture_ && !viewer_output_buffer_) {
       return;
     }
 
@@ -348,8 +448,15 @@ class Context : public realtime_compositor::Context {
     BKE_image_release_ibuf(image, image_buffer, lock);
     BLI_thread_unlock(LOCK_DRAW_IMAGE);
 
-    GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
-    float *output_buffer = (float *)GPU_texture_read(viewer_output_texture_, GPU_DATA_FLOAT, 0);
+    float *output_buffer = nullptr;
+    if (viewer_output_buffer_) {
+      output_buffer = viewer_output_buffer_;
+      viewer_output_buffer_ = nullptr;
+    }
+    else {
+      GPU_memory_barrier(GPU_BARRIER_TEXTURE_UPDATE);
+      output_buffer = (float *)GPU_texture_read(viewer_output_texture_, GPU_DATA_FLOAT, 0);
+    }
 
     std::memcpy(image_buffer->float_buffer.data,
                 output_buffer,
@@ -371,23 +478,37 @@ class RealtimeCompositor {
   /* Render instance for GPU context to run compositor in. */
   Render &render_;
 
+  /* If false, the compositor evaluates on the CPU and no GPU context is needed. */
+  bool use_gpu_;
+
   std::unique_ptr<TexturePool> texture_pool_;
   std::unique_ptr<Context> context_;
 
  public:
-  RealtimeCompositor(Render &render, const ContextInputData &input_data) : render_(render)
+  RealtimeCompositor(Render &render, const ContextInputData &input_data, const bool use_gpu)
+      : render_(render), use_gpu_(use_gpu)
   {
     BLI_assert(!BLI_thread_is_main());
 
     /* Create resources with GPU context enabled. */
-    DRW_render_context_enable(&render_);
-    texture_pool_ = std::make_unique<TexturePool>();
+    if (use_gpu_) {
+      DRW_render_context_enable(&render_);
+    }
+    texture_pool_ = std::make_unique<TexturePool>(use_gpu_);
     context_ = std::make_unique<Context>(input_data, *texture_pool_);
-    DRW_render_context_disable(&render_);
+    if (use_gpu_) {
+      DRW_render_context_disable(&render_);
+    }
   }
 
   ~RealtimeCompositor()
   {
+    if (!use_gpu_) {
+      context_.reset();
+      texture_pool_.reset();
+      return;
+    }
+
     /* Free resources with GPU context enabled. Cleanup may happen from the
      * main thread, and we must use the main context there. */
     if (BLI_thread_is_main()) {
@@ -408,12 +529,19 @@ class RealtimeCompositor {
     }
   }
 
+  bool use_gpu() const
+  {
+    return use_gpu_;
+  }
+
   /* Evaluate the compositor and output to the scene render result. */
   void execute(const ContextInputData &input_data)
   {
     BLI_assert(!BLI_thread_is_main());
 
-    DRW_render_context_enable(&render_);
+    if (use_gpu_) {
+      DRW_render_context_enable(&render_);
+    }
     context_->update_input_data(input_data);
 
     /* Always recreate the evaluator, as this only runs on compositing node changes and
@@ -425,7 +553,10 @@ class RealtimeCompositor {
 
     context_->output_to_render_result();
     context_->viewer_output_to_viewer_image();
-    DRW_render_context_disable(&render_);
+    context_->release_input_image_buffers();
+    if (use_gpu_) {
+      DRW_render_context_disable(&render_);
+    }
   }
 };
 
@@ -442,8 +573,15 @@ void Render::compositor_execute(const Scene &scene,
   blender::render::ContextInputData input_data(
       scene, render_data, node_tree, use_file_output, view_name);
 
+  /* Recreate the compositor if the evaluation device changed since it was created. */
+  const bool use_gpu = !U.experimental.use_realtime_compositor_cpu;
+  if (gpu_compositor != nullptr && gpu_compositor->use_gpu() != use_gpu) {
+    delete gpu_compositor;
+    gpu_compositor = nullptr;
+  }
+
   if (gpu_compositor == nullptr) {
-    gpu_compositor = new blender::render::RealtimeCompositor(*this, input_data);
+    gpu_compositor = new blender::render::RealtimeCompositor(*this, input_data, use_gpu);
   }
 
   gpu_compositor->execute(input_data);
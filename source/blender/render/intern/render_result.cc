@@ -13,6 +13,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "BLI_ghash.h"
 #include "BLI_hash_md5.h"
 #include "BLI_implicit_sharing.hh"
@@ -250,6 +252,7 @@ RenderResult *render_result_new(Render *re,
   rr = MEM_cnew<RenderResult>("new render result");
   rr->rectx = rectx;
   rr->recty = recty;
+  render_result_tag_updated(rr);
 
   /* tilerect is relative coordinates within render disprect. do not subtract crop yet */
   rr->tilerect.xmin = partrct->xmin - re->disprect.xmin;
@@ -673,6 +676,7 @@ RenderResult *render_result_new_from_exr(
 
   rr->rectx = rectx;
   rr->recty = recty;
+  render_result_tag_updated(rr);
 
   IMB_exr_multilayer_convert(exrhandle, rr, ml_addview_cb, ml_addlayer_cb, ml_addpass_cb);
 
@@ -729,6 +733,14 @@ void render_result_views_new(RenderResult *rr, const RenderData *rd)
   }
 }
 
+/*********************************** Update **********************************/
+
+void render_result_tag_updated(RenderResult *rr)
+{
+  static uint64_t update_count = 0;
+  rr->update_count = atomic_add_and_fetch_uint64(&update_count, 1);
+}
+
 /*********************************** Merge ***********************************/
 
 static void do_merge_tile(
@@ -790,6 +802,8 @@ void render_result_merge(RenderResult *rr, RenderResult *rrpart)
       }
     }
   }
+
+  render_result_tag_updated(rr);
 }
 
 /**************************** Single Layer Rendering *************************/
@@ -931,6 +945,9 @@ bool render_result_exr_file_read_path(RenderResult *rr,
 
   if (found_channels) {
     IMB_exr_read_channels(exrhandle);
+    if (rr) {
+      render_result_tag_updated(rr);
+    }
   }
 
   IMB_exr_close(exrhandle);
@@ -53,6 +53,13 @@ struct RenderResult *render_result_new_from_exr(
 void render_result_view_new(struct RenderResult *rr, const char *viewname);
 void render_result_views_new(struct RenderResult *rr, const struct RenderData *rd);
 
+/* Update */
+
+/**
+ * Give the render result a new #RenderResult.update_count, to be called after writing passes.
+ */
+void render_result_tag_updated(struct RenderResult *rr);
+
 /* Merge */
 
 /**
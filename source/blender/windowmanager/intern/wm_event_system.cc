@@ -17,6 +17,7 @@
 #include "AS_asset_library.h"
 
 #include "DNA_listBase.h"
+#include "DNA_node_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_screen_types.h"
 #include "DNA_userdef_types.h"
@@ -84,6 +85,8 @@
 
 #include "RE_pipeline.h"
 
+#include "COM_compositor.h"
+
 /**
  * When a gizmo is highlighted and uses click/drag events,
  * this prevents mouse button press events from being passed through to other key-maps
@@ -511,6 +514,30 @@ static void wm_event_timers_execute(bContext *C)
   CTX_wm_window_set(C, nullptr);
 }
 
+/**
+ * Free the compositor results kept across executions once no window shows a scene using the
+ * full-frame compositor anymore.
+ */
+static void wm_free_unused_compositor_caches(const wmWindowManager *wm)
+{
+  /* Clearing the caches waits for running compositor executions. */
+  if (WM_jobs_has_running_type(wm, WM_JOB_TYPE_COMPOSITE) ||
+      WM_jobs_has_running_type(wm, WM_JOB_TYPE_RENDER))
+  {
+    return;
+  }
+
+  LISTBASE_FOREACH (const wmWindow *, win, &wm->windows) {
+    const Scene *scene = WM_window_get_active_scene(win);
+    if (scene->use_nodes && scene->nodetree &&
+        scene->nodetree->execution_mode == NTREE_EXECUTION_MODE_FULL_FRAME)
+    {
+      return;
+    }
+  }
+  COM_clear_caches();
+}
+
 void wm_event_do_notifiers(bContext *C)
 {
   /* Ensure inside render boundary. */
@@ -717,6 +744,7 @@ void wm_event_do_notifiers(bContext *C)
   wm_event_do_refresh_wm_and_depsgraph(C);
 
   RE_FreeUnusedGPUResources();
+  wm_free_unused_compositor_caches(wm);
 
   /* Status bar. */
   if (wm->winactive) {
@@ -85,6 +85,8 @@
 #include "BLO_undofile.h" /* to save from an undo memfile */
 #include "BLO_writefile.h"
 
+#include "COM_compositor.h"
+
 #include "RNA_access.h"
 #include "RNA_define.h"
 
@@ -639,6 +641,8 @@ static void wm_file_read_pre(bool use_data, bool /*use_userdef*/)
 {
   if (use_data) {
     BLI_timer_on_file_load();
+    /* Cached compositor results refer to data of the previous file. */
+    COM_clear_caches();
   }
 
   /* Always do this as both startup and preferences may have loaded in many font's
@@ -0,0 +1,67 @@
+# SPDX-FileCopyrightText: 2023 Blender Foundation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+import api
+
+
+def _run(args):
+    import bpy
+    import time
+
+    # Evaluate objects once first, to avoid any possible lazy evaluation later.
+    bpy.context.view_layer.update()
+
+    ob = bpy.context.view_layer.objects.active
+    if ob is None or ob.type != 'MESH':
+        ob = next(ob for ob in bpy.context.view_layer.objects if ob.type == 'MESH')
+        bpy.context.view_layer.objects.active = ob
+    if ob.mode != 'OBJECT':
+        bpy.ops.object.mode_set(mode='OBJECT')
+
+    test_time_start = time.time()
+    measured_times = []
+
+    min_measurements = 5
+    max_measurements = 100
+    timeout = 5
+
+    while True:
+        # Entering sculpt mode builds the PBVH from scratch.
+        start_time = time.time()
+        bpy.ops.object.mode_set(mode='SCULPT')
+        elapsed_time = time.time() - start_time
+        measured_times.append(elapsed_time)
+        bpy.ops.object.mode_set(mode='OBJECT')
+
+        if len(measured_times) >= min_measurements and test_time_start + timeout < time.time():
+            break
+        if len(measured_times) >= max_measurements:
+            break
+
+    average_time = sum(measured_times) / len(measured_times)
+    result = {'time': average_time}
+    return result
+
+
+class SculptModeEnterTest(api.Test):
+    def __init__(self, filepath):
+        self.filepath = filepath
+
+    def name(self):
+        return self.filepath.stem
+
+    def category(self):
+        return "sculpt"
+
+    def run(self, env, device_id):
+        args = {}
+
+        result, _ = env.run_in_blender(_run, args, [self.filepath])
+
+        return result
+
+
+def generate(env):
+    filepaths = env.find_blend_files('sculpt/*')
+    return [SculptModeEnterTest(filepath) for filepath in filepaths]